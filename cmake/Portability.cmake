@@ -43,6 +43,24 @@ macro(check_strlcpy)
     endif ()
 endmacro()
 
+macro(check_pread)
+    message(CHECK_START "Checking for pread()")
+    
+    cmake_push_check_state(RESET)
+    set(CMAKE_REQUIRED_QUIET ON)
+    check_symbol_exists(pread "unistd.h" HAVE_PREAD)
+    cmake_pop_check_state()
+    
+    if (HAVE_PREAD)
+        message(CHECK_PASS "found")
+    else ()
+        # Ensure that the variable is defined, even if the check failed.
+        set(HAVE_PREAD 0)
+        
+        message(CHECK_FAIL "not found")
+    endif ()
+endmacro()
+
 
 macro(_check_64bit_file_offset_support)
     message(CHECK_START "Checking for 64-bit file offset support")
@@ -9,6 +9,7 @@
  *   - Iterate over dictionary entries using CosDictObjNodeIterator.
  *   - Resolve indirect object references.
  *   - Recursively walk the object tree.
+ *   - Visit every object in file order with a sequential cursor.
  */
 
 #include "CosExample.h"
@@ -244,6 +245,7 @@ EXAMPLE_MAIN()
 {
     CosDoc *doc = NULL;
     CosMemoryStream *stream = NULL;
+    CosDocObjCursor *cursor = NULL;
     CosError error = cos_error_none();
     int result = EXIT_FAILURE;
 
@@ -287,9 +289,39 @@ EXAMPLE_MAIN()
     visit_object_(root, 0);
     printf("----------------------------\n");
 
+    /* Visit every object in the order it appears in the file, in one forward pass.
+     * This reads the file sequentially instead of jumping around by xref order. */
+    cursor = cos_doc_obj_cursor_create(doc, &error);
+    if (!cursor) {
+        fprintf(stderr, "Failed to create object cursor (error %d)\n", (int)error.code);
+        goto cleanup;
+    }
+
+    printf("\n--- Objects in file order ---\n");
+    CosObjID obj_id = CosObjID_Invalid;
+    CosObjNode *obj = NULL;
+    while (cos_doc_obj_cursor_next(cursor, &obj_id, &obj, &error)) {
+        CosObjNode *value = cos_indirect_obj_node_get_value((CosIndirectObjNode *)obj);
+        printf("%u %u obj: %s\n",
+               obj_id.obj_number,
+               obj_id.gen_number,
+               obj_type_name_(value ? cos_obj_node_get_type(value) : CosObjNodeType_Unknown));
+
+        /* The cursor does not cache the objects, so the caller releases them. */
+        cos_obj_node_release(obj);
+    }
+    if (error.code != COS_ERROR_NONE) {
+        fprintf(stderr, "Scan failed (error %d)\n", (int)error.code);
+        goto cleanup;
+    }
+    printf("-----------------------------\n");
+
     result = EXIT_SUCCESS;
 
 cleanup:
+    if (cursor) {
+        cos_doc_obj_cursor_destroy(cursor);
+    }
     if (doc) {
         cos_doc_destroy(doc);
     }
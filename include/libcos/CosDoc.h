@@ -9,11 +9,73 @@
 
 #include <libcos/CosObjID.h>
 #include <libcos/common/CosDefines.h>
+#include <libcos/common/CosExecutor.h>
 #include <libcos/common/CosTypes.h>
+#include <libcos/parse/CosObjEvent.h>
+
+#include <stdbool.h>
+#include <stddef.h>
 
 COS_DECLS_BEGIN
 COS_ASSUME_NONNULL_BEGIN
 
+/**
+ * The budget of a document's object cache.
+ *
+ * When the cache goes over either limit, it evicts unpinned objects that have not been used
+ * recently until it is within both again. A limit of @c 0 means no limit.
+ */
+typedef struct CosDocCacheLimits {
+    /**
+     * The maximum number of cached objects.
+     */
+    size_t max_objects;
+
+    /**
+     * The maximum estimated size in bytes of the cached objects.
+     */
+    size_t max_bytes;
+
+} CosDocCacheLimits;
+
+typedef struct CosDocCacheStats {
+    /**
+     * The number of object lookups that were served from the cache.
+     */
+    size_t hit_count;
+
+    /**
+     * The number of object lookups that had to parse the object.
+     */
+    size_t miss_count;
+
+    /**
+     * The number of objects that were evicted to stay within the limits.
+     */
+    size_t eviction_count;
+
+    /**
+     * The number of objects that are currently cached.
+     */
+    size_t object_count;
+
+    /**
+     * The estimated size in bytes of the objects that are currently cached.
+     */
+    size_t byte_count;
+
+    /**
+     * The number of cached objects that are pinned.
+     */
+    size_t pinned_count;
+
+} CosDocCacheStats;
+
+/**
+ * A forward-only cursor over the in-use objects of a document, in file order.
+ */
+typedef struct CosDocObjCursor CosDocObjCursor;
+
 void
 cos_doc_destroy(CosDoc *doc)
     COS_DEALLOCATOR_FUNC;
@@ -45,6 +107,258 @@ cos_doc_get_object(CosDoc *doc,
                    CosObjID obj_id,
                    CosError * COS_Nullable error);
 
+/**
+ * @brief Loads several objects at once.
+ *
+ * The objects that are not cached are loaded in the order they appear in the file, rather than
+ * in the order they are requested. An object that starts where the previous one ended is parsed
+ * straight on, without seeking or resetting the tokenizer, so a batch of neighbouring objects
+ * (such as a page's resources) is read in one sequential pass.
+ *
+ * @param doc The document.
+ * @param obj_ids The identifiers of the objects to load. An identifier can appear more than once.
+ * @param count The number of identifiers in @p obj_ids .
+ * @param out_objs On output, the object for each identifier, or @c NULL if the object could not
+ * be loaded. The caller must release each object, as with @c cos_doc_get_object .
+ * @param out_error On input, a pointer to an error object, or @c NULL. Receives the first error.
+ *
+ * @return @c true if every object was loaded, @c false otherwise.
+ */
+bool
+cos_doc_load_objects(CosDoc *doc,
+                     const CosObjID *obj_ids,
+                     size_t count,
+                     CosObjNode * COS_Nullable *out_objs,
+                     CosError * COS_Nullable out_error)
+    COS_ATTR_ACCESS_READ_ONLY_SIZE(2, 3)
+    COS_ATTR_ACCESS_WRITE_ONLY_SIZE(4, 3);
+
+/**
+ * @brief Gets an object, parsing only some of its dictionary's entries.
+ *
+ * This is for reading a few entries of a large dictionary, such as a page's Type and Parent:
+ * the values of the other keys are skipped in the file, without being parsed or allocated.
+ * For a stream object, only the dictionary is returned.
+ *
+ * The partial object is not added to the object cache. If the object is already cached, the
+ * complete cached object is returned instead.
+ *
+ * @param doc The document.
+ * @param obj_id The identifier of the object.
+ * @param keys The keys to parse, without the leading solidus.
+ * @param key_count The number of keys in @p keys .
+ * @param out_error On input, a pointer to an error object, or @c NULL.
+ *
+ * @return The object, which the caller must release, or @c NULL if an error occurred. Keys
+ * that the object does not have are missing from the returned dictionary.
+ */
+CosObjNode * COS_Nullable
+cos_doc_get_object_keys(CosDoc *doc,
+                        CosObjID obj_id,
+                        const char * const *keys,
+                        size_t key_count,
+                        CosError * COS_Nullable out_error)
+    COS_ATTR_ACCESS_READ_ONLY_SIZE(3, 4);
+
+// MARK: - Sequential scan
+
+void
+cos_doc_obj_cursor_destroy(CosDocObjCursor *cursor)
+    COS_DEALLOCATOR_FUNC;
+
+/**
+ * @brief Creates a cursor that visits every in-use object of the document in one forward pass.
+ *
+ * The objects are visited in the order they appear in the file, rather than in xref order. The
+ * cursor reads the file through a large read-ahead buffer of its own, and never seeks backwards:
+ * neighbouring objects are parsed straight on, and stream data is skipped by its length.
+ *
+ * The cursor borrows the document, which must outlive it.
+ *
+ * @param doc The document, which must have been parsed.
+ * @param out_error On input, a pointer to an error object, or @c NULL.
+ *
+ * @return A new cursor, or @c NULL if an error occurred.
+ */
+CosDocObjCursor * COS_Nullable
+cos_doc_obj_cursor_create(CosDoc *doc,
+                          CosError * COS_Nullable out_error)
+    COS_ALLOCATOR_FUNC
+    COS_ALLOCATOR_FUNC_MATCHED_DEALLOC(cos_doc_obj_cursor_destroy);
+
+/**
+ * @brief Moves the cursor to the next object.
+ *
+ * Objects that are already in the document's object cache are returned from there. Other
+ * objects are parsed, but not added to the cache.
+ *
+ * @param cursor The cursor.
+ * @param out_obj_id On output, the identifier of the object.
+ * @param out_obj On output, the object, which the caller must release, or @c NULL.
+ * @param out_error On input, a pointer to an error object, or @c NULL.
+ *
+ * @return @c true if the cursor moved to an object, @c false at the end of the document or if
+ * the object could not be parsed. After an error, the cursor has moved past the object, so the
+ * scan can carry on with the next call.
+ */
+bool
+cos_doc_obj_cursor_next(CosDocObjCursor *cursor,
+                        CosObjID *out_obj_id,
+                        CosObjNode * COS_Nullable *out_obj,
+                        CosError * COS_Nullable out_error)
+    COS_ATTR_ACCESS_WRITE_ONLY(2)
+    COS_ATTR_ACCESS_WRITE_ONLY(3);
+
+/**
+ * @brief Moves the cursor to the next object, and reports its structure as events.
+ *
+ * No object nodes are created: the object is tokenized straight from the file, and each value
+ * is passed to @p handler as it is read. This is useful for filtering large documents, such
+ * as looking for every URI, in constant memory. Stream data is skipped, and reported with a
+ * @c CosObjEventType_StreamStart event. The data is skipped by the stream's Length entry when
+ * that is a direct integer. An indirect Length is not resolved: the data is read through up to
+ * the endstream keyword instead, and the event's length is @c -1.
+ *
+ * @param cursor The cursor.
+ * @param handler The event handler. If it stops the scan, the rest of the object is skipped.
+ * @param out_obj_id On output, the identifier of the object.
+ * @param out_error On input, a pointer to an error object, or @c NULL.
+ *
+ * @return @c true if the cursor moved to an object, @c false at the end of the document or if
+ * the object could not be scanned. As with @c cos_doc_obj_cursor_next , the scan can carry on
+ * after an error.
+ */
+bool
+cos_doc_obj_cursor_scan_next(CosDocObjCursor *cursor,
+                             const CosObjEventHandler *handler,
+                             CosObjID *out_obj_id,
+                             CosError * COS_Nullable out_error)
+    COS_ATTR_ACCESS_WRITE_ONLY(3);
+
+// MARK: - Concurrency
+
+/**
+ * @brief Makes the document safe to read from multiple threads.
+ *
+ * Afterwards, @c cos_doc_get_object can be called from any thread. Objects that are loaded are
+ * frozen (see @c cos_obj_node_freeze), so they can be read from any thread, but not modified.
+ * Each object is loaded only once: a thread that asks for an object that another thread is
+ * loading waits for it.
+ *
+ * If the input stream supports positional reads (see @c cos_stream_can_read_at ), each load
+ * gets its own tokenizer and parser state over the shared input, so objects are parsed in
+ * parallel. Otherwise, the threads take turns with the document's parser.
+ *
+ * This must be called after the document is parsed, and before it is shared with other threads.
+ * The cache limits must also be set before then. The document's allocator must be safe to use
+ * from multiple threads, and the library must be built with atomic reference counts.
+ *
+ * @param doc The document.
+ * @param out_error On input, a pointer to an error object, or @c NULL.
+ *
+ * @return @c true if the document can be read from multiple threads, @c false if an error
+ * occurred.
+ */
+bool
+cos_doc_enable_concurrent_access(CosDoc *doc,
+                                 CosError * COS_Nullable out_error);
+
+/**
+ * @brief Loads every in-use object of the document into the object cache, with several threads.
+ *
+ * The document is made concurrent first (see @c cos_doc_enable_concurrent_access ). The objects
+ * are sorted by byte offset and split into contiguous byte ranges, and each range becomes a task
+ * that parses its objects in order, with its own parser. The tasks run on a work-stealing task
+ * pool, or on the document's executor if one is set (see @c cos_doc_set_executor ). There are
+ * more ranges than threads, so a range with a large object does not hold up the others.
+ *
+ * With cache limits, some of the objects may have been evicted again by the time this returns.
+ *
+ * @param doc The document.
+ * @param thread_count The number of threads to use, including the calling thread, or @c 0 to
+ * use one thread per processor. Ignored if the document has an executor.
+ * @param out_error On input, a pointer to an error object, or @c NULL.
+ *
+ * @return @c true if every object was loaded, @c false if an error occurred. The objects that
+ * could be loaded are cached either way.
+ */
+bool
+cos_doc_load_all_objects_parallel(CosDoc *doc,
+                                  size_t thread_count,
+                                  CosError * COS_Nullable out_error);
+
+// MARK: - Object cache
+
+/**
+ * @brief Sets the budget of the document's object cache.
+ *
+ * Objects are evicted straight away if the cache is over the new limits. By default the cache
+ * has no limits.
+ *
+ * An evicted object is only released by the cache. It stays valid for as long as a caller
+ * retains it, and is parsed again the next time it is requested.
+ *
+ * @param doc The document.
+ * @param limits The new limits.
+ */
+void
+cos_doc_set_cache_limits(CosDoc *doc,
+                         CosDocCacheLimits limits);
+
+/**
+ * @brief Loads an object and keeps it in the document's object cache until it is unpinned.
+ *
+ * Pinned objects, such as the catalog or the root of the page tree, are never evicted.
+ * Pins are counted, so each call must be balanced by a call to @c cos_doc_unpin_object.
+ *
+ * @param doc The document.
+ * @param obj_id The ID of the object.
+ * @param out_error On input, a pointer to an error object, or @c NULL.
+ *
+ * @return @c true if the object was loaded and pinned, @c false if an error occurred.
+ */
+bool
+cos_doc_pin_object(CosDoc *doc,
+                   CosObjID obj_id,
+                   CosError * COS_Nullable out_error);
+
+/**
+ * @brief Removes a pin that was added with @c cos_doc_pin_object.
+ *
+ * @param doc The document.
+ * @param obj_id The ID of the object.
+ */
+void
+cos_doc_unpin_object(CosDoc *doc,
+                     CosObjID obj_id);
+
+/**
+ * @brief Gets the statistics of the document's object cache.
+ *
+ * @param doc The document.
+ * @param out_stats On output, the statistics.
+ */
+void
+cos_doc_get_cache_stats(const CosDoc *doc,
+                        CosDocCacheStats *out_stats)
+    COS_ATTR_ACCESS_WRITE_ONLY(2);
+
+// MARK: - Background work
+
+/**
+ * @brief Sets the executor that runs the document's background work.
+ *
+ * By default, the library starts threads of its own for work such as
+ * @c cos_doc_load_all_objects_parallel . With an executor, that work is submitted to the
+ * executor instead, and the calling thread waits for it to finish.
+ *
+ * @param doc The document.
+ * @param executor The executor, which is copied, or @c NULL to use the library's own threads.
+ */
+void
+cos_doc_set_executor(CosDoc *doc,
+                     const CosExecutor * COS_Nullable executor);
+
 // MARK: - Diagnostics
 
 /**
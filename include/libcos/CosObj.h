@@ -53,6 +53,9 @@ cos_obj_destroy(CosObj *obj)
  * Type-specific accessors resolve through indirect and reference wrappers
  * transparently.
  *
+ * Objects obtained from arrays and dictionaries may instead wrap a scalar
+ * that the container stores inline; the accessors treat both alike.
+ *
  * @param node The object node to wrap.
  *
  * @return The new object, or @c NULL on allocation failure.
@@ -209,6 +212,91 @@ cos_obj_get_object_at_index(const CosObj *obj,
                             CosError * COS_Nullable out_error)
     COS_ATTR_ACCESS_WRITE_ONLY(3);
 
+/**
+ * Gets the integer at the given index, without creating an object for the element.
+ *
+ * @pre @c cos_obj_get_type returns @c CosObjType_Array.
+ *
+ * @param obj The object.
+ * @param index The zero-based element index.
+ * @param[out] out_value On success, receives the integer.
+ * @param out_error On failure, receives error information.
+ *
+ * @return @c true on success, or @c false if the index is out of range or the element is not
+ *         an integer.
+ */
+bool
+cos_obj_get_int_at_index(const CosObj *obj,
+                         size_t index,
+                         int *out_value,
+                         CosError * COS_Nullable out_error)
+    COS_ATTR_ACCESS_WRITE_ONLY(3)
+    COS_ATTR_ACCESS_WRITE_ONLY(4);
+
+/**
+ * Gets the number (integer or real) at the given index, without creating an object for the
+ * element.
+ *
+ * @pre @c cos_obj_get_type returns @c CosObjType_Array.
+ *
+ * @param obj The object.
+ * @param index The zero-based element index.
+ * @param[out] out_value On success, receives the number.
+ * @param out_error On failure, receives error information.
+ *
+ * @return @c true on success, or @c false if the index is out of range or the element is not
+ *         a number.
+ */
+bool
+cos_obj_get_number_at_index(const CosObj *obj,
+                            size_t index,
+                            double *out_value,
+                            CosError * COS_Nullable out_error)
+    COS_ATTR_ACCESS_WRITE_ONLY(3)
+    COS_ATTR_ACCESS_WRITE_ONLY(4);
+
+/**
+ * Copies the first @p count elements of a numeric array in one pass.
+ *
+ * @pre @c cos_obj_get_type returns @c CosObjType_Array.
+ *
+ * @param obj The object.
+ * @param[out] out_numbers On success, receives @p count numbers.
+ * @param count The number of elements to copy.
+ * @param out_error On failure, receives error information.
+ *
+ * @return @c true on success, or @c false if the array has fewer than @p count elements or
+ *         one of them is not a number.
+ */
+bool
+cos_obj_get_number_array(const CosObj *obj,
+                         double *out_numbers,
+                         size_t count,
+                         CosError * COS_Nullable out_error)
+    COS_ATTR_ACCESS_WRITE_ONLY_SIZE(2, 3)
+    COS_ATTR_ACCESS_WRITE_ONLY(4);
+
+/**
+ * Copies the first @p count elements of an integer array in one pass.
+ *
+ * @pre @c cos_obj_get_type returns @c CosObjType_Array.
+ *
+ * @param obj The object.
+ * @param[out] out_ints On success, receives @p count integers.
+ * @param count The number of elements to copy.
+ * @param out_error On failure, receives error information.
+ *
+ * @return @c true on success, or @c false if the array has fewer than @p count elements or
+ *         one of them is not an integer.
+ */
+bool
+cos_obj_get_int_array(const CosObj *obj,
+                      int *out_ints,
+                      size_t count,
+                      CosError * COS_Nullable out_error)
+    COS_ATTR_ACCESS_WRITE_ONLY_SIZE(2, 3)
+    COS_ATTR_ACCESS_WRITE_ONLY(4);
+
 // MARK: - Dict accessors
 
 /**
@@ -243,6 +331,49 @@ cos_obj_get_value_for_key(const CosObj *obj,
                           CosError * COS_Nullable out_error)
     COS_ATTR_ACCESS_WRITE_ONLY(3);
 
+/**
+ * Gets the integer for a key in the dictionary, without creating an object for the value.
+ *
+ * @pre @c cos_obj_get_type returns @c CosObjType_Dict.
+ *
+ * @param obj The object.
+ * @param key The key, as a nul-terminated C string.
+ * @param[out] out_value On success, receives the integer.
+ * @param out_error On failure, receives error information.
+ *
+ * @return @c true on success, or @c false if the key was not found or the value is not an
+ *         integer.
+ */
+bool
+cos_obj_get_int_for_key(const CosObj *obj,
+                        const char *key,
+                        int *out_value,
+                        CosError * COS_Nullable out_error)
+    COS_ATTR_ACCESS_WRITE_ONLY(3)
+    COS_ATTR_ACCESS_WRITE_ONLY(4);
+
+/**
+ * Gets the number (integer or real) for a key in the dictionary, without creating an object
+ * for the value.
+ *
+ * @pre @c cos_obj_get_type returns @c CosObjType_Dict.
+ *
+ * @param obj The object.
+ * @param key The key, as a nul-terminated C string.
+ * @param[out] out_value On success, receives the number.
+ * @param out_error On failure, receives error information.
+ *
+ * @return @c true on success, or @c false if the key was not found or the value is not a
+ *         number.
+ */
+bool
+cos_obj_get_number_for_key(const CosObj *obj,
+                           const char *key,
+                           double *out_value,
+                           CosError * COS_Nullable out_error)
+    COS_ATTR_ACCESS_WRITE_ONLY(3)
+    COS_ATTR_ACCESS_WRITE_ONLY(4);
+
 // MARK: - Dict iterator
 
 /**
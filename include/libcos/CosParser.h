@@ -5,16 +5,77 @@
 #ifndef LIBCOS_COS_PARSER_H
 #define LIBCOS_COS_PARSER_H
 
+#include <libcos/CosObjID.h>
 #include <libcos/common/CosBasicTypes.h>
 #include <libcos/common/CosDefines.h>
 #include <libcos/common/CosError.h>
 #include <libcos/common/CosTypes.h>
 
 #include <stdbool.h>
+#include <stddef.h>
 
 COS_DECLS_BEGIN
 COS_ASSUME_NONNULL_BEGIN
 
+/**
+ * @brief A callback for each indirect object that a forward parse reads.
+ *
+ * @param obj_id The object's ID.
+ * @param obj The object's value. Borrowed, and only valid during the call.
+ * @param data The data of a stream object, read straight from the input, or @c NULL for other
+ * objects. The data is still encoded with the stream's filters. It is only valid during the
+ * call, and cannot seek. Any data that the callback does not read is skipped.
+ * @param user_data The handler's user data.
+ *
+ * @return @c true to carry on parsing, or @c false to stop.
+ */
+typedef bool (*CosParserObjFunc)(CosObjID obj_id,
+                                 CosObjNode *obj,
+                                 CosStream * COS_Nullable data,
+                                 void * COS_Nullable user_data);
+
+/**
+ * @brief Receives the objects of a forward parse.
+ */
+typedef struct CosParserObjHandler {
+    /**
+     * Called for each indirect object, in file order.
+     */
+    CosParserObjFunc handle_object;
+
+    /**
+     * The user data that is passed to @a handle_object .
+     */
+    void * COS_Nullable user_data;
+} CosParserObjHandler;
+
+/**
+ * @brief What a forward parse found.
+ */
+typedef struct CosParserForwardSummary {
+    /**
+     * The number of indirect objects that were read.
+     */
+    size_t obj_count;
+
+    /**
+     * The number of cross-reference sections that were read.
+     */
+    size_t xref_section_count;
+
+    /**
+     * The number of objects whose newest cross-reference entry is in use, but that were not
+     * found anywhere in the file.
+     */
+    size_t missing_obj_count;
+
+    /**
+     * The number of objects whose newest cross-reference entry is in use, with an offset that
+     * differs from where the object was last found.
+     */
+    size_t moved_obj_count;
+} CosParserForwardSummary;
+
 /**
  * @brief Deallocates a parser.
  *
@@ -63,6 +124,32 @@ cos_parser_parse(CosParser *parser,
                  CosError * COS_Nullable out_error)
     COS_ATTR_ACCESS_WRITE_ONLY(2);
 
+/**
+ * @brief Parses the PDF file structure in a single pass from the start of the input stream.
+ *
+ * Unlike @c cos_parser_parse , this never seeks, so the input can be a pipe or a socket. Each
+ * indirect object is passed to @p handler as it is read, and is not kept. The cross-reference
+ * sections and trailers are read where they appear, and checked against the offsets where the
+ * objects were actually found. Once the input ends, the document's cross-reference table,
+ * trailer and root are set from them, as @c cos_parser_parse would.
+ *
+ * Only classic cross-reference tables are read. Cross-reference streams are passed to
+ * @p handler like any other stream object.
+ *
+ * @param parser The parser, whose input stream must be at the start of the file.
+ * @param handler The object handler.
+ * @param out_summary On output, what the parse found, or @c NULL.
+ * @param out_error On failure, set to describe the error.
+ *
+ * @return @c true if the input was parsed to the end, or the handler stopped the parse,
+ * @c false if an error occurred.
+ */
+bool
+cos_parser_parse_forward(CosParser *parser,
+                         const CosParserObjHandler *handler,
+                         CosParserForwardSummary * COS_Nullable out_summary,
+                         CosError * COS_Nullable out_error);
+
 /**
  * @brief Seeks to a byte offset and parses the next PDF object.
  *
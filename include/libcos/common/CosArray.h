@@ -29,8 +29,19 @@ void
 cos_array_destroy(CosArray *array)
     COS_DEALLOCATOR_FUNC;
 
+/**
+ * @brief Creates an array.
+ *
+ * @param allocator The allocator to use, or @c NULL to use the default allocator.
+ * @param element_size The size of each element in the array.
+ * @param callbacks The element callbacks, or @c NULL.
+ * @param capacity_hint A hint for the initial capacity of the array.
+ *
+ * @return The new array, or @c NULL if an error occurred.
+ */
 CosArray * COS_Nullable
-cos_array_create(size_t element_size,
+cos_array_create(CosAllocator * COS_Nullable allocator,
+                 size_t element_size,
                  const CosArrayCallbacks * COS_Nullable callbacks,
                  size_t capacity_hint)
     COS_ALLOCATOR_FUNC
@@ -76,6 +87,27 @@ cos_array_get_item(const CosArray *array,
     COS_ATTR_ACCESS_WRITE_ONLY(3)
     COS_ATTR_ACCESS_WRITE_ONLY(4);
 
+/**
+ * @brief Replaces the item at the given index.
+ *
+ * The old item is released before the new item is stored and retained, as configured by the
+ * array's callbacks, just like removing the old item and inserting the new one.
+ *
+ * @param array The array.
+ * @param index The index of the item to replace.
+ * @param item The new item.
+ * @param out_error On input, a pointer to an error object, or @c NULL.
+ *
+ * @return @c true if the item was replaced, or @c false if the index is out of bounds.
+ */
+bool
+cos_array_set_item(CosArray *array,
+                   size_t index,
+                   const void *item,
+                   CosError * COS_Nullable out_error)
+    COS_ATTR_ACCESS_READ_ONLY(3)
+    COS_ATTR_ACCESS_WRITE_ONLY(4);
+
 /** @name Insertion */
 /** @{ **/
 
@@ -15,12 +15,22 @@
 COS_DECLS_BEGIN
 COS_ASSUME_NONNULL_BEGIN
 
+/**
+ * @brief The number of bytes that a data object can store without a separate allocation.
+ */
+#define COS_DATA_INLINE_CAPACITY 24
+
 /**
  * @brief A data object.
+ *
+ * @note Short data is stored inside the object, so a data object must not be copied by value.
  */
 struct CosData {
     /**
      * @brief The bytes of the data object.
+     *
+     * Points to @c inline_bytes while the data fits in it, or to a separately allocated
+     * buffer otherwise.
      */
     unsigned char *bytes;
 
@@ -33,15 +43,47 @@ struct CosData {
      * @brief The capacity of the data object.
      */
     size_t capacity;
+
+    /**
+     * @brief The allocator used to allocate the data object, or @c NULL for the default allocator.
+     */
+    CosAllocator * COS_Nullable allocator;
+
+    /**
+     * @brief The cached hash of the bytes.
+     *
+     * Only valid if @c has_hash is @c true.
+     * @private
+     */
+    size_t hash;
+
+    /**
+     * @brief Whether @c hash holds the hash of the current bytes.
+     *
+     * Cleared by the functions that modify the data object. Code that writes to @c bytes or
+     * @c size directly must clear it too.
+     * @private
+     */
+    bool has_hash;
+
+    /**
+     * @brief The storage for short data.
+     * @private
+     */
+    unsigned char inline_bytes[COS_DATA_INLINE_CAPACITY];
 };
 
 /**
  * @brief Allocates a new data object.
  *
+ * @param allocator The allocator to use, or @c NULL to use the default allocator.
+ * @param capacity_hint A hint for the initial capacity of the data object.
+ *
  * @return A pointer to the allocated data object, or @c NULL if an error occurred.
  */
 CosData * COS_Nullable
-cos_data_alloc(size_t capacity_hint)
+cos_data_alloc(CosAllocator * COS_Nullable allocator,
+               size_t capacity_hint)
     COS_MALLOC_LIKE
     COS_WARN_UNUSED_RESULT;
 
@@ -56,6 +98,8 @@ cos_data_free(CosData *data);
 /**
  * @brief Creates a copy of a data object.
  *
+ * The copy is allocated with the same allocator as @p data.
+ *
  * @param data The data object to copy.
  * @param error On input, a pointer to an error object, or @c NULL.
  * On output, if an error occurred, the error object will be set with the error information.
@@ -142,6 +186,22 @@ cos_data_push_back(CosData *data,
                    unsigned char byte,
                    CosError * COS_Nullable error);
 
+/**
+ * @brief Returns the hash value of the data object.
+ *
+ * The hash is computed on first use and cached until the data object is modified. It is the
+ * same as the hash of a string with the same bytes.
+ *
+ * Caching writes to the data object, so a data object that is shared between threads must be
+ * hashed before it is shared. Freezing a string object hashes its data.
+ *
+ * @param data The data object.
+ *
+ * @return The hash value of the data object.
+ */
+size_t
+cos_data_get_hash(const CosData *data);
+
 // MARK: - Data reference
 
 /**
@@ -30,6 +30,18 @@ CosDataRef
 cos_data_ref_make(const unsigned char * COS_Nullable bytes,
                   size_t size);
 
+/**
+ * @brief Returns the hash value of a data reference.
+ *
+ * @param data_ref The data reference.
+ *
+ * @return The hash value of the referenced bytes.
+ *
+ * @see @c cos_data_get_hash()
+ */
+size_t
+cos_data_ref_get_hash(CosDataRef data_ref);
+
 COS_ASSUME_NONNULL_END
 COS_DECLS_END
 
@@ -21,6 +21,8 @@ typedef void (*CosDictRetainCallback)(void *value);
 typedef void (*CosDictReleaseCallback)(void *value);
 typedef bool (*CosDictEqualValuesCallback)(void *value1,
                                            void *value2);
+typedef bool (*CosDictMatchKeyCallback)(void *key,
+                                        const void *context);
 
 typedef struct CosDictKeyCallbacks {
     CosDictHashCallback hash;
@@ -39,8 +41,19 @@ void
 cos_dict_destroy(CosDict *dict)
     COS_DEALLOCATOR_FUNC;
 
+/**
+ * Creates a dictionary.
+ *
+ * @param allocator The allocator to use, or @c NULL to use the default allocator.
+ * @param key_callbacks The key callbacks.
+ * @param value_callbacks The value callbacks.
+ * @param capacity_hint A hint for the initial capacity of the dictionary.
+ *
+ * @return The new dictionary, or @c NULL if an error occurred.
+ */
 CosDict * COS_Nullable
-cos_dict_create(const CosDictKeyCallbacks *key_callbacks,
+cos_dict_create(CosAllocator * COS_Nullable allocator,
+                const CosDictKeyCallbacks *key_callbacks,
                 const CosDictValueCallbacks *value_callbacks,
                 size_t capacity_hint)
     COS_ALLOCATOR_FUNC
@@ -55,12 +68,50 @@ cos_dict_get(CosDict *dict,
              void * COS_Nullable * COS_Nonnull out_value,
              CosError * COS_Nullable out_error);
 
+/**
+ * Looks up a value without constructing a key.
+ *
+ * The dictionary is probed with a precomputed hash, and each candidate key is passed to
+ * @a match_key until it returns @c true. The hash must be the value that the key callbacks
+ * would return for a matching key.
+ *
+ * @param dict The dictionary.
+ * @param hash The hash of the key to look up.
+ * @param match_key The callback that decides whether a key matches.
+ * @param context The context to pass to @a match_key.
+ * @param out_value On output, the value of the matching key.
+ *
+ * @return @c true if a matching key was found, otherwise @c false.
+ */
+bool
+cos_dict_get_matching(const CosDict *dict,
+                      size_t hash,
+                      CosDictMatchKeyCallback match_key,
+                      const void *context,
+                      void * COS_Nullable * COS_Nonnull out_value);
+
 bool
 cos_dict_set(CosDict *dict,
              void *key,
              void *value,
              CosError * COS_Nullable error);
 
+/**
+ * Removes a key and its value from a dictionary.
+ *
+ * The removed key and value are released with the dictionary's callbacks.
+ *
+ * @param dict The dictionary.
+ * @param key The key to remove.
+ * @param out_error On input, a pointer to an error object, or @c NULL.
+ *
+ * @return @c true if the key was found and removed, otherwise @c false.
+ */
+bool
+cos_dict_remove(CosDict *dict,
+                void *key,
+                CosError * COS_Nullable out_error);
+
 // MARK: - Iterator
 
 /**
@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2025 OpenCOS.
+ */
+
+#ifndef LIBCOS_COMMON_COS_EXECUTOR_H
+#define LIBCOS_COMMON_COS_EXECUTOR_H
+
+#include <libcos/common/CosDefines.h>
+
+COS_DECLS_BEGIN
+COS_ASSUME_NONNULL_BEGIN
+
+/**
+ * @brief A unit of background work, run by an executor.
+ *
+ * @param job The job, as passed to the executor's submit callback.
+ */
+typedef void (*CosExecutorJobFunc)(void *job);
+
+/**
+ * @brief Schedules a job on an executor.
+ *
+ * The executor must call @p job_func with @p job exactly once, on any thread. It can do so before
+ * returning, on the calling thread.
+ *
+ * @param job_func The function to call.
+ * @param job The argument to pass to @p job_func .
+ * @param user_data The executor's user data.
+ */
+typedef void (*CosExecutorSubmitCallback)(CosExecutorJobFunc job_func,
+                                          void *job,
+                                          void * COS_Nullable user_data);
+
+/**
+ * @brief An external executor, such as an application's own thread pool.
+ *
+ * By default, the library runs background work on threads of its own. An executor lets the
+ * application run that work on its threads instead.
+ */
+typedef struct CosExecutor {
+    /**
+     * Schedules a job.
+     */
+    CosExecutorSubmitCallback submit;
+
+    /**
+     * The user data that is passed to @a submit .
+     */
+    void * COS_Nullable user_data;
+} CosExecutor;
+
+COS_ASSUME_NONNULL_END
+COS_DECLS_END
+
+#endif /* LIBCOS_COMMON_COS_EXECUTOR_H */
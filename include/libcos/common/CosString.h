@@ -17,6 +17,11 @@ COS_ASSUME_NONNULL_BEGIN
 /**
  * Allocates a new empty string.
  *
+ * Short strings are stored inside the string object itself. A string only allocates a
+ * separate character buffer once it outgrows that storage, or if @p capacity_hint asks for
+ * more up front.
+ *
+ * @param allocator The allocator to use, or @c NULL to use the default allocator.
  * @param capacity_hint A hint for the initial capacity of the string.
  *
  * @return The new string, or @c NULL if memory allocation failed.
@@ -25,13 +30,15 @@ COS_ASSUME_NONNULL_BEGIN
  * @see cos_string_free()
  */
 CosString * COS_Nullable
-cos_string_alloc(size_t capacity_hint)
+cos_string_alloc(CosAllocator * COS_Nullable allocator,
+                 size_t capacity_hint)
     COS_ATTR_MALLOC
     COS_WARN_UNUSED_RESULT;
 
 /**
  * Allocates a new string with the given C-string.
  *
+ * @param allocator The allocator to use, or @c NULL to use the default allocator.
  * @param str The null-terminated C-string to copy.
  * @return The new string, or @c NULL if memory allocation failed.
  *
@@ -39,14 +46,16 @@ cos_string_alloc(size_t capacity_hint)
  * @see cos_string_free()
  */
 CosString * COS_Nullable
-cos_string_alloc_with_str(const char *str)
+cos_string_alloc_with_str(CosAllocator * COS_Nullable allocator,
+                          const char *str)
     COS_ATTR_MALLOC
     COS_WARN_UNUSED_RESULT
-    COS_ATTR_ACCESS_READ_ONLY(1);
+    COS_ATTR_ACCESS_READ_ONLY(2);
 
 /**
  * Allocates a new string with the given C-string.
  *
+ * @param allocator The allocator to use, or @c NULL to use the default allocator.
  * @param str The C-string to copy.
  * @param n The number of characters to copy.
  * @return The new string, or @c NULL if memory allocation failed.
@@ -55,9 +64,11 @@ cos_string_alloc_with_str(const char *str)
  * @see cos_string_free()
  */
 CosString * COS_Nullable
-cos_string_alloc_with_strn(const char *str, size_t n)
+cos_string_alloc_with_strn(CosAllocator * COS_Nullable allocator,
+                           const char *str,
+                           size_t n)
     COS_ATTR_MALLOC
-    COS_WARN_UNUSED_RESULT COS_ATTR_ACCESS_READ_ONLY_SIZE(1, 2);
+    COS_WARN_UNUSED_RESULT COS_ATTR_ACCESS_READ_ONLY_SIZE(2, 3);
 
 /**
  * Frees a string.
@@ -132,6 +143,7 @@ cos_string_get_capacity(const CosString *string)
  *
  * @return The new string, or @c NULL if memory allocation failed.
  *
+ * @note The copy is allocated with the same allocator as @p string.
  * @note The returned string must be freed with @c cos_string_free().
  */
 CosString * COS_Nullable
@@ -164,13 +176,16 @@ cos_string_push_back(CosString *string, char c);
 /**
  * @brief Returns the hash value of the string.
  *
+ * The hash is computed on first use and cached until the string is modified. Caching writes to
+ * the string, so a string that is shared between threads must be hashed before it is shared.
+ * Name objects hash their value when it is set.
+ *
  * @param string The string.
  *
  * @return The hash value of the string.
  */
 size_t
-cos_string_get_hash(const CosString *string)
-    COS_ATTR_ACCESS_READ_ONLY(1);
+cos_string_get_hash(const CosString *string);
 
 /** @} */
 
@@ -256,6 +271,20 @@ cos_string_ref_make(const char *str, size_t n)
 int
 cos_string_ref_cmp(CosStringRef lhs, CosStringRef rhs);
 
+/**
+ * Returns the hash value of a string reference.
+ *
+ * The hash value is the same as the hash value of a string with the same contents.
+ *
+ * @param string_ref The string reference.
+ *
+ * @return The hash value of the string reference.
+ *
+ * @see @c cos_string_get_hash()
+ */
+size_t
+cos_string_ref_get_hash(CosStringRef string_ref);
+
 COS_ASSUME_NONNULL_END
 COS_DECLS_END
 
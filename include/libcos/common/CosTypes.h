@@ -48,11 +48,13 @@ typedef struct CosDoc CosDoc;
 typedef struct CosObjID CosObjID;
 
 typedef struct CosObjNode CosObjNode;
+typedef struct CosObjValue CosObjValue;
 typedef struct CosBoolObjNode CosBoolObjNode;
 typedef struct CosIntObjNode CosIntObjNode;
 typedef struct CosRealObjNode CosRealObjNode;
 typedef struct CosStringObjNode CosStringObjNode;
 typedef struct CosNameObjNode CosNameObjNode;
+typedef struct CosNameKey CosNameKey;
 typedef struct CosArrayObjNode CosArrayObjNode;
 typedef struct CosDictObjNode CosDictObjNode;
 typedef struct CosStreamObjNode CosStreamObjNode;
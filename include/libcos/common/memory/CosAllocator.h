@@ -8,6 +8,7 @@
 #include <libcos/common/CosDefines.h>
 #include <libcos/common/CosTypes.h>
 
+#include <stdbool.h>
 #include <stddef.h>
 
 COS_DECLS_BEGIN
@@ -40,6 +41,66 @@ typedef struct CosAllocatorCallbacks {
 
 } CosAllocatorCallbacks;
 
+/**
+ * The number of size classes served by a pool allocator.
+ *
+ * Size classes are multiples of 16 bytes, so the largest allocation served from a slab is
+ * @c 16 * COS_POOL_ALLOCATOR_SIZE_CLASS_COUNT bytes.
+ */
+#define COS_POOL_ALLOCATOR_SIZE_CLASS_COUNT 8
+
+typedef struct CosPoolAllocatorSizeClassStats {
+    /**
+     * The size of each slot in this size class.
+     */
+    size_t slot_size;
+
+    /**
+     * The number of slabs allocated for this size class.
+     */
+    size_t slab_count;
+
+    /**
+     * The total number of slots in the slabs of this size class.
+     */
+    size_t slot_count;
+
+    /**
+     * The number of slots that are currently allocated.
+     */
+    size_t live_count;
+
+} CosPoolAllocatorSizeClassStats;
+
+typedef struct CosPoolAllocatorStats {
+    /**
+     * The statistics of each size class, in ascending order of slot size.
+     */
+    CosPoolAllocatorSizeClassStats size_classes[COS_POOL_ALLOCATOR_SIZE_CLASS_COUNT];
+
+    /**
+     * The total number of slabs, across all size classes.
+     */
+    size_t slab_count;
+
+    /**
+     * The total number of slots, across all size classes.
+     */
+    size_t slot_count;
+
+    /**
+     * The total number of live allocations served from slabs.
+     */
+    size_t live_count;
+
+    /**
+     * The number of live allocations that were too large for a size class and were forwarded
+     * to the parent allocator.
+     */
+    size_t large_live_count;
+
+} CosPoolAllocatorStats;
+
 /** @name Creation and Destruction */
 /** @{ **/
 
@@ -70,6 +131,71 @@ cos_allocator_create(CosAllocator * COS_Nullable allocator,
     COS_ALLOCATOR_FUNC
     COS_ALLOCATOR_FUNC_MATCHED_DEALLOC(cos_allocator_destroy);
 
+/**
+ * @brief Creates a new arena allocator.
+ *
+ * An arena allocator hands out memory by bumping a pointer through large blocks that are
+ * obtained from the parent allocator. Deallocating a block of memory is a no-op (unless it
+ * was the most recent allocation), and all of the memory is released in bulk when the arena
+ * allocator is destroyed.
+ *
+ * This makes it suitable for use as a document allocator when parsed objects are expected to
+ * live as long as the document itself: tearing down a large object graph does not require a
+ * call to the parent allocator for every object.
+ *
+ * @param allocator The parent allocator to obtain the arena blocks from, or @c NULL to use the
+ * default allocator.
+ * @param block_size The size of each arena block, or @c 0 to use the default block size.
+ *
+ * @return The new arena allocator, or @c NULL if the allocation failed.
+ */
+CosAllocator * COS_Nullable
+cos_allocator_create_arena(CosAllocator * COS_Nullable allocator,
+                           size_t block_size)
+    COS_ALLOCATOR_FUNC
+    COS_ALLOCATOR_FUNC_MATCHED_DEALLOC(cos_allocator_destroy);
+
+/**
+ * @brief Creates a new pool allocator.
+ *
+ * A pool allocator serves small allocations, such as the nodes of scalar objects, from
+ * fixed-size slots in slabs that are obtained from the parent allocator. Each size class keeps
+ * a free list, so deallocated slots are reused by subsequent allocations of the same size class
+ * without calling into the parent allocator. Allocations that are larger than the largest size
+ * class are forwarded to the parent allocator.
+ *
+ * Slabs are only returned to the parent allocator when the pool allocator is destroyed.
+ *
+ * A pool allocator is not thread-safe. Use a separate pool allocator for each document or
+ * thread.
+ *
+ * @param allocator The parent allocator to obtain the slabs from, or @c NULL to use the default
+ * allocator.
+ *
+ * @return The new pool allocator, or @c NULL if the allocation failed.
+ */
+CosAllocator * COS_Nullable
+cos_allocator_create_pool(CosAllocator * COS_Nullable allocator)
+    COS_ALLOCATOR_FUNC
+    COS_ALLOCATOR_FUNC_MATCHED_DEALLOC(cos_allocator_destroy);
+
+/** @} **/
+
+/** @name Statistics */
+/** @{ **/
+
+/**
+ * @brief Gets the statistics of a pool allocator.
+ *
+ * @param allocator The pool allocator.
+ * @param out_stats On output, the statistics of the pool allocator.
+ *
+ * @return @c true if @a allocator is a pool allocator, otherwise @c false.
+ */
+bool
+cos_allocator_get_pool_stats(const CosAllocator *allocator,
+                             CosPoolAllocatorStats *out_stats);
+
 /** @} **/
 
 /** @name Memory Management */
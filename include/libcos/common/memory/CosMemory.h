@@ -24,6 +24,22 @@ cos_alloc(CosAllocator * COS_Nullable allocator,
     COS_ALLOCATOR_FUNC_SIZE(2)
     COS_ALLOCATOR_FUNC_MATCHED_DEALLOC_INDEX(cos_free, 2);
 
+/**
+ * @brief Allocates a zero-initialized block of memory for an array of @p count elements.
+ *
+ * @param allocator The allocator, or @c NULL to use the default allocator.
+ * @param count The number of elements.
+ * @param size The size of each element.
+ *
+ * @return A pointer to the allocated block of memory, or @c NULL if the allocation failed.
+ */
+void * COS_Nullable
+cos_calloc(CosAllocator * COS_Nullable allocator,
+           size_t count,
+           size_t size)
+    COS_ALLOCATOR_FUNC_SIZE(3)
+    COS_ALLOCATOR_FUNC_MATCHED_DEALLOC_INDEX(cos_free, 2);
+
 void * COS_Nullable
 cos_realloc(CosAllocator * COS_Nullable allocator,
             void * COS_Nullable ptr,
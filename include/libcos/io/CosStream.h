@@ -58,6 +58,28 @@ typedef struct CosStreamFunctions {
         COS_ATTR_ACCESS_WRITE_ONLY_SIZE(2, 3)
         COS_ATTR_ACCESS_WRITE_ONLY(4);
 
+    /**
+     * @brief Reads data from the stream at an offset, without changing the stream's offset.
+     *
+     * This function is optional. If it is implemented, it must be safe to call from multiple
+     * threads at once, as long as the stream is not written to.
+     *
+     * @param stream The stream.
+     * @param offset The offset to read from.
+     * @param buffer The output buffer to read into.
+     * @param count The maximum number of bytes to read.
+     * @param out_error The error information.
+     *
+     * @return The number of bytes read, or @c 0 if an error occurred or @p offset is at the end.
+     */
+    size_t (* COS_Nullable read_at_func)(CosStream *stream,
+                                         CosStreamOffset offset,
+                                         COS_PARAM_SPEC(out, nonnull, sized_by(count)) void *buffer,
+                                         size_t count,
+                                         CosError * COS_Nullable out_error)
+        COS_ATTR_ACCESS_WRITE_ONLY_SIZE(3, 4)
+        COS_ATTR_ACCESS_WRITE_ONLY(5);
+
     /**
      * @brief Writes data to the stream.
      *
@@ -180,6 +202,38 @@ cos_stream_read(CosStream *stream,
     COS_ATTR_ACCESS_WRITE_ONLY_SIZE(2, 3)
     COS_ATTR_ACCESS_WRITE_ONLY(4);
 
+/**
+ * @brief Returns whether the stream can read at an offset, without changing its offset.
+ *
+ * @param stream The stream.
+ *
+ * @return @c true if the stream supports positional reads, @c false otherwise.
+ */
+bool
+cos_stream_can_read_at(const CosStream *stream);
+
+/**
+ * @brief Reads data from the stream at an offset, without changing the stream's offset.
+ *
+ * Positional reads let several readers share one stream, e.g. from different threads.
+ *
+ * @param stream The stream.
+ * @param offset The offset to read from.
+ * @param buffer The output buffer to read into.
+ * @param count The maximum number of bytes to read and the size of @p buffer .
+ * @param out_error The error information.
+ *
+ * @return The number of bytes read, or @c 0 if an error occurred or @p offset is at the end.
+ */
+size_t
+cos_stream_read_at(CosStream *stream,
+                   CosStreamOffset offset,
+                   COS_PARAM_SPEC(out, nonnull, sized_by(count)) void *buffer,
+                   size_t count,
+                   CosError * COS_Nullable out_error)
+    COS_ATTR_ACCESS_WRITE_ONLY_SIZE(3, 4)
+    COS_ATTR_ACCESS_WRITE_ONLY(5);
+
 /**
  * @brief Returns whether the stream can write.
  *
@@ -10,6 +10,7 @@
 #include <libcos/common/CosTypes.h>
 
 #include <stdbool.h>
+#include <stddef.h>
 
 COS_DECLS_BEGIN
 COS_ASSUME_NONNULL_BEGIN
@@ -34,6 +35,23 @@ cos_stream_reader_create(CosStream *input_stream)
 void
 cos_stream_reader_reset(CosStreamReader *stream_reader);
 
+/**
+ * @brief Moves the stream reader to an offset in the input stream.
+ *
+ * If the offset is in the bytes that the reader has buffered, only the reader's position is
+ * moved. Otherwise, the input stream is seeked and the buffer is cleared.
+ *
+ * @param stream_reader The stream reader.
+ * @param offset The offset from the start of the input stream.
+ * @param out_error The error object to set if an error occurs.
+ *
+ * @return @c true if the reader was moved, @c false otherwise.
+ */
+bool
+cos_stream_reader_seek(CosStreamReader *stream_reader,
+                       CosStreamOffset offset,
+                       CosError * COS_Nullable out_error);
+
 /**
  * @brief Returns the current position of the stream reader.
  *
@@ -44,6 +62,33 @@ cos_stream_reader_reset(CosStreamReader *stream_reader);
 CosStreamOffset
 cos_stream_reader_get_position(CosStreamReader *stream_reader);
 
+/**
+ * @brief Returns the bytes that are buffered after the stream reader's position.
+ *
+ * The buffer is not refilled, so fewer bytes than are left in the stream may be returned.
+ * Use @c cos_stream_reader_skip_buffered to consume some of them.
+ *
+ * @param stream_reader The stream reader.
+ * @param out_count On return, the number of buffered bytes.
+ *
+ * @return The buffered bytes, or @c NULL if there are none.
+ */
+const unsigned char * COS_Nullable
+cos_stream_reader_get_buffered_bytes(CosStreamReader *stream_reader,
+                                     size_t *out_count)
+    COS_ATTR_ACCESS_WRITE_ONLY(2);
+
+/**
+ * @brief Consumes buffered bytes.
+ *
+ * @param stream_reader The stream reader.
+ * @param count The number of bytes to consume, which must not exceed the number of bytes
+ * returned by @c cos_stream_reader_get_buffered_bytes .
+ */
+void
+cos_stream_reader_skip_buffered(CosStreamReader *stream_reader,
+                                size_t count);
+
 /**
  * @brief Reads a character from the stream.
  *
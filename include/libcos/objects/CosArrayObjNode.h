@@ -8,6 +8,7 @@
 #include <libcos/common/CosArray.h>
 #include <libcos/common/CosDefines.h>
 #include <libcos/common/CosTypes.h>
+#include <libcos/objects/CosObjValue.h>
 
 #include <stdbool.h>
 #include <stddef.h>
@@ -17,6 +18,8 @@ COS_ASSUME_NONNULL_BEGIN
 
 /**
  * @brief The callbacks for arrays of objects.
+ *
+ * The items of such an array are @c CosObjValue values.
  */
 extern const CosArrayCallbacks cos_array_obj_node_callbacks;
 
@@ -32,15 +35,34 @@ cos_array_obj_node_free(CosArrayObjNode *array_obj)
 /**
  * @brief Allocates a new array object.
  *
- * @param array The array to use for the object, or @c NULL to create a new empty array.
+ * @param allocator The allocator to use, or @c NULL to use the default allocator.
+ * @param array The array to use for the object, or @c NULL to create a new empty array. The
+ *              array must hold @c CosObjValue items, with @c cos_array_obj_node_callbacks .
  *
  * @return The new array object, or @c NULL if an error occurred.
  */
 CosArrayObjNode * COS_Nullable
-cos_array_obj_node_alloc(CosArray * COS_Nullable array)
+cos_array_obj_node_alloc(CosAllocator * COS_Nullable allocator,
+                         CosArray * COS_Nullable array)
     COS_ALLOCATOR_FUNC
     COS_ALLOCATOR_FUNC_MATCHED_DEALLOC(cos_array_obj_node_free);
 
+/**
+ * @brief Packs the elements of a numeric array into contiguous storage.
+ *
+ * An array whose elements are all inline integers is stored as an array of @c int, and one
+ * whose elements are all inline real numbers as an array of @c double. Arrays of mixed types
+ * are not packed.
+ * A packed array is unpacked again when it is modified, or when an object node is requested
+ * for one of its elements.
+ *
+ * @param array_obj The array object.
+ *
+ * @return @c true if the array is packed, @c false if its elements cannot be packed.
+ */
+bool
+cos_array_obj_node_pack(CosArrayObjNode *array_obj);
+
 /**
  * @brief Get the number of objects in the array.
  *
@@ -54,6 +76,10 @@ cos_array_obj_node_get_count(const CosArrayObjNode *array_obj);
 /**
  * @brief Get the object at the specified index.
  *
+ * A scalar that is stored inline is converted to an object node on first access, which stays
+ * in the array from then on. Use @c cos_array_obj_node_get_value_at to read elements without
+ * allocating.
+ *
  * @param array_obj The array object.
  * @param index The index of the object to get.
  * @param out_error The error object to set if an error occurs.
@@ -66,6 +92,67 @@ cos_array_obj_node_get_at(const CosArrayObjNode *array_obj,
                      CosError * COS_Nullable out_error)
     COS_WARN_UNUSED_RESULT;
 
+/**
+ * @brief Get the value at the specified index.
+ *
+ * @param array_obj The array object.
+ * @param index The index of the value to get.
+ * @param out_value On success, receives the value. Its object node, if any, is borrowed from
+ *                  the array.
+ * @param out_error The error object to set if an error occurs.
+ *
+ * @return @c true if the value was found, @c false otherwise.
+ */
+bool
+cos_array_obj_node_get_value_at(const CosArrayObjNode *array_obj,
+                                size_t index,
+                                CosObjValue *out_value,
+                                CosError * COS_Nullable out_error)
+    COS_ATTR_ACCESS_WRITE_ONLY(3)
+    COS_ATTR_ACCESS_WRITE_ONLY(4);
+
+/**
+ * @brief Copies a range of numbers out of the array.
+ *
+ * @param array_obj The array object.
+ * @param index The index of the first number to copy.
+ * @param out_numbers On success, receives @p count numbers.
+ * @param count The number of numbers to copy.
+ * @param out_error The error object to set if an error occurs.
+ *
+ * @return @c true if the numbers were copied, @c false if the range is out of bounds or one
+ *         of its elements is not a number.
+ */
+bool
+cos_array_obj_node_get_numbers(const CosArrayObjNode *array_obj,
+                               size_t index,
+                               double *out_numbers,
+                               size_t count,
+                               CosError * COS_Nullable out_error)
+    COS_ATTR_ACCESS_WRITE_ONLY_SIZE(3, 4)
+    COS_ATTR_ACCESS_WRITE_ONLY(5);
+
+/**
+ * @brief Copies a range of integers out of the array.
+ *
+ * @param array_obj The array object.
+ * @param index The index of the first integer to copy.
+ * @param out_ints On success, receives @p count integers.
+ * @param count The number of integers to copy.
+ * @param out_error The error object to set if an error occurs.
+ *
+ * @return @c true if the integers were copied, @c false if the range is out of bounds or one
+ *         of its elements is not an integer.
+ */
+bool
+cos_array_obj_node_get_ints(const CosArrayObjNode *array_obj,
+                            size_t index,
+                            int *out_ints,
+                            size_t count,
+                            CosError * COS_Nullable out_error)
+    COS_ATTR_ACCESS_WRITE_ONLY_SIZE(3, 4)
+    COS_ATTR_ACCESS_WRITE_ONLY(5);
+
 /**
  * @brief Insert an object into the array at the specified index.
  *
@@ -96,6 +183,23 @@ cos_array_obj_node_append(CosArrayObjNode *array_obj,
                      CosObjNode *obj,
                      CosError * COS_Nullable error);
 
+/**
+ * @brief Append a value to the array.
+ *
+ * Scalar values are stored inline. The array takes over the reference to the object node of
+ * a node value.
+ *
+ * @param array_obj The array object.
+ * @param value The value to append.
+ * @param error The error object to set if an error occurs.
+ *
+ * @return @c true if the value was appended, @c false otherwise.
+ */
+bool
+cos_array_obj_node_append_value(CosArrayObjNode *array_obj,
+                                CosObjValue value,
+                                CosError * COS_Nullable error);
+
 /**
  * @brief Remove the object at the specified index from the array.
  *
@@ -14,7 +14,8 @@ COS_DECLS_BEGIN
 COS_ASSUME_NONNULL_BEGIN
 
 CosBoolObjNode * COS_Nullable
-cos_bool_obj_node_alloc(bool value)
+cos_bool_obj_node_alloc(CosAllocator * COS_Nullable allocator,
+                        bool value)
     COS_ATTR_MALLOC
     COS_WARN_UNUSED_RESULT;
 
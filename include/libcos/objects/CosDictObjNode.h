@@ -10,6 +10,7 @@
 #include <libcos/common/CosDefines.h>
 #include <libcos/common/CosString.h>
 #include <libcos/common/CosTypes.h>
+#include <libcos/objects/CosObjValue.h>
 
 #include <stdbool.h>
 #include <stddef.h>
@@ -29,12 +30,18 @@ cos_dict_obj_node_destroy(CosDictObjNode *dict_obj)
 /**
  * @brief Creates a dictionary object.
  *
- * @param dict The dictionary or @c NULL.
+ * Without a dictionary, the dictionary object stores its first few entries inline, and only
+ * creates a hash table once it grows past them.
+ *
+ * @param allocator The allocator to use, or @c NULL to use the default allocator.
+ * @param dict The dictionary to take ownership of, or @c NULL to create an empty dictionary
+ * object.
  *
  * @return The dictionary object, or @c NULL if an error occurred.
  */
 CosDictObjNode * COS_Nullable
-cos_dict_obj_node_create(CosDict * COS_Nullable dict)
+cos_dict_obj_node_create(CosAllocator * COS_Nullable allocator,
+                         CosDict * COS_Nullable dict)
     COS_ALLOCATOR_FUNC
     COS_ALLOCATOR_FUNC_MATCHED_DEALLOC(cos_dict_obj_node_destroy);
 
@@ -51,6 +58,10 @@ cos_dict_obj_node_get_count(const CosDictObjNode *dict_obj);
 /**
  * @brief Gets the object value for a given key in a dictionary object.
  *
+ * A scalar that is stored inline is converted to an object node on first access, which stays
+ * in the dictionary from then on. Use @c cos_dict_obj_node_lookup_with_key to read values
+ * without allocating.
+ *
  * @param dict_obj The dictionary object.
  * @param key The key.
  * @param out_value The output parameter for the object value.
@@ -69,6 +80,9 @@ cos_dict_obj_node_get_value(const CosDictObjNode *dict_obj,
 /**
  * @brief Gets the object value for a given key in a dictionary object.
  *
+ * The lookup does not allocate, except to convert a scalar that is stored inline to an
+ * object node.
+ *
  * @param dict_obj The dictionary object.
  * @param key The key, as a nul-terminated string.
  * @param out_value The output parameter for the object value.
@@ -84,12 +98,74 @@ cos_dict_obj_node_get_value_with_string(const CosDictObjNode *dict_obj,
     COS_ATTR_ACCESS_WRITE_ONLY(3)
     COS_ATTR_ACCESS_WRITE_ONLY(4);
 
+/**
+ * @brief Gets the object value for a given name key in a dictionary object.
+ *
+ * The lookup uses the precomputed hash of the key, and does not allocate, except to convert
+ * a scalar that is stored inline to an object node.
+ *
+ * @param dict_obj The dictionary object.
+ * @param key The name key.
+ * @param out_value The output parameter for the object value.
+ * @param out_error The error information.
+ *
+ * @return @c true if the object value was found, otherwise @c false.
+ *
+ * @see @c cos_name_key_get_well_known()
+ */
+bool
+cos_dict_obj_node_get_value_with_key(const CosDictObjNode *dict_obj,
+                                     const CosNameKey *key,
+                                     CosObjNode * COS_Nullable * COS_Nonnull out_value,
+                                     CosError * COS_Nullable out_error)
+    COS_ATTR_ACCESS_WRITE_ONLY(3)
+    COS_ATTR_ACCESS_WRITE_ONLY(4);
+
+/**
+ * @brief Looks up the value for a given name key in a dictionary object.
+ *
+ * Unlike @c cos_dict_obj_node_get_value_with_key, scalars are returned as they are stored, so
+ * the lookup never allocates.
+ *
+ * @param dict_obj The dictionary object.
+ * @param key The name key.
+ * @param out_value On success, receives the value. Its object node, if any, is borrowed from
+ *                  the dictionary object.
+ *
+ * @return @c true if the value was found, otherwise @c false.
+ */
+bool
+cos_dict_obj_node_lookup_with_key(const CosDictObjNode *dict_obj,
+                                  const CosNameKey *key,
+                                  CosObjValue *out_value)
+    COS_ATTR_ACCESS_WRITE_ONLY(3);
+
 bool
 cos_dict_obj_node_set(CosDictObjNode *dict_obj,
                  CosNameObjNode *key,
                  CosObjNode *value,
                  CosError * COS_Nullable error);
 
+/**
+ * @brief Sets the value for a given key in a dictionary object.
+ *
+ * Scalar values are stored inline while the dictionary object holds its entries inline. The
+ * dictionary object takes over the references to the key and to the object node of a node
+ * value.
+ *
+ * @param dict_obj The dictionary object.
+ * @param key The key.
+ * @param value The value.
+ * @param error The error information.
+ *
+ * @return @c true if the value was set, otherwise @c false.
+ */
+bool
+cos_dict_obj_node_set_value(CosDictObjNode *dict_obj,
+                            CosNameObjNode *key,
+                            CosObjValue value,
+                            CosError * COS_Nullable error);
+
 extern const CosDictKeyCallbacks cos_dict_obj_node_key_callbacks;
 extern const CosDictValueCallbacks cos_dict_obj_node_value_callbacks;
 
@@ -104,10 +180,23 @@ extern const CosDictValueCallbacks cos_dict_obj_node_value_callbacks;
  */
 typedef struct CosDictObjNodeIterator {
     /**
-     * The underlying dictionary iterator.
+     * The underlying dictionary iterator, used once the dictionary has outgrown its inline
+     * entries.
      * @private
      */
     CosDictIterator base;
+
+    /**
+     * The dictionary object being iterated.
+     * @private
+     */
+    const CosDictObjNode * COS_Nullable dict_obj;
+
+    /**
+     * The index of the next inline entry.
+     * @private
+     */
+    size_t index;
 } CosDictObjNodeIterator;
 
 /**
@@ -123,6 +212,9 @@ cos_dict_obj_node_iterator_init(CosDictObjNode *dict_obj);
 /**
  * Advances the iterator to the next key-value pair.
  *
+ * A scalar that is stored inline is converted to an object node, as with
+ * @c cos_dict_obj_node_get_value.
+ *
  * @param iterator The iterator.
  * @param[out] out_key On success, receives the key (a name object).
  * @param[out] out_value On success, receives the value.
@@ -137,6 +229,25 @@ cos_dict_obj_node_iterator_next(CosDictObjNodeIterator *iterator,
     COS_ATTR_ACCESS_WRITE_ONLY(2)
     COS_ATTR_ACCESS_WRITE_ONLY(3);
 
+/**
+ * Advances the iterator to the next key-value pair, without converting scalars that are
+ * stored inline to object nodes.
+ *
+ * @param iterator The iterator.
+ * @param[out] out_key On success, receives the key (a name object).
+ * @param[out] out_value On success, receives the value. Its object node, if any, is borrowed
+ *                       from the dictionary object.
+ *
+ * @return @c true if another entry was found, @c false when iteration is
+ * complete.
+ */
+bool
+cos_dict_obj_node_iterator_next_value(CosDictObjNodeIterator *iterator,
+                                      CosNameObjNode * COS_Nullable * COS_Nonnull out_key,
+                                      CosObjValue *out_value)
+    COS_ATTR_ACCESS_WRITE_ONLY(2)
+    COS_ATTR_ACCESS_WRITE_ONLY(3);
+
 COS_ASSUME_NONNULL_END
 COS_DECLS_END
 
@@ -15,7 +15,8 @@ COS_DECLS_BEGIN
 COS_ASSUME_NONNULL_BEGIN
 
 CosIndirectObjNode * COS_Nullable
-cos_indirect_obj_node_alloc(CosObjID id,
+cos_indirect_obj_node_alloc(CosAllocator * COS_Nullable allocator,
+                            CosObjID id,
                        CosObjNode *value)
     COS_ATTR_MALLOC
     COS_WARN_UNUSED_RESULT;
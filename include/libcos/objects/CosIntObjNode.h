@@ -12,7 +12,8 @@ COS_DECLS_BEGIN
 COS_ASSUME_NONNULL_BEGIN
 
 CosIntObjNode * COS_Nullable
-cos_int_obj_node_alloc(int value)
+cos_int_obj_node_alloc(CosAllocator * COS_Nullable allocator,
+                       int value)
     COS_ATTR_MALLOC
     COS_WARN_UNUSED_RESULT;
 
@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2025 OpenCOS.
+ */
+
+#ifndef LIBCOS_OBJECTS_COS_NAME_KEY_H
+#define LIBCOS_OBJECTS_COS_NAME_KEY_H
+
+#include <libcos/common/CosDefines.h>
+#include <libcos/common/CosString.h>
+#include <libcos/common/CosTypes.h>
+
+#include <stddef.h>
+
+COS_DECLS_BEGIN
+COS_ASSUME_NONNULL_BEGIN
+
+/**
+ * A name with a precomputed hash, used to look up dictionary entries without allocating a
+ * name object.
+ *
+ * A key refers to the characters of the name, which must remain valid as long as the key is
+ * in use.
+ */
+struct CosNameKey {
+    /**
+     * The characters of the name, without the leading solidus.
+     */
+    CosStringRef name;
+
+    /**
+     * The hash of the name.
+     */
+    size_t hash;
+};
+
+/**
+ * Well-known dictionary keys.
+ */
+typedef enum CosWellKnownName {
+    CosWellKnownName_Type,
+    CosWellKnownName_Subtype,
+    CosWellKnownName_Length,
+    CosWellKnownName_Filter,
+    CosWellKnownName_DecodeParms,
+    CosWellKnownName_DL,
+    CosWellKnownName_Root,
+    CosWellKnownName_Size,
+    CosWellKnownName_Prev,
+    CosWellKnownName_Info,
+    CosWellKnownName_ID,
+    CosWellKnownName_Encrypt,
+    CosWellKnownName_XRefStm,
+    CosWellKnownName_Index,
+    CosWellKnownName_W,
+    CosWellKnownName_N,
+    CosWellKnownName_First,
+    CosWellKnownName_Extends,
+    CosWellKnownName_Pages,
+    CosWellKnownName_Kids,
+    CosWellKnownName_Parent,
+    CosWellKnownName_Count,
+    CosWellKnownName_Resources,
+    CosWellKnownName_Contents,
+    CosWellKnownName_MediaBox,
+    CosWellKnownName_CropBox,
+    CosWellKnownName_Rotate,
+    CosWellKnownName_Annots,
+    CosWellKnownName_Font,
+    CosWellKnownName_XObject,
+    CosWellKnownName_BaseFont,
+    CosWellKnownName_Encoding,
+    CosWellKnownName_Width,
+    CosWellKnownName_Height,
+    CosWellKnownName_ColorSpace,
+    CosWellKnownName_BitsPerComponent,
+    CosWellKnownName_Names,
+    CosWellKnownName_Outlines,
+} CosWellKnownName;
+
+/**
+ * The number of well-known dictionary keys.
+ */
+#define COS_WELL_KNOWN_NAME_COUNT (CosWellKnownName_Outlines + 1)
+
+/**
+ * @brief Creates a name key from a C-string.
+ *
+ * @param name The nul-terminated name, without the leading solidus.
+ *
+ * @return The name key.
+ */
+CosNameKey
+cos_name_key(const char *name)
+    COS_ATTR_ACCESS_READ_ONLY(1);
+
+/**
+ * @brief Creates a name key from a string reference.
+ *
+ * @param name The name, without the leading solidus.
+ *
+ * @return The name key.
+ */
+CosNameKey
+cos_name_key_make(CosStringRef name);
+
+/**
+ * @brief Returns the key for a well-known name.
+ *
+ * The returned key is valid for the lifetime of the program.
+ *
+ * @param name The well-known name.
+ *
+ * @return The name key.
+ */
+const CosNameKey *
+cos_name_key_get_well_known(CosWellKnownName name);
+
+COS_ASSUME_NONNULL_END
+COS_DECLS_END
+
+#endif /* LIBCOS_OBJECTS_COS_NAME_KEY_H */
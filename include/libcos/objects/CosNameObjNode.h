@@ -24,7 +24,8 @@ cos_name_obj_node_free(CosNameObjNode *name_obj)
     COS_DEALLOCATOR_FUNC;
 
 CosNameObjNode * COS_Nullable
-cos_name_obj_node_alloc(CosString *value)
+cos_name_obj_node_alloc(CosAllocator * COS_Nullable allocator,
+                        CosString *value)
     COS_ALLOCATOR_FUNC
     COS_ALLOCATOR_FUNC_MATCHED_DEALLOC(cos_name_obj_node_free)
     COS_OWNERSHIP_HOLDS(1);
@@ -32,6 +33,14 @@ cos_name_obj_node_alloc(CosString *value)
 const CosString * COS_Nullable
 cos_name_obj_node_get_value(const CosNameObjNode *name_obj);
 
+/**
+ * @brief Sets the value of the name object.
+ *
+ * Name objects that were interned by a document are shared and cannot be modified.
+ *
+ * @param name_obj The name object.
+ * @param value The new value. Ownership is transferred to the name object.
+ */
 void
 cos_name_obj_node_set_value(CosNameObjNode *name_obj,
                        CosString *value);
@@ -39,6 +48,8 @@ cos_name_obj_node_set_value(CosNameObjNode *name_obj,
 /**
  * @brief Returns the hash value of the name object.
  *
+ * The hash value is computed once, when the value of the name object is set.
+ *
  * @param name_obj The name object.
  *
  * @return The hash value of the name object.
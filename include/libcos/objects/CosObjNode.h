@@ -35,6 +35,10 @@ typedef enum CosObjNodeType {
 /**
  * @brief Retains an object, incrementing its reference count.
  *
+ * Reference counts are updated atomically if the library is built with
+ * @c COS_ENABLE_ATOMIC_REF_COUNTS (the default), so an object can be retained and released
+ * from multiple threads.
+ *
  * @param obj The object to retain.
  *
  * @return The retained object (same pointer as @p obj).
@@ -52,6 +56,67 @@ cos_obj_node_retain(CosObjNode * COS_Nullable obj);
 void
 cos_obj_node_release(CosObjNode * COS_Nullable obj);
 
+/**
+ * @brief Makes an object immortal.
+ *
+ * Retaining and releasing an immortal object has no effect, so it is never deallocated and
+ * can be shared between threads without any reference count traffic. This is intended for
+ * objects that are cached for the lifetime of the process.
+ *
+ * This must be done before the object is shared with other threads, and cannot be undone.
+ *
+ * @param obj The object.
+ */
+void
+cos_obj_node_make_immortal(CosObjNode *obj);
+
+/**
+ * @brief Determines whether an object is immortal.
+ *
+ * @param obj The object.
+ *
+ * @return @c true if the object is immortal, @c false otherwise.
+ */
+bool
+cos_obj_node_is_immortal(const CosObjNode *obj);
+
+/**
+ * @brief Freezes an object and the objects below it, so that they can be read from multiple
+ * threads without locking.
+ *
+ * A frozen object cannot be modified: its setters fail. The state that objects would otherwise
+ * create when they are read (e.g. object nodes for inline scalars, and the values of
+ * references) is created up front, or published atomically.
+ *
+ * The root keeps counting references for the whole subgraph. An object below it that is only
+ * referenced by its parent stops counting references, and is deallocated with the parent, so
+ * a reference to it is borrowed from the root. Objects that are shared with others outside the
+ * subgraph (e.g. interned names) are frozen but keep counting references.
+ *
+ * References are not followed, so the objects that they refer to are not frozen.
+ *
+ * This must be done before the object is shared with other threads, and cannot be undone.
+ * Sharing the root between threads also requires atomic reference counts.
+ *
+ * @param obj The root object.
+ * @param out_error The error object to set if an error occurs.
+ *
+ * @return @c true if the object is frozen, @c false if an error occurred.
+ */
+bool
+cos_obj_node_freeze(CosObjNode *obj,
+                    CosError * COS_Nullable out_error);
+
+/**
+ * @brief Determines whether an object is frozen.
+ *
+ * @param obj The object.
+ *
+ * @return @c true if the object is frozen, @c false otherwise.
+ */
+bool
+cos_obj_node_is_frozen(const CosObjNode *obj);
+
 /** @name Object type **/
 /** @{ **/
 
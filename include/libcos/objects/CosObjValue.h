@@ -0,0 +1,209 @@
+/*
+ * Copyright (c) 2025 OpenCOS.
+ */
+
+#ifndef LIBCOS_OBJECTS_COS_OBJ_VALUE_H
+#define LIBCOS_OBJECTS_COS_OBJ_VALUE_H
+
+#include <libcos/common/CosDefines.h>
+#include <libcos/common/CosTypes.h>
+#include <libcos/objects/CosObjNodeTypes.h>
+
+#include <stdbool.h>
+
+COS_DECLS_BEGIN
+COS_ASSUME_NONNULL_BEGIN
+
+/**
+ * The storage kind of an object value.
+ */
+typedef enum CosObjValueKind {
+    /**
+     * The value is an object node.
+     */
+    CosObjValueKind_Node = 0,
+
+    CosObjValueKind_Boolean,
+    CosObjValueKind_Integer,
+    CosObjValueKind_Real,
+} CosObjValueKind;
+
+/**
+ * An element of an array object or a value of a dictionary object.
+ *
+ * Booleans, integers and real numbers are stored inline, without allocating an object node.
+ * All other objects are stored as a (retained) object node.
+ *
+ * A value is 16 bytes on 64-bit platforms, compared to a pointer plus a heap-allocated node
+ * for a boxed scalar.
+ */
+struct CosObjValue {
+    CosObjValueKind kind;
+
+    union {
+        bool boolean;
+        int integer;
+        double real;
+        CosObjNode * COS_Nullable node;
+    } as;
+};
+
+// MARK: - Constructors
+
+/**
+ * @brief Makes a value that holds an object node.
+ *
+ * The value takes over the caller's reference to the node.
+ *
+ * @param node The object node.
+ *
+ * @return The value.
+ */
+CosObjValue
+cos_obj_value_make_node(CosObjNode *node);
+
+CosObjValue
+cos_obj_value_make_bool(bool value);
+
+CosObjValue
+cos_obj_value_make_int(int value);
+
+CosObjValue
+cos_obj_value_make_real(double value);
+
+// MARK: - Memory management
+
+/**
+ * @brief Retains the object node of a value, if any.
+ *
+ * @param value The value.
+ */
+void
+cos_obj_value_retain(CosObjValue value);
+
+/**
+ * @brief Releases the object node of a value, if any.
+ *
+ * @param value The value.
+ */
+void
+cos_obj_value_release(CosObjValue value);
+
+/**
+ * @brief Converts a value to an object node.
+ *
+ * A scalar value is allocated as a new object node, and the object node of a node value is
+ * returned as-is. In both cases, the caller receives the value's reference.
+ *
+ * @param allocator The allocator to use for a new object node, or @c NULL to use the default
+ *                  allocator.
+ * @param value The value.
+ *
+ * @return The object node, or @c NULL if allocation failed.
+ */
+CosObjNode * COS_Nullable
+cos_obj_value_box(CosAllocator * COS_Nullable allocator,
+                  CosObjValue value)
+    COS_WARN_UNUSED_RESULT;
+
+// MARK: - Accessors
+
+/**
+ * @brief Resolves a value through indirect objects and references.
+ *
+ * @param value The value.
+ *
+ * @return The direct value. Its object node, if any, is borrowed from @p value, and the node
+ *         is @c NULL if a reference could not be resolved.
+ */
+CosObjValue
+cos_obj_value_resolve(CosObjValue value);
+
+/**
+ * @brief Gets the value type of a value.
+ *
+ * For a value that holds an indirect object or reference, this is the value type of the
+ * resolved object.
+ *
+ * @param value The value.
+ *
+ * @return The value type.
+ */
+CosObjNodeValueType
+cos_obj_value_get_type(CosObjValue value);
+
+/**
+ * @brief Gets the object node of a value.
+ *
+ * @param value The value.
+ *
+ * @return The object node (borrowed), or @c NULL if the value is a scalar stored inline.
+ */
+CosObjNode * COS_Nullable
+cos_obj_value_get_node(CosObjValue value);
+
+/**
+ * @brief Gets the boolean of a value.
+ *
+ * This works for inline booleans as well as for boolean object nodes, resolving indirect
+ * objects and references.
+ *
+ * @param value The value.
+ * @param[out] out_bool On success, receives the boolean.
+ *
+ * @return @c true if the value is a boolean, @c false otherwise.
+ */
+bool
+cos_obj_value_get_bool(CosObjValue value,
+                       bool *out_bool)
+    COS_ATTR_ACCESS_WRITE_ONLY(2);
+
+/**
+ * @brief Gets the integer of a value.
+ *
+ * This works for inline integers as well as for integer object nodes, resolving indirect
+ * objects and references.
+ *
+ * @param value The value.
+ * @param[out] out_int On success, receives the integer.
+ *
+ * @return @c true if the value is an integer, @c false otherwise.
+ */
+bool
+cos_obj_value_get_int(CosObjValue value,
+                      int *out_int)
+    COS_ATTR_ACCESS_WRITE_ONLY(2);
+
+/**
+ * @brief Gets the real number of a value.
+ *
+ * This works for inline real numbers as well as for real number object nodes, resolving
+ * indirect objects and references.
+ *
+ * @param value The value.
+ * @param[out] out_real On success, receives the real number.
+ *
+ * @return @c true if the value is a real number, @c false otherwise.
+ */
+bool
+cos_obj_value_get_real(CosObjValue value,
+                       double *out_real)
+    COS_ATTR_ACCESS_WRITE_ONLY(2);
+
+/**
+ * @brief Gets the number of a value, which may be an integer or a real number.
+ *
+ * @param value The value.
+ * @param[out] out_number On success, receives the number.
+ *
+ * @return @c true if the value is an integer or a real number, @c false otherwise.
+ */
+bool
+cos_obj_value_get_number(CosObjValue value,
+                         double *out_number)
+    COS_ATTR_ACCESS_WRITE_ONLY(2);
+
+COS_ASSUME_NONNULL_END
+COS_DECLS_END
+
+#endif /* LIBCOS_OBJECTS_COS_OBJ_VALUE_H */
@@ -12,7 +12,8 @@ COS_DECLS_BEGIN
 COS_ASSUME_NONNULL_BEGIN
 
 CosRealObjNode * COS_Nullable
-cos_real_obj_node_alloc(double value)
+cos_real_obj_node_alloc(CosAllocator * COS_Nullable allocator,
+                        double value)
     COS_ATTR_MALLOC
     COS_WARN_UNUSED_RESULT;
 
@@ -13,7 +13,8 @@ COS_DECLS_BEGIN
 COS_ASSUME_NONNULL_BEGIN
 
 CosReferenceObjNode * COS_Nullable
-cos_reference_obj_node_alloc(CosObjID id,
+cos_reference_obj_node_alloc(CosAllocator * COS_Nullable allocator,
+                             CosObjID id,
                         CosDoc *document)
     COS_ATTR_MALLOC
     COS_WARN_UNUSED_RESULT;
@@ -19,7 +19,8 @@ cos_stream_obj_node_destroy(CosStreamObjNode *stream_obj)
     COS_DEALLOCATOR_FUNC;
 
 CosStreamObjNode * COS_Nullable
-cos_stream_obj_node_create(CosDictObjNode *dict,
+cos_stream_obj_node_create(CosAllocator * COS_Nullable allocator,
+                           CosDictObjNode *dict,
                       CosData * COS_Nullable data)
     COS_ALLOCATOR_FUNC
     COS_ALLOCATOR_FUNC_MATCHED_DEALLOC(cos_stream_obj_node_destroy)
@@ -36,7 +37,8 @@ cos_stream_obj_node_get_data(const CosStreamObjNode *stream_obj);
  *
  * @param stream_obj The stream object.
  *
- * @return The length in bytes of the encoded stream data.
+ * @return The length in bytes of the encoded stream data, or @c 0 if the data has not been
+ * loaded.
  */
 size_t
 cos_stream_obj_node_get_length(const CosStreamObjNode *stream_obj);
@@ -19,7 +19,8 @@ cos_string_obj_node_free(CosStringObjNode *string_obj)
     COS_DEALLOCATOR_FUNC;
 
 CosStringObjNode * COS_Nullable
-cos_string_obj_node_alloc(CosData *data)
+cos_string_obj_node_alloc(CosAllocator * COS_Nullable allocator,
+                          CosData *data)
     COS_ALLOCATOR_FUNC
     COS_ALLOCATOR_FUNC_MATCHED_DEALLOC(cos_string_obj_node_free)
     COS_OWNERSHIP_HOLDS(1);
@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2025 OpenCOS.
+ */
+
+#ifndef LIBCOS_PARSE_COS_OBJ_EVENT_H
+#define LIBCOS_PARSE_COS_OBJ_EVENT_H
+
+#include <libcos/CosObj.h>
+#include <libcos/CosObjID.h>
+#include <libcos/common/CosBasicTypes.h>
+#include <libcos/common/CosDataRef.h>
+#include <libcos/common/CosDefines.h>
+#include <libcos/common/CosString.h>
+
+#include <stdbool.h>
+
+COS_DECLS_BEGIN
+COS_ASSUME_NONNULL_BEGIN
+
+/**
+ * @brief The kinds of events that are reported while an object is scanned.
+ */
+typedef enum CosObjEventType {
+    CosObjEventType_ArrayStart,
+    CosObjEventType_ArrayEnd,
+    CosObjEventType_DictStart,
+    CosObjEventType_DictEnd,
+
+    /**
+     * A dictionary key. The next event is the key's value.
+     */
+    CosObjEventType_Key,
+
+    /**
+     * A boolean, number, string, name or null value.
+     */
+    CosObjEventType_Scalar,
+
+    /**
+     * An indirect object reference. The referenced object is not loaded.
+     */
+    CosObjEventType_Reference,
+
+    /**
+     * The data of a stream object, whose dictionary was reported just before. The data is
+     * skipped, not read.
+     */
+    CosObjEventType_StreamStart,
+} CosObjEventType;
+
+/**
+ * @brief An event that is reported while an object is scanned.
+ *
+ * Names and strings are borrowed from the parser, and are only valid during the callback.
+ */
+typedef struct CosObjEvent {
+    CosObjEventType type;
+
+    /**
+     * The offset of the event's first token in the input stream.
+     */
+    CosStreamOffset offset;
+
+    /**
+     * The type of a scalar: @c CosObjType_Boolean , @c CosObjType_Integer , @c CosObjType_Real ,
+     * @c CosObjType_String , @c CosObjType_Name or @c CosObjType_Null .
+     */
+    CosObjType scalar_type;
+
+    union {
+        bool boolean;
+        int integer;
+        double real;
+
+        /**
+         * A key, or a name scalar, without the leading solidus.
+         */
+        CosStringRef name;
+
+        /**
+         * A string scalar, with escape sequences and hex digits decoded.
+         */
+        CosDataRef string;
+
+        /**
+         * The object that a reference points to.
+         */
+        CosObjID obj_id;
+
+        struct {
+            /**
+             * The offset of the first byte of the stream data.
+             */
+            CosStreamOffset data_offset;
+
+            /**
+             * The length of the stream data, or @c -1 if the Length entry is not a direct
+             * integer.
+             */
+            CosStreamOffset length;
+        } stream;
+    } as;
+} CosObjEvent;
+
+/**
+ * @brief Handles an event.
+ *
+ * @param event The event.
+ * @param user_data The handler's user data.
+ *
+ * @return @c true to carry on scanning, or @c false to stop.
+ */
+typedef bool (*CosObjEventFunc)(const CosObjEvent *event,
+                                void * COS_Nullable user_data);
+
+/**
+ * @brief Receives the events of a scan.
+ */
+typedef struct CosObjEventHandler {
+    /**
+     * Called for each event, in document order.
+     */
+    CosObjEventFunc handle_event;
+
+    /**
+     * The user data that is passed to @a handle_event .
+     */
+    void * COS_Nullable user_data;
+} CosObjEventHandler;
+
+COS_ASSUME_NONNULL_END
+COS_DECLS_END
+
+#endif /* LIBCOS_PARSE_COS_OBJ_EVENT_H */
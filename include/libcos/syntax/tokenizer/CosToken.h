@@ -5,6 +5,7 @@
 #ifndef LIBCOS_COS_TOKEN_H
 #define LIBCOS_COS_TOKEN_H
 
+#include <libcos/CosObjID.h>
 #include <libcos/common/CosDefines.h>
 #include <libcos/common/CosTypes.h>
 
@@ -52,6 +53,21 @@ typedef enum CosToken_Type {
     CosToken_Type_Null,
     CosToken_Type_R,
     CosToken_Type_Obj,
+
+    /**
+     * An indirect object reference, such as "12 0 R", read as a single token.
+     *
+     * Only produced when the tokenizer combines indirect object tokens.
+     */
+    CosToken_Type_IndirectRef,
+
+    /**
+     * An indirect object header, such as "12 0 obj", read as a single token.
+     *
+     * Only produced when the tokenizer combines indirect object tokens.
+     */
+    CosToken_Type_IndirectDef,
+
     CosToken_Type_EndObj,
     CosToken_Type_Stream,
     CosToken_Type_EndStream,
@@ -76,6 +92,7 @@ struct CosTokenValue {
         CosTokenValue_Type_RealNumber,
         CosTokenValue_Type_String,
         CosTokenValue_Type_Data,
+        CosTokenValue_Type_ObjID,
     } type;
 
     union {
@@ -84,6 +101,7 @@ struct CosTokenValue {
         double real_number;
         CosString *string;
         CosData *data;
+        CosObjID obj_id;
     } value;
 };
 
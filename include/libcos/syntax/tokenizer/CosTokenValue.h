@@ -85,6 +85,18 @@ bool
 cos_token_value_get_real_number(const CosTokenValue *token_value,
                                 double *result);
 
+/**
+ * @brief Gets the object ID value of a token value.
+ *
+ * @param token_value The token value.
+ * @param result A pointer to the variable in which to store the object ID.
+ *
+ * @return @c true if the token value is an object ID, @c false otherwise.
+ */
+bool
+cos_token_value_get_obj_id(const CosTokenValue *token_value,
+                           CosObjID *result);
+
 // MARK: - Setters
 
 /**
@@ -137,6 +149,16 @@ void
 cos_token_value_set_real_number(CosTokenValue *token_value,
                                 double value);
 
+/**
+ * @brief Sets the object ID value of a token value.
+ *
+ * @param token_value The token value.
+ * @param value The object ID value.
+ */
+void
+cos_token_value_set_obj_id(CosTokenValue *token_value,
+                           CosObjID value);
+
 // MARK: - Ownership transfer
 
 /**
@@ -5,10 +5,14 @@
 #ifndef LIBCOS_SYNTAX_TOKENIZER_COS_TOKENIZER_H
 #define LIBCOS_SYNTAX_TOKENIZER_COS_TOKENIZER_H
 
+#include <libcos/common/CosBasicTypes.h>
 #include <libcos/common/CosDefines.h>
 #include <libcos/common/CosTypes.h>
 #include <libcos/syntax/tokenizer/CosToken.h>
 
+#include <stdbool.h>
+#include <stddef.h>
+
 COS_DECLS_BEGIN
 COS_ASSUME_NONNULL_BEGIN
 
@@ -24,15 +28,18 @@ cos_tokenizer_destroy(CosTokenizer *tokenizer)
 /**
  * @brief Creates a new tokenizer.
  *
+ * @param allocator The allocator to use for the tokenizer and the values of its tokens, or
+ * @c NULL to use the default allocator.
  * @param input_stream The input stream to tokenize.
  *
  * @return The new tokenizer, or @c NULL if an error occurred.
  */
 CosTokenizer * COS_Nullable
-cos_tokenizer_create(CosStream *input_stream)
+cos_tokenizer_create(CosAllocator * COS_Nullable allocator,
+                     CosStream *input_stream)
     COS_ALLOCATOR_FUNC
     COS_ALLOCATOR_FUNC_MATCHED_DEALLOC(cos_tokenizer_destroy)
-    COS_OWNERSHIP_HOLDS(1);
+    COS_OWNERSHIP_HOLDS(2);
 
 /**
  * @brief Resets the tokenizer to an initial state.
@@ -42,6 +49,86 @@ cos_tokenizer_create(CosStream *input_stream)
 void
 cos_tokenizer_reset(CosTokenizer *tokenizer);
 
+/**
+ * @brief Sets whether the tokenizer reads indirect object references and headers as single
+ * tokens.
+ *
+ * When enabled, "12 0 R" is read as a @c CosToken_Type_IndirectRef token and "12 0 obj" as a
+ * @c CosToken_Type_IndirectDef token, with the object ID as the token's value. Only the common
+ * spelling, with single spaces between the parts, is combined. Anything else is still read as
+ * separate tokens.
+ *
+ * This is disabled by default.
+ *
+ * @param tokenizer The tokenizer.
+ * @param enabled Whether to combine indirect object tokens.
+ */
+void
+cos_tokenizer_set_combines_indirect_tokens(CosTokenizer *tokenizer,
+                                           bool enabled);
+
+/**
+ * @brief Moves the tokenizer to an offset in its input stream.
+ *
+ * This is cheaper than seeking the input stream and resetting the tokenizer when the offset is
+ * close to the tokenizer's current position, since buffered bytes are reused.
+ *
+ * @param tokenizer The tokenizer.
+ * @param offset The offset from the start of the input stream.
+ * @param out_error The error object to set if an error occurs.
+ *
+ * @return @c true if the tokenizer was moved, @c false otherwise.
+ */
+bool
+cos_tokenizer_seek(CosTokenizer *tokenizer,
+                   CosStreamOffset offset,
+                   CosError * COS_Nullable out_error);
+
+/**
+ * @brief Skips an end-of-line marker (LF, CR, or CR LF) at the tokenizer's position.
+ *
+ * @param tokenizer The tokenizer.
+ *
+ * @return The number of bytes that were skipped.
+ */
+size_t
+cos_tokenizer_skip_eol(CosTokenizer *tokenizer);
+
+/**
+ * @brief Reads raw bytes from the tokenizer's position, such as the data of a stream object.
+ *
+ * Buffered bytes are returned first, so this does not seek the input stream.
+ *
+ * @param tokenizer The tokenizer.
+ * @param buffer The buffer to read into.
+ * @param count The maximum number of bytes to read.
+ *
+ * @return The number of bytes read, which is less than @p count only at the end of the input.
+ */
+size_t
+cos_tokenizer_read_raw(CosTokenizer *tokenizer,
+                       void *buffer,
+                       size_t count)
+    COS_ATTR_ACCESS_WRITE_ONLY_SIZE(2, 3);
+
+/**
+ * @brief Skips the value of a dictionary entry, up to the next key or the end of the
+ * dictionary.
+ *
+ * The value is skipped byte by byte, without producing tokens or allocating memory. Nested
+ * arrays and dictionaries are skipped as a whole, and literal strings, hex strings and comments
+ * are read so that the brackets inside them are not counted. A value that starts with a number
+ * or keyword runs on to the next delimiter, which covers indirect references such as "12 0 R".
+ *
+ * @param tokenizer The tokenizer, positioned after the entry's key.
+ * @param out_error The error object to set if an error occurs.
+ *
+ * @return @c true if a value was skipped, @c false if the input ended or the value is missing.
+ */
+bool
+cos_tokenizer_skip_dict_value(CosTokenizer *tokenizer,
+                              CosError * COS_Nullable out_error);
+
 /**
  * @brief Gets the next token from the tokenizer.
  *
@@ -57,6 +57,24 @@ cos_xref_table_parser_parse_section(CosXrefTableParser *parser,
     COS_OWNERSHIP_RETURNS
     COS_ATTR_ACCESS_WRITE_ONLY(2);
 
+/**
+ * @brief Parses the subsections of a cross-reference section whose @c xref keyword has already
+ * been read.
+ *
+ * This is the same as @c cos_xref_table_parser_parse_section, for callers that read the keyword
+ * themselves.
+ *
+ * @param parser    The parser.
+ * @param out_error On input, a pointer to an error object, or @c NULL.
+ *
+ * @return The parsed section (caller takes ownership), or @c NULL on error.
+ */
+CosXrefSection * COS_Nullable
+cos_xref_table_parser_parse_section_body(CosXrefTableParser *parser,
+                                         CosError * COS_Nullable out_error)
+    COS_OWNERSHIP_RETURNS
+    COS_ATTR_ACCESS_WRITE_ONLY(2);
+
 COS_ASSUME_NONNULL_END
 COS_DECLS_END
 
@@ -47,6 +47,16 @@ cos_xref_table_add_section(CosXrefTable *table,
                            CosXrefSection *section,
                            CosError * COS_Nullable out_error);
 
+/**
+ * @brief Gets the number of object numbers that a cross-reference table covers.
+ *
+ * @param table The cross-reference table.
+ *
+ * @return One more than the highest object number in the table, or @c 0 if it is empty.
+ */
+size_t
+cos_xref_table_get_obj_count(const CosXrefTable *table);
+
 const CosXrefEntry * COS_Nullable
 cos_xref_table_find_entry_for_obj_num(const CosXrefTable *table,
                                       CosObjNumber object_number,
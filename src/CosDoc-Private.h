@@ -35,6 +35,21 @@ void
 cos_doc_set_root_(CosDoc *doc,
                   CosObjNode * COS_Nullable root);
 
+/**
+ * @brief Interns a name in the document's name table.
+ *
+ * Equal names parsed from the same document share a single, immutable name object.
+ *
+ * @param doc The document.
+ * @param name The name string. Ownership is transferred to the document.
+ *
+ * @return A new reference to the interned name object, or @c NULL on allocation failure.
+ */
+CosNameObjNode * COS_Nullable
+cos_doc_intern_name_(CosDoc *doc,
+                     CosString *name)
+    COS_OWNERSHIP_RETURNS;
+
 COS_ASSUME_NONNULL_END
 COS_DECLS_END
 
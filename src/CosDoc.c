@@ -4,24 +4,60 @@
 
 #include "libcos/CosDoc.h"
 
+#include "config.h"
+
 #include "CosDoc-Private.h"
 #include "common/Assert.h"
+#include "common/CosTaskPool.h"
+#include "common/CosThread.h"
+#include "io/CosReadAheadStream.h"
+#include "io/CosStreamView.h"
+#include "objects/CosNameTable.h"
 #include "objects/CosObjCache.h"
+#include "parse/CosParser-Private.h"
 
 #include <libcos/CosObjID.h>
 #include <libcos/CosParser.h>
 #include <libcos/common/CosError.h>
+#include <libcos/common/CosString.h>
 #include <libcos/common/memory/CosAllocator.h>
 #include <libcos/common/memory/CosMemory.h>
+#include <libcos/io/CosStream.h>
 #include <libcos/objects/CosDictObjNode.h>
+#include <libcos/objects/CosIntObjNode.h>
+#include <libcos/objects/CosNameKey.h>
 #include <libcos/objects/CosObjNode.h>
+#include <libcos/objects/CosObjValue.h>
 #include <libcos/xref/table/CosXrefEntry.h>
 #include <libcos/xref/table/CosXrefTable.h>
 
+#include <stdlib.h>
 #include <string.h>
 
 COS_ASSUME_NONNULL_BEGIN
 
+/**
+ * A parser with its own tokenizer and stream offset, for loading objects concurrently.
+ */
+typedef struct CosDocParserContext CosDocParserContext;
+
+struct CosDocParserContext {
+    /**
+     * The parser, which reads from @a stream .
+     */
+    CosParser *parser;
+
+    /**
+     * A view of the document's input stream. Owned by the context.
+     */
+    CosStream *stream;
+
+    /**
+     * The next idle context.
+     */
+    CosDocParserContext * COS_Nullable next;
+};
+
 struct CosDoc {
     int version;
 
@@ -34,9 +70,90 @@ struct CosDoc {
 
     CosObjCache * COS_Nullable obj_cache;
 
+    CosNameTable * COS_Nullable name_table;
+
     CosDiagnosticHandler * COS_Nullable diagnostic_handler;
+
+    /**
+     * Whether the document can be read from multiple threads.
+     */
+    bool concurrent;
+
+    /**
+     * Whether concurrent loads use parser contexts, rather than taking turns with the parser.
+     *
+     * This requires an input stream that supports positional reads.
+     */
+    bool uses_parser_contexts;
+
+    /**
+     * The size of the input stream, for the parser contexts' stream views.
+     */
+    CosStreamOffset input_size;
+
+    /**
+     * Serializes the use of the parser, if the document is concurrent without parser contexts.
+     *
+     * The lock is recursive, as loading an object can load another (e.g. a stream's /Length).
+     */
+    CosMutex parser_mutex;
+
+    /**
+     * Protects @a idle_parser_contexts .
+     */
+    CosMutex parser_contexts_mutex;
+
+    /**
+     * The parser contexts that are not in use.
+     */
+    CosDocParserContext * COS_Nullable idle_parser_contexts;
+
+    /**
+     * Protects @a name_table , if the document is concurrent.
+     */
+    CosMutex name_table_mutex;
+
+    /**
+     * The executor for background work, if @a has_executor is set.
+     */
+    CosExecutor executor;
+    bool has_executor;
 };
 
+static CosObjCache * COS_Nullable
+cos_doc_get_obj_cache_(CosDoc *doc);
+
+static size_t
+cos_doc_get_obj_count_(const CosDoc *doc);
+
+static CosDocParserContext * COS_Nullable
+cos_doc_acquire_parser_context_(CosDoc *doc);
+
+static void
+cos_doc_release_parser_context_(CosDoc *doc,
+                                CosDocParserContext *context);
+
+static void
+cos_doc_destroy_parser_context_(CosDoc *doc,
+                                CosDocParserContext *context);
+
+static bool
+cos_doc_find_obj_offset_(CosDoc *doc,
+                         CosObjID obj_id,
+                         CosStreamOffset *out_byte_offset,
+                         CosError * COS_Nullable out_error)
+    COS_ATTR_ACCESS_WRITE_ONLY(3)
+    COS_ATTR_ACCESS_WRITE_ONLY(4);
+
+static CosObjNode * COS_Nullable
+cos_doc_load_object_(CosDoc *doc,
+                     CosObjID obj_id,
+                     CosStreamOffset byte_offset,
+                     CosObjCache * COS_Nullable obj_cache,
+                     CosDocParserContext * COS_Nullable parser_context,
+                     bool resume,
+                     CosError * COS_Nullable out_error);
+
 CosDoc *
 cos_doc_create(CosAllocator * COS_Nullable allocator)
 {
@@ -82,6 +199,25 @@ cos_doc_destroy(CosDoc *doc)
         doc->obj_cache = NULL;
     }
 
+    if (doc->name_table) {
+        cos_name_table_destroy(COS_nonnull_cast(doc->name_table));
+        doc->name_table = NULL;
+    }
+
+    if (doc->concurrent) {
+        CosDocParserContext *context = doc->idle_parser_contexts;
+        while (context) {
+            CosDocParserContext * const next = context->next;
+            cos_doc_destroy_parser_context_(doc, COS_nonnull_cast(context));
+            context = next;
+        }
+        doc->idle_parser_contexts = NULL;
+
+        cos_mutex_destroy(&doc->parser_mutex);
+        cos_mutex_destroy(&doc->parser_contexts_mutex);
+        cos_mutex_destroy(&doc->name_table_mutex);
+    }
+
     cos_free(doc->allocator, doc);
 }
 
@@ -129,29 +265,281 @@ cos_doc_get_object(CosDoc *doc,
         return NULL;
     }
 
+    // Check the cache for a previously loaded object. Only objects that were found in the
+    // xref table with a matching generation number are cached.
+    CosObjCache * const obj_cache = cos_doc_get_obj_cache_(doc);
+    if (obj_cache) {
+        CosObjNode * const cached = cos_obj_cache_get(COS_nonnull_cast(obj_cache), obj_id);
+        if (cached) {
+            return cached;
+        }
+    }
+
+    CosStreamOffset byte_offset = 0;
+    if (!cos_doc_find_obj_offset_(doc, obj_id, &byte_offset, error)) {
+        return NULL;
+    }
+
+    return cos_doc_load_object_(doc,
+                                obj_id,
+                                byte_offset,
+                                obj_cache,
+                                NULL,
+                                false,
+                                error);
+}
+
+/**
+ * An object requested from @c cos_doc_load_objects that is not cached.
+ */
+typedef struct CosDocBatchRequest {
+    /**
+     * The index of the object in the caller's arrays.
+     */
+    size_t index;
+    CosObjID obj_id;
+    CosStreamOffset byte_offset;
+} CosDocBatchRequest;
+
+static int
+cos_doc_compare_batch_requests_(const void *lhs,
+                                const void *rhs);
+
+bool
+cos_doc_load_objects(CosDoc *doc,
+                     const CosObjID *obj_ids,
+                     size_t count,
+                     CosObjNode * COS_Nullable *out_objs,
+                     CosError * COS_Nullable out_error)
+{
+    COS_API_PARAM_CHECK(doc != NULL);
+    COS_API_PARAM_CHECK(obj_ids != NULL || count == 0);
+    COS_API_PARAM_CHECK(out_objs != NULL || count == 0);
+    if (COS_UNLIKELY(!doc || (count > 0 && (!obj_ids || !out_objs)))) {
+        return false;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        out_objs[i] = NULL;
+    }
+
+    if (!doc->parser || !doc->xref_table) {
+        COS_ERROR_PROPAGATE(cos_error_make(COS_ERROR_INVALID_STATE,
+                                           "Document has not been parsed"),
+                            out_error);
+        return false;
+    }
+
+    if (count == 0) {
+        return true;
+    }
+
+    CosObjCache * const obj_cache = cos_doc_get_obj_cache_(doc);
+
+    CosDocBatchRequest * const requests = cos_calloc(doc->allocator, count, sizeof(CosDocBatchRequest));
+    if (!requests) {
+        COS_ERROR_PROPAGATE(cos_error_make(COS_ERROR_MEMORY,
+                                           "Failed to allocate the object requests"),
+                            out_error);
+        return false;
+    }
+
+    bool result = true;
+
+    // Serve what we can from the cache, and look up the offsets of the rest.
+    size_t request_count = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (obj_cache) {
+            CosObjNode * const cached = cos_obj_cache_get(COS_nonnull_cast(obj_cache), obj_ids[i]);
+            if (cached) {
+                out_objs[i] = cached;
+                continue;
+            }
+        }
+
+        CosError error = cos_error_none();
+        CosStreamOffset byte_offset = 0;
+        if (!cos_doc_find_obj_offset_(doc, obj_ids[i], &byte_offset, &error)) {
+            if (result) {
+                COS_ERROR_PROPAGATE(error, out_error);
+                result = false;
+            }
+            continue;
+        }
+
+        CosDocBatchRequest * const request = &requests[request_count++];
+        request->index = i;
+        request->obj_id = obj_ids[i];
+        request->byte_offset = byte_offset;
+    }
+
+    // Parse the objects in file order, so that each one that starts where the previous one ended
+    // is parsed without a seek.
+    qsort(requests, request_count, sizeof(CosDocBatchRequest), &cos_doc_compare_batch_requests_);
+
+    CosDocParserContext *parser_context = NULL;
+    if (doc->concurrent && doc->uses_parser_contexts) {
+        // Without a context of its own, each load takes one from the pool.
+        parser_context = cos_doc_acquire_parser_context_(doc);
+    }
+
+    const CosDocBatchRequest *previous_request = NULL;
+    for (size_t i = 0; i < request_count; i++) {
+        const CosDocBatchRequest * const request = &requests[i];
+
+        // A repeated object shares the result of its first request.
+        if (previous_request && cos_obj_id_compare(previous_request->obj_id, request->obj_id) == 0) {
+            out_objs[request->index] = cos_obj_node_retain(out_objs[previous_request->index]);
+            continue;
+        }
+        previous_request = request;
+
+        CosError error = cos_error_none();
+        CosObjNode * const obj = cos_doc_load_object_(doc,
+                                                      request->obj_id,
+                                                      request->byte_offset,
+                                                      obj_cache,
+                                                      parser_context,
+                                                      true,
+                                                      &error);
+        if (!obj && result) {
+            COS_ERROR_PROPAGATE(error, out_error);
+            result = false;
+        }
+        out_objs[request->index] = obj;
+    }
+
+    if (parser_context) {
+        cos_doc_release_parser_context_(doc, COS_nonnull_cast(parser_context));
+    }
+    cos_free(doc->allocator, requests);
+
+    return result;
+}
+
+static int
+cos_doc_compare_batch_requests_(const void *lhs,
+                                const void *rhs)
+{
+    const CosDocBatchRequest * const lhs_request = lhs;
+    const CosDocBatchRequest * const rhs_request = rhs;
+
+    if (lhs_request->byte_offset != rhs_request->byte_offset) {
+        return (lhs_request->byte_offset < rhs_request->byte_offset) ? -1 : 1;
+    }
+
+    // Keep the requests for the same object together, in the caller's order.
+    const int obj_id_comparison = cos_obj_id_compare(lhs_request->obj_id, rhs_request->obj_id);
+    if (obj_id_comparison != 0) {
+        return obj_id_comparison;
+    }
+    if (lhs_request->index != rhs_request->index) {
+        return (lhs_request->index < rhs_request->index) ? -1 : 1;
+    }
+    return 0;
+}
+
+CosObjNode *
+cos_doc_get_object_keys(CosDoc *doc,
+                        CosObjID obj_id,
+                        const char * const *keys,
+                        size_t key_count,
+                        CosError * COS_Nullable out_error)
+{
+    COS_API_PARAM_CHECK(doc != NULL);
+    COS_API_PARAM_CHECK(keys != NULL || key_count == 0);
+    if (COS_UNLIKELY(!doc || (key_count > 0 && !keys))) {
+        return NULL;
+    }
+
+    if (!doc->parser || !doc->xref_table) {
+        COS_ERROR_PROPAGATE(cos_error_make(COS_ERROR_INVALID_STATE,
+                                           "Document has not been parsed"),
+                            out_error);
+        return NULL;
+    }
+
+    CosObjCache * const obj_cache = cos_doc_get_obj_cache_(doc);
+    if (obj_cache) {
+        CosObjNode * const cached = cos_obj_cache_get(COS_nonnull_cast(obj_cache), obj_id);
+        if (cached) {
+            return cached;
+        }
+    }
+
+    CosStreamOffset byte_offset = 0;
+    if (!cos_doc_find_obj_offset_(doc, obj_id, &byte_offset, out_error)) {
+        return NULL;
+    }
+
+    CosObjNode *obj = NULL;
+    if (doc->concurrent && doc->uses_parser_contexts) {
+        CosDocParserContext * const context = cos_doc_acquire_parser_context_(doc);
+        if (!context) {
+            COS_ERROR_PROPAGATE(cos_error_make(COS_ERROR_MEMORY,
+                                               "Failed to create a parser context"),
+                                out_error);
+            return NULL;
+        }
+        obj = cos_parser_load_object_keys_(context->parser,
+                                           byte_offset,
+                                           keys,
+                                           key_count,
+                                           out_error);
+        cos_doc_release_parser_context_(doc, COS_nonnull_cast(context));
+    }
+    else {
+        if (doc->concurrent) {
+            cos_mutex_lock(&doc->parser_mutex);
+        }
+        obj = cos_parser_load_object_keys_(COS_nonnull_cast(doc->parser),
+                                           byte_offset,
+                                           keys,
+                                           key_count,
+                                           out_error);
+        if (doc->concurrent) {
+            cos_mutex_unlock(&doc->parser_mutex);
+        }
+    }
+
+    return obj;
+}
+
+/**
+ * Looks up the byte offset of an in-use object in the xref table.
+ */
+static bool
+cos_doc_find_obj_offset_(CosDoc *doc,
+                         CosObjID obj_id,
+                         CosStreamOffset *out_byte_offset,
+                         CosError * COS_Nullable out_error)
+{
+    COS_IMPL_PARAM_CHECK(doc != NULL);
+    COS_IMPL_PARAM_CHECK(out_byte_offset != NULL);
+
     const CosXrefEntry * const entry =
         cos_xref_table_find_entry_for_obj_num(COS_nonnull_cast(doc->xref_table),
                                               (CosObjNumber)obj_id.obj_number,
-                                              error);
+                                              out_error);
     if (!entry) {
-        cos_error_propagate(error,
+        cos_error_propagate(out_error,
                             cos_error_make(COS_ERROR_XREF,
                                            "Object not found in xref table"));
-        return NULL;
+        return false;
     }
 
     switch (entry->type) {
         case CosXrefEntryType_Free:
-            cos_error_propagate(error,
+            cos_error_propagate(out_error,
                                 cos_error_make(COS_ERROR_XREF,
                                                "Object is free"));
-            return NULL;
+            return false;
 
         case CosXrefEntryType_Compressed:
-            cos_error_propagate(error,
+            cos_error_propagate(out_error,
                                 cos_error_make(COS_ERROR_NOT_IMPLEMENTED,
                                                "Compressed objects are not yet supported"));
-            return NULL;
+            return false;
 
         case CosXrefEntryType_InUse:
             break;
@@ -159,40 +547,962 @@ cos_doc_get_object(CosDoc *doc,
 
     // Validate that the reference's generation number matches the xref entry.
     if (entry->value.in_use.gen_number != obj_id.gen_number) {
-        cos_error_propagate(error,
+        cos_error_propagate(out_error,
                             cos_error_make(COS_ERROR_XREF,
                                            "Generation number mismatch"));
+        return false;
+    }
+
+    *out_byte_offset = (CosStreamOffset)entry->value.in_use.byte_offset;
+    return true;
+}
+
+/**
+ * Parses an object from the file and inserts it into the cache.
+ *
+ * In a concurrent document, the object is parsed with @p parser_context if one is given, or with
+ * a parser context from the pool otherwise.
+ *
+ * With @p resume , the parser carries on from its previous load if the object starts there (see
+ * @c cos_parser_load_next_object_ ).
+ */
+static CosObjNode *
+cos_doc_load_object_(CosDoc *doc,
+                     CosObjID obj_id,
+                     CosStreamOffset byte_offset,
+                     CosObjCache * COS_Nullable obj_cache,
+                     CosDocParserContext * COS_Nullable parser_context,
+                     bool resume,
+                     CosError * COS_Nullable out_error)
+{
+    COS_IMPL_PARAM_CHECK(doc != NULL);
+
+    const bool shares_parser = doc->concurrent && !doc->uses_parser_contexts;
+    if (shares_parser) {
+        cos_mutex_lock(&doc->parser_mutex);
+    }
+
+    // In a concurrent document, another thread may have loaded the object since the lookup.
+    CosObjNode *obj = NULL;
+    CosObjCacheLoadState load_state = CosObjCacheLoadState_Unclaimed;
+    if (obj_cache) {
+        load_state = cos_obj_cache_begin_load(COS_nonnull_cast(obj_cache), obj_id, &obj);
+    }
+
+    if (load_state == CosObjCacheLoadState_Cycle) {
+        COS_ERROR_PROPAGATE(cos_error_make(COS_ERROR_PARSE,
+                                           "Object is needed to load itself"),
+                            out_error);
+    }
+    else if (load_state != CosObjCacheLoadState_Cached) {
+        if (parser_context) {
+            obj = resume
+                      ? cos_parser_load_next_object_(parser_context->parser, byte_offset, out_error)
+                      : cos_parser_load_object(parser_context->parser, byte_offset, out_error);
+        }
+        else if (doc->concurrent && doc->uses_parser_contexts) {
+            CosDocParserContext * const context = cos_doc_acquire_parser_context_(doc);
+            if (context) {
+                obj = resume
+                          ? cos_parser_load_next_object_(context->parser, byte_offset, out_error)
+                          : cos_parser_load_object(context->parser, byte_offset, out_error);
+                cos_doc_release_parser_context_(doc, COS_nonnull_cast(context));
+            }
+            else {
+                COS_ERROR_PROPAGATE(cos_error_make(COS_ERROR_MEMORY,
+                                                   "Failed to create a parser context"),
+                                    out_error);
+            }
+        }
+        else {
+            CosParser * const parser = COS_nonnull_cast(doc->parser);
+            obj = resume
+                      ? cos_parser_load_next_object_(parser, byte_offset, out_error)
+                      : cos_parser_load_object(parser, byte_offset, out_error);
+        }
+    }
+
+    if (load_state == CosObjCacheLoadState_Claimed) {
+        cos_obj_cache_end_load(COS_nonnull_cast(obj_cache), obj_id, obj);
+    }
+
+    if (shares_parser) {
+        cos_mutex_unlock(&doc->parser_mutex);
+    }
+
+    return obj;
+}
+
+// MARK: - Concurrency
+
+bool
+cos_doc_enable_concurrent_access(CosDoc *doc,
+                                 CosError * COS_Nullable out_error)
+{
+    COS_API_PARAM_CHECK(doc != NULL);
+    if (COS_UNLIKELY(!doc)) {
+        return false;
+    }
+
+    if (doc->concurrent) {
+        return true;
+    }
+
+#if !COS_ATOMIC_REF_COUNTS
+    COS_ERROR_PROPAGATE(cos_error_make(COS_ERROR_NOT_IMPLEMENTED,
+                                       "Concurrent access requires atomic reference counts"),
+                        out_error);
+    return false;
+#else
+    if (!doc->parser || !doc->xref_table) {
+        COS_ERROR_PROPAGATE(cos_error_make(COS_ERROR_INVALID_STATE,
+                                           "Document has not been parsed"),
+                            out_error);
+        return false;
+    }
+
+    CosObjCache * const obj_cache = cos_doc_get_obj_cache_(doc);
+    if (!obj_cache) {
+        COS_ERROR_PROPAGATE(cos_error_make(COS_ERROR_MEMORY,
+                                           "Failed to create the object cache"),
+                            out_error);
+        return false;
+    }
+
+    // Each reader gets its own parser context if the input can be shared with positional reads.
+    // Otherwise, the readers take turns with the document's parser.
+    CosStream * const input_stream = cos_parser_get_input_stream_(COS_nonnull_cast(doc->parser));
+    CosStreamOffset input_size = -1;
+    if (cos_stream_can_read_at(input_stream) &&
+        cos_stream_seek(input_stream, 0, CosStreamOffsetWhence_End, NULL)) {
+        input_size = cos_stream_get_position(input_stream, NULL);
+    }
+
+    bool parser_mutex_initialized = false;
+    bool parser_contexts_mutex_initialized = false;
+    bool name_table_mutex_initialized = false;
+
+    parser_mutex_initialized = cos_mutex_init(&doc->parser_mutex, true);
+    if (parser_mutex_initialized) {
+        parser_contexts_mutex_initialized = cos_mutex_init(&doc->parser_contexts_mutex, false);
+    }
+    if (parser_contexts_mutex_initialized) {
+        name_table_mutex_initialized = cos_mutex_init(&doc->name_table_mutex, false);
+    }
+    if (!name_table_mutex_initialized) {
+        COS_ERROR_PROPAGATE(cos_error_make(COS_ERROR_MEMORY,
+                                           "Failed to create the document's locks"),
+                            out_error);
+        goto failure;
+    }
+
+    // The slots of a concurrent cache cannot grow, so they must cover the whole xref table. Only
+    // objects in the table can be loaded, so a larger /Size entry does not need more.
+    const size_t xref_obj_count = cos_xref_table_get_obj_count(COS_nonnull_cast(doc->xref_table));
+    if (!cos_obj_cache_make_concurrent(COS_nonnull_cast(obj_cache),
+                                       xref_obj_count,
+                                       out_error)) {
+        goto failure;
+    }
+
+    doc->uses_parser_contexts = (input_size >= 0);
+    doc->input_size = input_size;
+    doc->concurrent = true;
+    return true;
+
+failure:
+    if (name_table_mutex_initialized) {
+        cos_mutex_destroy(&doc->name_table_mutex);
+    }
+    if (parser_contexts_mutex_initialized) {
+        cos_mutex_destroy(&doc->parser_contexts_mutex);
+    }
+    if (parser_mutex_initialized) {
+        cos_mutex_destroy(&doc->parser_mutex);
+    }
+    return false;
+#endif
+}
+
+/**
+ * The location of an in-use object in the file.
+ */
+typedef struct CosDocObjLocation {
+    CosObjID obj_id;
+    CosStreamOffset byte_offset;
+} CosDocObjLocation;
+
+/**
+ * The state shared by the tasks of @c cos_doc_load_all_objects_parallel .
+ */
+typedef struct CosDocParallelLoad {
+    CosDoc *doc;
+    CosObjCache *obj_cache;
+
+    /**
+     * The locations of the objects to load, sorted by byte offset.
+     */
+    const CosDocObjLocation *locations;
+
+    /**
+     * The index of the first location of each range, followed by the number of locations.
+     */
+    const size_t *range_starts;
+
+    /**
+     * Protects @a failed and @a error .
+     */
+    CosMutex error_mutex;
+    bool failed;
+    CosError error;
+} CosDocParallelLoad;
+
+/**
+ * A task that loads the objects of one byte range.
+ */
+typedef struct CosDocRangeTask {
+    CosDocParallelLoad *load;
+    size_t range_index;
+} CosDocRangeTask;
+
+enum {
+    /**
+     * The number of byte ranges per thread.
+     *
+     * Each range is a task, so having more ranges than threads lets the other threads carry on
+     * while one parses a large object.
+     */
+    COS_DOC_RANGES_PER_THREAD = 16,
+};
+
+static CosDocObjLocation * COS_Nullable
+cos_doc_collect_obj_locations_(CosDoc *doc,
+                               size_t *out_count,
+                               CosError * COS_Nullable out_error)
+    COS_ATTR_ACCESS_WRITE_ONLY(2)
+    COS_ATTR_ACCESS_WRITE_ONLY(3);
+
+static int
+cos_doc_compare_obj_locations_(const void *lhs,
+                               const void *rhs);
+
+static void
+cos_doc_load_range_task_(void * COS_Nullable arg);
+
+static void
+cos_doc_parallel_load_fail_(CosDocParallelLoad *load,
+                            CosError error);
+
+bool
+cos_doc_load_all_objects_parallel(CosDoc *doc,
+                                  size_t thread_count,
+                                  CosError * COS_Nullable out_error)
+{
+    COS_API_PARAM_CHECK(doc != NULL);
+    if (COS_UNLIKELY(!doc)) {
+        return false;
+    }
+
+    if (!cos_doc_enable_concurrent_access(doc, out_error)) {
+        return false;
+    }
+
+    CosObjCache * const obj_cache = COS_nonnull_cast(doc->obj_cache);
+
+    if (thread_count == 0) {
+        thread_count = cos_thread_get_processor_count();
+    }
+
+    bool result = false;
+    CosDocObjLocation *locations = NULL;
+    size_t *range_starts = NULL;
+    CosDocRangeTask *range_tasks = NULL;
+    CosTaskPool *task_pool = NULL;
+    bool error_mutex_initialized = false;
+
+    size_t location_count = 0;
+    locations = cos_doc_collect_obj_locations_(doc, &location_count, out_error);
+    if (!locations) {
+        goto cleanup;
+    }
+
+    if (location_count == 0) {
+        result = true;
+        goto cleanup;
+    }
+
+    // Split the locations into contiguous byte ranges of about the same size. An object that is
+    // larger than a range ends up in a range of its own.
+    size_t max_range_count = thread_count * COS_DOC_RANGES_PER_THREAD;
+    if (max_range_count > location_count) {
+        max_range_count = location_count;
+    }
+
+    range_starts = cos_calloc(doc->allocator, max_range_count + 1, sizeof(size_t));
+    range_tasks = cos_calloc(doc->allocator, max_range_count, sizeof(CosDocRangeTask));
+    if (!range_starts || !range_tasks) {
+        COS_ERROR_PROPAGATE(cos_error_make(COS_ERROR_MEMORY,
+                                           "Failed to allocate the byte ranges"),
+                            out_error);
+        goto cleanup;
+    }
+
+    const CosStreamOffset first_offset = locations[0].byte_offset;
+    const CosStreamOffset last_offset = locations[location_count - 1].byte_offset;
+    const CosStreamOffset end_offset = (doc->input_size > last_offset) ? doc->input_size : last_offset + 1;
+    CosStreamOffset range_size = (end_offset - first_offset) / (CosStreamOffset)max_range_count;
+    if (range_size < 1) {
+        range_size = 1;
+    }
+
+    size_t range_count = 0;
+    range_starts[range_count++] = 0;
+    for (size_t i = 1; i < location_count && range_count < max_range_count; i++) {
+        const CosStreamOffset range_start_offset = locations[range_starts[range_count - 1]].byte_offset;
+        if (locations[i].byte_offset - range_start_offset >= range_size) {
+            range_starts[range_count++] = i;
+        }
+    }
+    range_starts[range_count] = location_count;
+
+    CosDocParallelLoad load = {
+        .doc = doc,
+        .obj_cache = obj_cache,
+        .locations = locations,
+        .range_starts = range_starts,
+        .failed = false,
+        .error = cos_error_none(),
+    };
+
+    error_mutex_initialized = cos_mutex_init(&load.error_mutex, false);
+    if (!error_mutex_initialized) {
+        COS_ERROR_PROPAGATE(cos_error_make(COS_ERROR_MEMORY,
+                                           "Failed to create a lock"),
+                            out_error);
+        goto cleanup;
+    }
+
+    // The calling thread runs tasks while it waits, so it counts as one of the threads.
+    if (thread_count > range_count) {
+        thread_count = range_count;
+    }
+    const CosTaskPoolOptions pool_options = {
+        .thread_count = thread_count - 1,
+        .executor = doc->has_executor ? &doc->executor : NULL,
+    };
+    task_pool = cos_task_pool_create(doc->allocator, &pool_options);
+    if (!task_pool) {
+        COS_ERROR_PROPAGATE(cos_error_make(COS_ERROR_MEMORY,
+                                           "Failed to create a task pool"),
+                            out_error);
+        goto cleanup;
+    }
+
+    CosTaskGroup task_group;
+    cos_task_group_init(&task_group);
+
+    for (size_t i = 0; i < range_count; i++) {
+        CosDocRangeTask * const range_task = &range_tasks[i];
+        range_task->load = &load;
+        range_task->range_index = i;
+
+        if (!cos_task_pool_submit(COS_nonnull_cast(task_pool), &task_group, &cos_doc_load_range_task_, range_task)) {
+            // Load the range here instead.
+            cos_doc_load_range_task_(range_task);
+        }
+    }
+
+    cos_task_pool_wait(COS_nonnull_cast(task_pool), &task_group);
+
+    if (load.failed) {
+        COS_ERROR_PROPAGATE(load.error, out_error);
+        goto cleanup;
+    }
+
+    result = true;
+
+cleanup:
+    if (task_pool) {
+        cos_task_pool_destroy(COS_nonnull_cast(task_pool));
+    }
+    if (error_mutex_initialized) {
+        cos_mutex_destroy(&load.error_mutex);
+    }
+    if (range_tasks) {
+        cos_free(doc->allocator, range_tasks);
+    }
+    if (range_starts) {
+        cos_free(doc->allocator, range_starts);
+    }
+    if (locations) {
+        cos_free(doc->allocator, locations);
+    }
+    return result;
+}
+
+/**
+ * Returns the locations of the in-use objects, in the order they appear in the file.
+ */
+static CosDocObjLocation *
+cos_doc_collect_obj_locations_(CosDoc *doc,
+                               size_t *out_count,
+                               CosError * COS_Nullable out_error)
+{
+    COS_IMPL_PARAM_CHECK(doc != NULL);
+    COS_IMPL_PARAM_CHECK(out_count != NULL);
+
+    const CosXrefTable * const xref_table = COS_nonnull_cast(doc->xref_table);
+
+    const size_t obj_count = cos_xref_table_get_obj_count(xref_table);
+    CosDocObjLocation * const locations = cos_calloc(doc->allocator,
+                                                     (obj_count > 0) ? obj_count : 1,
+                                                     sizeof(CosDocObjLocation));
+    if (!locations) {
+        COS_ERROR_PROPAGATE(cos_error_make(COS_ERROR_MEMORY,
+                                           "Failed to allocate the object locations"),
+                            out_error);
+        return NULL;
+    }
+
+    size_t location_count = 0;
+    for (size_t obj_number = 0; obj_number < obj_count; obj_number++) {
+        const CosXrefEntry * const entry = cos_xref_table_find_entry_for_obj_num(xref_table,
+                                                                                 (CosObjNumber)obj_number,
+                                                                                 NULL);
+        if (!entry || entry->type != CosXrefEntryType_InUse) {
+            continue;
+        }
+
+        CosDocObjLocation * const location = &locations[location_count++];
+        location->obj_id = cos_obj_id_make((unsigned int)obj_number, entry->value.in_use.gen_number);
+        location->byte_offset = (CosStreamOffset)entry->value.in_use.byte_offset;
+    }
+
+    qsort(locations, location_count, sizeof(CosDocObjLocation), &cos_doc_compare_obj_locations_);
+
+    *out_count = location_count;
+    return locations;
+}
+
+static int
+cos_doc_compare_obj_locations_(const void *lhs,
+                               const void *rhs)
+{
+    const CosDocObjLocation * const lhs_location = lhs;
+    const CosDocObjLocation * const rhs_location = rhs;
+
+    if (lhs_location->byte_offset < rhs_location->byte_offset) {
+        return -1;
+    }
+    else if (lhs_location->byte_offset > rhs_location->byte_offset) {
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * Loads the objects of a byte range in order, with a parser of its own.
+ */
+static void
+cos_doc_load_range_task_(void *arg)
+{
+    const CosDocRangeTask * const range_task = arg;
+    CosDocParallelLoad * const load = range_task->load;
+    CosDoc * const doc = load->doc;
+
+    CosDocParserContext *parser_context = NULL;
+    if (doc->uses_parser_contexts) {
+        parser_context = cos_doc_acquire_parser_context_(doc);
+        if (!parser_context) {
+            cos_doc_parallel_load_fail_(load,
+                                        cos_error_make(COS_ERROR_MEMORY,
+                                                       "Failed to create a parser context"));
+            return;
+        }
+    }
+
+    const size_t range_end = load->range_starts[range_task->range_index + 1];
+    for (size_t i = load->range_starts[range_task->range_index]; i < range_end; i++) {
+        const CosDocObjLocation * const location = &load->locations[i];
+
+        CosObjNode *obj = cos_obj_cache_get(load->obj_cache, location->obj_id);
+        if (!obj) {
+            CosError error = cos_error_none();
+            obj = cos_doc_load_object_(doc,
+                                       location->obj_id,
+                                       location->byte_offset,
+                                       load->obj_cache,
+                                       parser_context,
+                                       true,
+                                       &error);
+            if (!obj) {
+                cos_doc_parallel_load_fail_(load, error);
+            }
+        }
+        if (obj) {
+            cos_obj_node_release(COS_nonnull_cast(obj));
+        }
+    }
+
+    if (parser_context) {
+        cos_doc_release_parser_context_(doc, COS_nonnull_cast(parser_context));
+    }
+}
+
+/**
+ * Records the first error of a parallel load.
+ */
+static void
+cos_doc_parallel_load_fail_(CosDocParallelLoad *load,
+                            CosError error)
+{
+    COS_IMPL_PARAM_CHECK(load != NULL);
+
+    cos_mutex_lock(&load->error_mutex);
+    if (!load->failed) {
+        load->failed = true;
+        load->error = error;
+    }
+    cos_mutex_unlock(&load->error_mutex);
+}
+
+// MARK: - Sequential scan
+
+enum {
+    /**
+     * The size of an object cursor's read-ahead buffer.
+     */
+    COS_DOC_OBJ_CURSOR_READ_AHEAD_SIZE = 1024 * 1024,
+};
+
+struct CosDocObjCursor {
+    CosDoc *doc;
+
+    /**
+     * The locations of the in-use objects, sorted by byte offset.
+     */
+    CosDocObjLocation *locations;
+    size_t location_count;
+
+    /**
+     * The index of the next location to visit.
+     */
+    size_t next_index;
+
+    /**
+     * A read-ahead view of the document's input stream. Owned by the cursor.
+     */
+    CosStream *stream;
+
+    /**
+     * The cursor's parser, which reads from @a stream .
+     */
+    CosParser *parser;
+};
+
+static void
+cos_doc_obj_cursor_free_(CosDocObjCursor *cursor);
+
+CosDocObjCursor *
+cos_doc_obj_cursor_create(CosDoc *doc,
+                          CosError * COS_Nullable out_error)
+{
+    COS_API_PARAM_CHECK(doc != NULL);
+    if (COS_UNLIKELY(!doc)) {
+        return NULL;
+    }
+
+    if (!doc->parser || !doc->xref_table) {
+        COS_ERROR_PROPAGATE(cos_error_make(COS_ERROR_INVALID_STATE,
+                                           "Document has not been parsed"),
+                            out_error);
+        return NULL;
+    }
+
+    CosDocObjCursor * const cursor = cos_calloc(doc->allocator, 1, sizeof(CosDocObjCursor));
+    if (!cursor) {
+        COS_ERROR_PROPAGATE(cos_error_make(COS_ERROR_MEMORY,
+                                           "Failed to allocate the object cursor"),
+                            out_error);
         return NULL;
     }
+    cursor->doc = doc;
+
+    size_t location_count = 0;
+    CosDocObjLocation * const locations = cos_doc_collect_obj_locations_(doc, &location_count, out_error);
+    if (!locations) {
+        goto failure;
+    }
+    cursor->locations = locations;
+    cursor->location_count = location_count;
+
+    CosStream * const input_stream = cos_parser_get_input_stream_(COS_nonnull_cast(doc->parser));
+    CosStream * const stream = cos_read_ahead_stream_create(input_stream,
+                                                            COS_DOC_OBJ_CURSOR_READ_AHEAD_SIZE);
+    if (!stream) {
+        COS_ERROR_PROPAGATE(cos_error_make(COS_ERROR_MEMORY,
+                                           "Failed to create the read-ahead stream"),
+                            out_error);
+        goto failure;
+    }
+    cursor->stream = stream;
+
+    CosParser * const parser = cos_parser_create_context_(doc, COS_nonnull_cast(stream));
+    if (!parser) {
+        COS_ERROR_PROPAGATE(cos_error_make(COS_ERROR_MEMORY,
+                                           "Failed to create the cursor's parser"),
+                            out_error);
+        goto failure;
+    }
+    cos_parser_set_input_size_(COS_nonnull_cast(parser), cos_parser_get_input_size_(COS_nonnull_cast(doc->parser)));
+    cursor->parser = parser;
+
+    return cursor;
+
+failure:
+    cos_doc_obj_cursor_free_(cursor);
+    return NULL;
+}
+
+void
+cos_doc_obj_cursor_destroy(CosDocObjCursor *cursor)
+{
+    if (!cursor) {
+        return;
+    }
+
+    cos_doc_obj_cursor_free_(cursor);
+}
+
+static void
+cos_doc_obj_cursor_free_(CosDocObjCursor *cursor)
+{
+    COS_IMPL_PARAM_CHECK(cursor != NULL);
+
+    CosAllocator * const allocator = cursor->doc->allocator;
+
+    if (cursor->parser) {
+        cos_parser_destroy(cursor->parser);
+    }
+    if (cursor->stream) {
+        cos_stream_close(cursor->stream);
+    }
+    if (cursor->locations) {
+        cos_free(allocator, cursor->locations);
+    }
+    cos_free(allocator, cursor);
+}
+
+bool
+cos_doc_obj_cursor_next(CosDocObjCursor *cursor,
+                        CosObjID *out_obj_id,
+                        CosObjNode * COS_Nullable *out_obj,
+                        CosError * COS_Nullable out_error)
+{
+    COS_API_PARAM_CHECK(cursor != NULL);
+    COS_API_PARAM_CHECK(out_obj_id != NULL);
+    COS_API_PARAM_CHECK(out_obj != NULL);
+    if (COS_UNLIKELY(!cursor || !out_obj_id || !out_obj)) {
+        return false;
+    }
+
+    *out_obj = NULL;
+
+    if (cursor->next_index >= cursor->location_count) {
+        return false;
+    }
 
-    // Check the cache for a previously loaded object.
+    CosDoc * const doc = cursor->doc;
+    const CosDocObjLocation * const location = &cursor->locations[cursor->next_index++];
+    *out_obj_id = location->obj_id;
+
+    // An object that is cached already is not parsed again. The cursor does not add objects to
+    // the cache, so that a scan of a large file does not keep every object alive.
     if (doc->obj_cache) {
-        CosObjNode * const cached = cos_obj_cache_get(COS_nonnull_cast(doc->obj_cache),
-                                                  obj_id.obj_number);
+        CosObjNode * const cached = cos_obj_cache_get(COS_nonnull_cast(doc->obj_cache), location->obj_id);
         if (cached) {
-            return cos_obj_node_retain(cached);
+            *out_obj = cached;
+            return true;
         }
     }
 
-    // Parse the object from the file.
-    CosObjNode * const obj = cos_parser_load_object(COS_nonnull_cast(doc->parser),
-                                                (CosStreamOffset)entry->value.in_use.byte_offset,
-                                                error);
+    // Without positional reads, filling the read-ahead buffer moves the shared input stream.
+    const bool shares_input = doc->concurrent && !doc->uses_parser_contexts;
+    if (shares_input) {
+        cos_mutex_lock(&doc->parser_mutex);
+    }
+
+    CosObjNode * const obj = cos_parser_load_next_object_(cursor->parser,
+                                                          location->byte_offset,
+                                                          out_error);
+
+    if (shares_input) {
+        cos_mutex_unlock(&doc->parser_mutex);
+    }
+
     if (!obj) {
-        return NULL;
+        return false;
     }
 
-    // Lazily create the cache and insert the object.
-    if (!doc->obj_cache) {
-        doc->obj_cache = cos_obj_cache_create(0);
+    *out_obj = obj;
+    return true;
+}
+
+bool
+cos_doc_obj_cursor_scan_next(CosDocObjCursor *cursor,
+                             const CosObjEventHandler *handler,
+                             CosObjID *out_obj_id,
+                             CosError * COS_Nullable out_error)
+{
+    COS_API_PARAM_CHECK(cursor != NULL);
+    COS_API_PARAM_CHECK(handler != NULL);
+    COS_API_PARAM_CHECK(out_obj_id != NULL);
+    if (COS_UNLIKELY(!cursor || !handler || !out_obj_id)) {
+        return false;
+    }
+
+    if (cursor->next_index >= cursor->location_count) {
+        return false;
+    }
+
+    CosDoc * const doc = cursor->doc;
+    const CosDocObjLocation * const location = &cursor->locations[cursor->next_index++];
+    *out_obj_id = location->obj_id;
+
+    // The object is scanned from the file even if it is cached, since a node cannot be replayed
+    // as events without walking it.
+    const bool shares_input = doc->concurrent && !doc->uses_parser_contexts;
+    if (shares_input) {
+        cos_mutex_lock(&doc->parser_mutex);
+    }
+
+    const bool result = cos_parser_scan_next_object_(cursor->parser,
+                                                     location->byte_offset,
+                                                     handler,
+                                                     out_error);
+
+    if (shares_input) {
+        cos_mutex_unlock(&doc->parser_mutex);
+    }
+
+    return result;
+}
+
+/**
+ * Takes an idle parser context, or creates one if all are in use.
+ */
+static CosDocParserContext *
+cos_doc_acquire_parser_context_(CosDoc *doc)
+{
+    COS_IMPL_PARAM_CHECK(doc != NULL);
+    COS_IMPL_PARAM_CHECK(doc->uses_parser_contexts);
+
+    cos_mutex_lock(&doc->parser_contexts_mutex);
+    CosDocParserContext * const idle_context = doc->idle_parser_contexts;
+    if (idle_context) {
+        doc->idle_parser_contexts = idle_context->next;
+        idle_context->next = NULL;
+    }
+    cos_mutex_unlock(&doc->parser_contexts_mutex);
+
+    if (idle_context) {
+        return idle_context;
+    }
+
+    CosDocParserContext *context = NULL;
+    CosStream *stream = NULL;
+    CosParser *parser = NULL;
+
+    context = cos_calloc(doc->allocator, 1, sizeof(CosDocParserContext));
+    if (!context) {
+        goto failure;
+    }
+
+    stream = cos_stream_view_create(cos_parser_get_input_stream_(COS_nonnull_cast(doc->parser)),
+                                    doc->input_size);
+    if (!stream) {
+        goto failure;
+    }
+
+    parser = cos_parser_create_context_(doc, COS_nonnull_cast(stream));
+    if (!parser) {
+        goto failure;
+    }
+
+    cos_parser_set_input_size_(COS_nonnull_cast(parser), doc->input_size);
+
+    context->parser = COS_nonnull_cast(parser);
+    context->stream = COS_nonnull_cast(stream);
+    context->next = NULL;
+
+    return context;
+
+failure:
+    if (stream) {
+        cos_stream_close(COS_nonnull_cast(stream));
+    }
+    if (context) {
+        cos_free(doc->allocator, context);
+    }
+    return NULL;
+}
+
+static void
+cos_doc_release_parser_context_(CosDoc *doc,
+                                CosDocParserContext *context)
+{
+    COS_IMPL_PARAM_CHECK(doc != NULL);
+    COS_IMPL_PARAM_CHECK(context != NULL);
+
+    cos_mutex_lock(&doc->parser_contexts_mutex);
+    context->next = doc->idle_parser_contexts;
+    doc->idle_parser_contexts = context;
+    cos_mutex_unlock(&doc->parser_contexts_mutex);
+}
+
+static void
+cos_doc_destroy_parser_context_(CosDoc *doc,
+                                CosDocParserContext *context)
+{
+    COS_IMPL_PARAM_CHECK(doc != NULL);
+    COS_IMPL_PARAM_CHECK(context != NULL);
+
+    cos_parser_destroy(context->parser);
+    cos_stream_close(context->stream);
+    cos_free(doc->allocator, context);
+}
+
+// MARK: - Object cache
+
+void
+cos_doc_set_cache_limits(CosDoc *doc,
+                         CosDocCacheLimits limits)
+{
+    COS_API_PARAM_CHECK(doc != NULL);
+    if (COS_UNLIKELY(!doc)) {
+        return;
+    }
+
+    CosObjCache * const obj_cache = cos_doc_get_obj_cache_(doc);
+    if (obj_cache) {
+        cos_obj_cache_set_limits(COS_nonnull_cast(obj_cache), limits);
     }
+}
+
+bool
+cos_doc_pin_object(CosDoc *doc,
+                   CosObjID obj_id,
+                   CosError * COS_Nullable out_error)
+{
+    COS_API_PARAM_CHECK(doc != NULL);
+    if (COS_UNLIKELY(!doc)) {
+        return false;
+    }
+
+    CosObjNode * const obj = cos_doc_get_object(doc, obj_id, out_error);
+    if (!obj) {
+        return false;
+    }
+
+    // The object was just looked up or inserted, so it is cached unless the cache could not
+    // be created or the object was evicted by its own insertion.
+    const bool pinned = (doc->obj_cache &&
+                         cos_obj_cache_pin(COS_nonnull_cast(doc->obj_cache), obj_id));
+    cos_obj_node_release(obj);
+
+    if (!pinned) {
+        COS_ERROR_PROPAGATE(cos_error_make(COS_ERROR_MEMORY,
+                                           "Object could not be kept in the cache"),
+                            out_error);
+        return false;
+    }
+    return true;
+}
+
+void
+cos_doc_unpin_object(CosDoc *doc,
+                     CosObjID obj_id)
+{
+    COS_API_PARAM_CHECK(doc != NULL);
+    if (COS_UNLIKELY(!doc)) {
+        return;
+    }
+
     if (doc->obj_cache) {
-        cos_obj_cache_insert(COS_nonnull_cast(doc->obj_cache),
-                             obj_id.obj_number,
-                             obj);
+        cos_obj_cache_unpin(COS_nonnull_cast(doc->obj_cache), obj_id);
     }
+}
 
-    return obj;
+void
+cos_doc_get_cache_stats(const CosDoc *doc,
+                        CosDocCacheStats *out_stats)
+{
+    COS_API_PARAM_CHECK(doc != NULL);
+    COS_API_PARAM_CHECK(out_stats != NULL);
+    if (COS_UNLIKELY(!doc || !out_stats)) {
+        return;
+    }
+
+    if (doc->obj_cache) {
+        cos_obj_cache_get_stats(COS_nonnull_cast(doc->obj_cache), out_stats);
+    }
+    else {
+        *out_stats = (CosDocCacheStats){0};
+    }
+}
+
+/**
+ * Returns the document's object cache, creating it on first use.
+ */
+static CosObjCache * COS_Nullable
+cos_doc_get_obj_cache_(CosDoc *doc)
+{
+    COS_IMPL_PARAM_CHECK(doc != NULL);
+
+    if (!doc->obj_cache) {
+        doc->obj_cache = cos_obj_cache_create(doc->allocator, cos_doc_get_obj_count_(doc));
+    }
+    return doc->obj_cache;
+}
+
+/**
+ * Returns the number of objects in the document, from the trailer's /Size entry, or @c 0 if it
+ * is not known.
+ *
+ * The entry is not trusted beyond the objects that the xref table covers, since the cache
+ * reserves a slot for each object up front.
+ */
+static size_t
+cos_doc_get_obj_count_(const CosDoc *doc)
+{
+    COS_IMPL_PARAM_CHECK(doc != NULL);
+
+    if (!doc->trailer_dict) {
+        return 0;
+    }
+
+    // A reference is not resolved, as loading an object needs the cache.
+    CosObjValue size_value;
+    int size = 0;
+    if (!cos_dict_obj_node_lookup_with_key(COS_nonnull_cast(doc->trailer_dict),
+                                           cos_name_key_get_well_known(CosWellKnownName_Size),
+                                           &size_value)) {
+        return 0;
+    }
+    if (size_value.kind == CosObjValueKind_Integer) {
+        size = size_value.as.integer;
+    }
+    else if (size_value.kind == CosObjValueKind_Node && size_value.as.node &&
+             cos_obj_node_is_integer(COS_nonnull_cast(size_value.as.node))) {
+        size = cos_int_obj_node_get_value((const CosIntObjNode *)size_value.as.node);
+    }
+
+    if (size <= 0 || !doc->xref_table) {
+        return 0;
+    }
+
+    const size_t xref_obj_count = cos_xref_table_get_obj_count(COS_nonnull_cast(doc->xref_table));
+    return ((size_t)size < xref_obj_count) ? (size_t)size : xref_obj_count;
 }
 
 // MARK: - Diagnostics
@@ -220,6 +1530,26 @@ cos_doc_set_diagnostic_handler(CosDoc *doc,
     doc->diagnostic_handler = handler;
 }
 
+// MARK: - Background work
+
+void
+cos_doc_set_executor(CosDoc *doc,
+                     const CosExecutor * COS_Nullable executor)
+{
+    COS_API_PARAM_CHECK(doc != NULL);
+    if (!doc) {
+        return;
+    }
+
+    if (executor) {
+        doc->executor = *executor;
+        doc->has_executor = true;
+    }
+    else {
+        doc->has_executor = false;
+    }
+}
+
 // MARK: - Private setters
 
 void
@@ -276,6 +1606,10 @@ cos_doc_set_trailer_dict_(CosDoc *doc,
     }
 
     doc->trailer_dict = dict;
+
+    if (doc->obj_cache) {
+        (void)cos_obj_cache_reserve(COS_nonnull_cast(doc->obj_cache), cos_doc_get_obj_count_(doc));
+    }
 }
 
 void
@@ -289,4 +1623,34 @@ cos_doc_set_root_(CosDoc *doc,
     doc->root = root;
 }
 
+CosNameObjNode *
+cos_doc_intern_name_(CosDoc *doc,
+                     CosString *name)
+{
+    COS_IMPL_PARAM_CHECK(doc != NULL);
+    COS_IMPL_PARAM_CHECK(name != NULL);
+
+    // Parser contexts intern names from several threads at once.
+    if (doc->concurrent) {
+        cos_mutex_lock(&doc->name_table_mutex);
+    }
+
+    CosNameObjNode *name_obj = NULL;
+    if (!doc->name_table) {
+        doc->name_table = cos_name_table_create(doc->allocator, 0);
+    }
+    if (doc->name_table) {
+        name_obj = cos_name_table_intern(COS_nonnull_cast(doc->name_table), name);
+    }
+    else {
+        cos_string_free(name);
+    }
+
+    if (doc->concurrent) {
+        cos_mutex_unlock(&doc->name_table_mutex);
+    }
+
+    return name_obj;
+}
+
 COS_ASSUME_NONNULL_END
@@ -14,7 +14,9 @@
 #include "libcos/objects/CosIndirectObjNode.h"
 #include "libcos/objects/CosIntObjNode.h"
 #include "libcos/objects/CosNameObjNode.h"
+#include "libcos/objects/CosNameKey.h"
 #include "libcos/objects/CosObjNode.h"
+#include "libcos/objects/CosObjValue.h"
 #include "libcos/objects/CosRealObjNode.h"
 #include "libcos/objects/CosReferenceObjNode.h"
 #include "libcos/objects/CosStreamObjNode.h"
@@ -25,7 +27,10 @@
 COS_ASSUME_NONNULL_BEGIN
 
 struct CosObj {
-    CosObjNode *node;
+    /**
+     * The wrapped value, which is either a retained object node or a scalar.
+     */
+    CosObjValue value;
 };
 
 // MARK: - Private helpers
@@ -37,59 +42,144 @@ struct CosObj {
  * direct value. An Indirect object wraps a direct value directly.
  *
  * The returned pointer is borrowed from the wrapper -- it remains valid
- * as long as the wrapper (and thus the CosObj) is alive.
+ * as long as the wrapper (and thus the CosObj) is alive. Scalars that are
+ * stored inline have no node.
  */
 static CosObjNode * COS_Nullable
 cos_obj_get_direct_node_(const CosObj *obj)
 {
     COS_IMPL_PARAM_CHECK(obj != NULL);
 
-    CosObjNode *node = obj->node;
-
-    if (cos_obj_node_get_type(node) == CosObjNodeType_Reference) {
-        node = cos_reference_obj_node_get_value((CosReferenceObjNode *)node);
-        if (!node) {
-            return NULL;
-        }
-    }
-
-    if (cos_obj_node_get_type(node) == CosObjNodeType_Indirect) {
-        return cos_indirect_obj_node_get_value((CosIndirectObjNode *)node);
-    }
-
-    return node;
+    return cos_obj_value_get_node(cos_obj_value_resolve(obj->value));
 }
 
 static CosObjType
-cos_obj_type_from_node_type_(CosObjNodeType node_type)
+cos_obj_type_from_value_type_(CosObjNodeValueType value_type)
 {
-    switch (node_type) {
-        case CosObjNodeType_Boolean:
+    switch (value_type) {
+        case CosObjNodeValueType_Boolean:
             return CosObjType_Boolean;
-        case CosObjNodeType_Integer:
+        case CosObjNodeValueType_Integer:
             return CosObjType_Integer;
-        case CosObjNodeType_Real:
+        case CosObjNodeValueType_Real:
             return CosObjType_Real;
-        case CosObjNodeType_String:
+        case CosObjNodeValueType_String:
             return CosObjType_String;
-        case CosObjNodeType_Name:
+        case CosObjNodeValueType_Name:
             return CosObjType_Name;
-        case CosObjNodeType_Array:
+        case CosObjNodeValueType_Array:
             return CosObjType_Array;
-        case CosObjNodeType_Dict:
+        case CosObjNodeValueType_Dict:
             return CosObjType_Dict;
-        case CosObjNodeType_Stream:
+        case CosObjNodeValueType_Stream:
             return CosObjType_Stream;
-        case CosObjNodeType_Null:
+        case CosObjNodeValueType_Null:
             return CosObjType_Null;
-        case CosObjNodeType_Unknown:
-        case CosObjNodeType_Indirect:
-        case CosObjNodeType_Reference:
+        case CosObjNodeValueType_Unknown:
             return CosObjType_Unknown;
     }
     return CosObjType_Unknown;
 }
 
+/**
+ * Creates a new object wrapping the given value, retaining its node (if any).
+ */
+static CosObj * COS_Nullable
+cos_obj_create_with_value_(CosObjValue value)
+{
+    CosObj * const obj = malloc(sizeof(CosObj));
+    if (COS_UNLIKELY(!obj)) {
+        return NULL;
+    }
+
+    cos_obj_value_retain(value);
+    obj->value = value;
+
+    return obj;
+}
+
+/**
+ * Gets the direct array node of an array object.
+ */
+static const CosArrayObjNode * COS_Nullable
+cos_obj_get_direct_array_(const CosObj *obj,
+                          CosError * COS_Nullable out_error)
+{
+    COS_IMPL_PARAM_CHECK(obj != NULL);
+
+    CosObjNode * const direct = cos_obj_get_direct_node_(obj);
+    if (!direct || cos_obj_node_get_type(direct) != CosObjNodeType_Array) {
+        cos_error_propagate(out_error,
+                            cos_error_make(COS_ERROR_INVALID_ARGUMENT,
+                                           "Object is not an array"));
+        return NULL;
+    }
+    return (const CosArrayObjNode *)direct;
+}
+
+/**
+ * Gets the direct value of an array element.
+ */
+static bool
+cos_obj_get_direct_value_at_index_(const CosObj *obj,
+                                   size_t index,
+                                   CosObjValue *out_value,
+                                   CosError * COS_Nullable out_error)
+{
+    COS_IMPL_PARAM_CHECK(obj != NULL);
+    COS_IMPL_PARAM_CHECK(out_value != NULL);
+
+    const CosArrayObjNode * const array = cos_obj_get_direct_array_(obj, out_error);
+    if (!array) {
+        return false;
+    }
+
+    CosObjValue element;
+    if (!cos_array_obj_node_get_value_at(array,
+                                         index,
+                                         &element,
+                                         out_error)) {
+        return false;
+    }
+
+    *out_value = cos_obj_value_resolve(element);
+    return true;
+}
+
+/**
+ * Gets the direct value of a dictionary entry.
+ */
+static bool
+cos_obj_get_direct_value_for_key_(const CosObj *obj,
+                                  const char *key,
+                                  CosObjValue *out_value,
+                                  CosError * COS_Nullable out_error)
+{
+    COS_IMPL_PARAM_CHECK(obj != NULL);
+    COS_IMPL_PARAM_CHECK(key != NULL);
+    COS_IMPL_PARAM_CHECK(out_value != NULL);
+
+    CosObjNode * const direct = cos_obj_get_direct_node_(obj);
+    if (!direct || cos_obj_node_get_type(direct) != CosObjNodeType_Dict) {
+        cos_error_propagate(out_error,
+                            cos_error_make(COS_ERROR_INVALID_ARGUMENT,
+                                           "Object is not a dictionary"));
+        return false;
+    }
+
+    const CosNameKey name_key = cos_name_key(key);
+
+    CosObjValue value;
+    if (!cos_dict_obj_node_lookup_with_key((CosDictObjNode *)direct,
+                                           &name_key,
+                                           &value)) {
+        return false;
+    }
+
+    *out_value = cos_obj_value_resolve(value);
+    return true;
+}
+
 // MARK: - Lifecycle
 
 CosObj * COS_Nullable
@@ -100,15 +190,7 @@ cos_obj_create(CosObjNode *node)
         return NULL;
     }
 
-    CosObj * const obj = malloc(sizeof(CosObj));
-    if (COS_UNLIKELY(!obj)) {
-        return NULL;
-    }
-
-    cos_obj_node_retain(node);
-    obj->node = node;
-
-    return obj;
+    return cos_obj_create_with_value_(cos_obj_value_make_node(node));
 }
 
 void
@@ -119,7 +201,7 @@ cos_obj_destroy(CosObj *obj)
         return;
     }
 
-    cos_obj_node_release(obj->node);
+    cos_obj_value_release(obj->value);
     free(obj);
 }
 
@@ -133,11 +215,8 @@ cos_obj_get_type(const CosObj *obj)
         return CosObjType_Unknown;
     }
 
-    CosObjNode * const direct = cos_obj_get_direct_node_(obj);
-    if (!direct) {
-        return CosObjType_Unknown;
-    }
-    return cos_obj_type_from_node_type_(cos_obj_node_get_type(direct));
+    const CosObjValue direct = cos_obj_value_resolve(obj->value);
+    return cos_obj_type_from_value_type_(cos_obj_value_get_type(direct));
 }
 
 bool
@@ -148,7 +227,12 @@ cos_obj_is_direct(const CosObj *obj)
         return false;
     }
 
-    return cos_obj_node_is_direct(obj->node);
+    const CosObjNode * const node = cos_obj_value_get_node(obj->value);
+    if (!node) {
+        // Scalars that are stored inline are always direct.
+        return true;
+    }
+    return cos_obj_node_is_direct(node);
 }
 
 bool
@@ -159,7 +243,11 @@ cos_obj_is_indirect(const CosObj *obj)
         return false;
     }
 
-    return cos_obj_node_is_indirect(obj->node);
+    const CosObjNode * const node = cos_obj_value_get_node(obj->value);
+    if (!node) {
+        return false;
+    }
+    return cos_obj_node_is_indirect(node);
 }
 
 bool
@@ -183,11 +271,11 @@ cos_obj_get_bool_value(const CosObj *obj)
         return false;
     }
 
-    CosObjNode * const direct = cos_obj_get_direct_node_(obj);
-    if (!direct || cos_obj_node_get_type(direct) != CosObjNodeType_Boolean) {
+    bool value = false;
+    if (!cos_obj_value_get_bool(obj->value, &value)) {
         return false;
     }
-    return cos_bool_obj_node_get_value((CosBoolObjNode *)direct);
+    return value;
 }
 
 int
@@ -198,11 +286,11 @@ cos_obj_get_int_value(const CosObj *obj)
         return 0;
     }
 
-    CosObjNode * const direct = cos_obj_get_direct_node_(obj);
-    if (!direct || cos_obj_node_get_type(direct) != CosObjNodeType_Integer) {
+    int value = 0;
+    if (!cos_obj_value_get_int(obj->value, &value)) {
         return 0;
     }
-    return cos_int_obj_node_get_value((CosIntObjNode *)direct);
+    return value;
 }
 
 double
@@ -213,11 +301,11 @@ cos_obj_get_real_value(const CosObj *obj)
         return 0.0;
     }
 
-    CosObjNode * const direct = cos_obj_get_direct_node_(obj);
-    if (!direct || cos_obj_node_get_type(direct) != CosObjNodeType_Real) {
+    double value = 0.0;
+    if (!cos_obj_value_get_real(obj->value, &value)) {
         return 0.0;
     }
-    return cos_real_obj_node_get_value((CosRealObjNode *)direct);
+    return value;
 }
 
 // MARK: - String / Name accessors
@@ -290,15 +378,117 @@ cos_obj_get_object_at_index(const CosObj *obj,
         return NULL;
     }
 
-    CosObjNode * const element =
-        cos_array_obj_node_get_at((CosArrayObjNode *)direct,
-                                  index,
-                                  out_error);
-    if (!element) {
+    CosObjValue element;
+    if (!cos_array_obj_node_get_value_at((CosArrayObjNode *)direct,
+                                         index,
+                                         &element,
+                                         out_error)) {
         return NULL;
     }
 
-    return cos_obj_create(element);
+    return cos_obj_create_with_value_(element);
+}
+
+bool
+cos_obj_get_int_at_index(const CosObj *obj,
+                         size_t index,
+                         int *out_value,
+                         CosError * COS_Nullable out_error)
+{
+    COS_API_PARAM_CHECK(obj != NULL);
+    COS_API_PARAM_CHECK(out_value != NULL);
+    if (COS_UNLIKELY(!obj || !out_value)) {
+        cos_error_propagate(out_error,
+                            cos_error_make(COS_ERROR_INVALID_ARGUMENT,
+                                           "Object is NULL"));
+        return false;
+    }
+
+    CosObjValue element;
+    if (!cos_obj_get_direct_value_at_index_(obj, index, &element, out_error)) {
+        return false;
+    }
+
+    if (!cos_obj_value_get_int(element, out_value)) {
+        cos_error_propagate(out_error,
+                            cos_error_make(COS_ERROR_INVALID_ARGUMENT,
+                                           "Element is not an integer"));
+        return false;
+    }
+    return true;
+}
+
+bool
+cos_obj_get_number_at_index(const CosObj *obj,
+                            size_t index,
+                            double *out_value,
+                            CosError * COS_Nullable out_error)
+{
+    COS_API_PARAM_CHECK(obj != NULL);
+    COS_API_PARAM_CHECK(out_value != NULL);
+    if (COS_UNLIKELY(!obj || !out_value)) {
+        cos_error_propagate(out_error,
+                            cos_error_make(COS_ERROR_INVALID_ARGUMENT,
+                                           "Object is NULL"));
+        return false;
+    }
+
+    CosObjValue element;
+    if (!cos_obj_get_direct_value_at_index_(obj, index, &element, out_error)) {
+        return false;
+    }
+
+    if (!cos_obj_value_get_number(element, out_value)) {
+        cos_error_propagate(out_error,
+                            cos_error_make(COS_ERROR_INVALID_ARGUMENT,
+                                           "Element is not a number"));
+        return false;
+    }
+    return true;
+}
+
+bool
+cos_obj_get_number_array(const CosObj *obj,
+                         double *out_numbers,
+                         size_t count,
+                         CosError * COS_Nullable out_error)
+{
+    COS_API_PARAM_CHECK(obj != NULL);
+    COS_API_PARAM_CHECK(out_numbers != NULL || count == 0);
+    if (COS_UNLIKELY(!obj || (!out_numbers && count > 0))) {
+        cos_error_propagate(out_error,
+                            cos_error_make(COS_ERROR_INVALID_ARGUMENT,
+                                           "Object is NULL"));
+        return false;
+    }
+
+    const CosArrayObjNode * const array = cos_obj_get_direct_array_(obj, out_error);
+    if (!array) {
+        return false;
+    }
+    return cos_array_obj_node_get_numbers(array, 0, out_numbers, count, out_error);
+}
+
+bool
+cos_obj_get_int_array(const CosObj *obj,
+                      int *out_ints,
+                      size_t count,
+                      CosError * COS_Nullable out_error)
+{
+    COS_API_PARAM_CHECK(obj != NULL);
+    COS_API_PARAM_CHECK(out_ints != NULL || count == 0);
+    if (COS_UNLIKELY(!obj || (!out_ints && count > 0))) {
+        cos_error_propagate(out_error,
+                            cos_error_make(COS_ERROR_INVALID_ARGUMENT,
+                                           "Object is NULL"));
+        return false;
+    }
+
+    const CosArrayObjNode * const array = cos_obj_get_direct_array_(obj, out_error);
+    if (!array) {
+        return false;
+    }
+    return cos_array_obj_node_get_ints(array, 0, out_ints, count, out_error);
 }
 
 // MARK: - Dict accessors
@@ -340,15 +530,76 @@ cos_obj_get_value_for_key(const CosObj *obj,
         return NULL;
     }
 
-    CosObjNode *value = NULL;
-    if (!cos_dict_obj_node_get_value_with_string((CosDictObjNode *)direct,
-                                                 key,
-                                                 &value,
-                                                 out_error)) {
+    const CosNameKey name_key = cos_name_key(key);
+
+    CosObjValue value;
+    if (!cos_dict_obj_node_lookup_with_key((CosDictObjNode *)direct,
+                                           &name_key,
+                                           &value)) {
         return NULL;
     }
 
-    return cos_obj_create(value);
+    return cos_obj_create_with_value_(value);
+}
+
+bool
+cos_obj_get_int_for_key(const CosObj *obj,
+                        const char *key,
+                        int *out_value,
+                        CosError * COS_Nullable out_error)
+{
+    COS_API_PARAM_CHECK(obj != NULL);
+    COS_API_PARAM_CHECK(key != NULL);
+    COS_API_PARAM_CHECK(out_value != NULL);
+    if (COS_UNLIKELY(!obj || !key || !out_value)) {
+        cos_error_propagate(out_error,
+                            cos_error_make(COS_ERROR_INVALID_ARGUMENT,
+                                           "Object or key is NULL"));
+        return false;
+    }
+
+    CosObjValue value;
+    if (!cos_obj_get_direct_value_for_key_(obj, key, &value, out_error)) {
+        return false;
+    }
+
+    if (!cos_obj_value_get_int(value, out_value)) {
+        cos_error_propagate(out_error,
+                            cos_error_make(COS_ERROR_INVALID_ARGUMENT,
+                                           "Value is not an integer"));
+        return false;
+    }
+    return true;
+}
+
+bool
+cos_obj_get_number_for_key(const CosObj *obj,
+                           const char *key,
+                           double *out_value,
+                           CosError * COS_Nullable out_error)
+{
+    COS_API_PARAM_CHECK(obj != NULL);
+    COS_API_PARAM_CHECK(key != NULL);
+    COS_API_PARAM_CHECK(out_value != NULL);
+    if (COS_UNLIKELY(!obj || !key || !out_value)) {
+        cos_error_propagate(out_error,
+                            cos_error_make(COS_ERROR_INVALID_ARGUMENT,
+                                           "Object or key is NULL"));
+        return false;
+    }
+
+    CosObjValue value;
+    if (!cos_obj_get_direct_value_for_key_(obj, key, &value, out_error)) {
+        return false;
+    }
+
+    if (!cos_obj_value_get_number(value, out_value)) {
+        cos_error_propagate(out_error,
+                            cos_error_make(COS_ERROR_INVALID_ARGUMENT,
+                                           "Value is not a number"));
+        return false;
+    }
+    return true;
 }
 
 // MARK: - Dict iterator
@@ -382,11 +633,11 @@ cos_obj_dict_iterator_next(CosObjDictIterator *iterator,
     }
 
     CosNameObjNode *name_node = NULL;
-    CosObjNode *value_node = NULL;
+    CosObjValue value;
 
-    if (!cos_dict_obj_node_iterator_next(&iterator->base,
-                                         &name_node,
-                                         &value_node)) {
+    if (!cos_dict_obj_node_iterator_next_value(&iterator->base,
+                                               &name_node,
+                                               &value)) {
         *out_key = NULL;
         *out_value = NULL;
         return false;
@@ -394,7 +645,7 @@ cos_obj_dict_iterator_next(CosObjDictIterator *iterator,
 
     const CosString * const name_str = cos_name_obj_node_get_value(name_node);
     *out_key = name_str ? cos_string_get_data(name_str) : NULL;
-    *out_value = cos_obj_create(value_node);
+    *out_value = cos_obj_create_with_value_(value);
 
     return true;
 }
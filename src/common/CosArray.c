@@ -8,6 +8,7 @@
 #include "common/CosContainerUtils.h"
 
 #include <libcos/common/CosError.h>
+#include <libcos/common/memory/CosMemory.h>
 
 #include <stdlib.h>
 #include <string.h>
@@ -21,6 +22,8 @@ struct CosArray {
     size_t capacity;
 
     CosArrayCallbacks callbacks;
+
+    CosAllocator * COS_Nullable allocator;
 };
 
 static void
@@ -55,7 +58,8 @@ cos_array_resize_(CosArray *array,
 // MARK: - Public
 
 CosArray *
-cos_array_create(size_t element_size,
+cos_array_create(CosAllocator * COS_Nullable allocator,
+                 size_t element_size,
                  const CosArrayCallbacks * COS_Nullable callbacks,
                  size_t capacity_hint)
 {
@@ -67,14 +71,14 @@ cos_array_create(size_t element_size,
     CosArray *array = NULL;
     unsigned char *data = NULL;
 
-    array = calloc(1, sizeof(CosArray));
+    array = cos_calloc(allocator, 1, sizeof(CosArray));
     if (!array) {
         goto failure;
     }
 
     const size_t capacity = cos_container_round_capacity_(capacity_hint);
 
-    data = calloc(capacity, element_size);
+    data = cos_calloc(allocator, capacity, element_size);
     if (!data) {
         goto failure;
     }
@@ -83,6 +87,7 @@ cos_array_create(size_t element_size,
     array->element_size = element_size;
     array->count = 0;
     array->capacity = capacity;
+    array->allocator = allocator;
 
     if (callbacks) {
         array->callbacks = *callbacks;
@@ -92,10 +97,10 @@ cos_array_create(size_t element_size,
 
 failure:
     if (array) {
-        free(array);
+        cos_free(allocator, array);
     }
     if (data) {
-        free(data);
+        cos_free(allocator, data);
     }
     return NULL;
 }
@@ -116,8 +121,10 @@ cos_array_destroy(CosArray *array)
         }
     }
 
-    free(array->data);
-    free(array);
+    CosAllocator * const allocator = array->allocator;
+
+    cos_free(allocator, array->data);
+    cos_free(allocator, array);
 }
 
 // MARK: - Accessors
@@ -167,6 +174,41 @@ cos_array_get_item(const CosArray *array,
     return true;
 }
 
+bool
+cos_array_set_item(CosArray *array,
+                   size_t index,
+                   const void *item,
+                   CosError * COS_Nullable out_error)
+{
+    COS_API_PARAM_CHECK(array != NULL);
+    COS_API_PARAM_CHECK(item != NULL);
+    if (!array || !item) {
+        return false;
+    }
+
+    if (index >= array->count) {
+        COS_ERROR_PROPAGATE(cos_error_make(COS_ERROR_OUT_OF_RANGE,
+                                           "Index out of bounds"),
+                            out_error);
+        return false;
+    }
+
+    const size_t element_size = array->element_size;
+    void * const dest = array->data + (index * element_size);
+
+    if (array->callbacks.release) {
+        array->callbacks.release(dest);
+    }
+
+    memcpy(dest, item, element_size);
+
+    if (array->callbacks.retain) {
+        array->callbacks.retain(dest);
+    }
+
+    return true;
+}
+
 // MARK: Insertion
 
 bool
@@ -519,8 +561,9 @@ cos_array_resize_(CosArray *array,
 
     const size_t new_capacity = cos_container_round_capacity_(required_capacity);
 
-    unsigned char * const new_data = realloc(array->data,
-                                             new_capacity * array->element_size);
+    unsigned char * const new_data = cos_realloc(array->allocator,
+                                                 array->data,
+                                                 new_capacity * array->element_size);
     if (!new_data) {
         return false;
     }
@@ -0,0 +1,335 @@
+/*
+ * Copyright (c) 2025 OpenCOS.
+ */
+
+#ifndef LIBCOS_COMMON_COS_ATOMIC_H
+#define LIBCOS_COMMON_COS_ATOMIC_H
+
+#include "config.h"
+
+#include <libcos/common/CosDefines.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+    #include <intrin.h>
+#endif
+
+COS_DECLS_BEGIN
+COS_ASSUME_NONNULL_BEGIN
+
+/*
+ * Atomic operations on plain integers, with the memory orderings of C11 atomics.
+ *
+ * The library is built as C99, so these use the compiler builtins that <stdatomic.h> is
+ * implemented with rather than _Atomic-qualified types. That also keeps the layout of the
+ * structures whose fields are accessed atomically unchanged.
+ */
+
+#if defined(__GNUC__) || defined(__clang__)
+    #define COS_HAS_ATOMICS 1
+#elif defined(_MSC_VER)
+    #define COS_HAS_ATOMICS 1
+#else
+    #define COS_HAS_ATOMICS 0
+#endif
+
+#if COS_ATOMIC_REF_COUNTS && !COS_HAS_ATOMICS
+    #error "Atomic reference counts are not supported by this compiler."
+#endif
+
+/**
+ * @brief Loads a value, with relaxed ordering.
+ */
+COS_STATIC_INLINE
+unsigned int
+cos_atomic_load_relaxed(const unsigned int *value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __atomic_load_n(value, __ATOMIC_RELAXED);
+#else
+    return *(const volatile unsigned int *)value;
+#endif
+}
+
+/**
+ * @brief Adds to a value, with relaxed ordering.
+ *
+ * @return The previous value.
+ */
+COS_STATIC_INLINE
+unsigned int
+cos_atomic_fetch_add_relaxed(unsigned int *value,
+                             unsigned int operand)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __atomic_fetch_add(value, operand, __ATOMIC_RELAXED);
+#elif defined(_MSC_VER)
+    return (unsigned int)_InterlockedExchangeAdd((volatile long *)value, (long)operand);
+#else
+    const unsigned int previous = *value;
+    *value = previous + operand;
+    return previous;
+#endif
+}
+
+/**
+ * @brief Subtracts from a value, with release ordering.
+ *
+ * @return The previous value.
+ */
+COS_STATIC_INLINE
+unsigned int
+cos_atomic_fetch_sub_release(unsigned int *value,
+                             unsigned int operand)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __atomic_fetch_sub(value, operand, __ATOMIC_RELEASE);
+#elif defined(_MSC_VER)
+    return (unsigned int)_InterlockedExchangeAdd((volatile long *)value, -(long)operand);
+#else
+    const unsigned int previous = *value;
+    *value = previous - operand;
+    return previous;
+#endif
+}
+
+/**
+ * @brief Sets bits of a value, with relaxed ordering.
+ *
+ * @return The previous value.
+ */
+COS_STATIC_INLINE
+unsigned int
+cos_atomic_fetch_or_relaxed(unsigned int *value,
+                            unsigned int bits)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __atomic_fetch_or(value, bits, __ATOMIC_RELAXED);
+#elif defined(_MSC_VER)
+    return (unsigned int)_InterlockedOr((volatile long *)value, (long)bits);
+#else
+    const unsigned int previous = *value;
+    *value = previous | bits;
+    return previous;
+#endif
+}
+
+/**
+ * @brief Clears bits of a value, with relaxed ordering.
+ *
+ * @return The previous value.
+ */
+COS_STATIC_INLINE
+unsigned int
+cos_atomic_fetch_and_relaxed(unsigned int *value,
+                             unsigned int bits)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __atomic_fetch_and(value, bits, __ATOMIC_RELAXED);
+#elif defined(_MSC_VER)
+    return (unsigned int)_InterlockedAnd((volatile long *)value, (long)bits);
+#else
+    const unsigned int previous = *value;
+    *value = previous & bits;
+    return previous;
+#endif
+}
+
+/**
+ * @brief Stores a value, with relaxed ordering.
+ */
+COS_STATIC_INLINE
+void
+cos_atomic_store_relaxed(unsigned int *value,
+                         unsigned int desired)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    __atomic_store_n(value, desired, __ATOMIC_RELAXED);
+#else
+    *(volatile unsigned int *)value = desired;
+#endif
+}
+
+/**
+ * @brief Loads a size, with relaxed ordering.
+ */
+COS_STATIC_INLINE
+size_t
+cos_atomic_load_size_relaxed(const size_t *value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __atomic_load_n(value, __ATOMIC_RELAXED);
+#else
+    return *(const volatile size_t *)value;
+#endif
+}
+
+/**
+ * @brief Adds to a size, with relaxed ordering.
+ */
+COS_STATIC_INLINE
+void
+cos_atomic_add_size_relaxed(size_t *value,
+                            size_t operand)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    (void)__atomic_fetch_add(value, operand, __ATOMIC_RELAXED);
+#elif defined(_MSC_VER) && defined(_WIN64)
+    (void)_InterlockedExchangeAdd64((volatile __int64 *)value, (__int64)operand);
+#elif defined(_MSC_VER)
+    (void)_InterlockedExchangeAdd((volatile long *)value, (long)operand);
+#else
+    *value += operand;
+#endif
+}
+
+/**
+ * @brief Loads a pointer, with acquire ordering.
+ */
+COS_STATIC_INLINE
+void * COS_Nullable
+cos_atomic_load_ptr_acquire(void * COS_Nullable const *pointer)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __atomic_load_n(pointer, __ATOMIC_ACQUIRE);
+#elif defined(_MSC_VER)
+    void * const value = *(void * const volatile *)pointer;
+    _ReadWriteBarrier();
+    return value;
+#else
+    return *pointer;
+#endif
+}
+
+/**
+ * @brief Stores a pointer, with release ordering.
+ */
+COS_STATIC_INLINE
+void
+cos_atomic_store_ptr_release(void * COS_Nullable *pointer,
+                             void * COS_Nullable desired)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    __atomic_store_n(pointer, desired, __ATOMIC_RELEASE);
+#elif defined(_MSC_VER)
+    _ReadWriteBarrier();
+    *(void * volatile *)pointer = desired;
+#else
+    *pointer = desired;
+#endif
+}
+
+/**
+ * @brief Stores @p desired in a pointer if it is @c NULL, with acquire-release ordering.
+ *
+ * @return @c true if the pointer was stored, @c false if it was already set.
+ */
+COS_STATIC_INLINE
+bool
+cos_atomic_publish_ptr(void * COS_Nullable *pointer,
+                       void *desired)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    void *expected = NULL;
+    return __atomic_compare_exchange_n(pointer,
+                                       &expected,
+                                       desired,
+                                       false,
+                                       __ATOMIC_ACQ_REL,
+                                       __ATOMIC_ACQUIRE);
+#elif defined(_MSC_VER)
+    return _InterlockedCompareExchangePointer(pointer, desired, NULL) == NULL;
+#else
+    if (*pointer) {
+        return false;
+    }
+    *pointer = desired;
+    return true;
+#endif
+}
+
+/**
+ * @brief Orders the loads and stores after the fence after the loads of earlier atomic
+ * operations.
+ */
+COS_STATIC_INLINE
+void
+cos_atomic_fence_acquire(void)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+#elif defined(_MSC_VER)
+    _ReadWriteBarrier();
+#endif
+}
+
+// MARK: - Reference counts
+
+/*
+ * Reference counts use atomic operations if the library is built with
+ * COS_ENABLE_ATOMIC_REF_COUNTS, so that objects can be retained and released from multiple
+ * threads. Otherwise they are plain integer operations.
+ *
+ * An increment can be relaxed, as a new reference can only be made from an existing one. The
+ * decrement that drops the last reference must see every write that was made through the
+ * other references, hence the release decrement and the acquire fence before deallocation.
+ */
+
+/**
+ * @brief Increments a reference count.
+ */
+COS_STATIC_INLINE
+void
+cos_ref_count_increment(unsigned int *count)
+{
+#if COS_ATOMIC_REF_COUNTS
+    (void)cos_atomic_fetch_add_relaxed(count, 1);
+#else
+    (*count)++;
+#endif
+}
+
+/**
+ * @brief Decrements a reference count.
+ *
+ * @param count The reference count.
+ * @param count_mask The bits of @p count that hold the count, with any others used as flags.
+ *
+ * @return @c true if the last reference was released, @c false otherwise.
+ */
+COS_STATIC_INLINE
+bool
+cos_ref_count_decrement(unsigned int *count,
+                        unsigned int count_mask)
+{
+#if COS_ATOMIC_REF_COUNTS
+    if ((cos_atomic_fetch_sub_release(count, 1) & count_mask) != 1) {
+        return false;
+    }
+    cos_atomic_fence_acquire();
+    return true;
+#else
+    return ((--(*count) & count_mask) == 0);
+#endif
+}
+
+/**
+ * @brief Loads a reference count.
+ */
+COS_STATIC_INLINE
+unsigned int
+cos_ref_count_load(const unsigned int *count)
+{
+#if COS_ATOMIC_REF_COUNTS
+    return cos_atomic_load_relaxed(count);
+#else
+    return *count;
+#endif
+}
+
+COS_ASSUME_NONNULL_END
+COS_DECLS_END
+
+#endif /* LIBCOS_COMMON_COS_ATOMIC_H */
@@ -5,8 +5,10 @@
 #include "libcos/common/CosData.h"
 
 #include "common/Assert.h"
+#include "common/CosHash.h"
 
 #include <libcos/common/CosError.h>
+#include <libcos/common/memory/CosMemory.h>
 
 #include <stdlib.h>
 #include <string.h>
@@ -21,33 +23,41 @@ cos_data_resize_(CosData *data,
 // MARK: - Public
 
 CosData * COS_Nullable
-cos_data_alloc(size_t capacity_hint)
+cos_data_alloc(CosAllocator * COS_Nullable allocator,
+               size_t capacity_hint)
 {
     CosData *data = NULL;
     unsigned char *bytes = NULL;
 
-    data = malloc(sizeof(CosData));
+    data = cos_alloc(allocator, sizeof(CosData));
     if (!data) {
         goto failure;
     }
 
-    bytes = malloc(capacity_hint);
-    if (!bytes) {
-        goto failure;
+    size_t capacity = COS_DATA_INLINE_CAPACITY;
+    if (capacity_hint <= COS_DATA_INLINE_CAPACITY) {
+        bytes = data->inline_bytes;
+    }
+    else {
+        capacity = capacity_hint;
+        bytes = cos_alloc(allocator, capacity);
+        if (!bytes) {
+            goto failure;
+        }
     }
 
     data->bytes = bytes;
     data->size = 0;
-    data->capacity = capacity_hint;
+    data->capacity = capacity;
+    data->allocator = allocator;
+    data->hash = 0;
+    data->has_hash = false;
 
     return data;
 
 failure:
     if (data) {
-        free(data);
-    }
-    if (bytes) {
-        free(bytes);
+        cos_free(allocator, data);
     }
     return NULL;
 }
@@ -59,8 +69,12 @@ cos_data_free(CosData *data)
         return;
     }
 
-    free(data->bytes);
-    free(data);
+    CosAllocator * const allocator = data->allocator;
+
+    if (data->bytes != data->inline_bytes) {
+        cos_free(allocator, data->bytes);
+    }
+    cos_free(allocator, data);
 }
 
 CosData *
@@ -72,7 +86,8 @@ cos_data_copy(const CosData *source,
         return NULL;
     }
 
-    CosData * const copy = cos_data_alloc(source->size);
+    CosData * const copy = cos_data_alloc(source->allocator,
+                                          source->size);
     if (!copy) {
         goto failure;
     }
@@ -87,6 +102,8 @@ cos_data_copy(const CosData *source,
            source->bytes,
            source->size);
     copy->size = source->size;
+    copy->hash = source->hash;
+    copy->has_hash = source->has_hash;
 
     return copy;
 
@@ -143,6 +160,7 @@ cos_data_reset(CosData *data)
     }
 
     data->size = 0;
+    data->has_hash = false;
 
     return true;
 }
@@ -175,6 +193,7 @@ cos_data_append(CosData *data,
             bytes,
             count);
     data->size += count;
+    data->has_hash = false;
 
     return true;
 }
@@ -192,6 +211,24 @@ cos_data_push_back(CosData *data,
     return cos_data_append(data, &byte, 1, error);
 }
 
+size_t
+cos_data_get_hash(const CosData *data)
+{
+    COS_API_PARAM_CHECK(data != NULL);
+    if (!data) {
+        return 0;
+    }
+
+    if (!data->has_hash) {
+        // The cache is not part of the data object's observable state.
+        CosData * const mutable_data = (CosData *)data;
+        mutable_data->hash = cos_hash_bytes(data->bytes, data->size);
+        mutable_data->has_hash = true;
+    }
+
+    return data->hash;
+}
+
 // MARK: Data reference
 
 CosDataRef
@@ -221,10 +258,24 @@ cos_data_resize_(CosData *data,
         return true;
     }
 
-    const size_t new_capacity = required_capacity;
+    // Grow geometrically so that appending a byte at a time takes amortized constant time.
+    size_t new_capacity = data->capacity * 2;
+    if (new_capacity < required_capacity || new_capacity < data->capacity) {
+        new_capacity = required_capacity;
+    }
 
-    unsigned char * const new_bytes = realloc(data->bytes,
-                                              new_capacity);
+    unsigned char *new_bytes = NULL;
+    if (data->bytes == data->inline_bytes) {
+        new_bytes = cos_alloc(data->allocator, new_capacity);
+        if (new_bytes) {
+            memcpy(new_bytes, data->bytes, data->size);
+        }
+    }
+    else {
+        new_bytes = cos_realloc(data->allocator,
+                                data->bytes,
+                                new_capacity);
+    }
     if (!new_bytes) {
         COS_ERROR_PROPAGATE(cos_error_make(COS_ERROR_MEMORY,
                                            "Failed to allocate memory for data buffer"),
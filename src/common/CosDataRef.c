@@ -4,6 +4,8 @@
 
 #include "libcos/common/CosDataRef.h"
 
+#include "common/CosHash.h"
+
 COS_ASSUME_NONNULL_BEGIN
 
 CosDataRef
@@ -16,4 +18,12 @@ cos_data_ref_make(const unsigned char * COS_Nullable bytes,
     };
 }
 
+size_t
+cos_data_ref_get_hash(CosDataRef data_ref)
+{
+    const size_t size = data_ref.bytes ? data_ref.size : 0;
+
+    return cos_hash_bytes(data_ref.bytes, size);
+}
+
 COS_ASSUME_NONNULL_END
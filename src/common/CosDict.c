@@ -5,46 +5,132 @@
 #include "libcos/common/CosDict.h"
 
 #include "common/Assert.h"
-#include "common/CosContainerUtils.h"
 
+#include <libcos/common/memory/CosMemory.h>
+
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define COS_DICT_USE_SSE2 1
+#else
+    #define COS_DICT_USE_SSE2 0
+#endif
+
 COS_ASSUME_NONNULL_BEGIN
 
+/*
+ * The dictionary is an open-addressed table in the style of SwissTable.
+ *
+ * Each slot has a one-byte control tag next to it in a separate array: either a sentinel
+ * (empty or deleted), or the low 7 bits of the key's hash. Probing visits groups of
+ * @c COS_DICT_GROUP_WIDTH consecutive control bytes, which are compared against the tag all
+ * at once, so keys are only compared for slots whose tag matches. The control array is
+ * padded with a copy of its first group so that a group load never has to wrap around.
+ */
+
+// MARK: - Control bytes
+
+typedef uint8_t CosDictCtrl;
+
+enum {
+    COS_DICT_CTRL_EMPTY = 0x80,
+    COS_DICT_CTRL_DELETED = 0xFE,
+};
+
+enum {
+    COS_DICT_GROUP_WIDTH = 16,
+    COS_DICT_MIN_CAPACITY = 16,
+};
+
 typedef struct CosDictEntry {
     void * COS_Nullable key;
     void * COS_Nullable value;
 } CosDictEntry;
 
 struct CosDict {
+    /**
+     * The control bytes, @c capacity + @c COS_DICT_GROUP_WIDTH of them.
+     */
+    CosDictCtrl *ctrl;
+
     CosDictEntry *entries;
+
+    /**
+     * The number of slots. Always a power of two.
+     */
     size_t capacity;
 
     size_t count;
 
+    /**
+     * The number of deleted slots.
+     */
+    size_t tombstone_count;
+
     CosDictKeyCallbacks key_callbacks;
     CosDictValueCallbacks value_callbacks;
+
+    CosAllocator * COS_Nullable allocator;
 };
 
+/**
+ * A bit mask with one bit per slot in a group.
+ */
+typedef uint32_t CosDictGroupMask;
+
 COS_STATIC_INLINE
 size_t
 cos_dict_hash_(const CosDict *dict,
                void *key);
 
+COS_STATIC_INLINE
+size_t
+cos_dict_mix_hash_(size_t hash);
+
+COS_STATIC_INLINE
+bool
+cos_dict_alloc_table_(CosAllocator * COS_Nullable allocator,
+                      size_t capacity,
+                      CosDictCtrl * COS_Nullable * COS_Nonnull out_ctrl,
+                      CosDictEntry * COS_Nullable * COS_Nonnull out_entries);
+
+COS_STATIC_INLINE
+bool
+cos_dict_resize_(CosDict *dict,
+                 size_t new_capacity);
+
 COS_STATIC_INLINE
 bool
-cos_dict_grow_(CosDict *dict,
-               size_t new_capacity);
+cos_dict_make_room_(CosDict *dict);
 
 COS_STATIC_INLINE
-CosDictEntry *
-cos_dict_find_entry_(const CosDict *dict,
+size_t
+cos_dict_find_index_(const CosDict *dict,
                      void *key,
-                     size_t hash);
+                     size_t mixed_hash,
+                     size_t * COS_Nullable out_insert_index);
+
+COS_STATIC_INLINE
+size_t
+cos_dict_find_insert_index_(const CosDict *dict,
+                            size_t mixed_hash);
+
+COS_STATIC_INLINE
+void
+cos_dict_set_ctrl_(CosDict *dict,
+                   size_t index,
+                   CosDictCtrl ctrl);
+
+COS_STATIC_INLINE
+size_t
+cos_dict_capacity_for_count_(size_t count);
 
 CosDict *
-cos_dict_create(const CosDictKeyCallbacks *key_callbacks,
+cos_dict_create(CosAllocator * COS_Nullable allocator,
+                const CosDictKeyCallbacks *key_callbacks,
                 const CosDictValueCallbacks *value_callbacks,
                 size_t capacity_hint)
 {
@@ -55,34 +141,36 @@ cos_dict_create(const CosDictKeyCallbacks *key_callbacks,
     }
 
     CosDict *dict = NULL;
+    CosDictCtrl *ctrl = NULL;
     CosDictEntry *entries = NULL;
 
-    dict = calloc(1, sizeof(CosDict));
+    dict = cos_calloc(allocator, 1, sizeof(CosDict));
     if (!dict) {
         goto failure;
     }
 
+    dict->allocator = allocator;
     dict->key_callbacks = *key_callbacks;
     dict->value_callbacks = *value_callbacks;
 
-    const size_t capacity = cos_container_round_capacity_(capacity_hint);
+    const size_t capacity = cos_dict_capacity_for_count_(capacity_hint);
+    if (capacity == 0) {
+        goto failure;
+    }
 
-    entries = calloc(capacity, sizeof(CosDictEntry));
-    if (!entries) {
+    if (!cos_dict_alloc_table_(allocator, capacity, &ctrl, &entries)) {
         goto failure;
     }
 
-    dict->entries = entries;
+    dict->ctrl = COS_nonnull_cast(ctrl);
+    dict->entries = COS_nonnull_cast(entries);
     dict->capacity = capacity;
 
     return dict;
 
 failure:
     if (dict) {
-        free(dict);
-    }
-    if (entries) {
-        free(entries);
+        cos_free(allocator, dict);
     }
     return NULL;
 }
@@ -98,20 +186,29 @@ cos_dict_destroy(CosDict *dict)
     const CosDictReleaseCallback release_key = dict->key_callbacks.release;
     const CosDictReleaseCallback release_value = dict->value_callbacks.release;
 
-    for (size_t i = 0; i < dict->capacity; i++) {
-        CosDictEntry * const entry = &dict->entries[i];
+    if (release_key || release_value) {
+        for (size_t i = 0; i < dict->capacity; i++) {
+            if (dict->ctrl[i] & COS_DICT_CTRL_EMPTY) {
+                continue;
+            }
 
-        if (entry->key && release_key) {
-            release_key(COS_nonnull_cast(entry->key));
-        }
-        if (entry->value && release_value) {
-            release_value(COS_nonnull_cast(entry->value));
+            CosDictEntry * const entry = &dict->entries[i];
+
+            if (release_key) {
+                release_key(COS_nonnull_cast(entry->key));
+            }
+            if (entry->value && release_value) {
+                release_value(COS_nonnull_cast(entry->value));
+            }
         }
     }
 
-    free(dict->entries);
+    CosAllocator * const allocator = dict->allocator;
 
-    free(dict);
+    cos_free(allocator, dict->ctrl);
+    cos_free(allocator, dict->entries);
+
+    cos_free(allocator, dict);
 }
 
 size_t
@@ -140,14 +237,14 @@ cos_dict_get(CosDict *dict,
 
     (void)out_error;
 
-    const size_t hash = cos_dict_hash_(dict, key);
+    const size_t mixed_hash = cos_dict_mix_hash_(cos_dict_hash_(dict, key));
 
-    CosDictEntry * const entry = cos_dict_find_entry_(dict, key, hash);
-    if (!entry || entry->key == NULL) {
+    const size_t index = cos_dict_find_index_(dict, key, mixed_hash, NULL);
+    if (index == SIZE_MAX) {
         return false;
     }
 
-    *out_value = entry->value;
+    *out_value = dict->entries[index].value;
 
     return true;
 }
@@ -167,41 +264,222 @@ cos_dict_set(CosDict *dict,
 
     (void)error;
 
-    if (dict->count >= (dict->capacity / 4) * 3) {
-        const size_t new_capacity = cos_container_round_capacity_(dict->capacity + 1);
-        if (!cos_dict_grow_(dict,
-                            new_capacity)) {
-            return false;
+    const size_t mixed_hash = cos_dict_mix_hash_(cos_dict_hash_(dict, key));
+
+    const CosDictRetainCallback retain_key = dict->key_callbacks.retain;
+    const CosDictRetainCallback retain_value = dict->value_callbacks.retain;
+
+    size_t index = SIZE_MAX;
+    const size_t existing_index = cos_dict_find_index_(dict, key, mixed_hash, &index);
+    if (existing_index != SIZE_MAX) {
+        CosDictEntry * const entry = &dict->entries[existing_index];
+
+        // Take the new references before dropping the old ones, in case they are the same
+        // objects.
+        if (retain_key) {
+            retain_key(key);
+        }
+        if (retain_value) {
+            retain_value(value);
         }
-    }
 
-    const size_t hash = cos_dict_hash_(dict, key);
+        void * const old_key = COS_nonnull_cast(entry->key);
+        void * const old_value = entry->value;
 
-    CosDictEntry * const entry = cos_dict_find_entry_(dict, key, hash);
-    if (!entry) {
-        return false;
+        entry->key = key;
+        entry->value = value;
+
+        const CosDictReleaseCallback release_key = dict->key_callbacks.release;
+        if (release_key) {
+            release_key(old_key);
+        }
+        const CosDictReleaseCallback release_value = dict->value_callbacks.release;
+        if (old_value && release_value) {
+            release_value(COS_nonnull_cast(old_value));
+        }
+
+        return true;
     }
 
-    const bool is_new = (entry->key == NULL);
-    if (is_new) {
-        dict->count++;
+    const size_t capacity = dict->capacity;
+    if (dict->count + dict->tombstone_count + 1 > capacity - (capacity / 8)) {
+        if (!cos_dict_make_room_(dict)) {
+            return false;
+        }
+        index = cos_dict_find_insert_index_(dict, mixed_hash);
     }
 
-    const CosDictReleaseCallback retain_key = dict->key_callbacks.retain;
+    COS_ASSERT(index != SIZE_MAX, "Expected an insertion slot");
+    if (dict->ctrl[index] == COS_DICT_CTRL_DELETED) {
+        dict->tombstone_count--;
+    }
+    cos_dict_set_ctrl_(dict, index, (CosDictCtrl)(mixed_hash & 0x7F));
+
     if (retain_key) {
         retain_key(key);
     }
-    const CosDictRetainCallback retain_value = dict->value_callbacks.retain;
     if (retain_value) {
         retain_value(value);
     }
 
-    entry->key = key;
-    entry->value = value;
+    dict->entries[index].key = key;
+    dict->entries[index].value = value;
+    dict->count++;
+
+    return true;
+}
+
+bool
+cos_dict_remove(CosDict *dict,
+                void *key,
+                CosError * COS_Nullable out_error)
+{
+    COS_API_PARAM_CHECK(dict != NULL);
+    COS_API_PARAM_CHECK(key != NULL);
+    if (COS_UNLIKELY(!dict || !key)) {
+        return false;
+    }
+
+    (void)out_error;
+
+    const size_t mixed_hash = cos_dict_mix_hash_(cos_dict_hash_(dict, key));
+
+    const size_t index = cos_dict_find_index_(dict, key, mixed_hash, NULL);
+    if (index == SIZE_MAX) {
+        return false;
+    }
+
+    CosDictEntry * const entry = &dict->entries[index];
+    void * const old_key = COS_nonnull_cast(entry->key);
+    void * const old_value = entry->value;
+
+    entry->key = NULL;
+    entry->value = NULL;
+    cos_dict_set_ctrl_(dict, index, COS_DICT_CTRL_DELETED);
+    dict->count--;
+    dict->tombstone_count++;
+
+    const CosDictReleaseCallback release_key = dict->key_callbacks.release;
+    if (release_key) {
+        release_key(old_key);
+    }
+    const CosDictReleaseCallback release_value = dict->value_callbacks.release;
+    if (old_value && release_value) {
+        release_value(COS_nonnull_cast(old_value));
+    }
 
     return true;
 }
 
+// MARK: - Group matching
+
+COS_STATIC_INLINE
+unsigned int
+cos_dict_ctz_(CosDictGroupMask mask)
+{
+    // The mask must be non-zero.
+#if COS_HAS_BUILTIN(__builtin_ctz)
+    return (unsigned int)__builtin_ctz(mask);
+#else
+    unsigned int count = 0;
+    while ((mask & 1) == 0) {
+        mask >>= 1;
+        count++;
+    }
+    return count;
+#endif
+}
+
+/**
+ * Returns a mask of the slots in the group at @a group whose control byte equals @a tag.
+ */
+COS_STATIC_INLINE
+CosDictGroupMask
+cos_dict_group_match_(const CosDictCtrl *group,
+                      CosDictCtrl tag)
+{
+#if COS_DICT_USE_SSE2
+    const __m128i ctrl = _mm_loadu_si128((const __m128i *)(const void *)group);
+    const __m128i match = _mm_cmpeq_epi8(ctrl, _mm_set1_epi8((char)tag));
+    return (CosDictGroupMask)_mm_movemask_epi8(match);
+#else
+    CosDictGroupMask mask = 0;
+    for (unsigned int i = 0; i < COS_DICT_GROUP_WIDTH; i++) {
+        if (group[i] == tag) {
+            mask |= (CosDictGroupMask)1 << i;
+        }
+    }
+    return mask;
+#endif
+}
+
+/**
+ * Returns a mask of the slots in the group at @a group that are empty or deleted.
+ */
+COS_STATIC_INLINE
+CosDictGroupMask
+cos_dict_group_match_empty_or_deleted_(const CosDictCtrl *group)
+{
+#if COS_DICT_USE_SSE2
+    // Both sentinels have the high bit set, and full slots never do.
+    const __m128i ctrl = _mm_loadu_si128((const __m128i *)(const void *)group);
+    return (CosDictGroupMask)_mm_movemask_epi8(ctrl);
+#else
+    CosDictGroupMask mask = 0;
+    for (unsigned int i = 0; i < COS_DICT_GROUP_WIDTH; i++) {
+        if (group[i] & COS_DICT_CTRL_EMPTY) {
+            mask |= (CosDictGroupMask)1 << i;
+        }
+    }
+    return mask;
+#endif
+}
+
+// MARK: - Lookup
+
+bool
+cos_dict_get_matching(const CosDict *dict,
+                      size_t hash,
+                      CosDictMatchKeyCallback match_key,
+                      const void *context,
+                      void * COS_Nullable * COS_Nonnull out_value)
+{
+    COS_API_PARAM_CHECK(dict != NULL);
+    COS_API_PARAM_CHECK(match_key != NULL);
+    COS_API_PARAM_CHECK(out_value != NULL);
+    if (COS_UNLIKELY(!dict || !match_key || !out_value)) {
+        return false;
+    }
+
+    const size_t mixed_hash = cos_dict_mix_hash_(hash);
+    const CosDictCtrl tag = (CosDictCtrl)(mixed_hash & 0x7F);
+    const size_t mask = dict->capacity - 1;
+
+    size_t position = (mixed_hash >> 7) & mask;
+    size_t stride = 0;
+    while (true) {
+        const CosDictCtrl * const group = dict->ctrl + position;
+
+        CosDictGroupMask matches = cos_dict_group_match_(group, tag);
+        while (matches) {
+            const size_t index = (position + cos_dict_ctz_(matches)) & mask;
+            const CosDictEntry * const entry = &dict->entries[index];
+            if (match_key(COS_nonnull_cast(entry->key), context)) {
+                *out_value = entry->value;
+                return true;
+            }
+            matches &= matches - 1;
+        }
+
+        if (cos_dict_group_match_(group, COS_DICT_CTRL_EMPTY)) {
+            return false;
+        }
+
+        stride += COS_DICT_GROUP_WIDTH;
+        position = (position + stride) & mask;
+    }
+}
+
 // MARK: - Iterator
 
 CosDictIterator
@@ -231,10 +509,11 @@ cos_dict_iterator_next(CosDictIterator *iterator,
     const size_t capacity = dict->capacity;
 
     while (iterator->index < capacity) {
-        CosDictEntry * const entry = &dict->entries[iterator->index];
+        const size_t index = iterator->index;
         iterator->index++;
 
-        if (entry->key != NULL) {
+        if ((dict->ctrl[index] & COS_DICT_CTRL_EMPTY) == 0) {
+            CosDictEntry * const entry = &dict->entries[index];
             *out_key = entry->key;
             *out_value = entry->value;
             return true;
@@ -246,78 +525,203 @@ cos_dict_iterator_next(CosDictIterator *iterator,
 
 // MARK: - Private
 
+COS_STATIC_INLINE
+size_t
+cos_dict_capacity_for_count_(size_t count)
+{
+    // Keep the table at most 7/8 full.
+    if (count > (SIZE_MAX / 8)) {
+        return 0;
+    }
+    const size_t min_capacity = count + (count / 7) + 1;
+
+    size_t capacity = COS_DICT_MIN_CAPACITY;
+    while (capacity < min_capacity) {
+        capacity *= 2;
+    }
+    return capacity;
+}
+
 COS_STATIC_INLINE
 bool
-cos_dict_grow_(CosDict *dict,
-               size_t new_capacity)
+cos_dict_alloc_table_(CosAllocator * COS_Nullable allocator,
+                      size_t capacity,
+                      CosDictCtrl * COS_Nullable * COS_Nonnull out_ctrl,
+                      CosDictEntry * COS_Nullable * COS_Nonnull out_entries)
+{
+    COS_PARAM_ASSERT_INTERNAL(capacity >= COS_DICT_MIN_CAPACITY);
+
+    CosDictCtrl * const ctrl = cos_alloc(allocator, capacity + COS_DICT_GROUP_WIDTH);
+    if (!ctrl) {
+        return false;
+    }
+    CosDictEntry * const entries = cos_calloc(allocator, capacity, sizeof(CosDictEntry));
+    if (!entries) {
+        cos_free(allocator, ctrl);
+        return false;
+    }
+
+    memset(ctrl, COS_DICT_CTRL_EMPTY, capacity + COS_DICT_GROUP_WIDTH);
+
+    *out_ctrl = ctrl;
+    *out_entries = entries;
+    return true;
+}
+
+COS_STATIC_INLINE
+bool
+cos_dict_make_room_(CosDict *dict)
 {
     COS_PARAM_ASSERT_INTERNAL(dict != NULL);
-    COS_PARAM_ASSERT_INTERNAL(new_capacity > dict->capacity);
 
-    CosDictEntry *new_entries = NULL;
+    const size_t capacity = dict->capacity;
 
-    new_entries = calloc(new_capacity, sizeof(CosDictEntry));
-    if (COS_UNLIKELY(!new_entries)) {
-        goto failure;
+    // If enough of the load is tombstones, rehashing at the same size reclaims them.
+    // Otherwise double the table.
+    size_t new_capacity = capacity;
+    if (dict->count + 1 > capacity / 2) {
+        if (capacity > SIZE_MAX / 2) {
+            return false;
+        }
+        new_capacity = capacity * 2;
+    }
+
+    return cos_dict_resize_(dict, new_capacity);
+}
+
+COS_STATIC_INLINE
+bool
+cos_dict_resize_(CosDict *dict,
+                 size_t new_capacity)
+{
+    COS_PARAM_ASSERT_INTERNAL(dict != NULL);
+    COS_PARAM_ASSERT_INTERNAL(new_capacity >= dict->count);
+
+    CosDictCtrl *new_ctrl = NULL;
+    CosDictEntry *new_entries = NULL;
+    if (!cos_dict_alloc_table_(dict->allocator, new_capacity, &new_ctrl, &new_entries)) {
+        return false;
     }
 
+    CosDictCtrl * const old_ctrl = dict->ctrl;
     CosDictEntry * const old_entries = dict->entries;
     const size_t old_capacity = dict->capacity;
 
-    dict->entries = new_entries;
+    dict->ctrl = COS_nonnull_cast(new_ctrl);
+    dict->entries = COS_nonnull_cast(new_entries);
     dict->capacity = new_capacity;
+    dict->tombstone_count = 0;
 
-    // Copy all the old entries to the new array.
+    // Move all the live entries to the new table.
     for (size_t i = 0; i < old_capacity; i++) {
-        CosDictEntry * const old_entry = &old_entries[i];
-
-        if (old_entry->key == NULL) {
-            // Empty entry - skip.
+        if (old_ctrl[i] & COS_DICT_CTRL_EMPTY) {
             continue;
         }
 
-        const size_t hash = cos_dict_hash_(dict, COS_nonnull_cast(old_entry->key));
+        CosDictEntry * const old_entry = &old_entries[i];
 
-        CosDictEntry * const new_entry = cos_dict_find_entry_(dict,
-                                                              COS_nonnull_cast(old_entry->key),
-                                                              hash);
-        new_entry->key = old_entry->key;
-        new_entry->value = old_entry->value;
+        const size_t mixed_hash = cos_dict_mix_hash_(cos_dict_hash_(dict,
+                                                                    COS_nonnull_cast(old_entry->key)));
+        const size_t index = cos_dict_find_insert_index_(dict, mixed_hash);
+
+        cos_dict_set_ctrl_(dict, index, (CosDictCtrl)(mixed_hash & 0x7F));
+        dict->entries[index] = *old_entry;
     }
 
-    free(old_entries);
+    cos_free(dict->allocator, old_ctrl);
+    cos_free(dict->allocator, old_entries);
 
     return true;
-
-failure:
-    if (new_entries) {
-        free(new_entries);
-    }
-    return false;
 }
 
+/**
+ * Returns the slot of @a key, or @c SIZE_MAX if it is not in the table.
+ *
+ * If @a out_insert_index is not @c NULL and the key is not found, it receives the first
+ * empty or deleted slot on the probe sequence, where the key can be inserted.
+ */
 COS_STATIC_INLINE
-CosDictEntry *
-cos_dict_find_entry_(const CosDict *dict,
+size_t
+cos_dict_find_index_(const CosDict *dict,
                      void *key,
-                     size_t hash)
+                     size_t mixed_hash,
+                     size_t * COS_Nullable out_insert_index)
 {
     COS_PARAM_ASSERT_INTERNAL(dict != NULL);
     COS_PARAM_ASSERT_INTERNAL(key != NULL);
 
-    const size_t capacity = dict->capacity;
     const CosDictEqualValuesCallback key_equal = dict->key_callbacks.equal;
+    const CosDictCtrl tag = (CosDictCtrl)(mixed_hash & 0x7F);
+    const size_t mask = dict->capacity - 1;
 
-    size_t index = hash % capacity;
+    size_t position = (mixed_hash >> 7) & mask;
+    size_t stride = 0;
     while (true) {
-        CosDictEntry * const entry = &dict->entries[index];
+        const CosDictCtrl * const group = dict->ctrl + position;
+
+        CosDictGroupMask matches = cos_dict_group_match_(group, tag);
+        while (matches) {
+            const size_t index = (position + cos_dict_ctz_(matches)) & mask;
+            void * const entry_key = COS_nonnull_cast(dict->entries[index].key);
+            if (entry_key == key || key_equal(entry_key, key)) {
+                return index;
+            }
+            matches &= matches - 1;
+        }
+
+        if (out_insert_index && *out_insert_index == SIZE_MAX) {
+            const CosDictGroupMask available = cos_dict_group_match_empty_or_deleted_(group);
+            if (available) {
+                *out_insert_index = (position + cos_dict_ctz_(available)) & mask;
+            }
+        }
+
+        if (cos_dict_group_match_(group, COS_DICT_CTRL_EMPTY)) {
+            return SIZE_MAX;
+        }
+
+        // Triangular probing visits every group when the capacity is a power of two.
+        stride += COS_DICT_GROUP_WIDTH;
+        position = (position + stride) & mask;
+    }
+}
 
-        if (entry->key == NULL || key_equal(COS_nonnull_cast(entry->key),
-                                            key)) {
-            return entry;
+COS_STATIC_INLINE
+size_t
+cos_dict_find_insert_index_(const CosDict *dict,
+                            size_t mixed_hash)
+{
+    COS_PARAM_ASSERT_INTERNAL(dict != NULL);
+
+    const size_t mask = dict->capacity - 1;
+
+    size_t position = (mixed_hash >> 7) & mask;
+    size_t stride = 0;
+    while (true) {
+        const CosDictGroupMask available = cos_dict_group_match_empty_or_deleted_(dict->ctrl + position);
+        if (available) {
+            return (position + cos_dict_ctz_(available)) & mask;
         }
 
-        index = (index + 1) % capacity;
+        stride += COS_DICT_GROUP_WIDTH;
+        position = (position + stride) & mask;
+    }
+}
+
+COS_STATIC_INLINE
+void
+cos_dict_set_ctrl_(CosDict *dict,
+                   size_t index,
+                   CosDictCtrl ctrl)
+{
+    COS_PARAM_ASSERT_INTERNAL(dict != NULL);
+    COS_PARAM_ASSERT_INTERNAL(index < dict->capacity);
+
+    dict->ctrl[index] = ctrl;
+
+    // Keep the trailing copy of the first group in sync.
+    if (index < COS_DICT_GROUP_WIDTH) {
+        dict->ctrl[dict->capacity + index] = ctrl;
     }
 }
 
@@ -336,4 +740,17 @@ cos_dict_hash_(const CosDict *dict,
     return (size_t)key;
 }
 
+COS_STATIC_INLINE
+size_t
+cos_dict_mix_hash_(size_t hash)
+{
+    // Pointer and object-number keys have poor low and high bits, and the table takes the
+    // slot from the high bits and the tag from the low 7. Spread the entropy across both.
+    uint64_t value = (uint64_t)hash;
+    value ^= value >> 33;
+    value *= UINT64_C(0xFF51AFD7ED558CCD);
+    value ^= value >> 33;
+    return (size_t)value;
+}
+
 COS_ASSUME_NONNULL_END
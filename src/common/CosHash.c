@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2024 OpenCOS.
+ */
+
+#include "common/CosHash.h"
+
+#include <stdint.h>
+#include <string.h>
+
+COS_ASSUME_NONNULL_BEGIN
+
+/*
+ * A hash in the style of wyhash: the input is read in 64-bit words, and each pair of words is
+ * folded into the state with a 64 x 64 -> 128-bit multiply whose halves are xor-ed together.
+ */
+
+#define COS_HASH_SEED UINT64_C(0xA0761D6478BD642F)
+#define COS_HASH_P1 UINT64_C(0xE7037ED1A0B428DB)
+#define COS_HASH_P2 UINT64_C(0x8EBC6AF09C88C6E3)
+
+COS_STATIC_INLINE
+uint64_t
+cos_hash_mix_(uint64_t lhs,
+              uint64_t rhs)
+{
+#if defined(__SIZEOF_INT128__)
+    __extension__ typedef unsigned __int128 CosHashUInt128;
+    const CosHashUInt128 product = (CosHashUInt128)lhs * rhs;
+    return (uint64_t)product ^ (uint64_t)(product >> 64);
+#else
+    const uint64_t lhs_hi = lhs >> 32;
+    const uint64_t lhs_lo = (uint32_t)lhs;
+    const uint64_t rhs_hi = rhs >> 32;
+    const uint64_t rhs_lo = (uint32_t)rhs;
+
+    const uint64_t hi_hi = lhs_hi * rhs_hi;
+    const uint64_t hi_lo = lhs_hi * rhs_lo;
+    const uint64_t lo_hi = lhs_lo * rhs_hi;
+    const uint64_t lo_lo = lhs_lo * rhs_lo;
+
+    const uint64_t cross = (lo_lo >> 32) + (uint32_t)hi_lo + lo_hi;
+    const uint64_t hi = hi_hi + (hi_lo >> 32) + (cross >> 32);
+    const uint64_t lo = (cross << 32) | (uint32_t)lo_lo;
+    return lo ^ hi;
+#endif
+}
+
+COS_STATIC_INLINE
+uint64_t
+cos_hash_read64_(const unsigned char *bytes)
+{
+    uint64_t value;
+    memcpy(&value, bytes, sizeof(value));
+    return value;
+}
+
+COS_STATIC_INLINE
+uint64_t
+cos_hash_read32_(const unsigned char *bytes)
+{
+    uint32_t value;
+    memcpy(&value, bytes, sizeof(value));
+    return value;
+}
+
+size_t
+cos_hash_bytes(const void * COS_Nullable bytes,
+               size_t length)
+{
+    const unsigned char *p = bytes;
+    uint64_t state = COS_HASH_SEED ^ cos_hash_mix_(COS_HASH_SEED ^ (uint64_t)length, COS_HASH_P1);
+
+    uint64_t a = 0;
+    uint64_t b = 0;
+
+    if (length <= 16) {
+        if (length >= 4) {
+            // Two pairs of possibly overlapping 32-bit reads cover the whole input.
+            const size_t offset = (length >> 3) << 2;
+            a = (cos_hash_read32_(p) << 32) | cos_hash_read32_(p + offset);
+            b = (cos_hash_read32_(p + length - 4) << 32) | cos_hash_read32_(p + length - 4 - offset);
+        }
+        else if (length > 0) {
+            a = ((uint64_t)p[0] << 16) | ((uint64_t)p[length >> 1] << 8) | p[length - 1];
+        }
+    }
+    else {
+        size_t remaining = length;
+        while (remaining > 16) {
+            state = cos_hash_mix_(cos_hash_read64_(p) ^ COS_HASH_P1,
+                                  cos_hash_read64_(p + 8) ^ state);
+            p += 16;
+            remaining -= 16;
+        }
+        // The last 16 bytes, which may overlap with the previous block.
+        a = cos_hash_read64_(p + remaining - 16);
+        b = cos_hash_read64_(p + remaining - 8);
+    }
+
+    const uint64_t hash = cos_hash_mix_(COS_HASH_P1 ^ (uint64_t)length,
+                                        cos_hash_mix_(a ^ COS_HASH_P1, b ^ state ^ COS_HASH_P2));
+    return (size_t)hash;
+}
+
+COS_ASSUME_NONNULL_END
@@ -0,0 +1,35 @@
+/*
+ * Copyright (c) 2024 OpenCOS.
+ */
+
+#ifndef LIBCOS_COMMON_COS_HASH_H
+#define LIBCOS_COMMON_COS_HASH_H
+
+#include <libcos/common/CosDefines.h>
+
+#include <stddef.h>
+
+COS_DECLS_BEGIN
+COS_ASSUME_NONNULL_BEGIN
+
+/**
+ * @brief Hashes a sequence of bytes.
+ *
+ * The hash reads the input eight bytes at a time, so its cost grows with the length of the
+ * input much more slowly than a byte-wise hash. It is not a cryptographic hash, and its
+ * values may differ between platforms, so they should not be persisted.
+ *
+ * @param bytes The bytes to hash. May be @c NULL if @p length is 0.
+ * @param length The number of bytes.
+ *
+ * @return The hash of the bytes.
+ */
+size_t
+cos_hash_bytes(const void * COS_Nullable bytes,
+               size_t length)
+    COS_ATTR_PURE;
+
+COS_ASSUME_NONNULL_END
+COS_DECLS_END
+
+#endif /* LIBCOS_COMMON_COS_HASH_H */
@@ -5,20 +5,30 @@
 #include "libcos/common/CosString.h"
 
 #include "common/Assert.h"
+#include "common/CosHash.h"
 
-#include <libcos/io/string-support.h>
+#include <libcos/common/memory/CosMemory.h>
 
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 
-#define COS_STRING_DEFAULT_CAPACITY 32
+/**
+ * The number of characters, including the nul-terminator, that a string can store without
+ * a separate allocation.
+ *
+ * Most PDF names and keywords fit.
+ */
+#define COS_STRING_INLINE_CAPACITY 24
 
 COS_ASSUME_NONNULL_BEGIN
 
 struct CosString {
     /**
      * The nul-terminated character array.
+     *
+     * Points to @c inline_data while the string fits in it, or to a separately allocated
+     * buffer otherwise.
      */
     char *data;
 
@@ -37,8 +47,37 @@ struct CosString {
      * @endcode
      */
     size_t capacity;
+
+    /**
+     * The allocator used to allocate the string, or @c NULL for the default allocator.
+     */
+    CosAllocator * COS_Nullable allocator;
+
+    /**
+     * The cached hash of the string.
+     *
+     * Only valid if @c has_hash is @c true. Cleared whenever the contents change.
+     */
+    size_t hash;
+
+    /**
+     * Whether @c hash holds the hash of the current contents.
+     */
+    bool has_hash;
+
+    /**
+     * The storage for short strings.
+     */
+    char inline_data[COS_STRING_INLINE_CAPACITY];
 };
 
+COS_STATIC_INLINE
+bool
+cos_string_is_inline_(const CosString *string)
+{
+    return string->data == string->inline_data;
+}
+
 static bool
 cos_string_append_strn_impl_(CosString *string, const char *str, size_t n)
     COS_ATTR_ACCESS_READ_ONLY_SIZE(2, 3);
@@ -49,15 +88,21 @@ cos_string_ensure_capacity_(CosString *string, size_t required_capacity);
 static bool
 cos_string_resize_(CosString *string, size_t new_capacity);
 
+static bool
+cos_string_init_impl_(CosString *string,
+                      CosAllocator * COS_Nullable allocator,
+                      size_t capacity_hint);
+
 CosString *
-cos_string_alloc(size_t capacity_hint)
+cos_string_alloc(CosAllocator * COS_Nullable allocator,
+                 size_t capacity_hint)
 {
-    CosString * const string = malloc(sizeof(CosString));
+    CosString * const string = cos_alloc(allocator, sizeof(CosString));
     if (!string) {
         goto failure;
     }
 
-    if (!cos_string_init_capacity(string, capacity_hint)) {
+    if (!cos_string_init_impl_(string, allocator, capacity_hint)) {
         goto failure;
     }
 
@@ -65,47 +110,68 @@ cos_string_alloc(size_t capacity_hint)
 
 failure:
     if (string) {
-        free(string);
+        cos_free(allocator, string);
     }
     return NULL;
 }
 
 CosString *
-cos_string_alloc_with_str(const char *str)
+cos_string_alloc_with_str(CosAllocator * COS_Nullable allocator,
+                          const char *str)
 {
     if (!str) {
         return NULL;
     }
 
-    return cos_string_alloc_with_strn(str, strlen(str));
+    return cos_string_alloc_with_strn(allocator, str, strlen(str));
 }
 
 CosString *
-cos_string_alloc_with_strn(const char *str, size_t n)
+cos_string_alloc_with_strn(CosAllocator * COS_Nullable allocator,
+                           const char *str,
+                           size_t n)
 {
     if (!str) {
         return NULL;
     }
 
-    CosString * const string = malloc(sizeof(CosString));
+    CosString * const string = cos_alloc(allocator, sizeof(CosString));
     if (!string) {
         goto failure;
     }
 
-    char * const str_copy = cos_strndup(str, n);
-    if (!str_copy) {
-        goto failure;
+    // Stop at the first nul-terminator, if any.
+    const char * const nul = memchr(str, '\0', n);
+    const size_t length = nul ? (size_t)(nul - str) : n;
+
+    char *str_copy = NULL;
+    size_t capacity = 0;
+    if (length < COS_STRING_INLINE_CAPACITY) {
+        str_copy = string->inline_data;
+        capacity = COS_STRING_INLINE_CAPACITY;
+    }
+    else {
+        str_copy = cos_alloc(allocator, length + 1);
+        if (!str_copy) {
+            goto failure;
+        }
+        capacity = length + 1;
     }
+    memcpy(str_copy, str, length);
+    str_copy[length] = '\0';
 
     string->data = str_copy;
-    string->length = strlen(str_copy);
-    string->capacity = string->length + 1;
+    string->length = length;
+    string->capacity = capacity;
+    string->allocator = allocator;
+    string->hash = 0;
+    string->has_hash = false;
 
     return string;
 
 failure:
     if (string) {
-        free(string);
+        cos_free(allocator, string);
     }
     return NULL;
 }
@@ -117,9 +183,13 @@ cos_string_free(CosString *string)
         return;
     }
 
-    free(string->data);
+    CosAllocator * const allocator = string->allocator;
+
+    if (!cos_string_is_inline_(string)) {
+        cos_free(allocator, string->data);
+    }
 
-    free(string);
+    cos_free(allocator, string);
 }
 
 bool
@@ -138,19 +208,36 @@ cos_string_init_capacity(CosString *string, size_t capacity_hint)
         return false;
     }
 
-    size_t capacity = capacity_hint;
-    if (capacity == 0) {
-        capacity = COS_STRING_DEFAULT_CAPACITY;
-    }
+    return cos_string_init_impl_(string, NULL, capacity_hint);
+}
 
-    char * const data = malloc(capacity * sizeof(char));
-    if (!data) {
-        return false;
+static bool
+cos_string_init_impl_(CosString *string,
+                      CosAllocator * COS_Nullable allocator,
+                      size_t capacity_hint)
+{
+    COS_IMPL_PARAM_CHECK(string != NULL);
+
+    char *data = NULL;
+    size_t capacity = 0;
+    if (capacity_hint <= COS_STRING_INLINE_CAPACITY) {
+        data = string->inline_data;
+        capacity = COS_STRING_INLINE_CAPACITY;
+    }
+    else {
+        data = cos_alloc(allocator, capacity_hint * sizeof(char));
+        if (!data) {
+            return false;
+        }
+        capacity = capacity_hint;
     }
 
     string->data = data;
     string->length = 0;
     string->capacity = capacity;
+    string->allocator = allocator;
+    string->hash = 0;
+    string->has_hash = false;
 
     // Nul-terminate the string.
     string->data[string->length] = '\0';
@@ -199,7 +286,9 @@ cos_string_copy(const CosString *string)
         return NULL;
     }
 
-    return cos_string_alloc_with_strn(string->data, string->length);
+    return cos_string_alloc_with_strn(string->allocator,
+                                      string->data,
+                                      string->length);
 }
 
 CosStringRef
@@ -293,48 +382,6 @@ cos_string_push_back(CosString *string, char c)
     return cos_string_append_strn_impl_(string, &c, 1);
 }
 
-#if SIZE_MAX == UINT32_MAX
-    #define COS_SIZE_IS_32_BIT 1
-#else
-    #define COS_SIZE_IS_32_BIT 0
-#endif
-
-#if COS_SIZE_IS_32_BIT
-
-    #define COS_STRING_HASH_SEED_32 2166136261U
-    #define COS_STRING_HASH_FACTOR_32 16777619
-
-static uint32_t
-hash_string_32_(const char *key,
-                size_t length)
-{
-    uint32_t hash = COS_STRING_HASH_SEED_32;
-    for (size_t i = 0; i < length; i++) {
-        hash ^= (uint8_t)key[i];
-        hash *= COS_STRING_HASH_FACTOR_32;
-    }
-    return hash;
-}
-
-#else
-
-    #define COS_STRING_HASH_SEED_64 14695981039346656037ULL
-    #define COS_STRING_HASH_FACTOR_64 1099511628211ULL
-
-static uint64_t
-hash_string_64_(const char *key,
-                size_t length)
-{
-    uint64_t hash = COS_STRING_HASH_SEED_64;
-    for (size_t i = 0; i < length; i++) {
-        hash ^= (uint8_t)key[i];
-        hash *= COS_STRING_HASH_FACTOR_64;
-    }
-    return hash;
-}
-
-#endif
-
 size_t
 cos_string_get_hash(const CosString *string)
 {
@@ -344,12 +391,22 @@ cos_string_get_hash(const CosString *string)
         return 0;
     }
 
-    // Use the appropriate hash function based on the size of size_t.
-#if COS_SIZE_IS_32_BIT
-    return hash_string_32_(string->data, string->length);
-#else
-    return hash_string_64_(string->data, string->length);
-#endif
+    if (!string->has_hash) {
+        // The cache is not part of the string's observable state.
+        CosString * const mutable_string = (CosString *)string;
+        mutable_string->hash = cos_hash_bytes(string->data, string->length);
+        mutable_string->has_hash = true;
+    }
+
+    return string->hash;
+}
+
+size_t
+cos_string_ref_get_hash(CosStringRef string_ref)
+{
+    const size_t length = string_ref.data ? string_ref.length : 0;
+
+    return cos_hash_bytes(string_ref.data, length);
 }
 
 static bool
@@ -378,6 +435,7 @@ cos_string_append_strn_impl_(CosString *string, const char *str, size_t n)
         *dest = *str;
     }
     string->length += n;
+    string->has_hash = false;
 
     // Nul-terminate the string.
     string->data[string->length] = '\0';
@@ -418,15 +476,36 @@ cos_string_resize_(CosString *string, size_t new_capacity)
         new_length = new_capacity - 1;
     }
 
-    char * const new_data = realloc(string->data,
-                                    new_capacity * sizeof(char));
-    if (!new_data) {
-        return false;
+    char *new_data = NULL;
+    if (cos_string_is_inline_(string)) {
+        if (new_capacity <= COS_STRING_INLINE_CAPACITY) {
+            // The inline storage is already large enough.
+            new_data = string->data;
+            new_capacity = COS_STRING_INLINE_CAPACITY;
+        }
+        else {
+            new_data = cos_alloc(string->allocator, new_capacity * sizeof(char));
+            if (!new_data) {
+                return false;
+            }
+            memcpy(new_data, string->data, new_length);
+        }
+    }
+    else {
+        new_data = cos_realloc(string->allocator,
+                               string->data,
+                               new_capacity * sizeof(char));
+        if (!new_data) {
+            return false;
+        }
     }
     new_data[new_length] = '\0';
 
     string->data = new_data;
-    string->length = new_length;
+    if (new_length != string->length) {
+        string->length = new_length;
+        string->has_hash = false;
+    }
     string->capacity = new_capacity;
 
     // Nul-terminate the string.
@@ -0,0 +1,602 @@
+/*
+ * Copyright (c) 2025 OpenCOS.
+ */
+
+#include "common/CosTaskPool.h"
+
+#include "common/Assert.h"
+#include "common/CosThread.h"
+
+#include <libcos/common/memory/CosMemory.h>
+
+#include <string.h>
+
+COS_ASSUME_NONNULL_BEGIN
+
+enum {
+    /// The initial capacity of a deque.
+    COS_TASK_DEQUE_INITIAL_CAPACITY = 16,
+};
+
+typedef struct CosTask {
+    CosTaskFunc func;
+    void * COS_Nullable arg;
+    CosTaskGroup *group;
+} CosTask;
+
+/**
+ * A double-ended queue of tasks, stored in a ring buffer.
+ *
+ * The owner pushes and pops at the bottom; other threads steal from the top.
+ */
+typedef struct CosTaskDeque {
+    CosMutex mutex;
+
+    CosTask * COS_Nullable tasks;
+    size_t capacity;
+
+    /**
+     * The index of the top (oldest) task.
+     */
+    size_t head;
+    size_t count;
+} CosTaskDeque;
+
+typedef struct CosTaskWorker {
+    CosTaskPool *pool;
+    CosThread thread;
+
+    /**
+     * The index of the worker, which is also the index of its deque.
+     */
+    size_t index;
+
+    /**
+     * The identifier of the worker's thread, once @a started is set. Protected by the pool's lock.
+     */
+    CosThreadID thread_id;
+    bool started;
+} CosTaskWorker;
+
+/**
+ * A task that was handed to an external executor.
+ */
+typedef struct CosTaskJob {
+    CosTaskPool *pool;
+    CosTask task;
+} CosTaskJob;
+
+struct CosTaskPool {
+    CosAllocator * COS_Nullable allocator;
+
+    bool has_executor;
+    CosExecutor executor;
+
+    /**
+     * The workers. There may be fewer than requested, if threads could not be started.
+     */
+    CosTaskWorker * COS_Nullable workers;
+    size_t worker_count;
+
+    /**
+     * One deque per worker, followed by the shared deque for tasks submitted by other threads.
+     *
+     * There is a deque for every requested worker, so there may be more than @a worker_count + 1.
+     */
+    CosTaskDeque *deques;
+    size_t deque_count;
+
+    /**
+     * Protects @a queued_count , @a shutting_down , the workers' identifiers, and the groups.
+     */
+    CosMutex mutex;
+
+    /**
+     * Signaled when a task is queued, when a group finishes, and when the pool shuts down.
+     */
+    CosCondition condition;
+
+    /**
+     * The number of tasks in the deques.
+     */
+    size_t queued_count;
+    bool shutting_down;
+};
+
+static bool
+cos_task_deque_init_(CosTaskDeque *deque);
+
+static void
+cos_task_deque_destroy_(CosTaskDeque *deque,
+                        CosAllocator * COS_Nullable allocator);
+
+static bool
+cos_task_deque_push_bottom_(CosTaskDeque *deque,
+                            CosAllocator * COS_Nullable allocator,
+                            CosTask task);
+
+static bool
+cos_task_deque_pop_bottom_(CosTaskDeque *deque,
+                           CosTask *out_task)
+    COS_ATTR_ACCESS_WRITE_ONLY(2);
+
+static bool
+cos_task_deque_steal_top_(CosTaskDeque *deque,
+                          CosTask *out_task)
+    COS_ATTR_ACCESS_WRITE_ONLY(2);
+
+static size_t
+cos_task_pool_get_current_deque_index_(const CosTaskPool *pool);
+
+static bool
+cos_task_pool_take_(CosTaskPool *pool,
+                    size_t deque_index,
+                    CosTask *out_task)
+    COS_ATTR_ACCESS_WRITE_ONLY(3);
+
+static void
+cos_task_pool_run_(CosTaskPool *pool,
+                   CosTask task);
+
+static void
+cos_task_pool_worker_main_(void * COS_Nullable arg);
+
+static void
+cos_task_pool_run_job_(void *job);
+
+CosTaskPool *
+cos_task_pool_create(CosAllocator * COS_Nullable allocator,
+                     const CosTaskPoolOptions *options)
+{
+    COS_API_PARAM_CHECK(options != NULL);
+    if (COS_UNLIKELY(!options)) {
+        return NULL;
+    }
+
+    const size_t worker_count = options->executor ? 0 : options->thread_count;
+
+    CosTaskPool * const pool = cos_calloc(allocator, 1, sizeof(CosTaskPool));
+    if (!pool) {
+        return NULL;
+    }
+
+    pool->allocator = allocator;
+    if (options->executor) {
+        pool->has_executor = true;
+        pool->executor = *options->executor;
+    }
+
+    bool mutex_initialized = false;
+    bool condition_initialized = false;
+    size_t deque_initialized_count = 0;
+
+    mutex_initialized = cos_mutex_init(&pool->mutex, false);
+    if (!mutex_initialized) {
+        goto failure;
+    }
+    condition_initialized = cos_condition_init(&pool->condition);
+    if (!condition_initialized) {
+        goto failure;
+    }
+
+    pool->deques = cos_calloc(allocator, worker_count + 1, sizeof(CosTaskDeque));
+    if (!pool->deques) {
+        goto failure;
+    }
+    for (; deque_initialized_count < worker_count + 1; deque_initialized_count++) {
+        if (!cos_task_deque_init_(&pool->deques[deque_initialized_count])) {
+            goto failure;
+        }
+    }
+    pool->deque_count = worker_count + 1;
+
+    if (worker_count > 0) {
+        pool->workers = cos_calloc(allocator, worker_count, sizeof(CosTaskWorker));
+        if (!pool->workers) {
+            goto failure;
+        }
+
+        // The workers wait for the lock before they look at the pool, so they only start once
+        // the worker count is final. If a thread cannot be started, the pool carries on with
+        // fewer workers, and the shared deque moves down to the first unused index.
+        cos_mutex_lock(&pool->mutex);
+        for (size_t i = 0; i < worker_count; i++) {
+            CosTaskWorker * const worker = &pool->workers[i];
+            worker->pool = pool;
+            worker->index = i;
+            if (!cos_thread_create(&worker->thread, &cos_task_pool_worker_main_, worker)) {
+                break;
+            }
+            pool->worker_count++;
+        }
+        cos_mutex_unlock(&pool->mutex);
+    }
+
+    return pool;
+
+failure:
+    for (size_t i = 0; i < deque_initialized_count; i++) {
+        cos_task_deque_destroy_(&pool->deques[i], allocator);
+    }
+    if (pool->deques) {
+        cos_free(allocator, pool->deques);
+    }
+    if (condition_initialized) {
+        cos_condition_destroy(&pool->condition);
+    }
+    if (mutex_initialized) {
+        cos_mutex_destroy(&pool->mutex);
+    }
+    cos_free(allocator, pool);
+    return NULL;
+}
+
+void
+cos_task_pool_destroy(CosTaskPool *pool)
+{
+    if (!pool) {
+        return;
+    }
+
+    cos_mutex_lock(&pool->mutex);
+    pool->shutting_down = true;
+    cos_condition_broadcast(&pool->condition);
+    cos_mutex_unlock(&pool->mutex);
+
+    for (size_t i = 0; i < pool->worker_count; i++) {
+        cos_thread_join(&pool->workers[i].thread);
+    }
+
+    CosAllocator * const allocator = pool->allocator;
+    if (pool->workers) {
+        cos_free(allocator, pool->workers);
+    }
+
+    for (size_t i = 0; i < pool->deque_count; i++) {
+        cos_task_deque_destroy_(&pool->deques[i], allocator);
+    }
+    cos_free(allocator, pool->deques);
+
+    cos_condition_destroy(&pool->condition);
+    cos_mutex_destroy(&pool->mutex);
+
+    cos_free(allocator, pool);
+}
+
+size_t
+cos_task_pool_get_thread_count(const CosTaskPool *pool)
+{
+    COS_API_PARAM_CHECK(pool != NULL);
+    if (COS_UNLIKELY(!pool)) {
+        return 0;
+    }
+
+    return pool->worker_count;
+}
+
+void
+cos_task_group_init(CosTaskGroup *group)
+{
+    COS_API_PARAM_CHECK(group != NULL);
+    if (COS_UNLIKELY(!group)) {
+        return;
+    }
+
+    group->pending_count = 0;
+}
+
+bool
+cos_task_pool_submit(CosTaskPool *pool,
+                     CosTaskGroup *group,
+                     CosTaskFunc func,
+                     void * COS_Nullable arg)
+{
+    COS_API_PARAM_CHECK(pool != NULL);
+    COS_API_PARAM_CHECK(group != NULL);
+    COS_API_PARAM_CHECK(func != NULL);
+    if (COS_UNLIKELY(!pool || !group || !func)) {
+        return false;
+    }
+
+    const CosTask task = {
+        .func = func,
+        .arg = arg,
+        .group = group,
+    };
+
+    if (pool->has_executor) {
+        CosTaskJob * const job = cos_alloc(pool->allocator, sizeof(CosTaskJob));
+        if (!job) {
+            return false;
+        }
+        job->pool = pool;
+        job->task = task;
+
+        cos_mutex_lock(&pool->mutex);
+        group->pending_count++;
+        cos_mutex_unlock(&pool->mutex);
+
+        // The executor may run the job right away, so no lock can be held here.
+        pool->executor.submit(&cos_task_pool_run_job_, job, pool->executor.user_data);
+        return true;
+    }
+
+    cos_mutex_lock(&pool->mutex);
+
+    // Workers push onto their own deque, and everyone else onto the shared one.
+    const size_t deque_index = cos_task_pool_get_current_deque_index_(pool);
+    const bool pushed = cos_task_deque_push_bottom_(&pool->deques[deque_index],
+                                                    pool->allocator,
+                                                    task);
+    if (pushed) {
+        group->pending_count++;
+        pool->queued_count++;
+        cos_condition_broadcast(&pool->condition);
+    }
+
+    cos_mutex_unlock(&pool->mutex);
+
+    return pushed;
+}
+
+void
+cos_task_pool_wait(CosTaskPool *pool,
+                   CosTaskGroup *group)
+{
+    COS_API_PARAM_CHECK(pool != NULL);
+    COS_API_PARAM_CHECK(group != NULL);
+    if (COS_UNLIKELY(!pool || !group)) {
+        return;
+    }
+
+    cos_mutex_lock(&pool->mutex);
+    const size_t deque_index = cos_task_pool_get_current_deque_index_(pool);
+    cos_mutex_unlock(&pool->mutex);
+
+    while (true) {
+        cos_mutex_lock(&pool->mutex);
+        const bool is_done = (group->pending_count == 0);
+        cos_mutex_unlock(&pool->mutex);
+        if (is_done) {
+            break;
+        }
+
+        // Help out rather than block, which also keeps a waiting worker from deadlocking the pool.
+        CosTask task;
+        if (cos_task_pool_take_(pool, deque_index, &task)) {
+            cos_task_pool_run_(pool, task);
+            continue;
+        }
+
+        cos_mutex_lock(&pool->mutex);
+        if (group->pending_count > 0 && pool->queued_count == 0) {
+            cos_condition_wait(&pool->condition, &pool->mutex);
+        }
+        cos_mutex_unlock(&pool->mutex);
+    }
+}
+
+// MARK: - Scheduling
+
+/**
+ * Returns the index of the calling worker's deque, or of the shared deque.
+ *
+ * The pool's lock must be held.
+ */
+static size_t
+cos_task_pool_get_current_deque_index_(const CosTaskPool *pool)
+{
+    COS_IMPL_PARAM_CHECK(pool != NULL);
+
+    const CosThreadID current_thread_id = cos_thread_get_current_id();
+    for (size_t i = 0; i < pool->worker_count; i++) {
+        const CosTaskWorker * const worker = &pool->workers[i];
+        if (worker->started && cos_thread_id_equal(worker->thread_id, current_thread_id)) {
+            return i;
+        }
+    }
+    return pool->worker_count;
+}
+
+/**
+ * Takes a task from the deque at @p deque_index , or steals one from another deque.
+ */
+static bool
+cos_task_pool_take_(CosTaskPool *pool,
+                    size_t deque_index,
+                    CosTask *out_task)
+{
+    COS_IMPL_PARAM_CHECK(pool != NULL);
+    COS_IMPL_PARAM_CHECK(out_task != NULL);
+
+    const size_t deque_count = pool->worker_count + 1;
+
+    bool found = false;
+    if (deque_index < pool->worker_count) {
+        found = cos_task_deque_pop_bottom_(&pool->deques[deque_index], out_task);
+    }
+
+    // Steal the oldest task of another deque, starting with the next one over.
+    for (size_t i = 1; !found && i <= deque_count; i++) {
+        const size_t victim_index = (deque_index + i) % deque_count;
+        found = cos_task_deque_steal_top_(&pool->deques[victim_index], out_task);
+    }
+
+    if (found) {
+        cos_mutex_lock(&pool->mutex);
+        pool->queued_count--;
+        cos_mutex_unlock(&pool->mutex);
+    }
+
+    return found;
+}
+
+static void
+cos_task_pool_run_(CosTaskPool *pool,
+                   CosTask task)
+{
+    COS_IMPL_PARAM_CHECK(pool != NULL);
+
+    task.func(task.arg);
+
+    cos_mutex_lock(&pool->mutex);
+    COS_ASSERT(task.group->pending_count > 0, "Expected a pending task");
+    task.group->pending_count--;
+    if (task.group->pending_count == 0) {
+        cos_condition_broadcast(&pool->condition);
+    }
+    cos_mutex_unlock(&pool->mutex);
+}
+
+static void
+cos_task_pool_worker_main_(void *arg)
+{
+    CosTaskWorker * const worker = arg;
+    CosTaskPool * const pool = worker->pool;
+
+    cos_mutex_lock(&pool->mutex);
+    worker->thread_id = cos_thread_get_current_id();
+    worker->started = true;
+    cos_mutex_unlock(&pool->mutex);
+
+    while (true) {
+        CosTask task;
+        if (cos_task_pool_take_(pool, worker->index, &task)) {
+            cos_task_pool_run_(pool, task);
+            continue;
+        }
+
+        cos_mutex_lock(&pool->mutex);
+        while (pool->queued_count == 0 && !pool->shutting_down) {
+            cos_condition_wait(&pool->condition, &pool->mutex);
+        }
+        const bool should_stop = (pool->queued_count == 0 && pool->shutting_down);
+        cos_mutex_unlock(&pool->mutex);
+
+        if (should_stop) {
+            break;
+        }
+    }
+}
+
+static void
+cos_task_pool_run_job_(void *job)
+{
+    CosTaskJob * const task_job = job;
+    CosTaskPool * const pool = task_job->pool;
+    const CosTask task = task_job->task;
+
+    cos_free(pool->allocator, task_job);
+
+    cos_task_pool_run_(pool, task);
+}
+
+// MARK: - Deques
+
+static bool
+cos_task_deque_init_(CosTaskDeque *deque)
+{
+    COS_IMPL_PARAM_CHECK(deque != NULL);
+
+    deque->tasks = NULL;
+    deque->capacity = 0;
+    deque->head = 0;
+    deque->count = 0;
+
+    return cos_mutex_init(&deque->mutex, false);
+}
+
+static void
+cos_task_deque_destroy_(CosTaskDeque *deque,
+                        CosAllocator * COS_Nullable allocator)
+{
+    COS_IMPL_PARAM_CHECK(deque != NULL);
+
+    if (deque->tasks) {
+        cos_free(allocator, deque->tasks);
+        deque->tasks = NULL;
+    }
+    cos_mutex_destroy(&deque->mutex);
+}
+
+static bool
+cos_task_deque_push_bottom_(CosTaskDeque *deque,
+                            CosAllocator * COS_Nullable allocator,
+                            CosTask task)
+{
+    COS_IMPL_PARAM_CHECK(deque != NULL);
+
+    bool result = true;
+    cos_mutex_lock(&deque->mutex);
+
+    if (deque->count == deque->capacity) {
+        // Grow the ring buffer, unwrapping the tasks to the start of the new one.
+        const size_t new_capacity = (deque->capacity > 0) ? deque->capacity * 2 : COS_TASK_DEQUE_INITIAL_CAPACITY;
+        CosTask * const new_tasks = cos_calloc(allocator, new_capacity, sizeof(CosTask));
+        if (new_tasks) {
+            for (size_t i = 0; i < deque->count; i++) {
+                new_tasks[i] = deque->tasks[(deque->head + i) % deque->capacity];
+            }
+            if (deque->tasks) {
+                cos_free(allocator, deque->tasks);
+            }
+            deque->tasks = new_tasks;
+            deque->capacity = new_capacity;
+            deque->head = 0;
+        }
+        else {
+            result = false;
+        }
+    }
+
+    if (result) {
+        deque->tasks[(deque->head + deque->count) % deque->capacity] = task;
+        deque->count++;
+    }
+
+    cos_mutex_unlock(&deque->mutex);
+    return result;
+}
+
+static bool
+cos_task_deque_pop_bottom_(CosTaskDeque *deque,
+                           CosTask *out_task)
+{
+    COS_IMPL_PARAM_CHECK(deque != NULL);
+    COS_IMPL_PARAM_CHECK(out_task != NULL);
+
+    bool result = false;
+    cos_mutex_lock(&deque->mutex);
+
+    if (deque->count > 0) {
+        deque->count--;
+        *out_task = deque->tasks[(deque->head + deque->count) % deque->capacity];
+        result = true;
+    }
+
+    cos_mutex_unlock(&deque->mutex);
+    return result;
+}
+
+static bool
+cos_task_deque_steal_top_(CosTaskDeque *deque,
+                          CosTask *out_task)
+{
+    COS_IMPL_PARAM_CHECK(deque != NULL);
+    COS_IMPL_PARAM_CHECK(out_task != NULL);
+
+    bool result = false;
+    cos_mutex_lock(&deque->mutex);
+
+    if (deque->count > 0) {
+        *out_task = deque->tasks[deque->head];
+        deque->head = (deque->head + 1) % deque->capacity;
+        deque->count--;
+        result = true;
+    }
+
+    cos_mutex_unlock(&deque->mutex);
+    return result;
+}
+
+COS_ASSUME_NONNULL_END
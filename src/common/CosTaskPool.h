@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2025 OpenCOS.
+ */
+
+#ifndef LIBCOS_COMMON_COS_TASK_POOL_H
+#define LIBCOS_COMMON_COS_TASK_POOL_H
+
+#include <libcos/common/CosDefines.h>
+#include <libcos/common/CosExecutor.h>
+#include <libcos/common/CosTypes.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+
+COS_DECLS_BEGIN
+COS_ASSUME_NONNULL_BEGIN
+
+/*
+ * A small work-stealing task scheduler, for running library work in the background.
+ *
+ * Each worker thread has a deque of tasks. A worker runs the tasks that it submits itself
+ * newest-first, from the bottom of its deque, and when it runs out, it steals the oldest tasks
+ * from the top of the other deques. Tasks that are submitted from other threads go to a shared
+ * deque that the workers steal from.
+ *
+ * A thread that waits for a group of tasks runs tasks too, so a pool without worker threads
+ * runs everything on the waiting thread.
+ */
+
+typedef struct CosTaskPool CosTaskPool;
+
+/**
+ * @brief A task.
+ *
+ * @param arg The argument that was passed to @c cos_task_pool_submit .
+ */
+typedef void (*CosTaskFunc)(void * COS_Nullable arg);
+
+/**
+ * @brief A group of tasks that can be waited for.
+ *
+ * Initialize a group with @c cos_task_group_init . The group must stay valid until
+ * @c cos_task_pool_wait returns.
+ */
+typedef struct CosTaskGroup {
+    /**
+     * The number of tasks of the group that have not finished. Protected by the pool's lock.
+     */
+    size_t pending_count;
+} CosTaskGroup;
+
+typedef struct CosTaskPoolOptions {
+    /**
+     * The number of worker threads to start.
+     *
+     * With @c 0, tasks only run on the threads that wait for them.
+     */
+    size_t thread_count;
+
+    /**
+     * An external executor to run the tasks on, or @c NULL.
+     *
+     * If set, no worker threads are started, and every task is submitted to the executor.
+     */
+    const CosExecutor * COS_Nullable executor;
+} CosTaskPoolOptions;
+
+void
+cos_task_pool_destroy(CosTaskPool *pool)
+    COS_DEALLOCATOR_FUNC;
+
+/**
+ * @brief Creates a task pool.
+ *
+ * Fewer worker threads than requested may be started, if the system runs out of threads.
+ *
+ * @param allocator The allocator for the pool and its tasks, or @c NULL for the default.
+ * @param options The pool's options.
+ *
+ * @return A new task pool, or @c NULL if an error occurred.
+ */
+CosTaskPool * COS_Nullable
+cos_task_pool_create(CosAllocator * COS_Nullable allocator,
+                     const CosTaskPoolOptions *options)
+    COS_ALLOCATOR_FUNC
+    COS_ALLOCATOR_FUNC_MATCHED_DEALLOC(cos_task_pool_destroy);
+
+/**
+ * @brief Returns the number of worker threads of the pool.
+ */
+size_t
+cos_task_pool_get_thread_count(const CosTaskPool *pool);
+
+void
+cos_task_group_init(CosTaskGroup *group);
+
+/**
+ * @brief Submits a task.
+ *
+ * Tasks can submit more tasks, to the same group or to another one.
+ *
+ * @param pool The task pool.
+ * @param group The group that the task belongs to.
+ * @param func The task's function.
+ * @param arg The argument to pass to @p func .
+ *
+ * @return @c true if the task was submitted, @c false if memory could not be allocated for it.
+ */
+bool
+cos_task_pool_submit(CosTaskPool *pool,
+                     CosTaskGroup *group,
+                     CosTaskFunc func,
+                     void * COS_Nullable arg)
+    COS_WARN_UNUSED_RESULT;
+
+/**
+ * @brief Waits for the tasks of a group to finish, running tasks in the meantime.
+ *
+ * @param pool The task pool.
+ * @param group The group.
+ */
+void
+cos_task_pool_wait(CosTaskPool *pool,
+                   CosTaskGroup *group);
+
+COS_ASSUME_NONNULL_END
+COS_DECLS_END
+
+#endif /* LIBCOS_COMMON_COS_TASK_POOL_H */
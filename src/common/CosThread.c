@@ -0,0 +1,279 @@
+/*
+ * Copyright (c) 2025 OpenCOS.
+ */
+
+#include "common/CosThread.h"
+
+#include "common/Assert.h"
+
+#if COS_HAVE_PTHREADS
+    #include <unistd.h>
+#endif
+
+COS_ASSUME_NONNULL_BEGIN
+
+#if COS_HAVE_PTHREADS
+
+static void * COS_Nullable
+cos_thread_main_(void * COS_Nullable arg);
+
+#else
+
+static DWORD WINAPI
+cos_thread_main_(LPVOID arg);
+
+#endif
+
+// MARK: - Mutexes
+
+bool
+cos_mutex_init(CosMutex *mutex,
+               bool recursive)
+{
+    COS_API_PARAM_CHECK(mutex != NULL);
+    if (COS_UNLIKELY(!mutex)) {
+        return false;
+    }
+
+#if COS_HAVE_PTHREADS
+    pthread_mutexattr_t attributes;
+    if (pthread_mutexattr_init(&attributes) != 0) {
+        return false;
+    }
+    if (recursive &&
+        pthread_mutexattr_settype(&attributes, PTHREAD_MUTEX_RECURSIVE) != 0) {
+        (void)pthread_mutexattr_destroy(&attributes);
+        return false;
+    }
+
+    const int result = pthread_mutex_init(&mutex->mutex, &attributes);
+    (void)pthread_mutexattr_destroy(&attributes);
+    return (result == 0);
+#else
+    // Critical sections are always recursive.
+    (void)recursive;
+    InitializeCriticalSection(&mutex->critical_section);
+    return true;
+#endif
+}
+
+void
+cos_mutex_destroy(CosMutex *mutex)
+{
+    COS_API_PARAM_CHECK(mutex != NULL);
+    if (COS_UNLIKELY(!mutex)) {
+        return;
+    }
+
+#if COS_HAVE_PTHREADS
+    (void)pthread_mutex_destroy(&mutex->mutex);
+#else
+    DeleteCriticalSection(&mutex->critical_section);
+#endif
+}
+
+void
+cos_mutex_lock(CosMutex *mutex)
+{
+    COS_API_PARAM_CHECK(mutex != NULL);
+    if (COS_UNLIKELY(!mutex)) {
+        return;
+    }
+
+#if COS_HAVE_PTHREADS
+    const int result = pthread_mutex_lock(&mutex->mutex);
+    COS_ASSERT(result == 0, "Failed to lock a mutex");
+    (void)result;
+#else
+    EnterCriticalSection(&mutex->critical_section);
+#endif
+}
+
+void
+cos_mutex_unlock(CosMutex *mutex)
+{
+    COS_API_PARAM_CHECK(mutex != NULL);
+    if (COS_UNLIKELY(!mutex)) {
+        return;
+    }
+
+#if COS_HAVE_PTHREADS
+    const int result = pthread_mutex_unlock(&mutex->mutex);
+    COS_ASSERT(result == 0, "Failed to unlock a mutex");
+    (void)result;
+#else
+    LeaveCriticalSection(&mutex->critical_section);
+#endif
+}
+
+// MARK: - Condition variables
+
+bool
+cos_condition_init(CosCondition *condition)
+{
+    COS_API_PARAM_CHECK(condition != NULL);
+    if (COS_UNLIKELY(!condition)) {
+        return false;
+    }
+
+#if COS_HAVE_PTHREADS
+    return (pthread_cond_init(&condition->cond, NULL) == 0);
+#else
+    InitializeConditionVariable(&condition->condition_variable);
+    return true;
+#endif
+}
+
+void
+cos_condition_destroy(CosCondition *condition)
+{
+    COS_API_PARAM_CHECK(condition != NULL);
+    if (COS_UNLIKELY(!condition)) {
+        return;
+    }
+
+#if COS_HAVE_PTHREADS
+    (void)pthread_cond_destroy(&condition->cond);
+#else
+    // Win32 condition variables do not need to be destroyed.
+    (void)condition;
+#endif
+}
+
+void
+cos_condition_wait(CosCondition *condition,
+                   CosMutex *mutex)
+{
+    COS_API_PARAM_CHECK(condition != NULL);
+    COS_API_PARAM_CHECK(mutex != NULL);
+    if (COS_UNLIKELY(!condition || !mutex)) {
+        return;
+    }
+
+#if COS_HAVE_PTHREADS
+    const int result = pthread_cond_wait(&condition->cond, &mutex->mutex);
+    COS_ASSERT(result == 0, "Failed to wait for a condition variable");
+    (void)result;
+#else
+    (void)SleepConditionVariableCS(&condition->condition_variable,
+                                   &mutex->critical_section,
+                                   INFINITE);
+#endif
+}
+
+void
+cos_condition_broadcast(CosCondition *condition)
+{
+    COS_API_PARAM_CHECK(condition != NULL);
+    if (COS_UNLIKELY(!condition)) {
+        return;
+    }
+
+#if COS_HAVE_PTHREADS
+    (void)pthread_cond_broadcast(&condition->cond);
+#else
+    WakeAllConditionVariable(&condition->condition_variable);
+#endif
+}
+
+// MARK: - Threads
+
+bool
+cos_thread_create(CosThread *thread,
+                  CosThreadFunc func,
+                  void * COS_Nullable arg)
+{
+    COS_API_PARAM_CHECK(thread != NULL);
+    COS_API_PARAM_CHECK(func != NULL);
+    if (COS_UNLIKELY(!thread || !func)) {
+        return false;
+    }
+
+    thread->func = func;
+    thread->arg = arg;
+
+#if COS_HAVE_PTHREADS
+    return (pthread_create(&thread->thread, NULL, &cos_thread_main_, thread) == 0);
+#else
+    thread->handle = CreateThread(NULL, 0, &cos_thread_main_, thread, 0, NULL);
+    return (thread->handle != NULL);
+#endif
+}
+
+void
+cos_thread_join(CosThread *thread)
+{
+    COS_API_PARAM_CHECK(thread != NULL);
+    if (COS_UNLIKELY(!thread)) {
+        return;
+    }
+
+#if COS_HAVE_PTHREADS
+    const int result = pthread_join(thread->thread, NULL);
+    COS_ASSERT(result == 0, "Failed to join a thread");
+    (void)result;
+#else
+    (void)WaitForSingleObject(thread->handle, INFINITE);
+    (void)CloseHandle(thread->handle);
+#endif
+}
+
+size_t
+cos_thread_get_processor_count(void)
+{
+#if COS_HAVE_PTHREADS && defined(_SC_NPROCESSORS_ONLN)
+    const long processor_count = sysconf(_SC_NPROCESSORS_ONLN);
+    return (processor_count > 0) ? (size_t)processor_count : 1;
+#elif defined(_WIN32)
+    SYSTEM_INFO system_info;
+    GetSystemInfo(&system_info);
+    return (system_info.dwNumberOfProcessors > 0) ? (size_t)system_info.dwNumberOfProcessors : 1;
+#else
+    return 1;
+#endif
+}
+
+#if COS_HAVE_PTHREADS
+
+static void *
+cos_thread_main_(void *arg)
+{
+    CosThread * const thread = arg;
+    thread->func(thread->arg);
+    return NULL;
+}
+
+#else
+
+static DWORD WINAPI
+cos_thread_main_(LPVOID arg)
+{
+    CosThread * const thread = arg;
+    thread->func(thread->arg);
+    return 0;
+}
+
+#endif
+
+CosThreadID
+cos_thread_get_current_id(void)
+{
+#if COS_HAVE_PTHREADS
+    return pthread_self();
+#else
+    return GetCurrentThreadId();
+#endif
+}
+
+bool
+cos_thread_id_equal(CosThreadID thread_id1,
+                    CosThreadID thread_id2)
+{
+#if COS_HAVE_PTHREADS
+    return (pthread_equal(thread_id1, thread_id2) != 0);
+#else
+    return (thread_id1 == thread_id2);
+#endif
+}
+
+COS_ASSUME_NONNULL_END
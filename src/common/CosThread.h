@@ -0,0 +1,186 @@
+/*
+ * Copyright (c) 2025 OpenCOS.
+ */
+
+#ifndef LIBCOS_COMMON_COS_THREAD_H
+#define LIBCOS_COMMON_COS_THREAD_H
+
+#include "config.h"
+
+#include <libcos/common/CosDefines.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#if COS_HAVE_PTHREADS
+    #include <pthread.h>
+#elif defined(_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #include <windows.h>
+#else
+    #error "Threads are not supported on this platform."
+#endif
+
+COS_DECLS_BEGIN
+COS_ASSUME_NONNULL_BEGIN
+
+/*
+ * Thin wrappers around the platform's threading primitives: POSIX threads, or the Win32 API.
+ */
+
+/**
+ * A mutual exclusion lock.
+ */
+typedef struct CosMutex {
+#if COS_HAVE_PTHREADS
+    pthread_mutex_t mutex;
+#else
+    CRITICAL_SECTION critical_section;
+#endif
+} CosMutex;
+
+/**
+ * A condition variable, used together with a @c CosMutex.
+ */
+typedef struct CosCondition {
+#if COS_HAVE_PTHREADS
+    pthread_cond_t cond;
+#else
+    CONDITION_VARIABLE condition_variable;
+#endif
+} CosCondition;
+
+/**
+ * The function that a thread runs.
+ */
+typedef void (*CosThreadFunc)(void * COS_Nullable arg);
+
+/**
+ * A thread, created with @c cos_thread_create .
+ */
+typedef struct CosThread {
+#if COS_HAVE_PTHREADS
+    pthread_t thread;
+#else
+    HANDLE handle;
+#endif
+
+    CosThreadFunc func;
+    void * COS_Nullable arg;
+} CosThread;
+
+/**
+ * The identifier of a thread.
+ */
+#if COS_HAVE_PTHREADS
+typedef pthread_t CosThreadID;
+#else
+typedef DWORD CosThreadID;
+#endif
+
+// MARK: - Mutexes
+
+/**
+ * @brief Initializes a mutex.
+ *
+ * @param mutex The mutex.
+ * @param recursive Whether the thread that holds the mutex can lock it again.
+ *
+ * @return @c true if the mutex was initialized, @c false otherwise.
+ */
+bool
+cos_mutex_init(CosMutex *mutex,
+               bool recursive);
+
+void
+cos_mutex_destroy(CosMutex *mutex);
+
+void
+cos_mutex_lock(CosMutex *mutex);
+
+void
+cos_mutex_unlock(CosMutex *mutex);
+
+// MARK: - Condition variables
+
+/**
+ * @brief Initializes a condition variable.
+ *
+ * @param condition The condition variable.
+ *
+ * @return @c true if the condition variable was initialized, @c false otherwise.
+ */
+bool
+cos_condition_init(CosCondition *condition);
+
+void
+cos_condition_destroy(CosCondition *condition);
+
+/**
+ * @brief Unlocks @p mutex and waits for the condition variable to be signaled, then locks
+ * @p mutex again.
+ *
+ * The wait can end without a signal, so the caller must check its condition in a loop.
+ *
+ * @param condition The condition variable.
+ * @param mutex The mutex, which must be locked by the calling thread.
+ */
+void
+cos_condition_wait(CosCondition *condition,
+                   CosMutex *mutex);
+
+/**
+ * @brief Wakes all threads that are waiting for the condition variable.
+ */
+void
+cos_condition_broadcast(CosCondition *condition);
+
+// MARK: - Threads
+
+/**
+ * @brief Starts a thread.
+ *
+ * The thread must be joined with @c cos_thread_join , and @p thread must stay valid until then.
+ *
+ * @param thread The thread.
+ * @param func The function to run on the thread.
+ * @param arg The argument to pass to @p func .
+ *
+ * @return @c true if the thread was started, @c false otherwise.
+ */
+bool
+cos_thread_create(CosThread *thread,
+                  CosThreadFunc func,
+                  void * COS_Nullable arg);
+
+/**
+ * @brief Waits for a thread to finish.
+ *
+ * @param thread The thread.
+ */
+void
+cos_thread_join(CosThread *thread);
+
+/**
+ * @brief Returns the number of processors that are available, which is at least 1.
+ */
+size_t
+cos_thread_get_processor_count(void);
+
+/**
+ * @brief Returns the identifier of the calling thread.
+ */
+CosThreadID
+cos_thread_get_current_id(void);
+
+/**
+ * @brief Returns whether two thread identifiers identify the same thread.
+ */
+bool
+cos_thread_id_equal(CosThreadID thread_id1,
+                    CosThreadID thread_id2);
+
+COS_ASSUME_NONNULL_END
+COS_DECLS_END
+
+#endif /* LIBCOS_COMMON_COS_THREAD_H */
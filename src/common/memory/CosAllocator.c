@@ -6,7 +6,9 @@
 
 #include "common/Assert.h"
 
+#include <stdbool.h>
 #include <stdlib.h>
+#include <string.h>
 
 COS_ASSUME_NONNULL_BEGIN
 
@@ -157,4 +159,612 @@ static CosAllocator cos_allocator_default_ = {
 
 CosAllocator * const CosAllocatorDefault = &cos_allocator_default_;
 
+// MARK: - Alignment
+
+/**
+ * A type with the strictest alignment requirement of the objects allocated by the library.
+ */
+typedef union CosAllocatorAlign {
+    void *ptr;
+    double d;
+    long long ll;
+    size_t size;
+} CosAllocatorAlign;
+
+#define COS_ALLOCATOR_ALIGNMENT sizeof(CosAllocatorAlign)
+
+#define COS_ALLOCATOR_ALIGN_UP(size) (((size) + (COS_ALLOCATOR_ALIGNMENT - 1)) & ~(COS_ALLOCATOR_ALIGNMENT - 1))
+
+// MARK: - Arena Allocator
+
+/**
+ * The default size of an arena block.
+ */
+#define COS_ARENA_DEFAULT_BLOCK_SIZE (64 * 1024)
+
+/**
+ * The size of the header that precedes each allocation.
+ *
+ * The header stores the requested size of the allocation, which is needed to reallocate it.
+ */
+#define COS_ARENA_ALLOC_HEADER_SIZE COS_ALLOCATOR_ALIGN_UP(sizeof(size_t))
+
+typedef struct CosArenaBlock CosArenaBlock;
+
+struct CosArenaBlock {
+    /**
+     * The next (older) block in the arena.
+     */
+    CosArenaBlock * COS_Nullable next;
+
+    /**
+     * The number of bytes available for allocations in the block.
+     */
+    size_t capacity;
+
+    /**
+     * The number of bytes used by allocations in the block.
+     */
+    size_t used;
+};
+
+#define COS_ARENA_BLOCK_HEADER_SIZE COS_ALLOCATOR_ALIGN_UP(sizeof(CosArenaBlock))
+
+typedef struct CosArena {
+    /**
+     * The allocator used to allocate the arena blocks.
+     */
+    CosAllocator *parent;
+
+    /**
+     * The current block, from which allocations are made.
+     */
+    CosArenaBlock * COS_Nullable head;
+
+    /**
+     * The size of new arena blocks.
+     */
+    size_t block_size;
+
+    /**
+     * The most recent allocation from the current block, or @c NULL.
+     *
+     * The most recent allocation can be grown in place or reclaimed on deallocation.
+     */
+    unsigned char * COS_Nullable last_alloc;
+} CosArena;
+
+COS_STATIC_INLINE unsigned char *
+cos_arena_block_get_data_(CosArenaBlock *block)
+{
+    return (unsigned char *)block + COS_ARENA_BLOCK_HEADER_SIZE;
+}
+
+COS_STATIC_INLINE size_t
+cos_arena_alloc_get_size_(const void *ptr)
+{
+    size_t size = 0;
+    memcpy(&size, (const unsigned char *)ptr - COS_ARENA_ALLOC_HEADER_SIZE, sizeof(size));
+    return size;
+}
+
+COS_STATIC_INLINE void
+cos_arena_alloc_set_size_(void *ptr,
+                          size_t size)
+{
+    memcpy((unsigned char *)ptr - COS_ARENA_ALLOC_HEADER_SIZE, &size, sizeof(size));
+}
+
+static CosArenaBlock * COS_Nullable
+cos_arena_add_block_(CosArena *arena,
+                     size_t required_size)
+{
+    COS_IMPL_PARAM_CHECK(arena != NULL);
+
+    const bool is_oversized = required_size > arena->block_size;
+    const size_t capacity = is_oversized ? required_size : arena->block_size;
+
+    CosArenaBlock * const block = cos_allocator_alloc(arena->parent,
+                                                      COS_ARENA_BLOCK_HEADER_SIZE + capacity);
+    if (!block) {
+        return NULL;
+    }
+
+    block->capacity = capacity;
+    block->used = 0;
+
+    if (is_oversized && arena->head) {
+        // Keep allocating from the current block - the oversized block will only ever
+        // hold a single allocation.
+        CosArenaBlock * const head = COS_nonnull_cast(arena->head);
+        block->next = head->next;
+        head->next = block;
+    }
+    else {
+        block->next = arena->head;
+        arena->head = block;
+        arena->last_alloc = NULL;
+    }
+
+    return block;
+}
+
+static void * COS_Nullable
+cos_arena_alloc_(size_t size,
+                 void * COS_Nullable user_data)
+{
+    CosArena * const arena = user_data;
+    if (!arena || size == 0) {
+        return NULL;
+    }
+
+    const size_t required_size = COS_ARENA_ALLOC_HEADER_SIZE + COS_ALLOCATOR_ALIGN_UP(size);
+
+    CosArenaBlock *block = arena->head;
+    if (!block || (block->capacity - block->used) < required_size) {
+        block = cos_arena_add_block_(arena, required_size);
+        if (!block) {
+            return NULL;
+        }
+    }
+
+    unsigned char * const ptr = cos_arena_block_get_data_(COS_nonnull_cast(block)) + block->used + COS_ARENA_ALLOC_HEADER_SIZE;
+    block->used += required_size;
+
+    cos_arena_alloc_set_size_(ptr, size);
+    if (block == arena->head) {
+        arena->last_alloc = ptr;
+    }
+
+    return ptr;
+}
+
+static void
+cos_arena_dealloc_(void *ptr,
+                   void * COS_Nullable user_data)
+{
+    CosArena * const arena = user_data;
+    if (!arena) {
+        return;
+    }
+
+    // Only the most recent allocation can be reclaimed - everything else is released
+    // when the arena is destroyed.
+    if (ptr == arena->last_alloc && arena->head) {
+        CosArenaBlock * const head = COS_nonnull_cast(arena->head);
+        const size_t size = cos_arena_alloc_get_size_(ptr);
+
+        head->used -= COS_ARENA_ALLOC_HEADER_SIZE + COS_ALLOCATOR_ALIGN_UP(size);
+        arena->last_alloc = NULL;
+    }
+}
+
+static void * COS_Nullable
+cos_arena_realloc_(void * COS_Nullable ptr,
+                   size_t size,
+                   void * COS_Nullable user_data)
+{
+    CosArena * const arena = user_data;
+    if (!arena) {
+        return NULL;
+    }
+
+    if (!ptr) {
+        return cos_arena_alloc_(size, arena);
+    }
+    else if (size == 0) {
+        cos_arena_dealloc_(COS_nonnull_cast(ptr), arena);
+        return NULL;
+    }
+
+    const size_t old_size = cos_arena_alloc_get_size_(COS_nonnull_cast(ptr));
+
+    // Try to resize the most recent allocation in place.
+    if (ptr == arena->last_alloc && arena->head) {
+        CosArenaBlock * const head = COS_nonnull_cast(arena->head);
+        const size_t old_used = head->used - COS_ALLOCATOR_ALIGN_UP(old_size);
+        if (head->capacity - old_used >= COS_ALLOCATOR_ALIGN_UP(size)) {
+            head->used = old_used + COS_ALLOCATOR_ALIGN_UP(size);
+            cos_arena_alloc_set_size_(COS_nonnull_cast(ptr), size);
+            return ptr;
+        }
+    }
+
+    void * const new_ptr = cos_arena_alloc_(size, arena);
+    if (!new_ptr) {
+        return NULL;
+    }
+
+    memcpy(new_ptr, ptr, (old_size < size) ? old_size : size);
+
+    return new_ptr;
+}
+
+static void
+cos_arena_release_(void *user_data)
+{
+    CosArena * const arena = user_data;
+    CosAllocator * const parent = arena->parent;
+
+    CosArenaBlock *block = arena->head;
+    while (block) {
+        CosArenaBlock * const next = block->next;
+        cos_allocator_dealloc(parent, block);
+        block = next;
+    }
+
+    cos_allocator_dealloc(parent, arena);
+}
+
+static const CosAllocatorCallbacks cos_arena_callbacks_ = {
+    .alloc = &cos_arena_alloc_,
+    .realloc = &cos_arena_realloc_,
+    .dealloc = &cos_arena_dealloc_,
+    .retain = NULL,
+    .release = &cos_arena_release_,
+};
+
+CosAllocator *
+cos_allocator_create_arena(CosAllocator * COS_Nullable allocator,
+                           size_t block_size)
+{
+    CosAllocator * const parent_allocator = allocator ? allocator : CosAllocatorDefault;
+
+    CosArena * const arena = cos_allocator_alloc(COS_nonnull_cast(parent_allocator),
+                                                 sizeof(CosArena));
+    if (!arena) {
+        return NULL;
+    }
+
+    arena->parent = COS_nonnull_cast(parent_allocator);
+    arena->head = NULL;
+    arena->block_size = COS_ALLOCATOR_ALIGN_UP((block_size > 0) ? block_size : COS_ARENA_DEFAULT_BLOCK_SIZE);
+    arena->last_alloc = NULL;
+
+    CosAllocator * const arena_allocator = cos_allocator_create(parent_allocator,
+                                                                &cos_arena_callbacks_,
+                                                                arena);
+    if (!arena_allocator) {
+        cos_allocator_dealloc(COS_nonnull_cast(parent_allocator), arena);
+        return NULL;
+    }
+
+    return arena_allocator;
+}
+
+// MARK: - Pool Allocator
+
+/**
+ * The granularity of the pool allocator size classes.
+ */
+#define COS_POOL_SIZE_CLASS_GRANULARITY 16
+
+/**
+ * The approximate size of a slab.
+ */
+#define COS_POOL_SLAB_SIZE (16 * 1024)
+
+typedef struct CosPoolSlab CosPoolSlab;
+
+struct CosPoolSlab {
+    /**
+     * The next slab of the size class.
+     */
+    CosPoolSlab * COS_Nullable next;
+
+    /**
+     * The index of the size class that the slab belongs to.
+     */
+    size_t size_class_index;
+};
+
+#define COS_POOL_SLAB_HEADER_SIZE COS_ALLOCATOR_ALIGN_UP(sizeof(CosPoolSlab))
+
+/**
+ * The size of the header that precedes each allocation.
+ *
+ * The header stores a pointer to the slab that the allocation belongs to, or @c NULL if the
+ * allocation was forwarded to the parent allocator.
+ */
+#define COS_POOL_SLOT_HEADER_SIZE COS_ALLOCATOR_ALIGN_UP(sizeof(CosPoolSlab *))
+
+typedef struct CosPoolFreeSlot CosPoolFreeSlot;
+
+struct CosPoolFreeSlot {
+    CosPoolFreeSlot * COS_Nullable next;
+};
+
+typedef struct CosPoolSizeClass {
+    /**
+     * The usable size of each slot.
+     */
+    size_t slot_size;
+
+    /**
+     * The number of slots in each slab.
+     */
+    size_t slots_per_slab;
+
+    /**
+     * The slabs of the size class.
+     */
+    CosPoolSlab * COS_Nullable slabs;
+
+    /**
+     * The free slots of the size class.
+     */
+    CosPoolFreeSlot * COS_Nullable free_list;
+
+    size_t slab_count;
+    size_t live_count;
+} CosPoolSizeClass;
+
+typedef struct CosPool {
+    /**
+     * The allocator used to allocate the slabs and large allocations.
+     */
+    CosAllocator *parent;
+
+    CosPoolSizeClass size_classes[COS_POOL_ALLOCATOR_SIZE_CLASS_COUNT];
+
+    /**
+     * The number of live allocations that were forwarded to the parent allocator.
+     */
+    size_t large_live_count;
+} CosPool;
+
+COS_STATIC_INLINE CosPoolSlab * COS_Nullable
+cos_pool_alloc_get_slab_(const void *ptr)
+{
+    CosPoolSlab *slab = NULL;
+    memcpy(&slab, (const unsigned char *)ptr - COS_POOL_SLOT_HEADER_SIZE, sizeof(slab));
+    return slab;
+}
+
+COS_STATIC_INLINE void
+cos_pool_alloc_set_slab_(void *ptr,
+                         CosPoolSlab * COS_Nullable slab)
+{
+    memcpy((unsigned char *)ptr - COS_POOL_SLOT_HEADER_SIZE, &slab, sizeof(slab));
+}
+
+static bool
+cos_pool_add_slab_(CosPool *pool,
+                   size_t size_class_index)
+{
+    COS_IMPL_PARAM_CHECK(pool != NULL);
+
+    CosPoolSizeClass * const size_class = &pool->size_classes[size_class_index];
+    const size_t slot_stride = COS_POOL_SLOT_HEADER_SIZE + size_class->slot_size;
+
+    CosPoolSlab * const slab = cos_allocator_alloc(pool->parent,
+                                                   COS_POOL_SLAB_HEADER_SIZE + (slot_stride * size_class->slots_per_slab));
+    if (!slab) {
+        return false;
+    }
+
+    slab->size_class_index = size_class_index;
+    slab->next = size_class->slabs;
+    size_class->slabs = slab;
+    size_class->slab_count++;
+
+    // Push the slots onto the free list in reverse, so that they are handed out in address order.
+    unsigned char * const slots = (unsigned char *)slab + COS_POOL_SLAB_HEADER_SIZE;
+    for (size_t i = size_class->slots_per_slab; i > 0; i--) {
+        unsigned char * const ptr = slots + ((i - 1) * slot_stride) + COS_POOL_SLOT_HEADER_SIZE;
+        cos_pool_alloc_set_slab_(ptr, slab);
+
+        CosPoolFreeSlot * const free_slot = (CosPoolFreeSlot *)(void *)ptr;
+        free_slot->next = size_class->free_list;
+        size_class->free_list = free_slot;
+    }
+
+    return true;
+}
+
+static void * COS_Nullable
+cos_pool_alloc_(size_t size,
+                void * COS_Nullable user_data)
+{
+    CosPool * const pool = user_data;
+    if (!pool || size == 0) {
+        return NULL;
+    }
+
+    const size_t size_class_index = (size - 1) / COS_POOL_SIZE_CLASS_GRANULARITY;
+    if (size_class_index >= COS_POOL_ALLOCATOR_SIZE_CLASS_COUNT) {
+        // Forward the allocation to the parent allocator.
+        unsigned char * const base = cos_allocator_alloc(pool->parent,
+                                                         COS_POOL_SLOT_HEADER_SIZE + size);
+        if (!base) {
+            return NULL;
+        }
+
+        unsigned char * const ptr = base + COS_POOL_SLOT_HEADER_SIZE;
+        cos_pool_alloc_set_slab_(ptr, NULL);
+        pool->large_live_count++;
+
+        return ptr;
+    }
+
+    CosPoolSizeClass * const size_class = &pool->size_classes[size_class_index];
+    if (!size_class->free_list && !cos_pool_add_slab_(pool, size_class_index)) {
+        return NULL;
+    }
+
+    CosPoolFreeSlot * const free_slot = COS_nonnull_cast(size_class->free_list);
+    size_class->free_list = free_slot->next;
+    size_class->live_count++;
+
+    return free_slot;
+}
+
+static void
+cos_pool_dealloc_(void *ptr,
+                  void * COS_Nullable user_data)
+{
+    CosPool * const pool = user_data;
+    if (!pool) {
+        return;
+    }
+
+    CosPoolSlab * const slab = cos_pool_alloc_get_slab_(ptr);
+    if (!slab) {
+        cos_allocator_dealloc(pool->parent, (unsigned char *)ptr - COS_POOL_SLOT_HEADER_SIZE);
+        pool->large_live_count--;
+        return;
+    }
+
+    CosPoolSizeClass * const size_class = &pool->size_classes[slab->size_class_index];
+
+    CosPoolFreeSlot * const free_slot = ptr;
+    free_slot->next = size_class->free_list;
+    size_class->free_list = free_slot;
+    size_class->live_count--;
+}
+
+static void * COS_Nullable
+cos_pool_realloc_(void * COS_Nullable ptr,
+                  size_t size,
+                  void * COS_Nullable user_data)
+{
+    CosPool * const pool = user_data;
+    if (!pool) {
+        return NULL;
+    }
+
+    if (!ptr) {
+        return cos_pool_alloc_(size, pool);
+    }
+    else if (size == 0) {
+        cos_pool_dealloc_(COS_nonnull_cast(ptr), pool);
+        return NULL;
+    }
+
+    CosPoolSlab * const slab = cos_pool_alloc_get_slab_(COS_nonnull_cast(ptr));
+    if (!slab) {
+        if ((size - 1) / COS_POOL_SIZE_CLASS_GRANULARITY >= COS_POOL_ALLOCATOR_SIZE_CLASS_COUNT) {
+            // The allocation stays too large for a size class.
+            unsigned char * const base = cos_allocator_realloc(pool->parent,
+                                                               (unsigned char *)ptr - COS_POOL_SLOT_HEADER_SIZE,
+                                                               COS_POOL_SLOT_HEADER_SIZE + size);
+            if (!base) {
+                return NULL;
+            }
+            return base + COS_POOL_SLOT_HEADER_SIZE;
+        }
+    }
+    else if (size <= pool->size_classes[slab->size_class_index].slot_size) {
+        // The allocation still fits in its slot.
+        return ptr;
+    }
+
+    void * const new_ptr = cos_pool_alloc_(size, pool);
+    if (!new_ptr) {
+        return NULL;
+    }
+
+    // A slot only moves when it grows, and a large allocation only moves into a slot when it
+    // shrinks, so the smaller of the two sizes is known either way.
+    const size_t copy_size = slab ? pool->size_classes[slab->size_class_index].slot_size : size;
+    memcpy(new_ptr, ptr, copy_size);
+    cos_pool_dealloc_(COS_nonnull_cast(ptr), pool);
+
+    return new_ptr;
+}
+
+static void
+cos_pool_release_(void *user_data)
+{
+    CosPool * const pool = user_data;
+    CosAllocator * const parent = pool->parent;
+
+    for (size_t i = 0; i < COS_POOL_ALLOCATOR_SIZE_CLASS_COUNT; i++) {
+        CosPoolSlab *slab = pool->size_classes[i].slabs;
+        while (slab) {
+            CosPoolSlab * const next = slab->next;
+            cos_allocator_dealloc(parent, slab);
+            slab = next;
+        }
+    }
+
+    cos_allocator_dealloc(parent, pool);
+}
+
+static const CosAllocatorCallbacks cos_pool_callbacks_ = {
+    .alloc = &cos_pool_alloc_,
+    .realloc = &cos_pool_realloc_,
+    .dealloc = &cos_pool_dealloc_,
+    .retain = NULL,
+    .release = &cos_pool_release_,
+};
+
+CosAllocator *
+cos_allocator_create_pool(CosAllocator * COS_Nullable allocator)
+{
+    CosAllocator * const parent_allocator = allocator ? allocator : CosAllocatorDefault;
+
+    CosPool * const pool = cos_allocator_alloc(COS_nonnull_cast(parent_allocator),
+                                               sizeof(CosPool));
+    if (!pool) {
+        return NULL;
+    }
+
+    memset(pool, 0, sizeof(CosPool));
+    pool->parent = COS_nonnull_cast(parent_allocator);
+
+    for (size_t i = 0; i < COS_POOL_ALLOCATOR_SIZE_CLASS_COUNT; i++) {
+        CosPoolSizeClass * const size_class = &pool->size_classes[i];
+        size_class->slot_size = (i + 1) * COS_POOL_SIZE_CLASS_GRANULARITY;
+        size_class->slots_per_slab = COS_POOL_SLAB_SIZE / (COS_POOL_SLOT_HEADER_SIZE + size_class->slot_size);
+    }
+
+    CosAllocator * const pool_allocator = cos_allocator_create(parent_allocator,
+                                                               &cos_pool_callbacks_,
+                                                               pool);
+    if (!pool_allocator) {
+        cos_allocator_dealloc(COS_nonnull_cast(parent_allocator), pool);
+        return NULL;
+    }
+
+    return pool_allocator;
+}
+
+bool
+cos_allocator_get_pool_stats(const CosAllocator *allocator,
+                             CosPoolAllocatorStats *out_stats)
+{
+    COS_API_PARAM_CHECK(allocator != NULL);
+    COS_API_PARAM_CHECK(out_stats != NULL);
+    if (!allocator || !out_stats) {
+        return false;
+    }
+
+    if (allocator->callbacks.alloc != &cos_pool_alloc_ || !allocator->user_data) {
+        return false;
+    }
+
+    const CosPool * const pool = allocator->user_data;
+
+    memset(out_stats, 0, sizeof(CosPoolAllocatorStats));
+
+    for (size_t i = 0; i < COS_POOL_ALLOCATOR_SIZE_CLASS_COUNT; i++) {
+        const CosPoolSizeClass * const size_class = &pool->size_classes[i];
+        CosPoolAllocatorSizeClassStats * const size_class_stats = &out_stats->size_classes[i];
+
+        size_class_stats->slot_size = size_class->slot_size;
+        size_class_stats->slab_count = size_class->slab_count;
+        size_class_stats->slot_count = size_class->slab_count * size_class->slots_per_slab;
+        size_class_stats->live_count = size_class->live_count;
+
+        out_stats->slab_count += size_class_stats->slab_count;
+        out_stats->slot_count += size_class_stats->slot_count;
+        out_stats->live_count += size_class_stats->live_count;
+    }
+
+    out_stats->large_live_count = pool->large_live_count;
+
+    return true;
+}
+
 COS_ASSUME_NONNULL_END
@@ -8,7 +8,9 @@
 
 #include <libcos/common/memory/CosAllocator.h>
 
+#include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 
 COS_ASSUME_NONNULL_BEGIN
 
@@ -27,6 +29,29 @@ cos_alloc(CosAllocator * COS_Nullable allocator,
     }
 }
 
+void *
+cos_calloc(CosAllocator * COS_Nullable allocator,
+           size_t count,
+           size_t size)
+{
+    COS_API_PARAM_CHECK(count > 0 && size > 0);
+
+    if (!allocator) {
+        return calloc(count, size);
+    }
+
+    if (COS_UNLIKELY(count > SIZE_MAX / size)) {
+        return NULL;
+    }
+
+    void * const ptr = cos_allocator_alloc(COS_nonnull_cast(allocator),
+                                           count * size);
+    if (ptr) {
+        memset(ptr, 0, count * size);
+    }
+    return ptr;
+}
+
 void *
 cos_realloc(CosAllocator * COS_Nullable allocator,
             void * COS_Nullable ptr,
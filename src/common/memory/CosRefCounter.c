@@ -3,3 +3,67 @@
  */
 
 #include "CosRefCounter.h"
+
+#include "common/Assert.h"
+#include "common/CosAtomic.h"
+
+#include <limits.h>
+
+COS_ASSUME_NONNULL_BEGIN
+
+void
+cos_ref_counter_init(CosRefCounter *counter,
+                     void * COS_Nullable context,
+                     void (* COS_Nullable retain)(CosRefCounter *counter),
+                     void (* COS_Nullable release)(CosRefCounter *counter),
+                     void (* COS_Nullable dealloc)(CosRefCounter *counter))
+{
+    COS_API_PARAM_CHECK(counter != NULL);
+    if (!counter) {
+        return;
+    }
+
+    counter->count = 1;
+    counter->context = context;
+    counter->retain = retain;
+    counter->release = release;
+    counter->dealloc = dealloc;
+}
+
+void
+cos_ref_counter_retain(CosRefCounter *counter)
+{
+    COS_API_PARAM_CHECK(counter != NULL);
+    if (!counter) {
+        return;
+    }
+
+    cos_ref_count_increment(&counter->count);
+
+    if (counter->retain) {
+        counter->retain(counter);
+    }
+}
+
+void
+cos_ref_counter_release(CosRefCounter *counter)
+{
+    COS_API_PARAM_CHECK(counter != NULL);
+    if (!counter) {
+        return;
+    }
+
+    if (counter->release) {
+        counter->release(counter);
+    }
+
+    if (!cos_ref_count_decrement(&counter->count, UINT_MAX)) {
+        return;
+    }
+
+    if (counter->dealloc) {
+        counter->dealloc(counter);
+    }
+}
+
+COS_ASSUME_NONNULL_END
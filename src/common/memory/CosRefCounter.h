@@ -14,25 +14,50 @@ COS_ASSUME_NONNULL_BEGIN
 
 typedef struct CosRefCounter CosRefCounter;
 
+/**
+ * A reference count with callbacks.
+ *
+ * The count is updated with the same operations as object reference counts, so it is atomic
+ * if the library is built with @c COS_ENABLE_ATOMIC_REF_COUNTS.
+ */
 struct CosRefCounter {
-    size_t count;
+    unsigned int count;
 
     void * COS_Nullable context;
-    void (*retain)(CosRefCounter *counter);
-    void (*release)(CosRefCounter *counter);
-    void (*dealloc)(CosRefCounter *counter);
+    void (* COS_Nullable retain)(CosRefCounter *counter);
+    void (* COS_Nullable release)(CosRefCounter *counter);
+    void (* COS_Nullable dealloc)(CosRefCounter *counter);
 };
 
+/**
+ * @brief Initializes a reference counter with a count of 1.
+ *
+ * @param counter The counter.
+ * @param context The context of the counter.
+ * @param retain Called after each retain, or @c NULL.
+ * @param release Called before each release, or @c NULL.
+ * @param dealloc Called when the last reference is released, or @c NULL.
+ */
 void
 cos_ref_counter_init(CosRefCounter *counter,
                      void * COS_Nullable context,
-                     void (*retain)(CosRefCounter *counter),
-                     void (*release)(CosRefCounter *counter),
-                     void (*dealloc)(CosRefCounter *counter));
+                     void (* COS_Nullable retain)(CosRefCounter *counter),
+                     void (* COS_Nullable release)(CosRefCounter *counter),
+                     void (* COS_Nullable dealloc)(CosRefCounter *counter));
 
+/**
+ * @brief Increments the count.
+ *
+ * @param counter The counter.
+ */
 void
 cos_ref_counter_retain(CosRefCounter *counter);
 
+/**
+ * @brief Decrements the count, calling the @c dealloc callback if it reaches zero.
+ *
+ * @param counter The counter.
+ */
 void
 cos_ref_counter_release(CosRefCounter *counter);
 
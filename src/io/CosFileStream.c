@@ -13,6 +13,10 @@
 #include <stdlib.h>
 #include <string.h>
 
+#if COS_HAVE_PREAD
+    #include <unistd.h>
+#endif
+
 #if COS_HAS_LARGE_FILE_SUPPORT
     #define cos_fseek fseeko
 #else
@@ -30,6 +34,17 @@ cos_file_stream_read_(CosStream *stream,
                       size_t size,
                       CosError * COS_Nullable out_error);
 
+#if COS_HAVE_PREAD
+
+static size_t
+cos_file_stream_read_at_(CosStream *stream,
+                         CosStreamOffset offset,
+                         void *buffer,
+                         size_t size,
+                         CosError * COS_Nullable out_error);
+
+#endif
+
 static size_t
 cos_file_stream_write_(CosStream *stream,
                        const void *buffer,
@@ -108,6 +123,9 @@ cos_file_stream_init(CosFileStream *file_stream,
 
     const CosStreamFunctions functions = {
         .read_func = &cos_file_stream_read_,
+#if COS_HAVE_PREAD
+        .read_at_func = &cos_file_stream_read_at_,
+#endif
         .write_func = &cos_file_stream_write_,
         .seek_func = &cos_file_stream_seek_,
         .tell_func = &cos_file_stream_tell_,
@@ -157,6 +175,50 @@ cos_file_stream_read_(CosStream *stream,
     return fread_result;
 }
 
+#if COS_HAVE_PREAD
+
+static size_t
+cos_file_stream_read_at_(CosStream *stream,
+                         CosStreamOffset offset,
+                         void *buffer,
+                         size_t size,
+                         CosError * COS_Nullable out_error)
+{
+    COS_IMPL_PARAM_CHECK(stream != NULL);
+    COS_IMPL_PARAM_CHECK(buffer != NULL);
+    COS_IMPL_PARAM_CHECK(size > 0);
+
+    CosFileStream * const file_stream = (CosFileStream *)stream;
+    COS_ASSERT(cos_file_stream_is_valid_(file_stream),
+               "Expected a valid file stream stream");
+
+    // Read from the file descriptor, bypassing the FILE's buffer and offset.
+    const int fd = fileno(file_stream->file);
+
+    size_t total_read = 0;
+    while (total_read < size) {
+        const ssize_t pread_result = pread(fd,
+                                           (unsigned char *)buffer + total_read,
+                                           size - total_read,
+                                           (off_t)offset + (off_t)total_read);
+        if (pread_result < 0) {
+            COS_ERROR_PROPAGATE(cos_error_make(COS_ERROR_IO,
+                                               "Error reading from file"),
+                                out_error);
+            break;
+        }
+        else if (pread_result == 0) {
+            // End of file.
+            break;
+        }
+        total_read += (size_t)pread_result;
+    }
+
+    return total_read;
+}
+
+#endif /* COS_HAVE_PREAD */
+
 static size_t
 cos_file_stream_write_(CosStream *stream,
                        const void *buffer,
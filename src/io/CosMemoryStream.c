@@ -19,6 +19,13 @@ cos_memory_stream_read_(CosStream *stream,
                         size_t count,
                         CosError * COS_Nullable out_error);
 
+static size_t
+cos_memory_stream_read_at_(CosStream *stream,
+                           CosStreamOffset offset,
+                           void *buffer,
+                           size_t count,
+                           CosError * COS_Nullable out_error);
+
 static size_t
 cos_memory_stream_write_(CosStream *stream,
                          const void *buffer,
@@ -63,6 +70,7 @@ cos_memory_stream_create(void *buffer,
 
     const CosStreamFunctions stream_functions = {
         .read_func = &cos_memory_stream_read_,
+        .read_at_func = &cos_memory_stream_read_at_,
         .write_func = &cos_memory_stream_write_,
         .seek_func = &cos_memory_stream_seek_,
         .tell_func = &cos_memory_stream_tell_,
@@ -93,6 +101,7 @@ cos_memory_stream_create_readonly(const void *buffer,
 
     const CosStreamFunctions stream_functions = {
         .read_func = &cos_memory_stream_read_,
+        .read_at_func = &cos_memory_stream_read_at_,
         .write_func = NULL,
         .seek_func = &cos_memory_stream_seek_,
         .tell_func = &cos_memory_stream_tell_,
@@ -158,6 +167,35 @@ cos_memory_stream_read_(CosStream *stream,
     return read_count;
 }
 
+static size_t
+cos_memory_stream_read_at_(CosStream *stream,
+                           CosStreamOffset offset,
+                           void *buffer,
+                           size_t count,
+                           COS_ATTR_UNUSED CosError * COS_Nullable out_error)
+{
+    COS_IMPL_PARAM_CHECK(stream != NULL);
+    COS_IMPL_PARAM_CHECK(buffer != NULL);
+    COS_IMPL_PARAM_CHECK(offset >= 0);
+
+    const CosMemoryStream * const memory_stream = (const CosMemoryStream *)stream;
+
+    // The stream's position is neither read nor written, so this is safe to call concurrently.
+    const size_t size = memory_stream->size;
+    if ((size_t)offset >= size) {
+        return 0;
+    }
+
+    const size_t remaining = size - (size_t)offset;
+    const size_t read_count = (count < remaining) ? count : remaining;
+
+    memcpy(buffer,
+           memory_stream->buffer.read + offset,
+           read_count);
+
+    return read_count;
+}
+
 static size_t
 cos_memory_stream_write_(CosStream *stream,
                          const void *buffer,
@@ -0,0 +1,287 @@
+/*
+ * Copyright (c) 2025 OpenCOS.
+ */
+
+#include "io/CosReadAheadStream.h"
+
+#include "common/Assert.h"
+
+#include <libcos/common/CosError.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+COS_ASSUME_NONNULL_BEGIN
+
+typedef struct CosReadAheadStream {
+    CosStream base;
+
+    /**
+     * The source stream. Borrowed.
+     */
+    CosStream *source;
+
+    unsigned char *buffer COS_ATTR_NONSTRING;
+    size_t buffer_capacity;
+
+    /**
+     * The offset in the source stream of the first byte of @a buffer .
+     */
+    CosStreamOffset buffer_start;
+
+    /**
+     * The number of valid bytes in @a buffer .
+     */
+    size_t buffer_length;
+
+    /**
+     * The stream's offset in the source stream.
+     */
+    CosStreamOffset position;
+
+    /**
+     * The offset at which the source stream ended, once a fill came up short.
+     */
+    CosStreamOffset end_position;
+    bool end_found;
+} CosReadAheadStream;
+
+static bool
+cos_read_ahead_stream_fill_(CosReadAheadStream *stream,
+                            CosError * COS_Nullable out_error)
+    COS_ATTR_ACCESS_WRITE_ONLY(2);
+
+static size_t
+cos_read_ahead_stream_read_(CosStream *stream,
+                            void *buffer,
+                            size_t count,
+                            CosError * COS_Nullable out_error);
+
+static bool
+cos_read_ahead_stream_seek_(CosStream *stream,
+                            CosStreamOffset offset,
+                            CosStreamOffsetWhence whence,
+                            CosError * COS_Nullable out_error);
+
+static CosStreamOffset
+cos_read_ahead_stream_tell_(CosStream *stream,
+                            CosError * COS_Nullable out_error);
+
+static bool
+cos_read_ahead_stream_eof_(CosStream *stream);
+
+static void
+cos_read_ahead_stream_close_(CosStream *stream);
+
+CosStream *
+cos_read_ahead_stream_create(CosStream *source,
+                             size_t buffer_size)
+{
+    COS_API_PARAM_CHECK(source != NULL);
+    COS_API_PARAM_CHECK(buffer_size > 0);
+    if (COS_UNLIKELY(!source || buffer_size == 0)) {
+        return NULL;
+    }
+
+    if (!cos_stream_can_read_at(source) && !cos_stream_can_seek(source)) {
+        return NULL;
+    }
+
+    CosReadAheadStream * const stream = calloc(1, sizeof(CosReadAheadStream));
+    if (COS_UNLIKELY(!stream)) {
+        return NULL;
+    }
+
+    stream->buffer = malloc(buffer_size);
+    if (COS_UNLIKELY(!stream->buffer)) {
+        free(stream);
+        return NULL;
+    }
+
+    stream->source = source;
+    stream->buffer_capacity = buffer_size;
+    stream->buffer_start = 0;
+    stream->buffer_length = 0;
+    stream->position = 0;
+    stream->end_position = 0;
+    stream->end_found = false;
+
+    const CosStreamFunctions functions = {
+        .read_func = &cos_read_ahead_stream_read_,
+        .read_at_func = NULL,
+        .write_func = NULL,
+        .seek_func = &cos_read_ahead_stream_seek_,
+        .tell_func = &cos_read_ahead_stream_tell_,
+        .eof_func = &cos_read_ahead_stream_eof_,
+        .close_func = &cos_read_ahead_stream_close_,
+    };
+
+    cos_stream_init(&(stream->base),
+                    &functions);
+
+    return (CosStream *)stream;
+}
+
+/**
+ * Fills the buffer with the source's data from the stream's offset onwards.
+ */
+static bool
+cos_read_ahead_stream_fill_(CosReadAheadStream *stream,
+                            CosError * COS_Nullable out_error)
+{
+    COS_IMPL_PARAM_CHECK(stream != NULL);
+
+    stream->buffer_start = stream->position;
+    stream->buffer_length = 0;
+
+    size_t read_count = 0;
+    if (cos_stream_can_read_at(stream->source)) {
+        read_count = cos_stream_read_at(stream->source,
+                                        stream->position,
+                                        stream->buffer,
+                                        stream->buffer_capacity,
+                                        out_error);
+    }
+    else {
+        // Someone else may have moved the source since the last fill.
+        if (!cos_stream_seek(stream->source, stream->position, CosStreamOffsetWhence_Set, out_error)) {
+            return false;
+        }
+        read_count = cos_stream_read(stream->source,
+                                     stream->buffer,
+                                     stream->buffer_capacity,
+                                     out_error);
+    }
+
+    stream->buffer_length = read_count;
+    if (read_count < stream->buffer_capacity) {
+        stream->end_found = true;
+        stream->end_position = stream->position + (CosStreamOffset)read_count;
+    }
+
+    return true;
+}
+
+static size_t
+cos_read_ahead_stream_read_(CosStream *stream,
+                            void *buffer,
+                            size_t count,
+                            CosError * COS_Nullable out_error)
+{
+    COS_IMPL_PARAM_CHECK(stream != NULL);
+    COS_IMPL_PARAM_CHECK(buffer != NULL);
+
+    CosReadAheadStream * const read_ahead = (CosReadAheadStream *)stream;
+    unsigned char * const output = buffer;
+
+    size_t total_count = 0;
+    while (total_count < count) {
+        const CosStreamOffset buffer_end = read_ahead->buffer_start + (CosStreamOffset)read_ahead->buffer_length;
+        if (read_ahead->position < read_ahead->buffer_start || read_ahead->position >= buffer_end) {
+            if (read_ahead->end_found && read_ahead->position >= read_ahead->end_position) {
+                break;
+            }
+            if (!cos_read_ahead_stream_fill_(read_ahead, out_error) || read_ahead->buffer_length == 0) {
+                break;
+            }
+            continue;
+        }
+
+        const size_t buffer_offset = (size_t)(read_ahead->position - read_ahead->buffer_start);
+        size_t chunk_count = read_ahead->buffer_length - buffer_offset;
+        if (chunk_count > count - total_count) {
+            chunk_count = count - total_count;
+        }
+
+        memcpy(output + total_count, read_ahead->buffer + buffer_offset, chunk_count);
+        total_count += chunk_count;
+        read_ahead->position += (CosStreamOffset)chunk_count;
+    }
+
+    return total_count;
+}
+
+static bool
+cos_read_ahead_stream_seek_(CosStream *stream,
+                            CosStreamOffset offset,
+                            CosStreamOffsetWhence whence,
+                            CosError * COS_Nullable out_error)
+{
+    COS_IMPL_PARAM_CHECK(stream != NULL);
+
+    CosReadAheadStream * const read_ahead = (CosReadAheadStream *)stream;
+
+    CosStreamOffset base_offset = 0;
+    switch (whence) {
+        case CosStreamOffsetWhence_Set:
+            base_offset = 0;
+            break;
+        case CosStreamOffsetWhence_Current:
+            base_offset = read_ahead->position;
+            break;
+        case CosStreamOffsetWhence_End: {
+            // The end is only known once a fill has reached it.
+            if (!read_ahead->end_found) {
+                if (!cos_stream_seek(read_ahead->source, 0, CosStreamOffsetWhence_End, out_error)) {
+                    return false;
+                }
+                const CosStreamOffset end_position = cos_stream_get_position(read_ahead->source, out_error);
+                if (end_position < 0) {
+                    return false;
+                }
+                read_ahead->end_position = end_position;
+                read_ahead->end_found = true;
+            }
+            base_offset = read_ahead->end_position;
+        } break;
+    }
+
+    const CosStreamOffset position = base_offset + offset;
+    if (position < 0) {
+        COS_ERROR_PROPAGATE(cos_error_make(COS_ERROR_OUT_OF_RANGE,
+                                           "Stream offset out of range"),
+                            out_error);
+        return false;
+    }
+
+    // The next read fills the buffer from the new offset if it is outside the buffer.
+    read_ahead->position = position;
+
+    stream->flags = (CosStreamFlags)((unsigned int)stream->flags & ~(unsigned int)CosStreamFlag_EOF);
+
+    return true;
+}
+
+static CosStreamOffset
+cos_read_ahead_stream_tell_(CosStream *stream,
+                            COS_ATTR_UNUSED CosError * COS_Nullable out_error)
+{
+    COS_IMPL_PARAM_CHECK(stream != NULL);
+
+    const CosReadAheadStream * const read_ahead = (const CosReadAheadStream *)stream;
+
+    return read_ahead->position;
+}
+
+static bool
+cos_read_ahead_stream_eof_(CosStream *stream)
+{
+    COS_IMPL_PARAM_CHECK(stream != NULL);
+
+    const CosReadAheadStream * const read_ahead = (const CosReadAheadStream *)stream;
+
+    return (read_ahead->end_found && read_ahead->position >= read_ahead->end_position);
+}
+
+static void
+cos_read_ahead_stream_close_(CosStream *stream)
+{
+    COS_IMPL_PARAM_CHECK(stream != NULL);
+
+    CosReadAheadStream * const read_ahead = (CosReadAheadStream *)stream;
+
+    free(read_ahead->buffer);
+    read_ahead->buffer = NULL;
+}
+
+COS_ASSUME_NONNULL_END
@@ -0,0 +1,42 @@
+/*
+ * Copyright (c) 2025 OpenCOS.
+ */
+
+#ifndef LIBCOS_IO_COS_READ_AHEAD_STREAM_H
+#define LIBCOS_IO_COS_READ_AHEAD_STREAM_H
+
+#include <libcos/common/CosBasicTypes.h>
+#include <libcos/common/CosDefines.h>
+#include <libcos/common/CosTypes.h>
+#include <libcos/io/CosStream.h>
+
+#include <stddef.h>
+
+COS_DECLS_BEGIN
+COS_ASSUME_NONNULL_BEGIN
+
+/**
+ * @brief Creates a read-only stream that reads from another stream in large blocks.
+ *
+ * The stream keeps its own offset, and only touches @p source to fill its buffer, with a
+ * positional read if @p source supports them, or with a seek and a read otherwise. Seeks are
+ * free, and a forward seek that lands within the buffer does not touch @p source at all, so
+ * skipping over data that is smaller than the buffer costs nothing.
+ *
+ * The stream borrows @p source , which must outlive it.
+ *
+ * @param source The source stream, which must be seekable or support positional reads.
+ * @param buffer_size The size of the read-ahead buffer, in bytes.
+ *
+ * @return A new stream, or @c NULL if an error occurred. Close it with @c cos_stream_close .
+ */
+CosStream * COS_Nullable
+cos_read_ahead_stream_create(CosStream *source,
+                             size_t buffer_size)
+    COS_ALLOCATOR_FUNC
+    COS_ALLOCATOR_FUNC_MATCHED_DEALLOC(cos_stream_close);
+
+COS_ASSUME_NONNULL_END
+COS_DECLS_END
+
+#endif /* LIBCOS_IO_COS_READ_AHEAD_STREAM_H */
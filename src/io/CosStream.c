@@ -83,6 +83,56 @@ cos_stream_read(CosStream *stream,
                                        out_error);
 }
 
+bool
+cos_stream_can_read_at(const CosStream *stream)
+{
+    COS_API_PARAM_CHECK(stream != NULL);
+    if (COS_UNLIKELY(!stream)) {
+        return false;
+    }
+
+    return (stream->functions.read_at_func != NULL);
+}
+
+size_t
+cos_stream_read_at(CosStream *stream,
+                   CosStreamOffset offset,
+                   void *buffer,
+                   size_t count,
+                   CosError * COS_Nullable out_error)
+{
+    COS_API_PARAM_CHECK(stream != NULL);
+    COS_API_PARAM_CHECK(buffer != NULL);
+    if (COS_UNLIKELY(!stream || !buffer)) {
+        return 0;
+    }
+
+    if (!stream->functions.read_at_func) {
+        COS_ERROR_PROPAGATE(cos_error_make(COS_ERROR_INVALID_ARGUMENT,
+                                           "Stream does not support positional reading"),
+                            out_error);
+        return 0;
+    }
+
+    if (offset < 0) {
+        COS_ERROR_PROPAGATE(cos_error_make(COS_ERROR_INVALID_ARGUMENT,
+                                           "Invalid negative offset"),
+                            out_error);
+        return 0;
+    }
+
+    // Skip doing any work if we don't need to read any data.
+    if (COS_UNLIKELY(count == 0)) {
+        return 0;
+    }
+
+    return stream->functions.read_at_func(stream,
+                                          offset,
+                                          buffer,
+                                          count,
+                                          out_error);
+}
+
 bool
 cos_stream_can_write(const CosStream *stream)
 {
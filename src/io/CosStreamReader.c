@@ -26,6 +26,12 @@ struct CosStreamReader {
     size_t buffer_end;
     size_t buffer_position;
 
+    /**
+     * The offset in the input stream of the first byte of the buffer, or @c -1 if the buffer
+     * has not been filled since the last reset.
+     */
+    CosStreamOffset buffer_offset;
+
     bool is_eof;
     size_t eof_position;
 };
@@ -64,6 +70,7 @@ cos_stream_reader_create(CosStream *input_stream)
 
     reader->buffer_end = 0;
     reader->buffer_position = 0;
+    reader->buffer_offset = -1;
 
     reader->is_eof = false;
     reader->eof_position = 0;
@@ -101,25 +108,77 @@ cos_stream_reader_reset(CosStreamReader *stream_reader)
 
     stream_reader->buffer_end = 0;
     stream_reader->buffer_position = 0;
+    stream_reader->buffer_offset = -1;
 
     stream_reader->is_eof = false;
     stream_reader->eof_position = 0;
 }
 
+bool
+cos_stream_reader_seek(CosStreamReader *stream_reader,
+                       CosStreamOffset offset,
+                       CosError * COS_Nullable out_error)
+{
+    COS_API_PARAM_CHECK(stream_reader != NULL);
+    if (COS_UNLIKELY(!stream_reader)) {
+        return false;
+    }
+
+    // Stay in the buffer if the offset is in the bytes that were read last.
+    if (stream_reader->buffer_offset >= 0 &&
+        offset >= stream_reader->buffer_offset &&
+        offset <= stream_reader->buffer_offset + (CosStreamOffset)stream_reader->buffer_end) {
+        stream_reader->buffer_position = (size_t)(offset - stream_reader->buffer_offset);
+        return true;
+    }
+
+    if (!cos_stream_seek(stream_reader->input_stream,
+                         offset,
+                         CosStreamOffsetWhence_Set,
+                         out_error)) {
+        return false;
+    }
+
+    cos_stream_reader_reset(stream_reader);
+    return true;
+}
+
 CosStreamOffset
 cos_stream_reader_get_position(CosStreamReader *stream_reader)
 {
     COS_API_PARAM_CHECK(stream_reader != NULL);
 
-    const CosStreamOffset stream_offset = cos_stream_get_position(stream_reader->input_stream,
-                                                                  NULL);
-    if (stream_offset == -1) {
-        return -1;
+    if (stream_reader->buffer_offset >= 0) {
+        return stream_reader->buffer_offset + (CosStreamOffset)stream_reader->buffer_position;
     }
 
-    const CosStreamOffset buffer_offset = (CosStreamOffset)(stream_reader->buffer_end - stream_reader->buffer_position);
+    return cos_stream_get_position(stream_reader->input_stream, NULL);
+}
 
-    return stream_offset - buffer_offset;
+const unsigned char *
+cos_stream_reader_get_buffered_bytes(CosStreamReader *stream_reader,
+                                     size_t *out_count)
+{
+    COS_API_PARAM_CHECK(stream_reader != NULL);
+    COS_API_PARAM_CHECK(out_count != NULL);
+
+    if (stream_reader->buffer_position >= stream_reader->buffer_end) {
+        *out_count = 0;
+        return NULL;
+    }
+
+    *out_count = stream_reader->buffer_end - stream_reader->buffer_position;
+    return &stream_reader->buffer[stream_reader->buffer_position];
+}
+
+void
+cos_stream_reader_skip_buffered(CosStreamReader *stream_reader,
+                                size_t count)
+{
+    COS_API_PARAM_CHECK(stream_reader != NULL);
+    COS_API_PARAM_CHECK(count <= stream_reader->buffer_end - stream_reader->buffer_position);
+
+    stream_reader->buffer_position += count;
 }
 
 int
@@ -165,6 +224,20 @@ cos_stream_reader_get_current_(CosStreamReader *stream_reader)
             return EOF;
         }
 
+        // The next bytes follow the buffer, unless it is empty. The input stream may be shared,
+        // so make sure that it is still there.
+        CosStreamOffset next_offset = -1;
+        if (stream_reader->buffer_offset >= 0) {
+            next_offset = stream_reader->buffer_offset + (CosStreamOffset)stream_reader->buffer_end;
+            if (cos_stream_get_position(stream_reader->input_stream, NULL) != next_offset &&
+                !cos_stream_seek(stream_reader->input_stream, next_offset, CosStreamOffsetWhence_Set, NULL)) {
+                return EOF;
+            }
+        }
+        else {
+            next_offset = cos_stream_get_position(stream_reader->input_stream, NULL);
+        }
+
         const size_t read_count = stream_reader->buffer_capacity;
 
         const size_t actual_read_count = cos_stream_read(stream_reader->input_stream,
@@ -173,6 +246,7 @@ cos_stream_reader_get_current_(CosStreamReader *stream_reader)
                                                          NULL);
         stream_reader->buffer_end = actual_read_count;
         stream_reader->buffer_position = 0;
+        stream_reader->buffer_offset = next_offset;
 
         if (actual_read_count < read_count) {
             if (cos_stream_is_at_end(stream_reader->input_stream,
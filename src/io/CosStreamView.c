@@ -0,0 +1,199 @@
+/*
+ * Copyright (c) 2025 OpenCOS.
+ */
+
+#include "io/CosStreamView.h"
+
+#include "common/Assert.h"
+
+#include <libcos/common/CosError.h>
+
+#include <stdlib.h>
+
+COS_ASSUME_NONNULL_BEGIN
+
+typedef struct CosStreamView {
+    CosStream base;
+
+    /**
+     * The source stream. Borrowed.
+     */
+    CosStream *source;
+
+    /**
+     * The size of the source stream.
+     */
+    CosStreamOffset size;
+
+    /**
+     * The view's offset in the source stream.
+     */
+    CosStreamOffset position;
+} CosStreamView;
+
+static size_t
+cos_stream_view_read_(CosStream *stream,
+                      void *buffer,
+                      size_t count,
+                      CosError * COS_Nullable out_error);
+
+static size_t
+cos_stream_view_read_at_(CosStream *stream,
+                         CosStreamOffset offset,
+                         void *buffer,
+                         size_t count,
+                         CosError * COS_Nullable out_error);
+
+static bool
+cos_stream_view_seek_(CosStream *stream,
+                      CosStreamOffset offset,
+                      CosStreamOffsetWhence whence,
+                      CosError * COS_Nullable out_error);
+
+static CosStreamOffset
+cos_stream_view_tell_(CosStream *stream,
+                      CosError * COS_Nullable out_error);
+
+static bool
+cos_stream_view_eof_(CosStream *stream);
+
+CosStream *
+cos_stream_view_create(CosStream *source,
+                       CosStreamOffset size)
+{
+    COS_API_PARAM_CHECK(source != NULL);
+    COS_API_PARAM_CHECK(size >= 0);
+    if (COS_UNLIKELY(!source || size < 0)) {
+        return NULL;
+    }
+
+    if (!cos_stream_can_read_at(source)) {
+        return NULL;
+    }
+
+    CosStreamView * const view = calloc(1, sizeof(CosStreamView));
+    if (COS_UNLIKELY(!view)) {
+        return NULL;
+    }
+
+    view->source = source;
+    view->size = size;
+    view->position = 0;
+
+    const CosStreamFunctions functions = {
+        .read_func = &cos_stream_view_read_,
+        .read_at_func = &cos_stream_view_read_at_,
+        .write_func = NULL,
+        .seek_func = &cos_stream_view_seek_,
+        .tell_func = &cos_stream_view_tell_,
+        .eof_func = &cos_stream_view_eof_,
+        .close_func = NULL,
+    };
+
+    cos_stream_init(&(view->base),
+                    &functions);
+
+    return (CosStream *)view;
+}
+
+static size_t
+cos_stream_view_read_(CosStream *stream,
+                      void *buffer,
+                      size_t count,
+                      CosError * COS_Nullable out_error)
+{
+    COS_IMPL_PARAM_CHECK(stream != NULL);
+    COS_IMPL_PARAM_CHECK(buffer != NULL);
+
+    CosStreamView * const view = (CosStreamView *)stream;
+
+    const size_t read_count = cos_stream_read_at(view->source,
+                                                 view->position,
+                                                 buffer,
+                                                 count,
+                                                 out_error);
+    view->position += (CosStreamOffset)read_count;
+
+    return read_count;
+}
+
+static size_t
+cos_stream_view_read_at_(CosStream *stream,
+                         CosStreamOffset offset,
+                         void *buffer,
+                         size_t count,
+                         CosError * COS_Nullable out_error)
+{
+    COS_IMPL_PARAM_CHECK(stream != NULL);
+    COS_IMPL_PARAM_CHECK(buffer != NULL);
+
+    const CosStreamView * const view = (const CosStreamView *)stream;
+
+    return cos_stream_read_at(view->source,
+                              offset,
+                              buffer,
+                              count,
+                              out_error);
+}
+
+static bool
+cos_stream_view_seek_(CosStream *stream,
+                      CosStreamOffset offset,
+                      CosStreamOffsetWhence whence,
+                      CosError * COS_Nullable out_error)
+{
+    COS_IMPL_PARAM_CHECK(stream != NULL);
+
+    CosStreamView * const view = (CosStreamView *)stream;
+
+    CosStreamOffset base_offset = 0;
+    switch (whence) {
+        case CosStreamOffsetWhence_Set:
+            base_offset = 0;
+            break;
+        case CosStreamOffsetWhence_Current:
+            base_offset = view->position;
+            break;
+        case CosStreamOffsetWhence_End:
+            base_offset = view->size;
+            break;
+    }
+
+    const CosStreamOffset position = base_offset + offset;
+    if (position < 0 || position > view->size) {
+        COS_ERROR_PROPAGATE(cos_error_make(COS_ERROR_OUT_OF_RANGE,
+                                           "Stream offset out of range"),
+                            out_error);
+        return false;
+    }
+
+    view->position = position;
+
+    // Seeking back from the end makes the view readable again.
+    stream->flags = (CosStreamFlags)((unsigned int)stream->flags & ~(unsigned int)CosStreamFlag_EOF);
+
+    return true;
+}
+
+static CosStreamOffset
+cos_stream_view_tell_(CosStream *stream,
+                      COS_ATTR_UNUSED CosError * COS_Nullable out_error)
+{
+    COS_IMPL_PARAM_CHECK(stream != NULL);
+
+    const CosStreamView * const view = (const CosStreamView *)stream;
+
+    return view->position;
+}
+
+static bool
+cos_stream_view_eof_(CosStream *stream)
+{
+    COS_IMPL_PARAM_CHECK(stream != NULL);
+
+    const CosStreamView * const view = (const CosStreamView *)stream;
+
+    return view->position >= view->size;
+}
+
+COS_ASSUME_NONNULL_END
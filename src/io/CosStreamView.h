@@ -0,0 +1,37 @@
+/*
+ * Copyright (c) 2025 OpenCOS.
+ */
+
+#ifndef LIBCOS_IO_COS_STREAM_VIEW_H
+#define LIBCOS_IO_COS_STREAM_VIEW_H
+
+#include <libcos/common/CosBasicTypes.h>
+#include <libcos/common/CosDefines.h>
+#include <libcos/common/CosTypes.h>
+#include <libcos/io/CosStream.h>
+
+COS_DECLS_BEGIN
+COS_ASSUME_NONNULL_BEGIN
+
+/**
+ * @brief Creates a read-only view of a stream, with its own offset.
+ *
+ * The view reads from @p source with positional reads, so any number of views of the same
+ * source can be used at once, from different threads, as long as the source is not written to.
+ * The view borrows @p source , which must outlive it.
+ *
+ * @param source The source stream, which must support positional reads.
+ * @param size The size of the source stream.
+ *
+ * @return A new stream, or @c NULL if an error occurred. Close it with @c cos_stream_close .
+ */
+CosStream * COS_Nullable
+cos_stream_view_create(CosStream *source,
+                       CosStreamOffset size)
+    COS_ALLOCATOR_FUNC
+    COS_ALLOCATOR_FUNC_MATCHED_DEALLOC(cos_stream_close);
+
+COS_ASSUME_NONNULL_END
+COS_DECLS_END
+
+#endif /* LIBCOS_IO_COS_STREAM_VIEW_H */
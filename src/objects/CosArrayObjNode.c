@@ -5,12 +5,17 @@
 #include "libcos/objects/CosArrayObjNode.h"
 
 #include "common/Assert.h"
+#include "common/CosAtomic.h"
 
 #include "libcos/objects/CosObjNode.h"
+#include "libcos/objects/CosObjValue.h"
 
 #include <libcos/common/CosArray.h>
+#include <libcos/common/CosError.h>
+#include <libcos/common/memory/CosMemory.h>
 
 #include <stdlib.h>
+#include <string.h>
 
 COS_ASSUME_NONNULL_BEGIN
 
@@ -30,26 +35,81 @@ const CosArrayCallbacks cos_array_obj_node_callbacks = {
 struct CosArrayObjNode {
     CosObjNodeType type;
     unsigned int ref_count;
-
-    CosArray *value;
+    CosAllocator * COS_Nullable allocator;
+
+    /**
+     * The elements, or @c NULL if the array is packed.
+     */
+    CosArray * COS_Nullable value;
+
+    /**
+     * The kind of the packed elements, either @c CosObjValueKind_Integer or
+     * @c CosObjValueKind_Real. Only valid if the array is packed.
+     */
+    CosObjValueKind packed_kind;
+
+    /**
+     * The number of packed elements.
+     */
+    size_t packed_count;
+
+    /**
+     * The packed elements, stored contiguously.
+     */
+    union {
+        int * COS_Nullable ints;
+        double * COS_Nullable reals;
+    } packed;
+
+    /**
+     * The object nodes of the inline elements of a frozen array, or @c NULL.
+     *
+     * A frozen array cannot replace an inline element with its object node, as other threads
+     * may be reading it. The object nodes are published here instead, one per element, when
+     * they are first requested.
+     */
+    CosObjNode * COS_Nullable * COS_Nullable frozen_nodes;
 };
 
+static bool
+cos_array_obj_node_unpack_(CosArrayObjNode *array_obj,
+                           CosError * COS_Nullable out_error);
+
+static CosObjNode * COS_Nullable
+cos_array_obj_node_get_frozen_node_(const CosArrayObjNode *array_obj,
+                                    size_t index,
+                                    CosError * COS_Nullable out_error);
+
+static bool
+cos_array_obj_node_check_mutable_(const CosArrayObjNode *array_obj,
+                                  CosError * COS_Nullable out_error);
+
+COS_STATIC_INLINE
+bool
+cos_array_obj_node_is_packed_(const CosArrayObjNode *array_obj)
+{
+    return (array_obj->value == NULL);
+}
+
 CosArrayObjNode *
-cos_array_obj_node_alloc(CosArray * COS_Nullable array)
+cos_array_obj_node_alloc(CosAllocator * COS_Nullable allocator,
+                         CosArray * COS_Nullable array)
 {
-    CosArrayObjNode * const array_obj = calloc(1, sizeof(CosArrayObjNode));
+    CosArrayObjNode * const array_obj = cos_calloc(allocator, 1, sizeof(CosArrayObjNode));
     if (!array_obj) {
         goto failure;
     }
 
     array_obj->type = CosObjNodeType_Array;
     array_obj->ref_count = 1;
+    array_obj->allocator = allocator;
 
     if (array) {
         array_obj->value = COS_nonnull_cast(array);
     }
     else {
-        CosArray * const new_array = cos_array_create(sizeof(CosObjNode *),
+        CosArray * const new_array = cos_array_create(allocator,
+                                                      sizeof(CosObjValue),
                                                       &cos_array_obj_node_callbacks,
                                                       0);
         if (!new_array) {
@@ -63,7 +123,7 @@ cos_array_obj_node_alloc(CosArray * COS_Nullable array)
 
 failure:
     if (array_obj) {
-        free(array_obj);
+        cos_free(allocator, array_obj);
     }
     return NULL;
 }
@@ -75,8 +135,97 @@ cos_array_obj_node_free(CosArrayObjNode *array_obj)
         return;
     }
 
-    cos_array_destroy(array_obj->value);
-    free(array_obj);
+    if (array_obj->frozen_nodes) {
+        CosObjNode * COS_Nullable * const frozen_nodes = COS_nonnull_cast(array_obj->frozen_nodes);
+        const size_t count = cos_array_obj_node_get_count(array_obj);
+        for (size_t i = 0; i < count; i++) {
+            if (frozen_nodes[i]) {
+                cos_obj_node_release(COS_nonnull_cast(frozen_nodes[i]));
+            }
+        }
+        cos_free(array_obj->allocator, frozen_nodes);
+    }
+
+    if (cos_array_obj_node_is_packed_(array_obj)) {
+        // Both members of the union point to the same allocation.
+        cos_free(array_obj->allocator, array_obj->packed.ints);
+    }
+    else {
+        cos_array_destroy(COS_nonnull_cast(array_obj->value));
+    }
+    cos_free(array_obj->allocator, array_obj);
+}
+
+bool
+cos_array_obj_node_pack(CosArrayObjNode *array_obj)
+{
+    COS_API_PARAM_CHECK(array_obj != NULL);
+    if (!array_obj) {
+        return false;
+    }
+
+    if (cos_array_obj_node_is_packed_(array_obj)) {
+        return true;
+    }
+    if (cos_obj_node_is_frozen((const CosObjNode *)array_obj)) {
+        return false;
+    }
+
+    CosArray * const array = COS_nonnull_cast(array_obj->value);
+    const size_t count = cos_array_get_count(array);
+    if (count == 0) {
+        return false;
+    }
+
+    // Only arrays of inline integers, or of inline real numbers, can be packed. Mixed arrays
+    // are not, so that each element keeps its type.
+    CosObjValue first_element;
+    if (!cos_array_get_item(array, 0, (void *)&first_element, NULL)) {
+        return false;
+    }
+    const CosObjValueKind packed_kind = first_element.kind;
+    if (packed_kind != CosObjValueKind_Integer && packed_kind != CosObjValueKind_Real) {
+        return false;
+    }
+    for (size_t i = 1; i < count; i++) {
+        CosObjValue element;
+        if (!cos_array_get_item(array, i, (void *)&element, NULL) ||
+            element.kind != packed_kind) {
+            return false;
+        }
+    }
+
+    const size_t element_size = (packed_kind == CosObjValueKind_Integer) ? sizeof(int) : sizeof(double);
+    void * const packed_data = cos_alloc(array_obj->allocator, count * element_size);
+    if (!packed_data) {
+        return false;
+    }
+
+    int * const ints = packed_data;
+    double * const reals = packed_data;
+    for (size_t i = 0; i < count; i++) {
+        CosObjValue element;
+        const bool got_item = cos_array_get_item(array, i, (void *)&element, NULL);
+        COS_ASSERT(got_item, "Expected the index to be in bounds");
+        (void)got_item;
+
+        if (packed_kind == CosObjValueKind_Integer) {
+            ints[i] = element.as.integer;
+        }
+        else {
+            reals[i] = element.as.real;
+        }
+    }
+
+    // The elements are all scalars, so nothing needs to be released.
+    cos_array_destroy(array);
+
+    array_obj->value = NULL;
+    array_obj->packed_kind = packed_kind;
+    array_obj->packed_count = count;
+    array_obj->packed.ints = ints;
+
+    return true;
 }
 
 size_t
@@ -87,7 +236,11 @@ cos_array_obj_node_get_count(const CosArrayObjNode *array_obj)
         return 0;
     }
 
-    return cos_array_get_count(array_obj->value);
+    if (cos_array_obj_node_is_packed_(array_obj)) {
+        return array_obj->packed_count;
+    }
+
+    return cos_array_get_count(COS_nonnull_cast(array_obj->value));
 }
 
 CosObjNode *
@@ -100,14 +253,188 @@ cos_array_obj_node_get_at(const CosArrayObjNode *array_obj,
         return NULL;
     }
 
-    CosObjNode *obj = NULL;
-    if (!cos_array_get_item(array_obj->value,
+    if (cos_obj_node_is_frozen((const CosObjNode *)array_obj)) {
+        return cos_array_obj_node_get_frozen_node_(array_obj, index, out_error);
+    }
+
+    // The array object is only logically const: the caller expects a node that is owned by
+    // the array, which a packed array does not have.
+    CosArrayObjNode * const mutable_array_obj = (CosArrayObjNode *)array_obj;
+    if (cos_array_obj_node_is_packed_(array_obj) &&
+        !cos_array_obj_node_unpack_(mutable_array_obj, out_error)) {
+        return NULL;
+    }
+    CosArray * const array = COS_nonnull_cast(array_obj->value);
+
+    CosObjValue value;
+    if (!cos_array_get_item(array,
                             index,
-                            (void *)&obj,
+                            (void *)&value,
                             out_error)) {
         return NULL;
     }
-    return obj;
+
+    if (value.kind == CosObjValueKind_Node) {
+        return value.as.node;
+    }
+
+    // Box the scalar and keep the node in its place.
+    CosObjNode * const node = cos_obj_value_box(array_obj->allocator, value);
+    if (!node) {
+        COS_ERROR_PROPAGATE(cos_error_make(COS_ERROR_MEMORY,
+                                           "Failed to allocate object"),
+                            out_error);
+        return NULL;
+    }
+
+    const CosObjValue node_value = cos_obj_value_make_node(node);
+    const bool stored = cos_array_set_item(array,
+                                           index,
+                                           (const void *)&node_value,
+                                           out_error);
+    COS_ASSERT(stored, "Expected the index to be in bounds");
+    (void)stored;
+
+    return node;
+}
+
+bool
+cos_array_obj_node_get_value_at(const CosArrayObjNode *array_obj,
+                                size_t index,
+                                CosObjValue *out_value,
+                                CosError * COS_Nullable out_error)
+{
+    COS_API_PARAM_CHECK(array_obj != NULL);
+    COS_API_PARAM_CHECK(out_value != NULL);
+    if (!array_obj || !out_value) {
+        return false;
+    }
+
+    if (!cos_array_obj_node_is_packed_(array_obj)) {
+        return cos_array_get_item(COS_nonnull_cast(array_obj->value),
+                                  index,
+                                  (void *)out_value,
+                                  out_error);
+    }
+
+    if (index >= array_obj->packed_count) {
+        COS_ERROR_PROPAGATE(cos_error_make(COS_ERROR_OUT_OF_RANGE,
+                                           "Index out of bounds"),
+                            out_error);
+        return false;
+    }
+
+    if (array_obj->packed_kind == CosObjValueKind_Integer) {
+        *out_value = cos_obj_value_make_int(array_obj->packed.ints[index]);
+    }
+    else {
+        *out_value = cos_obj_value_make_real(array_obj->packed.reals[index]);
+    }
+    return true;
+}
+
+bool
+cos_array_obj_node_get_numbers(const CosArrayObjNode *array_obj,
+                               size_t index,
+                               double *out_numbers,
+                               size_t count,
+                               CosError * COS_Nullable out_error)
+{
+    COS_API_PARAM_CHECK(array_obj != NULL);
+    COS_API_PARAM_CHECK(out_numbers != NULL || count == 0);
+    if (!array_obj || (!out_numbers && count > 0)) {
+        return false;
+    }
+
+    const size_t element_count = cos_array_obj_node_get_count(array_obj);
+    if (index > element_count || count > element_count - index) {
+        COS_ERROR_PROPAGATE(cos_error_make(COS_ERROR_OUT_OF_RANGE,
+                                           "Range out of bounds"),
+                            out_error);
+        return false;
+    }
+
+    if (cos_array_obj_node_is_packed_(array_obj)) {
+        if (array_obj->packed_kind == CosObjValueKind_Real) {
+            memcpy(out_numbers, array_obj->packed.reals + index, count * sizeof(double));
+        }
+        else {
+            const int * const ints = array_obj->packed.ints + index;
+            for (size_t i = 0; i < count; i++) {
+                out_numbers[i] = (double)ints[i];
+            }
+        }
+        return true;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        CosObjValue element;
+        if (!cos_array_get_item(COS_nonnull_cast(array_obj->value),
+                                index + i,
+                                (void *)&element,
+                                out_error)) {
+            return false;
+        }
+        if (!cos_obj_value_get_number(element, &out_numbers[i])) {
+            COS_ERROR_PROPAGATE(cos_error_make(COS_ERROR_INVALID_ARGUMENT,
+                                               "Element is not a number"),
+                                out_error);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool
+cos_array_obj_node_get_ints(const CosArrayObjNode *array_obj,
+                            size_t index,
+                            int *out_ints,
+                            size_t count,
+                            CosError * COS_Nullable out_error)
+{
+    COS_API_PARAM_CHECK(array_obj != NULL);
+    COS_API_PARAM_CHECK(out_ints != NULL || count == 0);
+    if (!array_obj || (!out_ints && count > 0)) {
+        return false;
+    }
+
+    const size_t element_count = cos_array_obj_node_get_count(array_obj);
+    if (index > element_count || count > element_count - index) {
+        COS_ERROR_PROPAGATE(cos_error_make(COS_ERROR_OUT_OF_RANGE,
+                                           "Range out of bounds"),
+                            out_error);
+        return false;
+    }
+
+    if (cos_array_obj_node_is_packed_(array_obj)) {
+        if (array_obj->packed_kind != CosObjValueKind_Integer && count > 0) {
+            COS_ERROR_PROPAGATE(cos_error_make(COS_ERROR_INVALID_ARGUMENT,
+                                               "Element is not an integer"),
+                                out_error);
+            return false;
+        }
+        memcpy(out_ints, array_obj->packed.ints + index, count * sizeof(int));
+        return true;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        CosObjValue element;
+        if (!cos_array_get_item(COS_nonnull_cast(array_obj->value),
+                                index + i,
+                                (void *)&element,
+                                out_error)) {
+            return false;
+        }
+        if (!cos_obj_value_get_int(element, &out_ints[i])) {
+            COS_ERROR_PROPAGATE(cos_error_make(COS_ERROR_INVALID_ARGUMENT,
+                                               "Element is not an integer"),
+                                out_error);
+            return false;
+        }
+    }
+
+    return true;
 }
 
 bool
@@ -122,9 +449,18 @@ cos_array_obj_node_insert(CosArrayObjNode *array_obj,
         return false;
     }
 
-    return cos_array_insert_item(array_obj->value,
+    if (!cos_array_obj_node_check_mutable_(array_obj, error)) {
+        return false;
+    }
+    if (cos_array_obj_node_is_packed_(array_obj) &&
+        !cos_array_obj_node_unpack_(array_obj, error)) {
+        return false;
+    }
+
+    const CosObjValue value = cos_obj_value_make_node(obj);
+    return cos_array_insert_item(COS_nonnull_cast(array_obj->value),
                                  index,
-                                 (void *)&obj,
+                                 (const void *)&value,
                                  error);
 }
 
@@ -139,8 +475,31 @@ cos_array_obj_node_append(CosArrayObjNode *array_obj,
         return false;
     }
 
-    return cos_array_append_item(array_obj->value,
-                                 (void *)&obj,
+    return cos_array_obj_node_append_value(array_obj,
+                                           cos_obj_value_make_node(obj),
+                                           error);
+}
+
+bool
+cos_array_obj_node_append_value(CosArrayObjNode *array_obj,
+                                CosObjValue value,
+                                CosError * COS_Nullable error)
+{
+    COS_API_PARAM_CHECK(array_obj != NULL);
+    if (!array_obj) {
+        return false;
+    }
+
+    if (!cos_array_obj_node_check_mutable_(array_obj, error)) {
+        return false;
+    }
+    if (cos_array_obj_node_is_packed_(array_obj) &&
+        !cos_array_obj_node_unpack_(array_obj, error)) {
+        return false;
+    }
+
+    return cos_array_append_item(COS_nonnull_cast(array_obj->value),
+                                 (const void *)&value,
                                  error);
 }
 
@@ -154,11 +513,146 @@ cos_array_obj_node_remove_at(CosArrayObjNode *array_obj,
         return false;
     }
 
-    return cos_array_remove_item(array_obj->value,
+    if (!cos_array_obj_node_check_mutable_(array_obj, error)) {
+        return false;
+    }
+    if (cos_array_obj_node_is_packed_(array_obj) &&
+        !cos_array_obj_node_unpack_(array_obj, error)) {
+        return false;
+    }
+
+    return cos_array_remove_item(COS_nonnull_cast(array_obj->value),
                                  index,
                                  error);
 }
 
+// MARK: - Private
+
+/**
+ * Gets the object node of an element of a frozen array, without modifying the elements.
+ */
+static CosObjNode * COS_Nullable
+cos_array_obj_node_get_frozen_node_(const CosArrayObjNode *array_obj,
+                                    size_t index,
+                                    CosError * COS_Nullable out_error)
+{
+    COS_IMPL_PARAM_CHECK(array_obj != NULL);
+
+    CosObjValue value;
+    if (!cos_array_obj_node_get_value_at(array_obj, index, &value, out_error)) {
+        return NULL;
+    }
+    if (value.kind == CosObjValueKind_Node) {
+        return value.as.node;
+    }
+
+    // The table of object nodes is only logically part of the array object.
+    CosArrayObjNode * const mutable_array_obj = (CosArrayObjNode *)array_obj;
+
+    CosObjNode **frozen_nodes = cos_atomic_load_ptr_acquire((void * const *)&array_obj->frozen_nodes);
+    if (!frozen_nodes) {
+        CosObjNode ** const new_frozen_nodes = cos_calloc(array_obj->allocator,
+                                                          cos_array_obj_node_get_count(array_obj),
+                                                          sizeof(CosObjNode *));
+        if (!new_frozen_nodes) {
+            COS_ERROR_PROPAGATE(cos_error_make(COS_ERROR_MEMORY,
+                                               "Failed to allocate object table"),
+                                out_error);
+            return NULL;
+        }
+
+        if (cos_atomic_publish_ptr((void **)&mutable_array_obj->frozen_nodes, new_frozen_nodes)) {
+            frozen_nodes = new_frozen_nodes;
+        }
+        else {
+            // Another thread published its table first.
+            cos_free(array_obj->allocator, new_frozen_nodes);
+            frozen_nodes = cos_atomic_load_ptr_acquire((void * const *)&array_obj->frozen_nodes);
+        }
+    }
+    COS_ASSERT(frozen_nodes != NULL, "Expected a table of object nodes");
+
+    CosObjNode * const existing = cos_atomic_load_ptr_acquire((void * const *)&frozen_nodes[index]);
+    if (existing) {
+        return existing;
+    }
+
+    CosObjNode * const node = cos_obj_value_box(array_obj->allocator, value);
+    if (!node) {
+        COS_ERROR_PROPAGATE(cos_error_make(COS_ERROR_MEMORY,
+                                           "Failed to allocate object"),
+                            out_error);
+        return NULL;
+    }
+
+    if (!cos_atomic_publish_ptr((void **)&frozen_nodes[index], node)) {
+        // Another thread published its object node first.
+        cos_obj_node_release(node);
+        return cos_atomic_load_ptr_acquire((void * const *)&frozen_nodes[index]);
+    }
+    return node;
+}
+
+static bool
+cos_array_obj_node_check_mutable_(const CosArrayObjNode *array_obj,
+                                  CosError * COS_Nullable out_error)
+{
+    COS_IMPL_PARAM_CHECK(array_obj != NULL);
+
+    if (cos_obj_node_is_frozen((const CosObjNode *)array_obj)) {
+        COS_ERROR_PROPAGATE(cos_error_make(COS_ERROR_INVALID_STATE,
+                                           "The array object is frozen"),
+                            out_error);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Converts a packed array back to an array of values, before it is modified or a node is
+ * requested for one of its elements.
+ */
+static bool
+cos_array_obj_node_unpack_(CosArrayObjNode *array_obj,
+                           CosError * COS_Nullable out_error)
+{
+    COS_IMPL_PARAM_CHECK(array_obj != NULL);
+    COS_IMPL_PARAM_CHECK(cos_array_obj_node_is_packed_(array_obj));
+
+    const size_t count = array_obj->packed_count;
+
+    CosArray * const array = cos_array_create(array_obj->allocator,
+                                              sizeof(CosObjValue),
+                                              &cos_array_obj_node_callbacks,
+                                              count);
+    if (!array) {
+        COS_ERROR_PROPAGATE(cos_error_make(COS_ERROR_MEMORY,
+                                           "Failed to allocate array"),
+                            out_error);
+        return false;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        CosObjValue element;
+        const bool got_value = cos_array_obj_node_get_value_at(array_obj, i, &element, NULL);
+        COS_ASSERT(got_value, "Expected the index to be in bounds");
+        (void)got_value;
+
+        if (!cos_array_append_item(array, (const void *)&element, out_error)) {
+            cos_array_destroy(array);
+            return false;
+        }
+    }
+
+    cos_free(array_obj->allocator, array_obj->packed.ints);
+
+    array_obj->value = array;
+    array_obj->packed_count = 0;
+    array_obj->packed.ints = NULL;
+
+    return true;
+}
+
 static void
 cos_array_obj_node_callbacks_release_(void *item)
 {
@@ -167,8 +661,8 @@ cos_array_obj_node_callbacks_release_(void *item)
         return;
     }
 
-    CosObjNode * const obj = *(CosObjNode **)item;
-    cos_obj_node_release(obj);
+    const CosObjValue * const value = (const CosObjValue *)item;
+    cos_obj_value_release(*value);
 }
 
 static bool
@@ -184,10 +678,23 @@ cos_array_obj_node_callbacks_equal_(const void *item1,
         return false;
     }
 
-    const CosObjNode * const obj1 = *(CosObjNode * const *)item1;
-    const CosObjNode * const obj2 = *(CosObjNode * const *)item2;
+    const CosObjValue * const value1 = (const CosObjValue *)item1;
+    const CosObjValue * const value2 = (const CosObjValue *)item2;
+    if (value1->kind != value2->kind) {
+        return false;
+    }
 
-    return obj1 == obj2;
+    switch (value1->kind) {
+        case CosObjValueKind_Node:
+            return value1->as.node == value2->as.node;
+        case CosObjValueKind_Boolean:
+            return value1->as.boolean == value2->as.boolean;
+        case CosObjValueKind_Integer:
+            return value1->as.integer == value2->as.integer;
+        case CosObjValueKind_Real:
+            return value1->as.real == value2->as.real;
+    }
+    return false;
 }
 
 COS_ASSUME_NONNULL_END
@@ -8,6 +8,8 @@
 
 #include "libcos/objects/CosObjNode.h"
 
+#include <libcos/common/memory/CosMemory.h>
+
 #include <stdio.h>
 #include <stdlib.h>
 
@@ -16,20 +18,23 @@ COS_ASSUME_NONNULL_BEGIN
 struct CosBoolObjNode {
     CosObjNodeType type;
     unsigned int ref_count;
+    CosAllocator * COS_Nullable allocator;
 
     bool value;
 };
 
 CosBoolObjNode *
-cos_bool_obj_node_alloc(bool value)
+cos_bool_obj_node_alloc(CosAllocator * COS_Nullable allocator,
+                        bool value)
 {
-    CosBoolObjNode * const obj = calloc(1, sizeof(CosBoolObjNode));
+    CosBoolObjNode * const obj = cos_calloc(allocator, 1, sizeof(CosBoolObjNode));
     if (!obj) {
         return NULL;
     }
 
     obj->type = CosObjNodeType_Boolean;
     obj->ref_count = 1;
+    obj->allocator = allocator;
     obj->value = value;
 
     return obj;
@@ -42,7 +47,7 @@ cos_bool_obj_node_free(CosBoolObjNode *bool_obj)
         return;
     }
 
-    free(bool_obj);
+    cos_free(bool_obj->allocator, bool_obj);
 }
 
 bool
@@ -65,6 +70,11 @@ cos_bool_obj_node_set_value(CosBoolObjNode *bool_obj,
         return;
     }
 
+    COS_API_PARAM_CHECK(!cos_obj_node_is_frozen((const CosObjNode *)bool_obj));
+    if (cos_obj_node_is_frozen((const CosObjNode *)bool_obj)) {
+        return;
+    }
+
     bool_obj->value = value;
 }
 
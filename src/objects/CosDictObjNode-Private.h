@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) 2025 OpenCOS.
+ */
+
+#ifndef LIBCOS_COS_DICT_OBJ_NODE_PRIVATE_H
+#define LIBCOS_COS_DICT_OBJ_NODE_PRIVATE_H
+
+#include <libcos/common/CosDefines.h>
+#include <libcos/common/CosTypes.h>
+
+#include <stdbool.h>
+
+COS_DECLS_BEGIN
+COS_ASSUME_NONNULL_BEGIN
+
+/**
+ * @brief Converts the scalars that are stored inline in the dictionary object to object nodes.
+ *
+ * This is done before the dictionary object is frozen, so that its getters do not need to
+ * modify it.
+ *
+ * @param dict_obj The dictionary object.
+ * @param out_error The error object to set if an error occurs.
+ *
+ * @return @c true if all values are object nodes, @c false if an error occurred.
+ */
+bool
+cos_dict_obj_node_box_values_(CosDictObjNode *dict_obj,
+                              CosError * COS_Nullable out_error);
+
+COS_ASSUME_NONNULL_END
+COS_DECLS_END
+
+#endif /* LIBCOS_COS_DICT_OBJ_NODE_PRIVATE_H */
@@ -5,22 +5,69 @@
 #include "libcos/objects/CosDictObjNode.h"
 
 #include "common/Assert.h"
+#include "objects/CosDictObjNode-Private.h"
 
 #include "libcos/common/CosDict.h"
+#include "libcos/common/CosError.h"
+#include "libcos/objects/CosNameKey.h"
 #include "libcos/objects/CosNameObjNode.h"
 #include "libcos/objects/CosObjNode.h"
+#include "libcos/objects/CosObjValue.h"
+
+#include <libcos/common/memory/CosMemory.h>
 
 #include <stdlib.h>
 
 COS_ASSUME_NONNULL_BEGIN
 
+/**
+ * The number of entries that a dictionary object stores inline, before it is promoted to a
+ * hash table.
+ */
+#define COS_DICT_OBJ_NODE_INLINE_CAPACITY 8
+
+typedef struct CosDictObjNodeEntry {
+    CosNameObjNode *key;
+
+    /**
+     * The value, with scalars stored inline.
+     */
+    CosObjValue value;
+} CosDictObjNodeEntry;
+
 struct CosDictObjNode {
     CosObjNodeType type;
     unsigned int ref_count;
-
-    CosDict *value;
+    CosAllocator * COS_Nullable allocator;
+
+    /**
+     * The number of entries in @a inline_entries .
+     */
+    size_t inline_count;
+
+    /**
+     * The entries of a small dictionary, in insertion order.
+     *
+     * Most dictionaries only have a handful of entries, which are faster to find by a linear
+     * scan (comparing interned keys by pointer) than by hashing.
+     */
+    CosDictObjNodeEntry inline_entries[COS_DICT_OBJ_NODE_INLINE_CAPACITY];
+
+    /**
+     * The hash table of a dictionary that has outgrown the inline entries, or @c NULL.
+     */
+    CosDict * COS_Nullable value;
 };
 
+static bool
+cos_dict_obj_node_promote_(CosDictObjNode *dict_obj,
+                           CosError * COS_Nullable out_error);
+
+static CosObjNode * COS_Nullable
+cos_dict_obj_node_entry_get_node_(const CosDictObjNode *dict_obj,
+                                  const CosDictObjNodeEntry *entry,
+                                  CosError * COS_Nullable out_error);
+
 static size_t
 cos_dict_obj_node_key_hash_(void *key)
 {
@@ -64,6 +111,29 @@ cos_dict_obj_node_keys_equal_(void *key1,
                               name_obj2);
 }
 
+static bool
+cos_dict_obj_node_key_matches_(void *key,
+                               const void *context)
+{
+    COS_PARAM_ASSERT_INTERNAL(key != NULL);
+    COS_PARAM_ASSERT_INTERNAL(context != NULL);
+
+    const CosNameObjNode * const name_obj = (const CosNameObjNode *)key;
+    const CosNameKey * const name_key = (const CosNameKey *)context;
+
+    if (cos_name_obj_node_get_hash(name_obj) != name_key->hash) {
+        return false;
+    }
+
+    const CosString * const name_value = cos_name_obj_node_get_value(name_obj);
+    if (!name_value) {
+        return false;
+    }
+
+    return cos_string_ref_cmp(cos_string_get_ref(COS_nonnull_cast(name_value)),
+                              name_key->name) == 0;
+}
+
 const CosDictKeyCallbacks cos_dict_obj_node_key_callbacks = {
     .hash = &cos_dict_obj_node_key_hash_,
     .retain = NULL,
@@ -78,35 +148,26 @@ const CosDictValueCallbacks cos_dict_obj_node_value_callbacks = {
 };
 
 CosDictObjNode *
-cos_dict_obj_node_create(CosDict * COS_Nullable dict)
+cos_dict_obj_node_create(CosAllocator * COS_Nullable allocator,
+                         CosDict * COS_Nullable dict)
 {
-    CosDictObjNode * const dict_obj = calloc(1, sizeof(CosDictObjNode));
+    CosDictObjNode * const dict_obj = cos_calloc(allocator, 1, sizeof(CosDictObjNode));
     if (!dict_obj) {
         goto failure;
     }
 
     dict_obj->type = CosObjNodeType_Dict;
     dict_obj->ref_count = 1;
+    dict_obj->allocator = allocator;
 
-    if (dict) {
-        dict_obj->value = COS_nonnull_cast(dict);
-    }
-    else {
-        CosDict * const new_dict = cos_dict_create(&cos_dict_obj_node_key_callbacks,
-                                                   &cos_dict_obj_node_value_callbacks,
-                                                   0);
-        if (!new_dict) {
-            goto failure;
-        }
-        dict_obj->value = new_dict;
-    }
-    COS_ASSERT(dict_obj->value != NULL, "Expected a dictionary value");
+    // Entries are stored inline until the dictionary grows past the inline capacity.
+    dict_obj->value = dict;
 
     return dict_obj;
 
 failure:
     if (dict_obj) {
-        free(dict_obj);
+        cos_free(allocator, dict_obj);
     }
     return NULL;
 }
@@ -118,8 +179,16 @@ cos_dict_obj_node_destroy(CosDictObjNode *dict_obj)
         return;
     }
 
-    cos_dict_destroy(dict_obj->value);
-    free(dict_obj);
+    for (size_t i = 0; i < dict_obj->inline_count; i++) {
+        CosDictObjNodeEntry * const entry = &dict_obj->inline_entries[i];
+        cos_obj_node_release((CosObjNode *)entry->key);
+        cos_obj_value_release(entry->value);
+    }
+
+    if (dict_obj->value) {
+        cos_dict_destroy(COS_nonnull_cast(dict_obj->value));
+    }
+    cos_free(dict_obj->allocator, dict_obj);
 }
 
 size_t
@@ -130,7 +199,11 @@ cos_dict_obj_node_get_count(const CosDictObjNode *dict_obj)
         return 0;
     }
 
-    return cos_dict_get_count(dict_obj->value);
+    if (dict_obj->value) {
+        return cos_dict_get_count(COS_nonnull_cast(dict_obj->value));
+    }
+
+    return dict_obj->inline_count;
 }
 
 bool
@@ -146,10 +219,31 @@ cos_dict_obj_node_get_value(const CosDictObjNode *dict_obj,
         return false;
     }
 
-    return cos_dict_get(dict_obj->value,
-                        key,
-                        (void **)out_value,
-                        out_error);
+    if (dict_obj->value) {
+        return cos_dict_get(COS_nonnull_cast(dict_obj->value),
+                            key,
+                            (void **)out_value,
+                            out_error);
+    }
+
+    // Interned keys are found by pointer, so check for an identical key first.
+    for (size_t i = 0; i < dict_obj->inline_count; i++) {
+        const CosDictObjNodeEntry * const entry = &dict_obj->inline_entries[i];
+        if (entry->key == key) {
+            *out_value = cos_dict_obj_node_entry_get_node_(dict_obj, entry, out_error);
+            return (*out_value != NULL);
+        }
+    }
+
+    for (size_t i = 0; i < dict_obj->inline_count; i++) {
+        const CosDictObjNodeEntry * const entry = &dict_obj->inline_entries[i];
+        if (cos_name_obj_node_equal(entry->key, key)) {
+            *out_value = cos_dict_obj_node_entry_get_node_(dict_obj, entry, out_error);
+            return (*out_value != NULL);
+        }
+    }
+
+    return false;
 }
 
 bool
@@ -165,33 +259,77 @@ cos_dict_obj_node_get_value_with_string(const CosDictObjNode *dict_obj,
         return false;
     }
 
-    CosString *key_str = NULL;
-    CosNameObjNode *name_obj = NULL;
+    const CosNameKey name_key = cos_name_key(key);
 
-    key_str = cos_string_alloc_with_str(key);
-    if (!key_str) {
-        goto failure;
+    return cos_dict_obj_node_get_value_with_key(dict_obj,
+                                                &name_key,
+                                                out_value,
+                                                out_error);
+}
+
+bool
+cos_dict_obj_node_get_value_with_key(const CosDictObjNode *dict_obj,
+                                     const CosNameKey *key,
+                                     CosObjNode * COS_Nullable *out_value,
+                                     CosError * COS_Nullable out_error)
+{
+    COS_API_PARAM_CHECK(dict_obj != NULL);
+    COS_API_PARAM_CHECK(key != NULL);
+    COS_API_PARAM_CHECK(out_value != NULL);
+    if (!dict_obj || !key || !out_value) {
+        return false;
     }
 
-    name_obj = cos_name_obj_node_alloc(key_str);
-    if (!name_obj) {
-        goto failure;
+    if (dict_obj->value) {
+        return cos_dict_get_matching(COS_nonnull_cast(dict_obj->value),
+                                     key->hash,
+                                     &cos_dict_obj_node_key_matches_,
+                                     key,
+                                     (void **)out_value);
     }
 
-    const bool result = cos_dict_get(dict_obj->value,
-                                     name_obj,
-                                     (void **)out_value,
-                                     out_error);
-    cos_name_obj_node_free(name_obj);
+    for (size_t i = 0; i < dict_obj->inline_count; i++) {
+        const CosDictObjNodeEntry * const entry = &dict_obj->inline_entries[i];
+        if (cos_dict_obj_node_key_matches_(entry->key, key)) {
+            *out_value = cos_dict_obj_node_entry_get_node_(dict_obj, entry, out_error);
+            return (*out_value != NULL);
+        }
+    }
 
-    return result;
+    return false;
+}
 
-failure:
-    if (key_str) {
-        cos_string_free(key_str);
+bool
+cos_dict_obj_node_lookup_with_key(const CosDictObjNode *dict_obj,
+                                  const CosNameKey *key,
+                                  CosObjValue *out_value)
+{
+    COS_API_PARAM_CHECK(dict_obj != NULL);
+    COS_API_PARAM_CHECK(key != NULL);
+    COS_API_PARAM_CHECK(out_value != NULL);
+    if (!dict_obj || !key || !out_value) {
+        return false;
+    }
+
+    if (dict_obj->value) {
+        void *node = NULL;
+        if (!cos_dict_get_matching(COS_nonnull_cast(dict_obj->value),
+                                   key->hash,
+                                   &cos_dict_obj_node_key_matches_,
+                                   key,
+                                   &node)) {
+            return false;
+        }
+        *out_value = cos_obj_value_make_node((CosObjNode *)node);
+        return true;
     }
-    if (name_obj) {
-        cos_name_obj_node_free(name_obj);
+
+    for (size_t i = 0; i < dict_obj->inline_count; i++) {
+        const CosDictObjNodeEntry * const entry = &dict_obj->inline_entries[i];
+        if (cos_dict_obj_node_key_matches_(entry->key, key)) {
+            *out_value = entry->value;
+            return true;
+        }
     }
 
     return false;
@@ -210,10 +348,82 @@ cos_dict_obj_node_set(CosDictObjNode *dict_obj,
         return false;
     }
 
-    return cos_dict_set(dict_obj->value,
-                        key,
-                        value,
-                        error);
+    return cos_dict_obj_node_set_value(dict_obj,
+                                       key,
+                                       cos_obj_value_make_node(value),
+                                       error);
+}
+
+bool
+cos_dict_obj_node_set_value(CosDictObjNode *dict_obj,
+                            CosNameObjNode *key,
+                            CosObjValue value,
+                            CosError * COS_Nullable error)
+{
+    COS_API_PARAM_CHECK(dict_obj != NULL);
+    COS_API_PARAM_CHECK(key != NULL);
+    if (!dict_obj || !key) {
+        return false;
+    }
+
+    if (cos_obj_node_is_frozen((const CosObjNode *)dict_obj)) {
+        cos_error_propagate(error,
+                            cos_error_make(COS_ERROR_INVALID_STATE,
+                                           "The dictionary object is frozen"));
+        return false;
+    }
+
+    if (!dict_obj->value) {
+        // Replace the value of an existing entry.
+        for (size_t i = 0; i < dict_obj->inline_count; i++) {
+            CosDictObjNodeEntry * const entry = &dict_obj->inline_entries[i];
+            if (entry->key == key || cos_name_obj_node_equal(entry->key, key)) {
+                // The caller's references replace the stored ones, even if they are the
+                // same objects.
+                CosNameObjNode * const old_key = entry->key;
+                const CosObjValue old_value = entry->value;
+                entry->key = key;
+                entry->value = value;
+                cos_obj_node_release((CosObjNode *)old_key);
+                cos_obj_value_release(old_value);
+                return true;
+            }
+        }
+
+        if (dict_obj->inline_count < COS_DICT_OBJ_NODE_INLINE_CAPACITY) {
+            CosDictObjNodeEntry * const entry = &dict_obj->inline_entries[dict_obj->inline_count];
+            entry->key = key;
+            entry->value = value;
+            dict_obj->inline_count++;
+            return true;
+        }
+
+        if (!cos_dict_obj_node_promote_(dict_obj, error)) {
+            return false;
+        }
+    }
+
+    // The hash table stores object nodes only.
+    CosObjNode * const node = cos_obj_value_box(dict_obj->allocator, value);
+    if (!node) {
+        cos_error_propagate(error,
+                            cos_error_make(COS_ERROR_MEMORY,
+                                           "Failed to allocate object"));
+        return false;
+    }
+
+    if (!cos_dict_set(COS_nonnull_cast(dict_obj->value),
+                      key,
+                      node,
+                      error)) {
+        // The caller keeps ownership of a node value, but not of a node boxed here.
+        if (value.kind != CosObjValueKind_Node) {
+            cos_obj_node_release(node);
+        }
+        return false;
+    }
+
+    return true;
 }
 
 // MARK: - Iterator
@@ -223,9 +433,12 @@ cos_dict_obj_node_iterator_init(CosDictObjNode *dict_obj)
 {
     COS_API_PARAM_CHECK(dict_obj != NULL);
 
-    CosDictObjNodeIterator iterator = {
-        .base = cos_dict_iterator_init(dict_obj->value),
-    };
+    CosDictObjNodeIterator iterator = {0};
+    iterator.dict_obj = dict_obj;
+    iterator.index = 0;
+    if (dict_obj && dict_obj->value) {
+        iterator.base = cos_dict_iterator_init(COS_nonnull_cast(dict_obj->value));
+    }
     return iterator;
 }
 
@@ -241,9 +454,167 @@ cos_dict_obj_node_iterator_next(CosDictObjNodeIterator *iterator,
         return false;
     }
 
-    return cos_dict_iterator_next(&iterator->base,
-                                  (void **)out_key,
-                                  (void **)out_value);
+    const CosDictObjNode * const dict_obj = iterator->dict_obj;
+    if (!dict_obj) {
+        return false;
+    }
+
+    if (dict_obj->value) {
+        return cos_dict_iterator_next(&iterator->base,
+                                      (void **)out_key,
+                                      (void **)out_value);
+    }
+
+    if (iterator->index >= dict_obj->inline_count) {
+        return false;
+    }
+
+    const CosDictObjNodeEntry * const entry = &dict_obj->inline_entries[iterator->index];
+    CosObjNode * const value = cos_dict_obj_node_entry_get_node_(dict_obj, entry, NULL);
+    if (!value) {
+        return false;
+    }
+    iterator->index++;
+
+    *out_key = entry->key;
+    *out_value = value;
+    return true;
+}
+
+bool
+cos_dict_obj_node_iterator_next_value(CosDictObjNodeIterator *iterator,
+                                      CosNameObjNode * COS_Nullable * COS_Nonnull out_key,
+                                      CosObjValue *out_value)
+{
+    COS_API_PARAM_CHECK(iterator != NULL);
+    COS_API_PARAM_CHECK(out_key != NULL);
+    COS_API_PARAM_CHECK(out_value != NULL);
+    if (COS_UNLIKELY(!iterator || !out_key || !out_value)) {
+        return false;
+    }
+
+    const CosDictObjNode * const dict_obj = iterator->dict_obj;
+    if (!dict_obj) {
+        return false;
+    }
+
+    if (dict_obj->value) {
+        void *node = NULL;
+        if (!cos_dict_iterator_next(&iterator->base,
+                                    (void **)out_key,
+                                    &node)) {
+            return false;
+        }
+        *out_value = cos_obj_value_make_node((CosObjNode *)node);
+        return true;
+    }
+
+    if (iterator->index >= dict_obj->inline_count) {
+        return false;
+    }
+
+    const CosDictObjNodeEntry * const entry = &dict_obj->inline_entries[iterator->index];
+    iterator->index++;
+
+    *out_key = entry->key;
+    *out_value = entry->value;
+    return true;
+}
+
+// MARK: - Private
+
+bool
+cos_dict_obj_node_box_values_(CosDictObjNode *dict_obj,
+                              CosError * COS_Nullable out_error)
+{
+    COS_IMPL_PARAM_CHECK(dict_obj != NULL);
+
+    // The values of a promoted dictionary object are already object nodes.
+    for (size_t i = 0; i < dict_obj->inline_count; i++) {
+        if (!cos_dict_obj_node_entry_get_node_(dict_obj, &dict_obj->inline_entries[i], out_error)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool
+cos_dict_obj_node_promote_(CosDictObjNode *dict_obj,
+                           CosError * COS_Nullable out_error)
+{
+    COS_IMPL_PARAM_CHECK(dict_obj != NULL);
+    COS_IMPL_PARAM_CHECK(dict_obj->value == NULL);
+
+    CosDict * const dict = cos_dict_create(dict_obj->allocator,
+                                           &cos_dict_obj_node_key_callbacks,
+                                           &cos_dict_obj_node_value_callbacks,
+                                           COS_DICT_OBJ_NODE_INLINE_CAPACITY * 2);
+    if (!dict) {
+        cos_error_propagate(out_error,
+                            cos_error_make(COS_ERROR_MEMORY,
+                                           "Failed to allocate dictionary"));
+        return false;
+    }
+
+    // The hash table stores object nodes only, so box the inline scalars first. A boxed value
+    // stays in its entry, so the dictionary object is still valid if this fails part way.
+    for (size_t i = 0; i < dict_obj->inline_count; i++) {
+        if (!cos_dict_obj_node_entry_get_node_(dict_obj, &dict_obj->inline_entries[i], out_error)) {
+            cos_dict_destroy(dict);
+            return false;
+        }
+    }
+
+    // The inline entries are all distinct, and ownership of each key and value moves to the
+    // hash table. The table was created with room for all of them, so this cannot fail.
+    for (size_t i = 0; i < dict_obj->inline_count; i++) {
+        CosDictObjNodeEntry * const entry = &dict_obj->inline_entries[i];
+        COS_ASSERT(entry->value.kind == CosObjValueKind_Node, "Expected a boxed value");
+        const bool moved = cos_dict_set(dict,
+                                        entry->key,
+                                        entry->value.as.node,
+                                        out_error);
+        COS_ASSERT(moved, "Expected the dictionary to have room for the inline entries");
+        (void)moved;
+    }
+
+    dict_obj->value = dict;
+    dict_obj->inline_count = 0;
+
+    return true;
+}
+
+/**
+ * Gets the value of an inline entry as an object node.
+ *
+ * Callers of the node-based accessors expect a node that is owned by the dictionary object, so
+ * a scalar is boxed and the node is kept in the entry.
+ */
+static CosObjNode *
+cos_dict_obj_node_entry_get_node_(const CosDictObjNode *dict_obj,
+                                  const CosDictObjNodeEntry *entry,
+                                  CosError * COS_Nullable out_error)
+{
+    COS_IMPL_PARAM_CHECK(dict_obj != NULL);
+    COS_IMPL_PARAM_CHECK(entry != NULL);
+
+    if (entry->value.kind == CosObjValueKind_Node) {
+        return entry->value.as.node;
+    }
+
+    CosObjNode * const node = cos_obj_value_box(dict_obj->allocator, entry->value);
+    if (!node) {
+        cos_error_propagate(out_error,
+                            cos_error_make(COS_ERROR_MEMORY,
+                                           "Failed to allocate object"));
+        return NULL;
+    }
+
+    // The entry belongs to the dictionary object, which is only logically const here.
+    CosDictObjNodeEntry * const mutable_entry = (CosDictObjNodeEntry *)entry;
+    mutable_entry->value = cos_obj_value_make_node(node);
+
+    return node;
 }
 
 COS_ASSUME_NONNULL_END
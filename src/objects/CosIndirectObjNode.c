@@ -9,6 +9,7 @@
 #include "libcos/objects/CosObjNode.h"
 
 #include <libcos/CosDoc.h>
+#include <libcos/common/memory/CosMemory.h>
 
 #include <stddef.h>
 #include <stdio.h>
@@ -22,6 +23,7 @@ struct CosIndirectObjNode {
      */
     CosObjNodeType type;
     unsigned int ref_count;
+    CosAllocator * COS_Nullable allocator;
 
     /**
      * The ID of the indirect object.
@@ -35,7 +37,8 @@ struct CosIndirectObjNode {
 };
 
 CosIndirectObjNode *
-cos_indirect_obj_node_alloc(CosObjID id,
+cos_indirect_obj_node_alloc(CosAllocator * COS_Nullable allocator,
+                            CosObjID id,
                        CosObjNode *value)
 {
     COS_API_PARAM_CHECK(value != NULL);
@@ -43,13 +46,14 @@ cos_indirect_obj_node_alloc(CosObjID id,
         return NULL;
     }
 
-    CosIndirectObjNode * const indirect_obj = calloc(1, sizeof(CosIndirectObjNode));
+    CosIndirectObjNode * const indirect_obj = cos_calloc(allocator, 1, sizeof(CosIndirectObjNode));
     if (!indirect_obj) {
         return NULL;
     }
 
     indirect_obj->type = CosObjNodeType_Indirect;
     indirect_obj->ref_count = 1;
+    indirect_obj->allocator = allocator;
     indirect_obj->id = id;
     indirect_obj->value = value;
 
@@ -65,7 +69,7 @@ cos_indirect_obj_node_free(CosIndirectObjNode *indirect_obj)
 
     cos_obj_node_release(indirect_obj->value);
 
-    free(indirect_obj);
+    cos_free(indirect_obj->allocator, indirect_obj);
 }
 
 CosObjID
@@ -8,6 +8,8 @@
 
 #include "libcos/objects/CosObjNode.h"
 
+#include <libcos/common/memory/CosMemory.h>
+
 #include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -17,20 +19,23 @@ COS_ASSUME_NONNULL_BEGIN
 struct CosIntObjNode {
     CosObjNodeType type;
     unsigned int ref_count;
+    CosAllocator * COS_Nullable allocator;
 
     int value;
 };
 
 CosIntObjNode *
-cos_int_obj_node_alloc(int value)
+cos_int_obj_node_alloc(CosAllocator * COS_Nullable allocator,
+                       int value)
 {
-    CosIntObjNode * const int_obj = calloc(1, sizeof(CosIntObjNode));
+    CosIntObjNode * const int_obj = cos_calloc(allocator, 1, sizeof(CosIntObjNode));
     if (!int_obj) {
         return NULL;
     }
 
     int_obj->type = CosObjNodeType_Integer;
     int_obj->ref_count = 1;
+    int_obj->allocator = allocator;
     int_obj->value = value;
 
     return int_obj;
@@ -43,7 +48,7 @@ cos_int_obj_node_free(CosIntObjNode *int_obj)
         return;
     }
 
-    free(int_obj);
+    cos_free(int_obj->allocator, int_obj);
 }
 
 int
@@ -66,6 +71,11 @@ cos_int_obj_node_set_value(CosIntObjNode *int_obj,
         return;
     }
 
+    COS_API_PARAM_CHECK(!cos_obj_node_is_frozen((const CosObjNode *)int_obj));
+    if (cos_obj_node_is_frozen((const CosObjNode *)int_obj)) {
+        return;
+    }
+
     int_obj->value = value;
 }
 
@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2025 OpenCOS.
+ */
+
+#include "libcos/objects/CosNameKey.h"
+
+#include "common/Assert.h"
+#include "common/CosAtomic.h"
+
+#include <stdbool.h>
+
+COS_ASSUME_NONNULL_BEGIN
+
+#define COS_WELL_KNOWN_NAME_KEY_(key)   \
+    [CosWellKnownName_##key] = {        \
+        .name = {                       \
+            .data = #key,               \
+            .length = sizeof(#key) - 1, \
+        },                              \
+        .hash = 0,                      \
+    }
+
+/**
+ * The well-known name keys, indexed by @c CosWellKnownName.
+ *
+ * The hashes are computed on first use, by the thread that claims
+ * @c cos_well_known_name_keys_claim_.
+ */
+static CosNameKey cos_well_known_name_keys_[COS_WELL_KNOWN_NAME_COUNT] = {
+    COS_WELL_KNOWN_NAME_KEY_(Type),
+    COS_WELL_KNOWN_NAME_KEY_(Subtype),
+    COS_WELL_KNOWN_NAME_KEY_(Length),
+    COS_WELL_KNOWN_NAME_KEY_(Filter),
+    COS_WELL_KNOWN_NAME_KEY_(DecodeParms),
+    COS_WELL_KNOWN_NAME_KEY_(DL),
+    COS_WELL_KNOWN_NAME_KEY_(Root),
+    COS_WELL_KNOWN_NAME_KEY_(Size),
+    COS_WELL_KNOWN_NAME_KEY_(Prev),
+    COS_WELL_KNOWN_NAME_KEY_(Info),
+    COS_WELL_KNOWN_NAME_KEY_(ID),
+    COS_WELL_KNOWN_NAME_KEY_(Encrypt),
+    COS_WELL_KNOWN_NAME_KEY_(XRefStm),
+    COS_WELL_KNOWN_NAME_KEY_(Index),
+    COS_WELL_KNOWN_NAME_KEY_(W),
+    COS_WELL_KNOWN_NAME_KEY_(N),
+    COS_WELL_KNOWN_NAME_KEY_(First),
+    COS_WELL_KNOWN_NAME_KEY_(Extends),
+    COS_WELL_KNOWN_NAME_KEY_(Pages),
+    COS_WELL_KNOWN_NAME_KEY_(Kids),
+    COS_WELL_KNOWN_NAME_KEY_(Parent),
+    COS_WELL_KNOWN_NAME_KEY_(Count),
+    COS_WELL_KNOWN_NAME_KEY_(Resources),
+    COS_WELL_KNOWN_NAME_KEY_(Contents),
+    COS_WELL_KNOWN_NAME_KEY_(MediaBox),
+    COS_WELL_KNOWN_NAME_KEY_(CropBox),
+    COS_WELL_KNOWN_NAME_KEY_(Rotate),
+    COS_WELL_KNOWN_NAME_KEY_(Annots),
+    COS_WELL_KNOWN_NAME_KEY_(Font),
+    COS_WELL_KNOWN_NAME_KEY_(XObject),
+    COS_WELL_KNOWN_NAME_KEY_(BaseFont),
+    COS_WELL_KNOWN_NAME_KEY_(Encoding),
+    COS_WELL_KNOWN_NAME_KEY_(Width),
+    COS_WELL_KNOWN_NAME_KEY_(Height),
+    COS_WELL_KNOWN_NAME_KEY_(ColorSpace),
+    COS_WELL_KNOWN_NAME_KEY_(BitsPerComponent),
+    COS_WELL_KNOWN_NAME_KEY_(Names),
+    COS_WELL_KNOWN_NAME_KEY_(Outlines),
+};
+
+/**
+ * Set by the thread that computes the hashes of the well-known name keys.
+ */
+static void * COS_Nullable cos_well_known_name_keys_claim_ = NULL;
+
+/**
+ * The well-known name keys, published with release ordering once their hashes are computed.
+ */
+static void * COS_Nullable cos_well_known_name_keys_ready_ = NULL;
+
+static CosNameKey *
+cos_name_key_init_well_known_(void);
+
+CosNameKey
+cos_name_key(const char *name)
+{
+    COS_API_PARAM_CHECK(name != NULL);
+
+    return cos_name_key_make(cos_string_ref_from_str(name));
+}
+
+CosNameKey
+cos_name_key_make(CosStringRef name)
+{
+    const CosNameKey key = {
+        .name = name,
+        .hash = cos_string_ref_get_hash(name),
+    };
+    return key;
+}
+
+const CosNameKey *
+cos_name_key_get_well_known(CosWellKnownName name)
+{
+    COS_API_PARAM_CHECK((unsigned int)name < COS_WELL_KNOWN_NAME_COUNT);
+    if (COS_UNLIKELY((unsigned int)name >= COS_WELL_KNOWN_NAME_COUNT)) {
+        name = CosWellKnownName_Type;
+    }
+
+    const CosNameKey *keys = cos_atomic_load_ptr_acquire(&cos_well_known_name_keys_ready_);
+    if (COS_UNLIKELY(!keys)) {
+        keys = cos_name_key_init_well_known_();
+    }
+
+    return &keys[name];
+}
+
+static CosNameKey *
+cos_name_key_init_well_known_(void)
+{
+    CosNameKey *keys = cos_well_known_name_keys_;
+
+    if (cos_atomic_publish_ptr(&cos_well_known_name_keys_claim_, keys)) {
+        for (size_t i = 0; i < COS_WELL_KNOWN_NAME_COUNT; i++) {
+            CosNameKey * const key = &keys[i];
+            key->hash = cos_string_ref_get_hash(key->name);
+        }
+        cos_atomic_store_ptr_release(&cos_well_known_name_keys_ready_, keys);
+        return keys;
+    }
+
+    // Another thread is computing the hashes, which takes only a moment.
+    while (!(keys = cos_atomic_load_ptr_acquire(&cos_well_known_name_keys_ready_))) {
+    }
+    return keys;
+}
+
+COS_ASSUME_NONNULL_END
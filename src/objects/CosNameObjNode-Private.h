@@ -0,0 +1,32 @@
+/*
+ * Copyright (c) 2025 OpenCOS.
+ */
+
+#ifndef LIBCOS_COS_NAME_OBJ_NODE_PRIVATE_H
+#define LIBCOS_COS_NAME_OBJ_NODE_PRIVATE_H
+
+#include "objects/CosNameTable.h"
+
+#include <libcos/common/CosDefines.h>
+#include <libcos/common/CosTypes.h>
+
+COS_DECLS_BEGIN
+COS_ASSUME_NONNULL_BEGIN
+
+/**
+ * @brief Sets the name table that the name object is interned in.
+ *
+ * An interned name object cannot be modified, and is only equal to itself among the name
+ * objects interned in the same table.
+ *
+ * @param name_obj The name object.
+ * @param table The name table, or @c NULL if the name object is no longer interned.
+ */
+void
+cos_name_obj_node_set_name_table_(CosNameObjNode *name_obj,
+                                  const CosNameTable * COS_Nullable table);
+
+COS_ASSUME_NONNULL_END
+COS_DECLS_END
+
+#endif /* LIBCOS_COS_NAME_OBJ_NODE_PRIVATE_H */
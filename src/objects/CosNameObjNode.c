@@ -5,10 +5,13 @@
 #include "libcos/objects/CosNameObjNode.h"
 
 #include "common/Assert.h"
+#include "objects/CosNameObjNode-Private.h"
 
 #include "libcos/common/CosString.h"
 #include "libcos/objects/CosObjNode.h"
 
+#include <libcos/common/memory/CosMemory.h>
+
 #include <stdio.h>
 #include <stdlib.h>
 
@@ -17,26 +20,40 @@ COS_ASSUME_NONNULL_BEGIN
 struct CosNameObjNode {
     CosObjNodeType type;
     unsigned int ref_count;
+    CosAllocator * COS_Nullable allocator;
 
     CosString *value;
+
+    /**
+     * The hash of the value, which is computed once when the value is set.
+     */
+    size_t hash;
+
+    /**
+     * The name table that the name object is interned in, or @c NULL.
+     */
+    const CosNameTable * COS_Nullable name_table;
 };
 
 CosNameObjNode *
-cos_name_obj_node_alloc(CosString *value)
+cos_name_obj_node_alloc(CosAllocator * COS_Nullable allocator,
+                        CosString *value)
 {
     COS_API_PARAM_CHECK(value != NULL);
     if (!value) {
         return NULL;
     }
 
-    CosNameObjNode * const name_obj = calloc(1, sizeof(CosNameObjNode));
+    CosNameObjNode * const name_obj = cos_calloc(allocator, 1, sizeof(CosNameObjNode));
     if (!name_obj) {
         return NULL;
     }
 
     name_obj->type = CosObjNodeType_Name;
     name_obj->ref_count = 1;
+    name_obj->allocator = allocator;
     name_obj->value = value;
+    name_obj->hash = cos_string_get_hash(value);
 
     return name_obj;
 }
@@ -49,7 +66,7 @@ cos_name_obj_node_free(CosNameObjNode *name_obj)
     }
 
     cos_string_free(name_obj->value);
-    free(name_obj);
+    cos_free(name_obj->allocator, name_obj);
 }
 
 const CosString *
@@ -73,6 +90,17 @@ cos_name_obj_node_set_value(CosNameObjNode *name_obj,
         return;
     }
 
+    // Interned name objects are shared, so they must not be modified.
+    COS_API_PARAM_CHECK(name_obj->name_table == NULL);
+    if (name_obj->name_table) {
+        return;
+    }
+
+    COS_API_PARAM_CHECK(!cos_obj_node_is_frozen((const CosObjNode *)name_obj));
+    if (cos_obj_node_is_frozen((const CosObjNode *)name_obj)) {
+        return;
+    }
+
     if (name_obj->value == value) {
         // No change.
         return;
@@ -82,6 +110,7 @@ cos_name_obj_node_set_value(CosNameObjNode *name_obj,
     cos_string_free(name_obj->value);
 
     name_obj->value = value;
+    name_obj->hash = cos_string_get_hash(value);
 }
 
 size_t
@@ -92,7 +121,7 @@ cos_name_obj_node_get_hash(const CosNameObjNode *name_obj)
         return 0;
     }
 
-    return cos_string_get_hash(name_obj->value);
+    return name_obj->hash;
 }
 
 bool
@@ -105,10 +134,32 @@ cos_name_obj_node_equal(const CosNameObjNode *name_obj1,
         return false;
     }
 
+    if (name_obj1 == name_obj2) {
+        return true;
+    }
+
+    // Interned names are unique within their table.
+    if (name_obj1->name_table && name_obj1->name_table == name_obj2->name_table) {
+        return false;
+    }
+
+    if (name_obj1->hash != name_obj2->hash) {
+        return false;
+    }
+
     return cos_string_ref_cmp(cos_string_get_ref(name_obj1->value),
                               cos_string_get_ref(name_obj2->value)) == 0;
 }
 
+void
+cos_name_obj_node_set_name_table_(CosNameObjNode *name_obj,
+                                  const CosNameTable * COS_Nullable table)
+{
+    COS_IMPL_PARAM_CHECK(name_obj != NULL);
+
+    name_obj->name_table = table;
+}
+
 void
 cos_name_obj_node_print_desc(const CosNameObjNode *name_obj)
 {
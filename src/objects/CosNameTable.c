@@ -0,0 +1,232 @@
+/*
+ * Copyright (c) 2025 OpenCOS.
+ */
+
+#include "objects/CosNameTable.h"
+
+#include "common/Assert.h"
+#include "objects/CosNameObjNode-Private.h"
+
+#include <libcos/common/CosString.h>
+#include <libcos/common/memory/CosMemory.h>
+#include <libcos/objects/CosNameObjNode.h>
+#include <libcos/objects/CosObjNode.h>
+
+#include <stdint.h>
+#include <stdlib.h>
+
+COS_ASSUME_NONNULL_BEGIN
+
+/**
+ * The minimum number of slots in the table.
+ */
+#define COS_NAME_TABLE_MIN_CAPACITY 64
+
+struct CosNameTable {
+    CosAllocator * COS_Nullable allocator;
+
+    /**
+     * The open-addressed slots of the table.
+     *
+     * The capacity is always a power of two, and the table is kept at most 3/4 full.
+     */
+    CosNameObjNode * COS_Nullable *slots;
+
+    size_t capacity;
+    size_t count;
+};
+
+static size_t
+cos_name_table_find_slot_(const CosNameTable *table,
+                          CosStringRef value,
+                          size_t hash);
+
+static bool
+cos_name_table_grow_(CosNameTable *table);
+
+// MARK: - Lifecycle
+
+CosNameTable *
+cos_name_table_create(CosAllocator * COS_Nullable allocator,
+                      size_t capacity_hint)
+{
+    CosNameTable *table = NULL;
+
+    table = cos_calloc(allocator, 1, sizeof(CosNameTable));
+    if (!table) {
+        goto failure;
+    }
+    table->allocator = allocator;
+
+    size_t capacity = COS_NAME_TABLE_MIN_CAPACITY;
+    while (capacity / 4 * 3 < capacity_hint) {
+        capacity *= 2;
+    }
+
+    table->slots = cos_calloc(allocator, capacity, sizeof(CosNameObjNode *));
+    if (!table->slots) {
+        goto failure;
+    }
+    table->capacity = capacity;
+
+    return table;
+
+failure:
+    if (table) {
+        cos_free(allocator, table);
+    }
+    return NULL;
+}
+
+void
+cos_name_table_destroy(CosNameTable *table)
+{
+    if (!table) {
+        return;
+    }
+
+    for (size_t i = 0; i < table->capacity; i++) {
+        CosNameObjNode * const name_obj = table->slots[i];
+        if (!name_obj) {
+            continue;
+        }
+
+        // The name object may outlive the table, so it must no longer claim to be interned.
+        cos_name_obj_node_set_name_table_(COS_nonnull_cast(name_obj), NULL);
+        cos_obj_node_release((CosObjNode *)name_obj);
+    }
+
+    cos_free(table->allocator, table->slots);
+    cos_free(table->allocator, table);
+}
+
+// MARK: - Operations
+
+CosNameObjNode *
+cos_name_table_intern(CosNameTable *table,
+                      CosString *value)
+{
+    COS_API_PARAM_CHECK(table != NULL);
+    COS_API_PARAM_CHECK(value != NULL);
+    if (COS_UNLIKELY(!table || !value)) {
+        if (value) {
+            cos_string_free(value);
+        }
+        return NULL;
+    }
+
+    const size_t hash = cos_string_get_hash(value);
+
+    size_t slot_index = cos_name_table_find_slot_(table,
+                                                  cos_string_get_ref(value),
+                                                  hash);
+    CosNameObjNode * const existing = table->slots[slot_index];
+    if (existing) {
+        cos_string_free(value);
+        return (CosNameObjNode *)cos_obj_node_retain((CosObjNode *)existing);
+    }
+
+    if ((table->count + 1) > (table->capacity / 4 * 3)) {
+        if (!cos_name_table_grow_(table)) {
+            cos_string_free(value);
+            return NULL;
+        }
+        slot_index = cos_name_table_find_slot_(table,
+                                               cos_string_get_ref(value),
+                                               hash);
+    }
+
+    CosNameObjNode * const name_obj = cos_name_obj_node_alloc(table->allocator, value);
+    if (!name_obj) {
+        cos_string_free(value);
+        return NULL;
+    }
+    cos_name_obj_node_set_name_table_(name_obj, table);
+
+    // The table holds one reference, and the caller receives another.
+    table->slots[slot_index] = name_obj;
+    table->count++;
+
+    return (CosNameObjNode *)cos_obj_node_retain((CosObjNode *)name_obj);
+}
+
+size_t
+cos_name_table_get_count(const CosNameTable *table)
+{
+    COS_API_PARAM_CHECK(table != NULL);
+    if (COS_UNLIKELY(!table)) {
+        return 0;
+    }
+
+    return table->count;
+}
+
+// MARK: - Private
+
+static size_t
+cos_name_table_find_slot_(const CosNameTable *table,
+                          CosStringRef value,
+                          size_t hash)
+{
+    COS_IMPL_PARAM_CHECK(table != NULL);
+
+    const size_t mask = table->capacity - 1;
+
+    size_t index = hash & mask;
+    for (;;) {
+        CosNameObjNode * const name_obj = table->slots[index];
+        if (!name_obj) {
+            return index;
+        }
+
+        if (cos_name_obj_node_get_hash(COS_nonnull_cast(name_obj)) == hash) {
+            const CosString * const name_value = cos_name_obj_node_get_value(COS_nonnull_cast(name_obj));
+            if (name_value &&
+                cos_string_ref_cmp(cos_string_get_ref(COS_nonnull_cast(name_value)), value) == 0) {
+                return index;
+            }
+        }
+
+        index = (index + 1) & mask;
+    }
+}
+
+static bool
+cos_name_table_grow_(CosNameTable *table)
+{
+    COS_IMPL_PARAM_CHECK(table != NULL);
+
+    const size_t old_capacity = table->capacity;
+    CosNameObjNode * COS_Nullable * const old_slots = table->slots;
+
+    const size_t new_capacity = old_capacity * 2;
+    CosNameObjNode * COS_Nullable * const new_slots = cos_calloc(table->allocator,
+                                                                 new_capacity,
+                                                                 sizeof(CosNameObjNode *));
+    if (!new_slots) {
+        return false;
+    }
+
+    const size_t mask = new_capacity - 1;
+    for (size_t i = 0; i < old_capacity; i++) {
+        CosNameObjNode * const name_obj = old_slots[i];
+        if (!name_obj) {
+            continue;
+        }
+
+        // All interned names are distinct, so only an empty slot needs to be found.
+        size_t index = cos_name_obj_node_get_hash(COS_nonnull_cast(name_obj)) & mask;
+        while (new_slots[index]) {
+            index = (index + 1) & mask;
+        }
+        new_slots[index] = name_obj;
+    }
+
+    table->slots = new_slots;
+    table->capacity = new_capacity;
+    cos_free(table->allocator, old_slots);
+
+    return true;
+}
+
+COS_ASSUME_NONNULL_END
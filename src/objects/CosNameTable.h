@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2025 OpenCOS.
+ */
+
+#ifndef LIBCOS_COS_NAME_TABLE_H
+#define LIBCOS_COS_NAME_TABLE_H
+
+#include <libcos/common/CosDefines.h>
+#include <libcos/common/CosTypes.h>
+
+#include <stddef.h>
+
+COS_DECLS_BEGIN
+COS_ASSUME_NONNULL_BEGIN
+
+/**
+ * A table of interned name objects.
+ *
+ * Each distinct name is represented by a single, immutable name object with a precomputed
+ * hash. Name objects interned in the same table can be compared by pointer.
+ */
+typedef struct CosNameTable CosNameTable;
+
+/**
+ * @brief Destroys the name table, releasing all interned name objects.
+ *
+ * Name objects that are still retained elsewhere remain valid, but are no longer interned.
+ *
+ * @param table The name table.
+ */
+void
+cos_name_table_destroy(CosNameTable *table)
+    COS_DEALLOCATOR_FUNC;
+
+/**
+ * @brief Creates a new name table.
+ *
+ * @param allocator The allocator to use for the table and its name objects, or @c NULL to use
+ * the default allocator.
+ * @param capacity_hint An estimate of how many distinct names will be interned.
+ *
+ * @return A new name table, or @c NULL on allocation failure.
+ */
+CosNameTable * COS_Nullable
+cos_name_table_create(CosAllocator * COS_Nullable allocator,
+                      size_t capacity_hint)
+    COS_ALLOCATOR_FUNC
+    COS_ALLOCATOR_FUNC_MATCHED_DEALLOC(cos_name_table_destroy);
+
+/**
+ * @brief Interns a name.
+ *
+ * If an equal name has already been interned, @a value is freed and the existing name object is
+ * returned. Otherwise a new name object is created with @a value and added to the table.
+ *
+ * @param table The name table.
+ * @param value The name string. Ownership is transferred to the table.
+ *
+ * @return A new reference to the interned name object, or @c NULL on allocation failure.
+ */
+CosNameObjNode * COS_Nullable
+cos_name_table_intern(CosNameTable *table,
+                      CosString *value)
+    COS_OWNERSHIP_TAKES(2)
+    COS_OWNERSHIP_RETURNS;
+
+/**
+ * @brief Returns the number of interned names.
+ *
+ * @param table The name table.
+ *
+ * @return The number of interned names.
+ */
+size_t
+cos_name_table_get_count(const CosNameTable *table);
+
+COS_ASSUME_NONNULL_END
+COS_DECLS_END
+
+#endif /* LIBCOS_COS_NAME_TABLE_H */
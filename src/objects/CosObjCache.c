@@ -5,83 +5,240 @@
 #include "objects/CosObjCache.h"
 
 #include "common/Assert.h"
+#include "common/CosAtomic.h"
+#include "common/CosThread.h"
 
-#include <libcos/common/CosDict.h>
+#include <libcos/common/CosData.h>
 #include <libcos/common/CosError.h>
+#include <libcos/common/CosString.h>
+#include <libcos/common/memory/CosMemory.h>
+#include <libcos/objects/CosArrayObjNode.h>
+#include <libcos/objects/CosDictObjNode.h>
+#include <libcos/objects/CosIndirectObjNode.h>
+#include <libcos/objects/CosNameObjNode.h>
 #include <libcos/objects/CosObjNode.h>
+#include <libcos/objects/CosObjValue.h>
+#include <libcos/objects/CosStreamObjNode.h>
+#include <libcos/objects/CosStringObjNode.h>
 
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 
 COS_ASSUME_NONNULL_BEGIN
 
+/**
+ * The estimated size of an object node, before its payload.
+ */
+#define COS_OBJ_CACHE_NODE_SIZE 32
+
+/**
+ * The number of shards of a concurrent cache.
+ */
+#define COS_OBJ_CACHE_SHARD_COUNT 16
+
+/**
+ * The slot of an object number.
+ */
+typedef struct CosObjCacheSlot {
+    /**
+     * The cached object, or @c NULL if the slot is empty.
+     *
+     * The generation number is written before the object is published, so a reader that sees
+     * the object also sees its generation number.
+     */
+    CosObjNode * COS_Nullable obj;
+
+    unsigned int gen_number;
+
+    /**
+     * The index of the object number in the ring of its shard.
+     */
+    unsigned int ring_index;
+
+    /**
+     * The number of pins on the object. A pinned object is never evicted.
+     */
+    unsigned int pin_count;
+
+    /**
+     * Whether the object was used since the hand last passed it.
+     */
+    unsigned int referenced;
+
+    /**
+     * Whether a thread is loading the object, and if so which one.
+     */
+    bool loading;
+    CosThreadID loader;
+} CosObjCacheSlot;
+
+/**
+ * An entry in the ring of cached objects, which the hand sweeps over.
+ */
+typedef struct CosObjCacheRingEntry {
+    unsigned int obj_number;
+
+    /**
+     * The estimated size of the object, in bytes.
+     */
+    size_t size;
+} CosObjCacheRingEntry;
+
+/**
+ * A shard of the cache, which holds the objects whose number maps to it.
+ *
+ * Each shard has its own lock, ring and budget, so that threads working on different objects
+ * rarely contend. A cache that is not concurrent has a single shard, and no locks.
+ */
+typedef struct CosObjCacheShard {
+    CosMutex mutex;
+
+    /**
+     * Signaled when a thread finishes loading an object of the shard.
+     */
+    CosCondition load_finished;
+
+    CosObjCacheRingEntry * COS_Nullable ring;
+    size_t count;
+    size_t ring_capacity;
+
+    /**
+     * The index of the next ring entry that is considered for eviction.
+     */
+    size_t hand;
+
+    size_t byte_count;
+    size_t pinned_count;
+
+    size_t hit_count;
+    size_t miss_count;
+    size_t eviction_count;
+} CosObjCacheShard;
+
+/**
+ * A thread that waits for another thread to finish loading an object.
+ */
+typedef struct CosObjCacheWait {
+    CosThreadID waiter;
+    CosThreadID loader;
+} CosObjCacheWait;
+
 struct CosObjCache {
-    CosDict *dict;
+    CosAllocator * COS_Nullable allocator;
+
+    /**
+     * Whether the cache can be used from multiple threads.
+     */
+    bool concurrent;
+
+    /**
+     * The slots, indexed by object number.
+     */
+    CosObjCacheSlot * COS_Nullable slots;
+    size_t slot_count;
+
+    CosObjCacheShard *shards;
+    size_t shard_count;
+
+    /**
+     * Guards @c waits. It is taken while a shard's mutex is held, never the other way around.
+     */
+    CosMutex waits_mutex;
+
+    /**
+     * The threads of a concurrent cache that wait for another thread's load.
+     */
+    CosObjCacheWait * COS_Nullable waits;
+    size_t wait_count;
+    size_t wait_capacity;
+
+    CosDocCacheLimits limits;
+
+    /**
+     * The limits of each shard.
+     */
+    CosDocCacheLimits shard_limits;
 };
 
-// MARK: - Dict callbacks
+static CosObjCacheShard *
+cos_obj_cache_get_shard_(CosObjCache *cache,
+                         unsigned int obj_number);
+
+static void
+cos_obj_cache_lock_(const CosObjCache *cache,
+                    CosObjCacheShard *shard);
+
+static void
+cos_obj_cache_unlock_(const CosObjCache *cache,
+                      CosObjCacheShard *shard);
+
+static CosObjCacheSlot * COS_Nullable
+cos_obj_cache_find_slot_(CosObjCache *cache,
+                         CosObjID obj_id);
 
 static bool
-cos_obj_cache_keys_equal_(void *key1,
-                          void *key2)
-{
-    return key1 == key2;
-}
+cos_obj_cache_insert_locked_(CosObjCache *cache,
+                             CosObjCacheShard *shard,
+                             CosObjID obj_id,
+                             CosObjNode *obj,
+                             size_t size);
 
 static void
-cos_obj_cache_value_retain_(void *value)
-{
-    cos_obj_node_retain((CosObjNode *)value);
-}
+cos_obj_cache_remove_(CosObjCache *cache,
+                      CosObjCacheShard *shard,
+                      size_t ring_index);
 
 static void
-cos_obj_cache_value_release_(void *value)
-{
-    cos_obj_node_release((CosObjNode *)value);
-}
+cos_obj_cache_evict_(CosObjCache *cache,
+                     CosObjCacheShard *shard);
 
-static const CosDictKeyCallbacks cos_obj_cache_key_callbacks_ = {
-    .hash = NULL,
-    .retain = NULL,
-    .release = NULL,
-    .equal = &cos_obj_cache_keys_equal_,
-};
+static size_t
+cos_obj_cache_estimate_size_(CosObjNode *obj);
 
-static const CosDictValueCallbacks cos_obj_cache_value_callbacks_ = {
-    .retain = &cos_obj_cache_value_retain_,
-    .release = &cos_obj_cache_value_release_,
-    .equal = NULL,
-};
+static bool
+cos_obj_cache_add_wait_(CosObjCache *cache,
+                        CosThreadID waiter,
+                        CosThreadID loader);
+
+static void
+cos_obj_cache_remove_wait_(CosObjCache *cache,
+                           CosThreadID waiter);
 
 // MARK: - Lifecycle
 
 CosObjCache *
-cos_obj_cache_create(size_t capacity_hint)
+cos_obj_cache_create(CosAllocator * COS_Nullable allocator,
+                     size_t obj_count)
 {
     CosObjCache *cache = NULL;
-    CosDict *dict = NULL;
+    CosObjCacheShard *shard = NULL;
 
-    cache = calloc(1, sizeof(CosObjCache));
+    cache = cos_calloc(allocator, 1, sizeof(CosObjCache));
     if (!cache) {
         goto failure;
     }
+    cache->allocator = allocator;
+
+    shard = cos_calloc(allocator, 1, sizeof(CosObjCacheShard));
+    if (!shard) {
+        goto failure;
+    }
+    cache->shards = shard;
+    cache->shard_count = 1;
 
-    dict = cos_dict_create(&cos_obj_cache_key_callbacks_,
-                           &cos_obj_cache_value_callbacks_,
-                           capacity_hint);
-    if (!dict) {
+    if (!cos_obj_cache_reserve(cache, obj_count)) {
         goto failure;
     }
-    cache->dict = COS_nonnull_cast(dict);
 
     return cache;
 
 failure:
-    if (cache) {
-        free(cache);
+    if (shard) {
+        cos_free(allocator, shard);
     }
-    if (dict) {
-        cos_dict_destroy(dict);
+    if (cache) {
+        cos_free(allocator, cache);
     }
     return NULL;
 }
@@ -93,35 +250,255 @@ cos_obj_cache_destroy(CosObjCache *cache)
         return;
     }
 
-    cos_dict_destroy(cache->dict);
-    free(cache);
+    for (size_t i = 0; i < cache->shard_count; i++) {
+        CosObjCacheShard * const shard = &cache->shards[i];
+        for (size_t j = 0; j < shard->count; j++) {
+            const CosObjCacheSlot * const slot = &cache->slots[shard->ring[j].obj_number];
+            cos_obj_node_release(slot->obj);
+        }
+        cos_free(cache->allocator, shard->ring);
+
+        if (cache->concurrent) {
+            cos_condition_destroy(&shard->load_finished);
+            cos_mutex_destroy(&shard->mutex);
+        }
+    }
+    cos_free(cache->allocator, cache->shards);
+    cos_free(cache->allocator, cache->slots);
+
+    if (cache->concurrent) {
+        cos_mutex_destroy(&cache->waits_mutex);
+    }
+    cos_free(cache->allocator, cache->waits);
+
+    cos_free(cache->allocator, cache);
+}
+
+bool
+cos_obj_cache_reserve(CosObjCache *cache,
+                      size_t obj_count)
+{
+    COS_API_PARAM_CHECK(cache != NULL);
+    if (COS_UNLIKELY(!cache)) {
+        return false;
+    }
+
+    if (obj_count <= cache->slot_count) {
+        return true;
+    }
+    // Readers of a concurrent cache index the slots without locks.
+    if (cache->concurrent || obj_count > SIZE_MAX / sizeof(CosObjCacheSlot)) {
+        return false;
+    }
+
+    CosObjCacheSlot * const new_slots = cos_realloc(cache->allocator,
+                                                    cache->slots,
+                                                    obj_count * sizeof(CosObjCacheSlot));
+    if (!new_slots) {
+        return false;
+    }
+    memset(new_slots + cache->slot_count,
+           0,
+           (obj_count - cache->slot_count) * sizeof(CosObjCacheSlot));
+
+    cache->slots = new_slots;
+    cache->slot_count = obj_count;
+    return true;
+}
+
+bool
+cos_obj_cache_make_concurrent(CosObjCache *cache,
+                              size_t obj_count,
+                              CosError * COS_Nullable out_error)
+{
+    COS_API_PARAM_CHECK(cache != NULL);
+    if (COS_UNLIKELY(!cache)) {
+        return false;
+    }
+
+    if (cache->concurrent) {
+        return true;
+    }
+
+    if (!cos_obj_cache_reserve(cache, obj_count)) {
+        COS_ERROR_PROPAGATE(cos_error_make(COS_ERROR_MEMORY,
+                                           "Failed to allocate the cache slots"),
+                            out_error);
+        return false;
+    }
+
+    CosObjCacheShard * const old_shard = &cache->shards[0];
+    for (size_t i = 0; i < old_shard->count; i++) {
+        CosObjNode * const obj = COS_nonnull_cast(cache->slots[old_shard->ring[i].obj_number].obj);
+        if (!cos_obj_node_freeze(obj, out_error)) {
+            return false;
+        }
+    }
+
+    CosObjCacheShard * const shards = cos_calloc(cache->allocator,
+                                                 COS_OBJ_CACHE_SHARD_COUNT,
+                                                 sizeof(CosObjCacheShard));
+    if (!shards) {
+        COS_ERROR_PROPAGATE(cos_error_make(COS_ERROR_MEMORY,
+                                           "Failed to allocate the cache shards"),
+                            out_error);
+        return false;
+    }
+
+    size_t initialized_count = 0;
+    for (; initialized_count < COS_OBJ_CACHE_SHARD_COUNT; initialized_count++) {
+        CosObjCacheShard * const shard = &shards[initialized_count];
+        if (!cos_mutex_init(&shard->mutex, false)) {
+            break;
+        }
+        if (!cos_condition_init(&shard->load_finished)) {
+            cos_mutex_destroy(&shard->mutex);
+            break;
+        }
+    }
+
+    bool waits_mutex_initialized = false;
+    if (initialized_count == COS_OBJ_CACHE_SHARD_COUNT) {
+        waits_mutex_initialized = cos_mutex_init(&cache->waits_mutex, false);
+    }
+
+    // Move the cached objects to their shards.
+    bool success = waits_mutex_initialized;
+    for (size_t i = 0; success && i < old_shard->count; i++) {
+        const CosObjCacheRingEntry entry = old_shard->ring[i];
+        CosObjCacheShard * const shard = &shards[entry.obj_number % COS_OBJ_CACHE_SHARD_COUNT];
+
+        if (shard->count == shard->ring_capacity) {
+            const size_t new_capacity = (shard->ring_capacity > 0) ? shard->ring_capacity * 2 : 16;
+            CosObjCacheRingEntry * const new_ring = cos_realloc(cache->allocator,
+                                                                shard->ring,
+                                                                new_capacity * sizeof(CosObjCacheRingEntry));
+            if (!new_ring) {
+                success = false;
+                break;
+            }
+            shard->ring = new_ring;
+            shard->ring_capacity = new_capacity;
+        }
+
+        CosObjCacheSlot * const slot = &cache->slots[entry.obj_number];
+        slot->ring_index = (unsigned int)shard->count;
+        shard->ring[shard->count++] = entry;
+        shard->byte_count += entry.size;
+        if (slot->pin_count > 0) {
+            shard->pinned_count++;
+        }
+    }
+
+    if (!success) {
+        // The slots still point into the old shard's ring, by index, so restore them.
+        for (size_t i = 0; i < old_shard->count; i++) {
+            cache->slots[old_shard->ring[i].obj_number].ring_index = (unsigned int)i;
+        }
+        for (size_t i = 0; i < COS_OBJ_CACHE_SHARD_COUNT; i++) {
+            cos_free(cache->allocator, shards[i].ring);
+            if (i < initialized_count) {
+                cos_condition_destroy(&shards[i].load_finished);
+                cos_mutex_destroy(&shards[i].mutex);
+            }
+        }
+        cos_free(cache->allocator, shards);
+        if (waits_mutex_initialized) {
+            cos_mutex_destroy(&cache->waits_mutex);
+        }
+
+        COS_ERROR_PROPAGATE(cos_error_make(COS_ERROR_MEMORY,
+                                           "Failed to set up the cache shards"),
+                            out_error);
+        return false;
+    }
+
+    shards[0].hit_count = old_shard->hit_count;
+    shards[0].miss_count = old_shard->miss_count;
+    shards[0].eviction_count = old_shard->eviction_count;
+
+    cos_free(cache->allocator, old_shard->ring);
+    cos_free(cache->allocator, cache->shards);
+
+    cache->shards = shards;
+    cache->shard_count = COS_OBJ_CACHE_SHARD_COUNT;
+    cache->concurrent = true;
+
+    cos_obj_cache_set_limits(cache, cache->limits);
+    return true;
+}
+
+void
+cos_obj_cache_set_limits(CosObjCache *cache,
+                         CosDocCacheLimits limits)
+{
+    COS_API_PARAM_CHECK(cache != NULL);
+    if (COS_UNLIKELY(!cache)) {
+        return;
+    }
+
+    // The budget is split evenly between the shards, rounding up.
+    const size_t shard_count = cache->shard_count;
+    cache->limits = limits;
+    cache->shard_limits = (CosDocCacheLimits){
+        .max_objects = (limits.max_objects + shard_count - 1) / shard_count,
+        .max_bytes = (limits.max_bytes + shard_count - 1) / shard_count,
+    };
+
+    for (size_t i = 0; i < shard_count; i++) {
+        CosObjCacheShard * const shard = &cache->shards[i];
+        cos_obj_cache_lock_(cache, shard);
+        cos_obj_cache_evict_(cache, shard);
+        cos_obj_cache_unlock_(cache, shard);
+    }
 }
 
 // MARK: - Operations
 
 CosObjNode *
 cos_obj_cache_get(CosObjCache *cache,
-                  unsigned int obj_number)
+                  CosObjID obj_id)
 {
     COS_API_PARAM_CHECK(cache != NULL);
     if (COS_UNLIKELY(!cache)) {
         return NULL;
     }
 
-    void *value = NULL;
-    if (cos_dict_get(cache->dict,
-                     (void *)(uintptr_t)obj_number,
-                     &value,
-                     NULL)) {
-        return (CosObjNode *)value;
+    CosObjCacheShard * const shard = cos_obj_cache_get_shard_(cache, obj_id.obj_number);
+
+    // Without a budget, a cached object is never removed, so it can be retained without
+    // taking the lock.
+    const bool is_bounded = (cache->limits.max_objects > 0 || cache->limits.max_bytes > 0);
+    const bool needs_lock = (cache->concurrent && is_bounded);
+
+    if (needs_lock) {
+        cos_obj_cache_lock_(cache, shard);
     }
 
-    return NULL;
+    CosObjNode *obj = NULL;
+    if (obj_id.obj_number < cache->slot_count) {
+        CosObjCacheSlot * const slot = &cache->slots[obj_id.obj_number];
+        obj = cos_atomic_load_ptr_acquire((void * const *)&slot->obj);
+        if (obj && slot->gen_number == obj_id.gen_number) {
+            cos_atomic_store_relaxed(&slot->referenced, 1);
+            (void)cos_obj_node_retain(obj);
+        }
+        else {
+            obj = NULL;
+        }
+    }
+
+    if (needs_lock) {
+        cos_obj_cache_unlock_(cache, shard);
+    }
+
+    cos_atomic_add_size_relaxed(obj ? &shard->hit_count : &shard->miss_count, 1);
+    return obj;
 }
 
 bool
 cos_obj_cache_insert(CosObjCache *cache,
-                     unsigned int obj_number,
+                     CosObjID obj_id,
                      CosObjNode *obj)
 {
     COS_API_PARAM_CHECK(cache != NULL);
@@ -130,10 +507,590 @@ cos_obj_cache_insert(CosObjCache *cache,
         return false;
     }
 
-    return cos_dict_set(cache->dict,
-                        (void *)(uintptr_t)obj_number,
-                        obj,
-                        NULL);
+    const unsigned int obj_number = obj_id.obj_number;
+    if (obj_number >= cache->slot_count) {
+        // The trailer's /Size was missing or too small.
+        const size_t min_count = (size_t)obj_number + 1;
+        const size_t grown_count = cache->slot_count + cache->slot_count / 2;
+        if (!cos_obj_cache_reserve(cache, (grown_count > min_count) ? grown_count : min_count)) {
+            return false;
+        }
+    }
+
+    if (cache->concurrent && !cos_obj_node_freeze(obj, NULL)) {
+        return false;
+    }
+
+    const size_t size = cos_obj_cache_estimate_size_(obj);
+    CosObjCacheShard * const shard = cos_obj_cache_get_shard_(cache, obj_number);
+
+    cos_obj_cache_lock_(cache, shard);
+    const bool result = cos_obj_cache_insert_locked_(cache, shard, obj_id, obj, size);
+    cos_obj_cache_unlock_(cache, shard);
+
+    return result;
+}
+
+CosObjCacheLoadState
+cos_obj_cache_begin_load(CosObjCache *cache,
+                         CosObjID obj_id,
+                         CosObjNode * COS_Nullable *out_obj)
+{
+    COS_API_PARAM_CHECK(cache != NULL);
+    COS_API_PARAM_CHECK(out_obj != NULL);
+    if (COS_UNLIKELY(!cache || !out_obj)) {
+        return CosObjCacheLoadState_Unclaimed;
+    }
+
+    *out_obj = NULL;
+
+    if (!cache->concurrent) {
+        return CosObjCacheLoadState_Claimed;
+    }
+    if (obj_id.obj_number >= cache->slot_count) {
+        return CosObjCacheLoadState_Unclaimed;
+    }
+
+    CosObjCacheShard * const shard = cos_obj_cache_get_shard_(cache, obj_id.obj_number);
+    CosObjCacheSlot * const slot = &cache->slots[obj_id.obj_number];
+    const CosThreadID current_thread = cos_thread_get_current_id();
+
+    cos_mutex_lock(&shard->mutex);
+
+    CosObjCacheLoadState state = CosObjCacheLoadState_Claimed;
+    for (;;) {
+        if (slot->obj) {
+            if (slot->gen_number == obj_id.gen_number) {
+                *out_obj = cos_obj_node_retain(slot->obj);
+                state = CosObjCacheLoadState_Cached;
+            }
+            else {
+                state = CosObjCacheLoadState_Unclaimed;
+            }
+            break;
+        }
+        if (!slot->loading) {
+            slot->loading = true;
+            slot->loader = current_thread;
+            break;
+        }
+        if (cos_thread_id_equal(slot->loader, current_thread)) {
+            // The object is needed to load itself, e.g. through the /Length of a stream.
+            state = CosObjCacheLoadState_Cycle;
+            break;
+        }
+        if (!cos_obj_cache_add_wait_(cache, current_thread, slot->loader)) {
+            // The loader waits, directly or not, for an object that this thread is loading.
+            state = CosObjCacheLoadState_Cycle;
+            break;
+        }
+
+        cos_condition_wait(&shard->load_finished, &shard->mutex);
+        cos_obj_cache_remove_wait_(cache, current_thread);
+    }
+
+    cos_mutex_unlock(&shard->mutex);
+    return state;
+}
+
+void
+cos_obj_cache_end_load(CosObjCache *cache,
+                       CosObjID obj_id,
+                       CosObjNode * COS_Nullable obj)
+{
+    COS_API_PARAM_CHECK(cache != NULL);
+    if (COS_UNLIKELY(!cache)) {
+        return;
+    }
+
+    if (!cache->concurrent) {
+        if (obj) {
+            (void)cos_obj_cache_insert(cache, obj_id, COS_nonnull_cast(obj));
+        }
+        return;
+    }
+
+    COS_ASSERT(obj_id.obj_number < cache->slot_count, "The load was not claimed");
+
+    // The object is frozen before it is published, as other threads read it without locks.
+    size_t size = 0;
+    if (obj) {
+        if (cos_obj_node_freeze(COS_nonnull_cast(obj), NULL)) {
+            size = cos_obj_cache_estimate_size_(COS_nonnull_cast(obj));
+        }
+        else {
+            obj = NULL;
+        }
+    }
+
+    CosObjCacheShard * const shard = cos_obj_cache_get_shard_(cache, obj_id.obj_number);
+    CosObjCacheSlot * const slot = &cache->slots[obj_id.obj_number];
+
+    cos_mutex_lock(&shard->mutex);
+
+    slot->loading = false;
+    if (obj) {
+        (void)cos_obj_cache_insert_locked_(cache, shard, obj_id, COS_nonnull_cast(obj), size);
+    }
+    cos_condition_broadcast(&shard->load_finished);
+
+    cos_mutex_unlock(&shard->mutex);
+}
+
+bool
+cos_obj_cache_pin(CosObjCache *cache,
+                  CosObjID obj_id)
+{
+    COS_API_PARAM_CHECK(cache != NULL);
+    if (COS_UNLIKELY(!cache)) {
+        return false;
+    }
+
+    CosObjCacheShard * const shard = cos_obj_cache_get_shard_(cache, obj_id.obj_number);
+    cos_obj_cache_lock_(cache, shard);
+
+    CosObjCacheSlot * const slot = cos_obj_cache_find_slot_(cache, obj_id);
+    if (slot && slot->pin_count++ == 0) {
+        shard->pinned_count++;
+    }
+
+    cos_obj_cache_unlock_(cache, shard);
+    return (slot != NULL);
+}
+
+void
+cos_obj_cache_unpin(CosObjCache *cache,
+                    CosObjID obj_id)
+{
+    COS_API_PARAM_CHECK(cache != NULL);
+    if (COS_UNLIKELY(!cache)) {
+        return;
+    }
+
+    CosObjCacheShard * const shard = cos_obj_cache_get_shard_(cache, obj_id.obj_number);
+    cos_obj_cache_lock_(cache, shard);
+
+    CosObjCacheSlot * const slot = cos_obj_cache_find_slot_(cache, obj_id);
+    COS_API_PARAM_CHECK(!slot || slot->pin_count > 0);
+    if (slot && slot->pin_count > 0 && --slot->pin_count == 0) {
+        shard->pinned_count--;
+        cos_obj_cache_evict_(cache, shard);
+    }
+
+    cos_obj_cache_unlock_(cache, shard);
+}
+
+void
+cos_obj_cache_get_stats(const CosObjCache *cache,
+                        CosDocCacheStats *out_stats)
+{
+    COS_API_PARAM_CHECK(cache != NULL);
+    COS_API_PARAM_CHECK(out_stats != NULL);
+    if (COS_UNLIKELY(!cache || !out_stats)) {
+        return;
+    }
+
+    CosDocCacheStats stats = {0};
+    for (size_t i = 0; i < cache->shard_count; i++) {
+        CosObjCacheShard * const shard = &cache->shards[i];
+        cos_obj_cache_lock_(cache, shard);
+
+        stats.hit_count += cos_atomic_load_size_relaxed(&shard->hit_count);
+        stats.miss_count += cos_atomic_load_size_relaxed(&shard->miss_count);
+        stats.eviction_count += shard->eviction_count;
+        stats.object_count += shard->count;
+        stats.byte_count += shard->byte_count;
+        stats.pinned_count += shard->pinned_count;
+
+        cos_obj_cache_unlock_(cache, shard);
+    }
+    *out_stats = stats;
+}
+
+// MARK: - Shards
+
+static CosObjCacheShard *
+cos_obj_cache_get_shard_(CosObjCache *cache,
+                         unsigned int obj_number)
+{
+    COS_IMPL_PARAM_CHECK(cache != NULL);
+
+    // Consecutive objects, which tend to be loaded together, go to different shards.
+    return &cache->shards[obj_number % cache->shard_count];
+}
+
+static void
+cos_obj_cache_lock_(const CosObjCache *cache,
+                    CosObjCacheShard *shard)
+{
+    COS_IMPL_PARAM_CHECK(cache != NULL);
+    COS_IMPL_PARAM_CHECK(shard != NULL);
+
+    if (cache->concurrent) {
+        cos_mutex_lock(&shard->mutex);
+    }
+}
+
+static void
+cos_obj_cache_unlock_(const CosObjCache *cache,
+                      CosObjCacheShard *shard)
+{
+    COS_IMPL_PARAM_CHECK(cache != NULL);
+    COS_IMPL_PARAM_CHECK(shard != NULL);
+
+    if (cache->concurrent) {
+        cos_mutex_unlock(&shard->mutex);
+    }
+}
+
+// MARK: - Slots
+
+/**
+ * Returns the slot of an object, or @c NULL if the object is not cached.
+ *
+ * In a concurrent cache, the lock of the object's shard must be held.
+ */
+static CosObjCacheSlot *
+cos_obj_cache_find_slot_(CosObjCache *cache,
+                         CosObjID obj_id)
+{
+    COS_IMPL_PARAM_CHECK(cache != NULL);
+
+    if (obj_id.obj_number >= cache->slot_count) {
+        return NULL;
+    }
+
+    CosObjCacheSlot * const slot = &cache->slots[obj_id.obj_number];
+    if (!slot->obj || slot->gen_number != obj_id.gen_number) {
+        return NULL;
+    }
+    return slot;
+}
+
+/**
+ * Inserts an object, with the lock of its shard held.
+ */
+static bool
+cos_obj_cache_insert_locked_(CosObjCache *cache,
+                             CosObjCacheShard *shard,
+                             CosObjID obj_id,
+                             CosObjNode *obj,
+                             size_t size)
+{
+    COS_IMPL_PARAM_CHECK(cache != NULL);
+    COS_IMPL_PARAM_CHECK(shard != NULL);
+    COS_IMPL_PARAM_CHECK(obj != NULL);
+    COS_IMPL_PARAM_CHECK(obj_id.obj_number < cache->slot_count);
+
+    CosObjCacheSlot * const slot = &cache->slots[obj_id.obj_number];
+
+    if (slot->obj) {
+        // Readers of a concurrent cache may be retaining the cached object without the lock.
+        if (cache->concurrent) {
+            return false;
+        }
+
+        // Another generation of the object, or the same one loaded again.
+        CosObjNode * const old_obj = COS_nonnull_cast(slot->obj);
+        CosObjCacheRingEntry * const ring_entry = &shard->ring[slot->ring_index];
+
+        if (slot->gen_number != obj_id.gen_number && slot->pin_count > 0) {
+            // The pins were for the old generation.
+            slot->pin_count = 0;
+            shard->pinned_count--;
+        }
+        slot->obj = cos_obj_node_retain(obj);
+        slot->gen_number = obj_id.gen_number;
+        slot->referenced = 1;
+        shard->byte_count = shard->byte_count - ring_entry->size + size;
+        ring_entry->size = size;
+
+        cos_obj_node_release(old_obj);
+        cos_obj_cache_evict_(cache, shard);
+        return true;
+    }
+
+    if (shard->count == shard->ring_capacity) {
+        const size_t new_capacity = (shard->ring_capacity > 0) ? shard->ring_capacity * 2 : 16;
+        CosObjCacheRingEntry * const new_ring = cos_realloc(cache->allocator,
+                                                            shard->ring,
+                                                            new_capacity * sizeof(CosObjCacheRingEntry));
+        if (!new_ring) {
+            return false;
+        }
+        shard->ring = new_ring;
+        shard->ring_capacity = new_capacity;
+    }
+
+    shard->ring[shard->count] = (CosObjCacheRingEntry){
+        .obj_number = obj_id.obj_number,
+        .size = size,
+    };
+
+    slot->gen_number = obj_id.gen_number;
+    slot->ring_index = (unsigned int)shard->count;
+    slot->pin_count = 0;
+    slot->referenced = 1;
+    cos_atomic_store_ptr_release((void **)&slot->obj, cos_obj_node_retain(obj));
+
+    shard->count++;
+    shard->byte_count += size;
+
+    cos_obj_cache_evict_(cache, shard);
+    return true;
+}
+
+/**
+ * Removes a cached object and releases it, with the lock of its shard held.
+ *
+ * The last ring entry is moved into its place, so the hand does not need to move to consider
+ * the next entry.
+ */
+static void
+cos_obj_cache_remove_(CosObjCache *cache,
+                      CosObjCacheShard *shard,
+                      size_t ring_index)
+{
+    COS_IMPL_PARAM_CHECK(cache != NULL);
+    COS_IMPL_PARAM_CHECK(shard != NULL);
+    COS_IMPL_PARAM_CHECK(ring_index < shard->count);
+
+    const CosObjCacheRingEntry removed = shard->ring[ring_index];
+    CosObjCacheSlot * const slot = &cache->slots[removed.obj_number];
+    CosObjNode * const obj = COS_nonnull_cast(slot->obj);
+
+    cos_atomic_store_ptr_release((void **)&slot->obj, NULL);
+    slot->pin_count = 0;
+    slot->referenced = 0;
+
+    const size_t last_index = shard->count - 1;
+    if (ring_index != last_index) {
+        shard->ring[ring_index] = shard->ring[last_index];
+        cache->slots[shard->ring[ring_index].obj_number].ring_index = (unsigned int)ring_index;
+    }
+    shard->count--;
+    shard->byte_count -= removed.size;
+
+    cos_obj_node_release(obj);
+}
+
+// MARK: - Eviction
+
+static bool
+cos_obj_cache_is_over_budget_(const CosObjCache *cache,
+                              const CosObjCacheShard *shard)
+{
+    COS_IMPL_PARAM_CHECK(cache != NULL);
+    COS_IMPL_PARAM_CHECK(shard != NULL);
+
+    const CosDocCacheLimits limits = cache->shard_limits;
+    return ((limits.max_objects > 0 && shard->count > limits.max_objects) ||
+            (limits.max_bytes > 0 && shard->byte_count > limits.max_bytes));
+}
+
+/**
+ * Evicts objects from a shard until it is within its budget, with the lock of the shard held.
+ */
+static void
+cos_obj_cache_evict_(CosObjCache *cache,
+                     CosObjCacheShard *shard)
+{
+    COS_IMPL_PARAM_CHECK(cache != NULL);
+    COS_IMPL_PARAM_CHECK(shard != NULL);
+
+    // Two passes of the hand are enough to clear every referenced bit and then reach each
+    // unpinned entry. If there is none, the shard stays over budget until objects are unpinned.
+    size_t steps_left = shard->count * 2;
+
+    while (steps_left > 0 && cos_obj_cache_is_over_budget_(cache, shard)) {
+        steps_left--;
+
+        if (shard->hand >= shard->count) {
+            shard->hand = 0;
+        }
+
+        CosObjCacheSlot * const slot = &cache->slots[shard->ring[shard->hand].obj_number];
+        if (slot->pin_count > 0) {
+            shard->hand++;
+        }
+        else if (cos_atomic_load_relaxed(&slot->referenced)) {
+            cos_atomic_store_relaxed(&slot->referenced, 0);
+            shard->hand++;
+        }
+        else {
+            cos_obj_cache_remove_(cache, shard, shard->hand);
+            shard->eviction_count++;
+        }
+    }
+}
+
+// MARK: - Size estimation
+
+/**
+ * Estimates the memory that is used by an object and the objects that it holds.
+ *
+ * This only needs to be good enough to compare objects against a budget. Shared objects, such
+ * as interned names, are counted once for each use.
+ */
+static size_t
+cos_obj_cache_estimate_size_(CosObjNode *obj)
+{
+    COS_IMPL_PARAM_CHECK(obj != NULL);
+
+    size_t size = COS_OBJ_CACHE_NODE_SIZE;
+
+    switch (cos_obj_node_get_type(obj)) {
+        case CosObjNodeType_Array: {
+            const CosArrayObjNode * const array_obj = (const CosArrayObjNode *)obj;
+            const size_t count = cos_array_obj_node_get_count(array_obj);
+            size += count * sizeof(CosObjValue);
+
+            for (size_t i = 0; i < count; i++) {
+                CosObjValue element;
+                if (cos_array_obj_node_get_value_at(array_obj, i, &element, NULL) &&
+                    element.kind == CosObjValueKind_Node && element.as.node) {
+                    size += cos_obj_cache_estimate_size_(COS_nonnull_cast(element.as.node));
+                }
+            }
+        } break;
+
+        case CosObjNodeType_Dict: {
+            CosDictObjNodeIterator iterator = cos_dict_obj_node_iterator_init((CosDictObjNode *)obj);
+            CosNameObjNode *key = NULL;
+            CosObjValue value;
+            while (cos_dict_obj_node_iterator_next_value(&iterator, &key, &value)) {
+                size += sizeof(void *) + sizeof(CosObjValue);
+                if (key) {
+                    size += cos_obj_cache_estimate_size_((CosObjNode *)key);
+                }
+                if (value.kind == CosObjValueKind_Node && value.as.node) {
+                    size += cos_obj_cache_estimate_size_(COS_nonnull_cast(value.as.node));
+                }
+            }
+        } break;
+
+        case CosObjNodeType_String: {
+            const CosData * const data = cos_string_obj_node_get_value((const CosStringObjNode *)obj);
+            if (data) {
+                size += data->size;
+            }
+        } break;
+
+        case CosObjNodeType_Name: {
+            const CosString * const string = cos_name_obj_node_get_value((const CosNameObjNode *)obj);
+            if (string) {
+                size += cos_string_get_length(string);
+            }
+        } break;
+
+        case CosObjNodeType_Stream: {
+            const CosStreamObjNode * const stream_obj = (const CosStreamObjNode *)obj;
+            size += cos_stream_obj_node_get_length(stream_obj);
+
+            CosDictObjNode * const dict_obj = cos_stream_obj_node_get_dict(stream_obj);
+            if (dict_obj) {
+                size += cos_obj_cache_estimate_size_((CosObjNode *)dict_obj);
+            }
+        } break;
+
+        case CosObjNodeType_Indirect: {
+            CosObjNode * const value = cos_indirect_obj_node_get_value((const CosIndirectObjNode *)obj);
+            if (value) {
+                size += cos_obj_cache_estimate_size_(COS_nonnull_cast(value));
+            }
+        } break;
+
+        case CosObjNodeType_Unknown:
+        case CosObjNodeType_Boolean:
+        case CosObjNodeType_Integer:
+        case CosObjNodeType_Real:
+        case CosObjNodeType_Null:
+        case CosObjNodeType_Reference:
+            break;
+    }
+
+    return size;
+}
+
+/**
+ * Records that @p waiter waits for a load of @p loader , unless @p loader waits for @p waiter
+ * itself, through the loads of other threads.
+ *
+ * A thread that has just been woken up may still be recorded as waiting, so this can report a
+ * cycle that is being broken. The caller then fails its load rather than waiting.
+ *
+ * @return @c false if waiting would never end, or if the wait could not be recorded.
+ */
+static bool
+cos_obj_cache_add_wait_(CosObjCache *cache,
+                        CosThreadID waiter,
+                        CosThreadID loader)
+{
+    COS_IMPL_PARAM_CHECK(cache != NULL);
+
+    cos_mutex_lock(&cache->waits_mutex);
+
+    // Each thread waits for at most one other thread, so the chain has at most one entry per
+    // recorded wait.
+    bool result = true;
+    CosThreadID thread = loader;
+    for (size_t step = 0; result && step < cache->wait_count; step++) {
+        const CosObjCacheWait *wait = NULL;
+        for (size_t i = 0; i < cache->wait_count; i++) {
+            if (cos_thread_id_equal(cache->waits[i].waiter, thread)) {
+                wait = &cache->waits[i];
+                break;
+            }
+        }
+        if (!wait) {
+            break;
+        }
+        thread = wait->loader;
+        if (cos_thread_id_equal(thread, waiter)) {
+            result = false;
+        }
+    }
+
+    if (result && cache->wait_count == cache->wait_capacity) {
+        const size_t new_capacity = (cache->wait_capacity > 0) ? cache->wait_capacity * 2 : 8;
+        CosObjCacheWait * const new_waits = cos_realloc(cache->allocator,
+                                                        cache->waits,
+                                                        new_capacity * sizeof(CosObjCacheWait));
+        if (new_waits) {
+            cache->waits = new_waits;
+            cache->wait_capacity = new_capacity;
+        }
+        else {
+            result = false;
+        }
+    }
+    if (result) {
+        cache->waits[cache->wait_count++] = (CosObjCacheWait){
+            .waiter = waiter,
+            .loader = loader,
+        };
+    }
+
+    cos_mutex_unlock(&cache->waits_mutex);
+    return result;
+}
+
+static void
+cos_obj_cache_remove_wait_(CosObjCache *cache,
+                           CosThreadID waiter)
+{
+    COS_IMPL_PARAM_CHECK(cache != NULL);
+
+    cos_mutex_lock(&cache->waits_mutex);
+
+    for (size_t i = 0; i < cache->wait_count; i++) {
+        if (cos_thread_id_equal(cache->waits[i].waiter, waiter)) {
+            cache->waits[i] = cache->waits[--cache->wait_count];
+            break;
+        }
+    }
+
+    cos_mutex_unlock(&cache->waits_mutex);
 }
 
 COS_ASSUME_NONNULL_END
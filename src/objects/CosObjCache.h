@@ -5,6 +5,8 @@
 #ifndef LIBCOS_COS_OBJ_CACHE_H
 #define LIBCOS_COS_OBJ_CACHE_H
 
+#include <libcos/CosDoc.h>
+#include <libcos/CosObjID.h>
 #include <libcos/common/CosDefines.h>
 #include <libcos/common/CosTypes.h>
 
@@ -14,6 +16,24 @@
 COS_DECLS_BEGIN
 COS_ASSUME_NONNULL_BEGIN
 
+/*
+ * The object cache of a document.
+ *
+ * Objects are kept in slots indexed by object number, so a lookup is a bounds check and a load.
+ * The slots are sized from the trailer's /Size up front, and grow if an object number is out of
+ * range. A slot also records the generation number, so only the generation that was loaded is
+ * returned.
+ *
+ * A cache can be made concurrent, so that it can be used from multiple threads. It is then split
+ * into shards by object number, each with its own lock and its own share of the budget. Cached
+ * objects are frozen, and while the cache has no budget they are never removed, so a lookup
+ * retains the object without taking a lock. With a budget, a lookup takes the shard's lock.
+ *
+ * The cache can be given a budget by number of objects and by estimated size. Once it is over
+ * budget, it evicts objects with the CLOCK algorithm: each entry has a referenced bit that is
+ * set when it is looked up, and a hand sweeps the entries, clearing the bits that are set and
+ * evicting the first unpinned entry whose bit is clear.
+ */
 typedef struct CosObjCache CosObjCache;
 
 /**
@@ -28,49 +48,188 @@ cos_obj_cache_destroy(CosObjCache *cache)
 /**
  * @brief Creates a new object cache.
  *
- * @param capacity_hint An estimate of how many objects will be cached.
+ * @param allocator The allocator to use, or @c NULL to use the default allocator.
+ * @param obj_count The number of objects in the document (the trailer's /Size), or @c 0 if
+ * it is not known yet.
  *
  * @return A new object cache, or NULL on allocation failure.
  */
 CosObjCache * COS_Nullable
-cos_obj_cache_create(size_t capacity_hint)
+cos_obj_cache_create(CosAllocator * COS_Nullable allocator,
+                     size_t obj_count)
     COS_ALLOCATOR_FUNC
     COS_ALLOCATOR_FUNC_MATCHED_DEALLOC(cos_obj_cache_destroy);
 
 /**
- * @brief Looks up a cached object by object number.
+ * @brief Makes room for objects numbered below @p obj_count.
  *
- * The returned pointer is not retained -- the caller does not own a new
- * reference. To keep the object beyond the cache's lifetime, the caller
- * must retain it explicitly.
+ * @param cache The object cache.
+ * @param obj_count The number of objects in the document.
+ *
+ * @return @c true on success, @c false on allocation failure.
+ */
+bool
+cos_obj_cache_reserve(CosObjCache *cache,
+                      size_t obj_count);
+
+/**
+ * @brief Makes the cache usable from multiple threads.
+ *
+ * The slots can no longer grow afterwards, so @p obj_count must cover every object number that
+ * will be cached. The objects that are already cached are frozen.
+ *
+ * This must be called before the cache is shared between threads, and so must
+ * @c cos_obj_cache_set_limits.
  *
  * @param cache The object cache.
- * @param obj_number The object number to look up.
+ * @param obj_count The number of objects in the document.
+ * @param out_error On input, a pointer to an error object, or @c NULL.
  *
- * @return The cached object, or NULL if not found.
+ * @return @c true on success, @c false if an error occurred.
+ */
+bool
+cos_obj_cache_make_concurrent(CosObjCache *cache,
+                              size_t obj_count,
+                              CosError * COS_Nullable out_error);
+
+/**
+ * @brief Sets the budget of the cache, evicting objects if it is over the new budget.
+ *
+ * @param cache The object cache.
+ * @param limits The limits, where @c 0 means no limit.
+ */
+void
+cos_obj_cache_set_limits(CosObjCache *cache,
+                         CosDocCacheLimits limits);
+
+/**
+ * @brief Looks up a cached object by object ID.
+ *
+ * @param cache The object cache.
+ * @param obj_id The ID of the object to look up.
+ *
+ * @return The cached object, retained for the caller, or NULL if not found.
  */
 CosObjNode * COS_Nullable
 cos_obj_cache_get(CosObjCache *cache,
-                  unsigned int obj_number);
+                  CosObjID obj_id)
+    COS_WARN_UNUSED_RESULT;
 
 /**
  * @brief Inserts an object into the cache.
  *
  * The cache retains the object (increments its reference count).
- * If an object with the same object number is already cached, it is
- * replaced and released.
+ * If an object with the same object number is already cached, whatever its
+ * generation, it is replaced and released. If the cache is then over its budget, objects
+ * are evicted, which may include the inserted one.
  *
  * @param cache The object cache.
- * @param obj_number The object number.
+ * @param obj_id The ID of the object.
  * @param obj The object to cache.
  *
  * @return true on success, false on allocation failure.
  */
 bool
 cos_obj_cache_insert(CosObjCache *cache,
-                     unsigned int obj_number,
+                     CosObjID obj_id,
                      CosObjNode *obj);
 
+/**
+ * The outcome of @c cos_obj_cache_begin_load.
+ */
+typedef enum CosObjCacheLoadState {
+    /**
+     * The object was loaded by another thread in the meantime, and is returned.
+     */
+    CosObjCacheLoadState_Cached,
+
+    /**
+     * The caller must load the object and pass it to @c cos_obj_cache_end_load.
+     */
+    CosObjCacheLoadState_Claimed,
+
+    /**
+     * The caller must load the object without caching it, because the object cannot be cached.
+     */
+    CosObjCacheLoadState_Unclaimed,
+
+    /**
+     * The caller must fail the load, because the object is needed to load itself: the calling
+     * thread is already loading it, or waiting would wait for a load that waits for this one.
+     */
+    CosObjCacheLoadState_Cycle,
+} CosObjCacheLoadState;
+
+/**
+ * @brief Claims the loading of an object that was not found in the cache.
+ *
+ * In a concurrent cache, only one thread loads a given object at a time: if another thread is
+ * loading it, this waits for it to finish and returns its object. Loads that need each other,
+ * on one thread or across threads, are reported as @c CosObjCacheLoadState_Cycle rather than
+ * waited for.
+ *
+ * @param cache The object cache.
+ * @param obj_id The ID of the object.
+ * @param out_obj On output, the cached object, retained for the caller, if the state is
+ * @c CosObjCacheLoadState_Cached, or @c NULL otherwise.
+ *
+ * @return What the caller must do next.
+ */
+CosObjCacheLoadState
+cos_obj_cache_begin_load(CosObjCache *cache,
+                         CosObjID obj_id,
+                         CosObjNode * COS_Nullable *out_obj)
+    COS_ATTR_ACCESS_WRITE_ONLY(3);
+
+/**
+ * @brief Finishes a load that was claimed with @c cos_obj_cache_begin_load.
+ *
+ * The object is inserted, and the threads that are waiting for it are woken up.
+ *
+ * @param cache The object cache.
+ * @param obj_id The ID of the object.
+ * @param obj The loaded object, or @c NULL if it could not be loaded.
+ */
+void
+cos_obj_cache_end_load(CosObjCache *cache,
+                       CosObjID obj_id,
+                       CosObjNode * COS_Nullable obj);
+
+/**
+ * @brief Pins a cached object, so that it is not evicted.
+ *
+ * @param cache The object cache.
+ * @param obj_id The ID of the object.
+ *
+ * @return @c true if the object was pinned, @c false if it is not cached.
+ */
+bool
+cos_obj_cache_pin(CosObjCache *cache,
+                  CosObjID obj_id);
+
+/**
+ * @brief Removes a pin from a cached object.
+ *
+ * The object may be evicted straight away if the cache is over its budget.
+ *
+ * @param cache The object cache.
+ * @param obj_id The ID of the object.
+ */
+void
+cos_obj_cache_unpin(CosObjCache *cache,
+                    CosObjID obj_id);
+
+/**
+ * @brief Gets the statistics of the cache.
+ *
+ * @param cache The object cache.
+ * @param out_stats On output, the statistics.
+ */
+void
+cos_obj_cache_get_stats(const CosObjCache *cache,
+                        CosDocCacheStats *out_stats)
+    COS_ATTR_ACCESS_WRITE_ONLY(2);
+
 COS_ASSUME_NONNULL_END
 COS_DECLS_END
 
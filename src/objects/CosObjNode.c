@@ -5,7 +5,10 @@
 #include "libcos/objects/CosObjNode.h"
 
 #include "common/Assert.h"
+#include "common/CosAtomic.h"
+#include "objects/CosDictObjNode-Private.h"
 
+#include "libcos/common/CosData.h"
 #include "libcos/objects/CosArrayObjNode.h"
 #include "libcos/objects/CosBoolObjNode.h"
 #include "libcos/objects/CosDictObjNode.h"
@@ -13,6 +16,7 @@
 #include "libcos/objects/CosIntObjNode.h"
 #include "libcos/objects/CosNameObjNode.h"
 #include "libcos/objects/CosNullObjNode.h"
+#include "libcos/objects/CosObjValue.h"
 #include "libcos/objects/CosRealObjNode.h"
 #include "libcos/objects/CosReferenceObjNode.h"
 #include "libcos/objects/CosStreamObjNode.h"
@@ -28,6 +32,53 @@ struct CosObjNode {
     unsigned int ref_count;
 };
 
+/*
+ * The top bits of the reference count are flags. The remaining bits hold the count.
+ */
+
+/**
+ * Marks an object as immortal. Its count is no longer updated.
+ */
+#define COS_OBJ_NODE_REF_COUNT_IMMORTAL (1U << 31)
+
+/**
+ * Marks an object as frozen, so that it cannot be modified.
+ */
+#define COS_OBJ_NODE_REF_COUNT_FROZEN (1U << 30)
+
+/**
+ * Marks a frozen object that is only referenced by its parent in a frozen subgraph. Its count
+ * is not updated until the parent is deallocated.
+ */
+#define COS_OBJ_NODE_REF_COUNT_GRAPH_OWNED (1U << 29)
+
+#define COS_OBJ_NODE_REF_COUNT_MASK (COS_OBJ_NODE_REF_COUNT_GRAPH_OWNED - 1)
+
+/**
+ * The flags of objects whose count is not updated.
+ */
+#define COS_OBJ_NODE_REF_COUNT_UNCOUNTED (COS_OBJ_NODE_REF_COUNT_IMMORTAL | COS_OBJ_NODE_REF_COUNT_GRAPH_OWNED)
+
+typedef bool (*CosObjNodeChildVisitor)(CosObjNode *child,
+                                       CosError * COS_Nullable out_error);
+
+static bool
+cos_obj_node_visit_children_(CosObjNode *obj,
+                             CosObjNodeChildVisitor visitor,
+                             CosError * COS_Nullable out_error);
+
+static bool
+cos_obj_node_prepare_freeze_(CosObjNode *obj,
+                             CosError * COS_Nullable out_error);
+
+static bool
+cos_obj_node_mark_frozen_(CosObjNode *obj,
+                          CosError * COS_Nullable out_error);
+
+static bool
+cos_obj_node_thaw_(CosObjNode *obj,
+                   CosError * COS_Nullable out_error);
+
 CosObjNode * COS_Nullable
 cos_obj_node_retain(CosObjNode * COS_Nullable obj)
 {
@@ -40,7 +91,11 @@ cos_obj_node_retain(CosObjNode * COS_Nullable obj)
         return obj;
     }
 
-    obj->ref_count++;
+    if (cos_ref_count_load(&obj->ref_count) & COS_OBJ_NODE_REF_COUNT_UNCOUNTED) {
+        return obj;
+    }
+
+    cos_ref_count_increment(&obj->ref_count);
     return obj;
 }
 
@@ -110,14 +165,93 @@ cos_obj_node_release(CosObjNode * COS_Nullable obj)
         return;
     }
 
-    if (obj->ref_count > 1) {
-        obj->ref_count--;
+    const unsigned int ref_count = cos_ref_count_load(&obj->ref_count);
+    if (ref_count & COS_OBJ_NODE_REF_COUNT_UNCOUNTED) {
+        return;
+    }
+
+    if (!cos_ref_count_decrement(&obj->ref_count, COS_OBJ_NODE_REF_COUNT_MASK)) {
         return;
     }
 
+    if (ref_count & COS_OBJ_NODE_REF_COUNT_FROZEN) {
+        // The children that this object owns must be released along with it.
+        (void)cos_obj_node_visit_children_(COS_nonnull_cast(obj), &cos_obj_node_thaw_, NULL);
+    }
+
     cos_obj_dealloc_(COS_nonnull_cast(obj));
 }
 
+void
+cos_obj_node_make_immortal(CosObjNode *obj)
+{
+    COS_API_PARAM_CHECK(obj != NULL);
+    if (!obj) {
+        return;
+    }
+
+    if (obj->type == CosObjNodeType_Null) {
+        return;
+    }
+
+    (void)cos_atomic_fetch_or_relaxed(&obj->ref_count, COS_OBJ_NODE_REF_COUNT_IMMORTAL);
+}
+
+bool
+cos_obj_node_is_immortal(const CosObjNode *obj)
+{
+    COS_API_PARAM_CHECK(obj != NULL);
+    if (!obj) {
+        return false;
+    }
+
+    if (obj->type == CosObjNodeType_Null) {
+        return true;
+    }
+
+    return (cos_ref_count_load(&obj->ref_count) & COS_OBJ_NODE_REF_COUNT_IMMORTAL) != 0;
+}
+
+bool
+cos_obj_node_freeze(CosObjNode *obj,
+                    CosError * COS_Nullable out_error)
+{
+    COS_API_PARAM_CHECK(obj != NULL);
+    if (!obj) {
+        return false;
+    }
+
+    if (cos_obj_node_is_frozen(obj) || cos_obj_node_is_immortal(obj)) {
+        return true;
+    }
+
+    // Everything that can fail is done before any object is marked, so that a failure leaves
+    // the subgraph unfrozen.
+    if (!cos_obj_node_prepare_freeze_(obj, out_error)) {
+        return false;
+    }
+
+    // The root keeps counting references, for the whole subgraph.
+    (void)cos_atomic_fetch_or_relaxed(&obj->ref_count, COS_OBJ_NODE_REF_COUNT_FROZEN);
+    return cos_obj_node_visit_children_(obj, &cos_obj_node_mark_frozen_, out_error);
+}
+
+bool
+cos_obj_node_is_frozen(const CosObjNode *obj)
+{
+    COS_API_PARAM_CHECK(obj != NULL);
+    if (!obj) {
+        return false;
+    }
+
+    // The null singleton cannot be modified.
+    if (obj->type == CosObjNodeType_Null) {
+        return true;
+    }
+
+    return (cos_ref_count_load(&obj->ref_count) & COS_OBJ_NODE_REF_COUNT_FROZEN) != 0;
+}
+
 CosObjNodeType
 cos_obj_node_get_type(const CosObjNode *obj)
 {
@@ -407,4 +541,161 @@ cos_obj_node_print_desc(const CosObjNode *obj)
     }
 }
 
+// MARK: - Freezing
+
+/**
+ * Calls @p visitor with each object that @p obj holds a reference to, stopping at the first
+ * failure.
+ *
+ * References are not followed, as the objects that they refer to belong to the document.
+ */
+static bool
+cos_obj_node_visit_children_(CosObjNode *obj,
+                             CosObjNodeChildVisitor visitor,
+                             CosError * COS_Nullable out_error)
+{
+    COS_IMPL_PARAM_CHECK(obj != NULL);
+    COS_IMPL_PARAM_CHECK(visitor != NULL);
+
+    switch (obj->type) {
+        case CosObjNodeType_Array: {
+            const CosArrayObjNode * const array_obj = (const CosArrayObjNode *)obj;
+            const size_t count = cos_array_obj_node_get_count(array_obj);
+            for (size_t i = 0; i < count; i++) {
+                CosObjValue element;
+                if (!cos_array_obj_node_get_value_at(array_obj, i, &element, out_error)) {
+                    return false;
+                }
+                if (element.kind == CosObjValueKind_Node && element.as.node &&
+                    !visitor(COS_nonnull_cast(element.as.node), out_error)) {
+                    return false;
+                }
+            }
+        } break;
+
+        case CosObjNodeType_Dict: {
+            CosDictObjNodeIterator iterator = cos_dict_obj_node_iterator_init((CosDictObjNode *)obj);
+            CosNameObjNode *key = NULL;
+            CosObjValue value;
+            while (cos_dict_obj_node_iterator_next_value(&iterator, &key, &value)) {
+                if (key && !visitor((CosObjNode *)key, out_error)) {
+                    return false;
+                }
+                if (value.kind == CosObjValueKind_Node && value.as.node &&
+                    !visitor(COS_nonnull_cast(value.as.node), out_error)) {
+                    return false;
+                }
+            }
+        } break;
+
+        case CosObjNodeType_Stream: {
+            CosDictObjNode * const dict_obj = cos_stream_obj_node_get_dict((const CosStreamObjNode *)obj);
+            if (dict_obj && !visitor((CosObjNode *)dict_obj, out_error)) {
+                return false;
+            }
+        } break;
+
+        case CosObjNodeType_Indirect: {
+            CosObjNode * const value = cos_indirect_obj_node_get_value((const CosIndirectObjNode *)obj);
+            if (value && !visitor(COS_nonnull_cast(value), out_error)) {
+                return false;
+            }
+        } break;
+
+        case CosObjNodeType_Unknown:
+        case CosObjNodeType_Boolean:
+        case CosObjNodeType_Integer:
+        case CosObjNodeType_Real:
+        case CosObjNodeType_String:
+        case CosObjNodeType_Name:
+        case CosObjNodeType_Null:
+        case CosObjNodeType_Reference:
+            break;
+    }
+
+    return true;
+}
+
+/**
+ * Removes the state that an object would otherwise create lazily when it is read, for the
+ * object and the unfrozen objects below it.
+ */
+static bool
+cos_obj_node_prepare_freeze_(CosObjNode *obj,
+                             CosError * COS_Nullable out_error)
+{
+    COS_IMPL_PARAM_CHECK(obj != NULL);
+
+    if (cos_obj_node_is_frozen(obj) || cos_obj_node_is_immortal(obj)) {
+        return true;
+    }
+
+    switch (obj->type) {
+        case CosObjNodeType_Dict: {
+            if (!cos_dict_obj_node_box_values_((CosDictObjNode *)obj, out_error)) {
+                return false;
+            }
+        } break;
+
+        case CosObjNodeType_String: {
+            // Cache the hash now, so that readers of the frozen string never write it.
+            const CosData * const data = cos_string_obj_node_get_value((CosStringObjNode *)obj);
+            (void)cos_data_get_hash(data);
+        } break;
+
+        default:
+            // Names hash their value when it is set. Arrays box their inline elements on the side once they are frozen, and references
+            // publish the referenced object atomically when they are resolved.
+            break;
+    }
+
+    return cos_obj_node_visit_children_(obj, &cos_obj_node_prepare_freeze_, out_error);
+}
+
+/**
+ * Marks an object below the root of a frozen subgraph, and the objects below it, as frozen.
+ */
+static bool
+cos_obj_node_mark_frozen_(CosObjNode *obj,
+                          CosError * COS_Nullable out_error)
+{
+    COS_IMPL_PARAM_CHECK(obj != NULL);
+
+    if (cos_obj_node_is_frozen(obj) || cos_obj_node_is_immortal(obj)) {
+        // Another frozen subgraph, which is counted through its own root.
+        return true;
+    }
+
+    unsigned int flags = COS_OBJ_NODE_REF_COUNT_FROZEN;
+
+    // An object that is only referenced by its parent can live as long as the parent without
+    // counting references. One that is shared (e.g. an interned name) keeps counting them.
+    if ((cos_ref_count_load(&obj->ref_count) & COS_OBJ_NODE_REF_COUNT_MASK) == 1) {
+        flags |= COS_OBJ_NODE_REF_COUNT_GRAPH_OWNED;
+    }
+    (void)cos_atomic_fetch_or_relaxed(&obj->ref_count, flags);
+
+    return cos_obj_node_visit_children_(obj, &cos_obj_node_mark_frozen_, out_error);
+}
+
+/**
+ * Makes a graph-owned object count references again, as its parent is being deallocated.
+ */
+static bool
+cos_obj_node_thaw_(CosObjNode *obj,
+                   CosError * COS_Nullable out_error)
+{
+    COS_IMPL_PARAM_CHECK(obj != NULL);
+
+    if (obj->type == CosObjNodeType_Null ||
+        !(cos_ref_count_load(&obj->ref_count) & COS_OBJ_NODE_REF_COUNT_GRAPH_OWNED)) {
+        return true;
+    }
+
+    // The object stays frozen. Its own graph-owned children are made to count references too,
+    // as a stream object deallocates its dictionary object without releasing it.
+    (void)cos_atomic_fetch_and_relaxed(&obj->ref_count, ~COS_OBJ_NODE_REF_COUNT_GRAPH_OWNED);
+    return cos_obj_node_visit_children_(obj, &cos_obj_node_thaw_, out_error);
+}
+
 COS_ASSUME_NONNULL_END
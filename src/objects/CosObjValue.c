@@ -0,0 +1,251 @@
+/*
+ * Copyright (c) 2025 OpenCOS.
+ */
+
+#include "libcos/objects/CosObjValue.h"
+
+#include "common/Assert.h"
+
+#include "libcos/objects/CosBoolObjNode.h"
+#include "libcos/objects/CosIndirectObjNode.h"
+#include "libcos/objects/CosIntObjNode.h"
+#include "libcos/objects/CosObjNode.h"
+#include "libcos/objects/CosRealObjNode.h"
+#include "libcos/objects/CosReferenceObjNode.h"
+
+#include <stddef.h>
+
+COS_ASSUME_NONNULL_BEGIN
+
+// MARK: - Constructors
+
+CosObjValue
+cos_obj_value_make_node(CosObjNode *node)
+{
+    COS_API_PARAM_CHECK(node != NULL);
+
+    CosObjValue value;
+    value.kind = CosObjValueKind_Node;
+    value.as.node = node;
+    return value;
+}
+
+CosObjValue
+cos_obj_value_make_bool(bool boolean)
+{
+    CosObjValue value;
+    value.kind = CosObjValueKind_Boolean;
+    value.as.boolean = boolean;
+    return value;
+}
+
+CosObjValue
+cos_obj_value_make_int(int integer)
+{
+    CosObjValue value;
+    value.kind = CosObjValueKind_Integer;
+    value.as.integer = integer;
+    return value;
+}
+
+CosObjValue
+cos_obj_value_make_real(double real)
+{
+    CosObjValue value;
+    value.kind = CosObjValueKind_Real;
+    value.as.real = real;
+    return value;
+}
+
+// MARK: - Memory management
+
+void
+cos_obj_value_retain(CosObjValue value)
+{
+    if (value.kind == CosObjValueKind_Node) {
+        cos_obj_node_retain(value.as.node);
+    }
+}
+
+void
+cos_obj_value_release(CosObjValue value)
+{
+    if (value.kind == CosObjValueKind_Node) {
+        cos_obj_node_release(value.as.node);
+    }
+}
+
+CosObjNode *
+cos_obj_value_box(CosAllocator * COS_Nullable allocator,
+                  CosObjValue value)
+{
+    switch (value.kind) {
+        case CosObjValueKind_Node:
+            return value.as.node;
+
+        case CosObjValueKind_Boolean:
+            return (CosObjNode *)cos_bool_obj_node_alloc(allocator, value.as.boolean);
+
+        case CosObjValueKind_Integer:
+            return (CosObjNode *)cos_int_obj_node_alloc(allocator, value.as.integer);
+
+        case CosObjValueKind_Real:
+            return (CosObjNode *)cos_real_obj_node_alloc(allocator, value.as.real);
+    }
+    COS_ASSERT(false, "Invalid value kind: %d", (int)value.kind);
+
+    return NULL;
+}
+
+// MARK: - Accessors
+
+CosObjValue
+cos_obj_value_resolve(CosObjValue value)
+{
+    if (value.kind != CosObjValueKind_Node || !value.as.node) {
+        return value;
+    }
+
+    CosObjNode *node = value.as.node;
+
+    // A reference resolves to an indirect object, which in turn wraps the direct value.
+    if (cos_obj_node_get_type(node) == CosObjNodeType_Reference) {
+        node = cos_reference_obj_node_get_value((CosReferenceObjNode *)node);
+        if (!node) {
+            value.as.node = NULL;
+            return value;
+        }
+    }
+
+    if (cos_obj_node_get_type(node) == CosObjNodeType_Indirect) {
+        node = cos_indirect_obj_node_get_value((CosIndirectObjNode *)node);
+    }
+
+    value.as.node = node;
+    return value;
+}
+
+CosObjNodeValueType
+cos_obj_value_get_type(CosObjValue value)
+{
+    switch (value.kind) {
+        case CosObjValueKind_Node:
+            if (!value.as.node) {
+                return CosObjNodeValueType_Unknown;
+            }
+            return cos_obj_node_get_value_type(value.as.node);
+
+        case CosObjValueKind_Boolean:
+            return CosObjNodeValueType_Boolean;
+
+        case CosObjValueKind_Integer:
+            return CosObjNodeValueType_Integer;
+
+        case CosObjValueKind_Real:
+            return CosObjNodeValueType_Real;
+    }
+    COS_ASSERT(false, "Invalid value kind: %d", (int)value.kind);
+
+    return CosObjNodeValueType_Unknown;
+}
+
+CosObjNode *
+cos_obj_value_get_node(CosObjValue value)
+{
+    if (value.kind != CosObjValueKind_Node) {
+        return NULL;
+    }
+    return value.as.node;
+}
+
+bool
+cos_obj_value_get_bool(CosObjValue value,
+                       bool *out_bool)
+{
+    COS_API_PARAM_CHECK(out_bool != NULL);
+    if (!out_bool) {
+        return false;
+    }
+
+    const CosObjValue direct = cos_obj_value_resolve(value);
+    if (direct.kind == CosObjValueKind_Boolean) {
+        *out_bool = direct.as.boolean;
+        return true;
+    }
+    if (direct.kind == CosObjValueKind_Node &&
+        direct.as.node &&
+        cos_obj_node_get_type(direct.as.node) == CosObjNodeType_Boolean) {
+        *out_bool = cos_bool_obj_node_get_value((const CosBoolObjNode *)direct.as.node);
+        return true;
+    }
+
+    return false;
+}
+
+bool
+cos_obj_value_get_int(CosObjValue value,
+                      int *out_int)
+{
+    COS_API_PARAM_CHECK(out_int != NULL);
+    if (!out_int) {
+        return false;
+    }
+
+    const CosObjValue direct = cos_obj_value_resolve(value);
+    if (direct.kind == CosObjValueKind_Integer) {
+        *out_int = direct.as.integer;
+        return true;
+    }
+    if (direct.kind == CosObjValueKind_Node &&
+        direct.as.node &&
+        cos_obj_node_get_type(direct.as.node) == CosObjNodeType_Integer) {
+        *out_int = cos_int_obj_node_get_value((const CosIntObjNode *)direct.as.node);
+        return true;
+    }
+
+    return false;
+}
+
+bool
+cos_obj_value_get_real(CosObjValue value,
+                       double *out_real)
+{
+    COS_API_PARAM_CHECK(out_real != NULL);
+    if (!out_real) {
+        return false;
+    }
+
+    const CosObjValue direct = cos_obj_value_resolve(value);
+    if (direct.kind == CosObjValueKind_Real) {
+        *out_real = direct.as.real;
+        return true;
+    }
+    if (direct.kind == CosObjValueKind_Node &&
+        direct.as.node &&
+        cos_obj_node_get_type(direct.as.node) == CosObjNodeType_Real) {
+        *out_real = cos_real_obj_node_get_value((const CosRealObjNode *)direct.as.node);
+        return true;
+    }
+
+    return false;
+}
+
+bool
+cos_obj_value_get_number(CosObjValue value,
+                         double *out_number)
+{
+    COS_API_PARAM_CHECK(out_number != NULL);
+    if (!out_number) {
+        return false;
+    }
+
+    int int_value = 0;
+    if (cos_obj_value_get_int(value, &int_value)) {
+        *out_number = (double)int_value;
+        return true;
+    }
+
+    return cos_obj_value_get_real(value, out_number);
+}
+
+COS_ASSUME_NONNULL_END
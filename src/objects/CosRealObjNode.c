@@ -8,6 +8,8 @@
 
 #include "libcos/objects/CosObjNode.h"
 
+#include <libcos/common/memory/CosMemory.h>
+
 #include <stdio.h>
 #include <stdlib.h>
 
@@ -16,20 +18,23 @@ COS_ASSUME_NONNULL_BEGIN
 struct CosRealObjNode {
     CosObjNodeType type;
     unsigned int ref_count;
+    CosAllocator * COS_Nullable allocator;
 
     double value;
 };
 
 CosRealObjNode *
-cos_real_obj_node_alloc(double value)
+cos_real_obj_node_alloc(CosAllocator * COS_Nullable allocator,
+                        double value)
 {
-    CosRealObjNode *result = calloc(1, sizeof(CosRealObjNode));
+    CosRealObjNode *result = cos_calloc(allocator, 1, sizeof(CosRealObjNode));
     if (!result) {
         return NULL;
     }
 
     result->type = CosObjNodeType_Real;
     result->ref_count = 1;
+    result->allocator = allocator;
     result->value = value;
 
     return result;
@@ -42,7 +47,7 @@ cos_real_obj_node_free(CosRealObjNode *real_obj)
         return;
     }
 
-    free(real_obj);
+    cos_free(real_obj->allocator, real_obj);
 }
 
 double
@@ -65,6 +70,11 @@ cos_real_obj_node_set_value(CosRealObjNode *real_obj,
         return;
     }
 
+    COS_API_PARAM_CHECK(!cos_obj_node_is_frozen((const CosObjNode *)real_obj));
+    if (cos_obj_node_is_frozen((const CosObjNode *)real_obj)) {
+        return;
+    }
+
     real_obj->value = value;
 }
 
@@ -5,6 +5,7 @@
 #include "libcos/objects/CosReferenceObjNode.h"
 
 #include "common/Assert.h"
+#include "common/CosAtomic.h"
 
 #include "libcos/CosDoc.h"
 #include "libcos/CosObjID.h"
@@ -12,6 +13,8 @@
 #include "libcos/objects/CosNullObjNode.h"
 #include "libcos/objects/CosObjNode.h"
 
+#include <libcos/common/memory/CosMemory.h>
+
 #include <stdio.h>
 #include <stdlib.h>
 
@@ -20,6 +23,7 @@ COS_ASSUME_NONNULL_BEGIN
 struct CosReferenceObjNode {
     CosObjNodeType type;
     unsigned int ref_count;
+    CosAllocator * COS_Nullable allocator;
 
     CosObjID id;
     CosDoc *doc;
@@ -30,18 +34,20 @@ static void
 cos_reference_obj_node_resolve_value_(CosReferenceObjNode *reference_obj);
 
 CosReferenceObjNode * COS_Nullable
-cos_reference_obj_node_alloc(CosObjID id,
+cos_reference_obj_node_alloc(CosAllocator * COS_Nullable allocator,
+                             CosObjID id,
                         CosDoc *document)
 {
     COS_API_PARAM_CHECK(document != NULL);
 
-    CosReferenceObjNode * const reference_obj = calloc(1, sizeof(CosReferenceObjNode));
+    CosReferenceObjNode * const reference_obj = cos_calloc(allocator, 1, sizeof(CosReferenceObjNode));
     if (!reference_obj) {
         return NULL;
     }
 
     reference_obj->type = CosObjNodeType_Reference;
     reference_obj->ref_count = 1;
+    reference_obj->allocator = allocator;
     reference_obj->id = id;
     reference_obj->doc = document;
 
@@ -59,7 +65,7 @@ cos_reference_obj_node_free(CosReferenceObjNode *reference_obj)
         cos_obj_node_release(COS_nonnull_cast(reference_obj->value));
     }
 
-    free(reference_obj);
+    cos_free(reference_obj->allocator, reference_obj);
 }
 
 CosObjNode *
@@ -70,11 +76,9 @@ cos_reference_obj_node_get_value(CosReferenceObjNode *reference_obj)
         return NULL;
     }
 
-    if (!reference_obj->value) {
-        cos_reference_obj_node_resolve_value_(reference_obj);
-    }
+    cos_reference_obj_node_resolve_value_(reference_obj);
 
-    return reference_obj->value;
+    return cos_atomic_load_ptr_acquire((void * const *)&reference_obj->value);
 }
 
 CosObjNodeValueType
@@ -85,11 +89,9 @@ cos_reference_obj_node_get_type(CosReferenceObjNode *reference_obj)
         return CosObjNodeValueType_Unknown;
     }
 
-    if (!reference_obj->value) {
-        cos_reference_obj_node_resolve_value_(reference_obj);
-    }
+    cos_reference_obj_node_resolve_value_(reference_obj);
 
-    const CosObjNode * const direct_obj = reference_obj->value;
+    const CosObjNode * const direct_obj = cos_atomic_load_ptr_acquire((void * const *)&reference_obj->value);
     if (!direct_obj) {
         return CosObjNodeValueType_Unknown;
     }
@@ -106,21 +108,24 @@ cos_reference_obj_node_resolve_value_(CosReferenceObjNode *reference_obj)
         return;
     }
 
-    if (reference_obj->value) {
+    if (cos_atomic_load_ptr_acquire((void * const *)&reference_obj->value)) {
         return;
     }
 
     CosError error = cos_error_none();
-    void * const obj_value = cos_doc_get_object(reference_obj->doc,
-                                                reference_obj->id,
-                                                &error);
-    if (obj_value) {
-        reference_obj->value = obj_value;
-    }
-    else {
+    CosObjNode *obj_value = cos_doc_get_object(reference_obj->doc,
+                                               reference_obj->id,
+                                               &error);
+    if (!obj_value) {
         // TODO: Log undefined object if strict.
 
-        reference_obj->value = (CosObjNode *)cos_null_obj_node_get();
+        obj_value = (CosObjNode *)cos_null_obj_node_get();
+    }
+
+    // The reference may be shared between threads (e.g. in a frozen object), and another
+    // thread may have resolved it first.
+    if (!cos_atomic_publish_ptr((void **)&reference_obj->value, obj_value)) {
+        cos_obj_node_release(obj_value);
     }
 }
 
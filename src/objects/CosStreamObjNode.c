@@ -9,7 +9,9 @@
 #include "libcos/common/CosError.h"
 
 #include <libcos/common/CosData.h>
+#include <libcos/common/memory/CosMemory.h>
 #include <libcos/objects/CosDictObjNode.h>
+#include <libcos/objects/CosNameKey.h>
 #include <libcos/objects/CosObjNode.h>
 
 #include <stdlib.h>
@@ -19,22 +21,25 @@ COS_ASSUME_NONNULL_BEGIN
 struct CosStreamObjNode {
     CosObjNodeType type;
     unsigned int ref_count;
+    CosAllocator * COS_Nullable allocator;
 
     CosDictObjNode *dict_obj;
     CosData * COS_Nullable data;
 };
 
 CosStreamObjNode *
-cos_stream_obj_node_create(CosDictObjNode *dict,
+cos_stream_obj_node_create(CosAllocator * COS_Nullable allocator,
+                           CosDictObjNode *dict,
                       CosData * COS_Nullable data)
 {
-    CosStreamObjNode * const stream_obj = malloc(sizeof(CosStreamObjNode));
+    CosStreamObjNode * const stream_obj = cos_calloc(allocator, 1, sizeof(CosStreamObjNode));
     if (!stream_obj) {
         return NULL;
     }
 
     stream_obj->type = CosObjNodeType_Stream;
     stream_obj->ref_count = 1;
+    stream_obj->allocator = allocator;
     stream_obj->dict_obj = dict;
     stream_obj->data = data;
 
@@ -52,7 +57,7 @@ cos_stream_obj_node_destroy(CosStreamObjNode *stream_obj)
     if (stream_obj->data) {
         cos_data_free(COS_nonnull_cast(stream_obj->data));
     }
-    free(stream_obj);
+    cos_free(stream_obj->allocator, stream_obj);
 }
 
 CosDictObjNode *
@@ -85,6 +90,10 @@ cos_stream_obj_node_get_length(const CosStreamObjNode *stream_obj)
         return 0;
     }
 
+    // Parsed stream objects do not load their data.
+    if (!stream_obj->data) {
+        return 0;
+    }
     return stream_obj->data->size;
 }
 
@@ -114,10 +123,10 @@ cos_stream_obj_node_get_decoded_length_hint(const CosStreamObjNode *stream_obj,
     }
 
     CosObjNode *length_obj = NULL;
-    if (!cos_dict_obj_node_get_value_with_string(stream_obj->dict_obj,
-                                            "DL",
-                                            &length_obj,
-                                            out_error)) {
+    if (!cos_dict_obj_node_get_value_with_key(stream_obj->dict_obj,
+                                              cos_name_key_get_well_known(CosWellKnownName_DL),
+                                              &length_obj,
+                                              out_error)) {
         return false;
     }
     else if (!cos_obj_node_is_integer(length_obj)) {
@@ -7,6 +7,7 @@
 #include "common/Assert.h"
 
 #include <libcos/common/CosData.h>
+#include <libcos/common/memory/CosMemory.h>
 #include <libcos/objects/CosObjNode.h>
 
 #include <stdio.h>
@@ -17,25 +18,28 @@ COS_ASSUME_NONNULL_BEGIN
 struct CosStringObjNode {
     CosObjNodeType type;
     unsigned int ref_count;
+    CosAllocator * COS_Nullable allocator;
 
     CosData *data;
 };
 
 CosStringObjNode * COS_Nullable
-cos_string_obj_node_alloc(CosData *data)
+cos_string_obj_node_alloc(CosAllocator * COS_Nullable allocator,
+                          CosData *data)
 {
     COS_API_PARAM_CHECK(data != NULL);
     if (!data) {
         return NULL;
     }
 
-    CosStringObjNode * const string_obj = calloc(1, sizeof(CosStringObjNode));
+    CosStringObjNode * const string_obj = cos_calloc(allocator, 1, sizeof(CosStringObjNode));
     if (!string_obj) {
         return NULL;
     }
 
     string_obj->type = CosObjNodeType_String;
     string_obj->ref_count = 1;
+    string_obj->allocator = allocator;
     string_obj->data = data;
 
     return string_obj;
@@ -49,7 +53,7 @@ cos_string_obj_node_free(CosStringObjNode *string_obj)
     }
 
     cos_data_free(string_obj->data);
-    free(string_obj);
+    cos_free(string_obj->allocator, string_obj);
 }
 
 void
@@ -62,6 +66,11 @@ cos_string_obj_node_set_value(CosStringObjNode *string_obj,
         return;
     }
 
+    COS_API_PARAM_CHECK(!cos_obj_node_is_frozen((const CosObjNode *)string_obj));
+    if (cos_obj_node_is_frozen((const CosObjNode *)string_obj)) {
+        return;
+    }
+
     if (string_obj->data == data) {
         // No change.
         return;
@@ -36,7 +36,8 @@ cos_base_parser_init(CosBaseParser *parser,
     CosTokenizer *tokenizer = NULL;
     CosToken *token_buffer = NULL;
 
-    tokenizer = cos_tokenizer_create(input_stream);
+    tokenizer = cos_tokenizer_create(allocator,
+                                     input_stream);
     if (!tokenizer) {
         goto failure;
     }
@@ -140,6 +141,8 @@ cos_base_parser_destroy(CosBaseParser *parser)
         cos_tokenizer_destroy(parser->tokenizer);
     }
 
+    cos_free(parser->allocator, parser->token_buffer);
+
     cos_free(parser->allocator, parser);
 }
 
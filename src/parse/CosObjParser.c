@@ -4,28 +4,35 @@
 
 #include "CosObjParser.h"
 
+#include "CosDoc-Private.h"
 #include "common/Assert.h"
 #include "common/CosDict.h"
 #include "common/CosNumber.h"
 #include "parse/CosBaseParser.h"
+#include "parse/CosStreamBody.h"
 
 #include "libcos/common/CosMacros.h"
 
 #include <io/CosStreamReader.h>
 #include <libcos/CosDoc.h>
 #include <libcos/CosObjID.h>
+#include <libcos/common/CosData.h>
 #include <libcos/common/CosDiagnosticHandler.h>
 #include <libcos/common/CosError.h>
 #include <libcos/common/CosLog.h>
+#include <libcos/common/CosString.h>
+#include <libcos/common/memory/CosMemory.h>
 #include <libcos/io/CosStream.h>
 #include <libcos/objects/CosArrayObjNode.h>
 #include <libcos/objects/CosBoolObjNode.h>
 #include <libcos/objects/CosDictObjNode.h>
 #include <libcos/objects/CosIndirectObjNode.h>
 #include <libcos/objects/CosIntObjNode.h>
+#include <libcos/objects/CosNameKey.h>
 #include <libcos/objects/CosNameObjNode.h>
 #include <libcos/objects/CosNullObjNode.h>
 #include <libcos/objects/CosObjNode.h>
+#include <libcos/objects/CosObjValue.h>
 #include <libcos/objects/CosRealObjNode.h>
 #include <libcos/objects/CosReferenceObjNode.h>
 #include <libcos/objects/CosStreamObjNode.h>
@@ -84,6 +91,31 @@ struct CosObjParser {
     CosBaseParser base;
 
     CosObjNode * COS_Nullable peeked_node;
+
+    /**
+     * Whether stream objects are parsed without skipping their data.
+     */
+    bool stops_at_stream_data;
+
+    /**
+     * Whether a stream object was parsed whose data has not been read yet.
+     */
+    bool has_pending_stream;
+
+    /**
+     * The length of the pending stream's data, or -1 if it is not known.
+     */
+    CosStreamOffset pending_stream_length;
+
+    /**
+     * Whether an indirect Length entry of a stream is being resolved.
+     */
+    bool resolving_stream_length;
+
+    /**
+     * The size of the input, or -1 if it is not known.
+     */
+    CosStreamOffset input_size;
 };
 
 static bool
@@ -97,6 +129,12 @@ cos_next_object_(CosObjParser *parser,
                  CosError * COS_Nullable out_error)
     COS_OWNERSHIP_RETURNS;
 
+static bool
+cos_next_value_(CosObjParser *parser,
+                const CosObjParserContext *context,
+                CosObjValue *out_value,
+                CosError * COS_Nullable out_error);
+
 static CosObjNode * COS_Nullable
 cos_parse_string_(CosObjParser *parser,
                   CosError * COS_Nullable error);
@@ -131,7 +169,9 @@ cos_obj_parser_create(CosDoc *document,
         return NULL;
     }
 
-    CosObjParser * const parser = calloc(1, sizeof(CosObjParser));
+    CosAllocator * const allocator = cos_doc_get_allocator(document);
+
+    CosObjParser * const parser = cos_calloc(allocator, 1, sizeof(CosObjParser));
     if (!parser) {
         goto failure;
     }
@@ -146,7 +186,7 @@ cos_obj_parser_create(CosDoc *document,
 
 failure:
     if (parser) {
-        free(parser);
+        cos_free(allocator, parser);
     }
     return NULL;
 }
@@ -163,9 +203,15 @@ cos_obj_parser_init_(CosObjParser * const self,
         return false;
     }
 
-    return cos_base_parser_init(&(self->base),
-                                document,
-                                input_stream);
+    if (!cos_base_parser_init(&(self->base),
+                              document,
+                              input_stream)) {
+        return false;
+    }
+
+    cos_tokenizer_set_combines_indirect_tokens(self->base.tokenizer, true);
+    self->input_size = -1;
+    return true;
 }
 
 CosObjParser *
@@ -178,15 +224,19 @@ cos_obj_parser_create_with_tokenizer(CosDoc *document,
         return NULL;
     }
 
-    CosObjParser * const parser = calloc(1, sizeof(CosObjParser));
+    CosAllocator * const allocator = cos_doc_get_allocator(document);
+
+    CosObjParser * const parser = cos_calloc(allocator, 1, sizeof(CosObjParser));
     if (!parser) {
         return NULL;
     }
 
     if (!cos_base_parser_init_with_tokenizer(&(parser->base), document, tokenizer)) {
-        free(parser);
+        cos_free(allocator, parser);
         return NULL;
     }
+    cos_tokenizer_set_combines_indirect_tokens(tokenizer, true);
+    parser->input_size = -1;
 
     return parser;
 }
@@ -219,6 +269,80 @@ cos_obj_parser_flush_tokens_(CosObjParser *parser)
     base->token_count = 0;
 }
 
+void
+cos_obj_parser_set_input_stream_(CosObjParser *parser,
+                                 CosStream *input_stream)
+{
+    COS_IMPL_PARAM_CHECK(parser != NULL);
+    COS_IMPL_PARAM_CHECK(input_stream != NULL);
+
+    parser->base.input_stream = input_stream;
+}
+
+void
+cos_obj_parser_set_input_size_(CosObjParser *parser,
+                               CosStreamOffset input_size)
+{
+    COS_IMPL_PARAM_CHECK(parser != NULL);
+
+    parser->input_size = input_size;
+}
+
+CosStreamOffset
+cos_obj_parser_peek_token_offset_(CosObjParser *parser)
+{
+    COS_IMPL_PARAM_CHECK(parser != NULL);
+
+    if (parser->peeked_node) {
+        return -1;
+    }
+
+    const CosToken * const token = cos_base_parser_get_current_token(&(parser->base));
+    if (!token || token->type == CosToken_Type_EOF) {
+        return -1;
+    }
+
+    return (CosStreamOffset)token->offset;
+}
+
+void
+cos_obj_parser_set_stops_at_stream_data_(CosObjParser *parser,
+                                         bool enabled)
+{
+    COS_IMPL_PARAM_CHECK(parser != NULL);
+
+    parser->stops_at_stream_data = enabled;
+}
+
+bool
+cos_obj_parser_take_pending_stream_(CosObjParser *parser,
+                                    CosStreamOffset *out_length)
+{
+    COS_IMPL_PARAM_CHECK(parser != NULL);
+    COS_IMPL_PARAM_CHECK(out_length != NULL);
+
+    if (!parser->has_pending_stream) {
+        return false;
+    }
+
+    *out_length = parser->pending_stream_length;
+    parser->has_pending_stream = false;
+    parser->pending_stream_length = -1;
+    return true;
+}
+
+CosToken_Type
+cos_obj_parser_peek_token_type_(CosObjParser *parser)
+{
+    COS_IMPL_PARAM_CHECK(parser != NULL);
+
+    const CosToken * const token = cos_base_parser_get_current_token(&(parser->base));
+    if (!token) {
+        return CosToken_Type_EOF;
+    }
+    return token->type;
+}
+
 bool
 cos_obj_parser_has_next_object(CosObjParser *parser)
 {
@@ -288,6 +412,196 @@ cos_obj_parser_next_object(CosObjParser *parser,
                             error);
 }
 
+/**
+ * The state of an event scan.
+ */
+typedef struct CosObjEventScan {
+    const CosObjEventHandler *handler;
+
+    /**
+     * Whether the handler asked to stop.
+     */
+    bool stopped;
+} CosObjEventScan;
+
+static bool
+cos_scan_value_(CosObjParser *parser,
+                CosObjEventScan *scan,
+                CosError * COS_Nullable out_error);
+
+static bool
+cos_scan_dict_(CosObjParser *parser,
+               CosObjEventScan *scan,
+               CosStreamOffset * COS_Nullable out_length,
+               CosError * COS_Nullable out_error);
+
+static bool
+cos_scan_stream_(CosObjParser *parser,
+                 CosObjEventScan *scan,
+                 CosStreamOffset length,
+                 CosError * COS_Nullable out_error);
+
+/**
+ * Reads the object ID of an indirect object reference or header, and consumes its tokens.
+ *
+ * @param compound_type The token type of the reference or header when it was read as a
+ * single token. Otherwise it spans an object number, a generation number and a keyword token.
+ */
+static bool
+cos_read_obj_id_(CosObjParser *parser,
+                 CosToken_Type compound_type,
+                 CosObjID *out_obj_id,
+                 CosError * COS_Nullable out_error);
+
+/**
+ * Returns whether the current tokens start an indirect object reference or header, spelled as
+ * @p compound_type or as two integers and @p keyword_type .
+ */
+static bool
+cos_matches_obj_id_(CosObjParser *parser,
+                    CosToken_Type compound_type,
+                    CosToken_Type keyword_type);
+
+bool
+cos_obj_parser_scan_next_object(CosObjParser *parser,
+                                const CosObjEventHandler *handler,
+                                CosError * COS_Nullable out_error)
+{
+    COS_API_PARAM_CHECK(parser != NULL);
+    COS_API_PARAM_CHECK(handler != NULL);
+    if (COS_UNLIKELY(!parser || !handler)) {
+        return false;
+    }
+
+    if (parser->peeked_node) {
+        COS_ERROR_PROPAGATE(cos_error_make(COS_ERROR_INVALID_STATE,
+                                           "An object has already been peeked"),
+                            out_error);
+        return false;
+    }
+
+    CosObjEventScan scan = {
+        .handler = handler,
+        .stopped = false,
+    };
+
+    // Skip the object header, if there is one.
+    const bool is_indirect_def = cos_matches_obj_id_(parser,
+                                                     CosToken_Type_IndirectDef,
+                                                     CosToken_Type_Obj);
+    if (is_indirect_def) {
+        CosObjID obj_id = CosObjID_Invalid;
+        if (!cos_read_obj_id_(parser, CosToken_Type_IndirectDef, &obj_id, out_error)) {
+            return false;
+        }
+    }
+
+    bool result = false;
+    if (cos_base_parser_matches_next_token(&(parser->base),
+                                           CosToken_Type_DictionaryStart,
+                                           out_error)) {
+        CosStreamOffset length = -1;
+        result = cos_scan_dict_(parser, &scan, &length, out_error);
+        if (result && !scan.stopped &&
+            cos_base_parser_matches_next_token(&(parser->base),
+                                               CosToken_Type_Stream,
+                                               out_error)) {
+            result = cos_scan_stream_(parser, &scan, length, out_error);
+        }
+    }
+    else {
+        result = cos_scan_value_(parser, &scan, out_error);
+    }
+
+    if (scan.stopped) {
+        return true;
+    }
+    if (!result) {
+        return false;
+    }
+
+    if (is_indirect_def &&
+        cos_base_parser_matches_next_token(&(parser->base),
+                                           CosToken_Type_EndObj,
+                                           out_error)) {
+        cos_base_parser_advance(&(parser->base));
+    }
+
+    return true;
+}
+
+static CosObjNode * COS_Nullable
+cos_handle_dict_keys_(CosObjParser *parser,
+                      const char * const *keys,
+                      size_t key_count,
+                      CosError * COS_Nullable out_error);
+
+CosObjNode *
+cos_obj_parser_next_object_keys(CosObjParser *parser,
+                                const char * const *keys,
+                                size_t key_count,
+                                CosError * COS_Nullable out_error)
+{
+    COS_API_PARAM_CHECK(parser != NULL);
+    COS_API_PARAM_CHECK(keys != NULL || key_count == 0);
+    if (COS_UNLIKELY(!parser || (key_count > 0 && !keys))) {
+        return NULL;
+    }
+
+    if (parser->peeked_node) {
+        COS_ERROR_PROPAGATE(cos_error_make(COS_ERROR_INVALID_STATE,
+                                           "An object has already been peeked"),
+                            out_error);
+        return NULL;
+    }
+
+    if (!cos_matches_obj_id_(parser, CosToken_Type_IndirectDef, CosToken_Type_Obj)) {
+        return cos_obj_parser_next_object(parser, out_error);
+    }
+
+    CosObjID obj_id = CosObjID_Invalid;
+    if (!cos_read_obj_id_(parser, CosToken_Type_IndirectDef, &obj_id, out_error)) {
+        return NULL;
+    }
+
+    CosObjNode *obj = NULL;
+    if (cos_base_parser_matches_next_token(&(parser->base),
+                                           CosToken_Type_DictionaryStart,
+                                           out_error)) {
+        obj = cos_handle_dict_keys_(parser, keys, key_count, out_error);
+    }
+    else {
+        const CosObjParserContext def_context = {
+            .flags = (CosObjParserFlag_DirectObj |
+                      CosObjParserFlag_StreamObj),
+        };
+        obj = cos_next_object_(parser, &def_context, out_error);
+    }
+    if (!obj) {
+        return NULL;
+    }
+
+    // A stream keyword is left unread, along with its data.
+    if (cos_base_parser_matches_next_token(&(parser->base),
+                                           CosToken_Type_EndObj,
+                                           out_error)) {
+        cos_base_parser_advance(&(parser->base));
+    }
+
+    CosIndirectObjNode * const indirect_obj = cos_indirect_obj_node_alloc(parser->base.allocator,
+                                                                          obj_id,
+                                                                          obj);
+    if (!indirect_obj) {
+        cos_obj_node_release(obj);
+        COS_ERROR_PROPAGATE(cos_error_make(COS_ERROR_MEMORY,
+                                           "Failed to allocate an indirect object"),
+                            out_error);
+        return NULL;
+    }
+
+    return (CosObjNode *)indirect_obj;
+}
+
 // MARK: - Implementation
 
 // NOLINTBEGIN(misc-no-recursion)
@@ -311,7 +625,7 @@ cos_handle_dict_(CosObjParser *parser,
 static bool
 cos_handle_dict_entry_(CosObjParser *parser,
                        const CosObjParserContext *context,
-                       CosDict *dict,
+                       CosDictObjNode *dict_obj,
                        CosError * COS_Nullable out_error);
 
 static CosObjNode * COS_Nullable
@@ -419,6 +733,17 @@ cos_next_object_(CosObjParser *parser,
             // Unexpected token.
             break;
 
+        case CosToken_Type_IndirectRef: {
+            return cos_handle_indirect_ref_(parser,
+                                            context,
+                                            out_error);
+        }
+        case CosToken_Type_IndirectDef: {
+            return cos_handle_indirect_def_(parser,
+                                            context,
+                                            out_error);
+        }
+
         case CosToken_Type_EOF:
             break;
         case CosToken_Type_EndObj:
@@ -525,13 +850,113 @@ cos_handle_integer_(CosObjParser *parser,
 
     cos_base_parser_advance(&(parser->base));
 
-    CosIntObjNode * const int_obj = cos_int_obj_node_alloc(int_value);
+    CosIntObjNode * const int_obj = cos_int_obj_node_alloc(parser->base.allocator,
+                                                           int_value);
     return (CosObjNode *)int_obj;
 
 failure:
     return NULL;
 }
 
+/**
+ * Parses the next array element or dictionary value.
+ *
+ * Integers, real numbers and booleans are returned as inline values, without allocating an
+ * object node. Everything else, including indirect object references, is parsed as a node.
+ */
+static bool
+cos_next_value_(CosObjParser *parser,
+                const CosObjParserContext *context,
+                CosObjValue *out_value,
+                CosError * COS_Nullable out_error)
+{
+    COS_IMPL_PARAM_CHECK(parser != NULL);
+    COS_IMPL_PARAM_CHECK(context != NULL);
+    COS_IMPL_PARAM_CHECK(out_value != NULL);
+
+    CosToken * const token = cos_base_parser_get_current_token(&(parser->base));
+    if (!token) {
+        goto node;
+    }
+
+    switch (token->type) {
+        case CosToken_Type_Integer: {
+            if (!cos_parser_context_allows_(context, CosObjParserFlag_IntObj)) {
+                goto node;
+            }
+
+            // An integer followed by another integer may start an indirect object reference.
+            const CosToken * const second_token = cos_base_parser_peek_next_token(&(parser->base), 1);
+            if (second_token && second_token->type == CosToken_Type_Integer) {
+                const CosToken * const third_token = cos_base_parser_peek_next_token(&(parser->base), 2);
+                if (third_token &&
+                    (third_token->type == CosToken_Type_R ||
+                     third_token->type == CosToken_Type_Obj)) {
+                    goto node;
+                }
+            }
+
+            int int_value = 0;
+            if (!cos_token_value_get_integer_number(&token->value,
+                                                    &int_value)) {
+                COS_ERROR_PROPAGATE(cos_error_make(COS_ERROR_INVALID_STATE,
+                                                   "Invalid integer token"),
+                                    out_error);
+                return false;
+            }
+
+            cos_base_parser_advance(&(parser->base));
+            *out_value = cos_obj_value_make_int(int_value);
+            return true;
+        }
+
+        case CosToken_Type_Real: {
+            if (!cos_parser_context_allows_(context, CosObjParserFlag_RealObj)) {
+                goto node;
+            }
+
+            double real_value = 0.0;
+            if (!cos_token_value_get_real_number(&token->value,
+                                                 &real_value)) {
+                COS_ERROR_PROPAGATE(cos_error_make(COS_ERROR_INVALID_STATE,
+                                                   "Invalid real token"),
+                                    out_error);
+                return false;
+            }
+
+            cos_base_parser_advance(&(parser->base));
+            *out_value = cos_obj_value_make_real(real_value);
+            return true;
+        }
+
+        case CosToken_Type_True:
+        case CosToken_Type_False: {
+            if (!cos_parser_context_allows_(context, CosObjParserFlag_BoolObj)) {
+                goto node;
+            }
+
+            const bool bool_value = (token->type == CosToken_Type_True);
+            cos_base_parser_advance(&(parser->base));
+            *out_value = cos_obj_value_make_bool(bool_value);
+            return true;
+        }
+
+        default:
+            break;
+    }
+
+node:;
+    CosObjNode * const obj = cos_next_object_(parser,
+                                              context,
+                                              out_error);
+    if (!obj) {
+        return false;
+    }
+
+    *out_value = cos_obj_value_make_node(obj);
+    return true;
+}
+
 static CosObjNode *
 cos_handle_array_(CosObjParser *parser,
                   const CosObjParserContext *context,
@@ -553,7 +978,8 @@ cos_handle_array_(CosObjParser *parser,
 
     cos_base_parser_advance(&(parser->base));
 
-    array = cos_array_create(sizeof(CosObjNode *),
+    array = cos_array_create(parser->base.allocator,
+                             sizeof(CosObjValue),
                              &cos_array_obj_node_callbacks,
                              0);
     if (!array) {
@@ -573,11 +999,15 @@ cos_handle_array_(CosObjParser *parser,
         }
     }
 
-    CosArrayObjNode * const array_obj = cos_array_obj_node_alloc(array);
+    CosArrayObjNode * const array_obj = cos_array_obj_node_alloc(parser->base.allocator,
+                                                                 array);
     if (!array_obj) {
         goto failure;
     }
 
+    // Numeric arrays (e.g. /Widths, /MediaBox, /W) are stored contiguously.
+    (void)cos_array_obj_node_pack(array_obj);
+
     return (CosObjNode *)array_obj;
 
 failure:
@@ -604,24 +1034,26 @@ cos_handle_array_element_(CosObjParser *parser,
         return false;
     }
 
-    CosObjNode *element = NULL;
+    CosObjValue element;
+    bool has_element = false;
 
     const CosObjParserContext element_context = {
         .flags = (CosObjParserFlag_DirectObj |
                   CosObjParserFlag_IndirectObjRef),
     };
 
-    // Parse the next object.
-    element = cos_next_object_(parser,
-                               &element_context,
-                               out_error);
-    if (!element) {
+    // Parse the next value, with scalars stored inline.
+    if (!cos_next_value_(parser,
+                         &element_context,
+                         &element,
+                         out_error)) {
         goto failure;
     }
+    has_element = true;
 
-    // Append the object to the array.
+    // Append the value to the array.
     const bool append_success = cos_array_append_item(array,
-                                                      (void *)&element,
+                                                      (const void *)&element,
                                                       out_error);
     if (COS_UNLIKELY(!append_success)) {
         goto failure;
@@ -630,8 +1062,8 @@ cos_handle_array_element_(CosObjParser *parser,
     return true;
 
 failure:
-    if (element) {
-        cos_obj_node_release(element);
+    if (has_element) {
+        cos_obj_value_release(element);
     }
     return false;
 }
@@ -647,12 +1079,9 @@ cos_handle_dict_(CosObjParser *parser,
     // Consume the dictionary start token.
     cos_base_parser_advance(&(parser->base));
 
-    CosDict *new_dict = NULL;
-
-    new_dict = cos_dict_create(&cos_dict_obj_node_key_callbacks,
-                               &cos_dict_obj_node_value_callbacks,
-                               0);
-    if (!new_dict) {
+    CosDictObjNode * const dict_obj = cos_dict_obj_node_create(parser->base.allocator,
+                                                               NULL);
+    if (!dict_obj) {
         goto failure;
     }
 
@@ -660,7 +1089,7 @@ cos_handle_dict_(CosObjParser *parser,
     while (cos_base_parser_has_next_token(&(parser->base))) {
         entry_success = cos_handle_dict_entry_(parser,
                                                context,
-                                               new_dict,
+                                               dict_obj,
                                                out_error);
         if (!entry_success) {
             // Or, skip entry and continue parsing?
@@ -668,11 +1097,6 @@ cos_handle_dict_(CosObjParser *parser,
         }
     }
 
-    CosDictObjNode * const dict_obj = cos_dict_obj_node_create(new_dict);
-    if (!dict_obj) {
-        goto failure;
-    }
-
     // Check if the next token denotes the beginning of a stream object's data.
     if (cos_base_parser_matches_next_token(&(parser->base),
                                            CosToken_Type_Stream,
@@ -686,21 +1110,18 @@ cos_handle_dict_(CosObjParser *parser,
     return (CosObjNode *)dict_obj;
 
 failure:
-    if (new_dict) {
-        cos_dict_destroy(new_dict);
-    }
     return NULL;
 }
 
 static bool
 cos_handle_dict_entry_(CosObjParser *parser,
                        const CosObjParserContext *context,
-                       CosDict *dict,
+                       CosDictObjNode *dict_obj,
                        CosError * COS_Nullable out_error)
 {
     COS_IMPL_PARAM_CHECK(parser != NULL);
     COS_IMPL_PARAM_CHECK(context != NULL);
-    COS_IMPL_PARAM_CHECK(dict != NULL);
+    COS_IMPL_PARAM_CHECK(dict_obj != NULL);
 
     if (cos_base_parser_matches_next_token(&(parser->base),
                                            CosToken_Type_DictionaryEnd,
@@ -710,7 +1131,8 @@ cos_handle_dict_entry_(CosObjParser *parser,
     }
 
     CosObjNode *key = NULL;
-    CosObjNode *value = NULL;
+    CosObjValue value;
+    bool has_value = false;
 
     const CosObjParserContext key_context = {
         .flags = CosObjParserFlag_NameObj,
@@ -729,17 +1151,18 @@ cos_handle_dict_entry_(CosObjParser *parser,
         goto failure;
     }
 
-    value = cos_next_object_(parser,
-                             &value_context,
-                             out_error);
-    if (!value) {
+    if (!cos_next_value_(parser,
+                         &value_context,
+                         &value,
+                         out_error)) {
         goto failure;
     }
+    has_value = true;
 
-    if (!cos_dict_set(dict,
-                      (void *)key,
-                      (void *)value,
-                      out_error)) {
+    if (!cos_dict_obj_node_set_value(dict_obj,
+                                     (CosNameObjNode *)key,
+                                     value,
+                                     out_error)) {
         goto failure;
     }
 
@@ -749,12 +1172,113 @@ failure:
     if (key) {
         cos_obj_node_release(key);
     }
-    if (value) {
-        cos_obj_node_release(value);
+    if (has_value) {
+        cos_obj_value_release(value);
+    }
+    return false;
+}
+
+/**
+ * Returns whether @p key is one of @p keys .
+ */
+static bool
+cos_is_requested_key_(const CosString *key,
+                      const char * const *keys,
+                      size_t key_count)
+{
+    COS_IMPL_PARAM_CHECK(key != NULL);
+
+    const CosStringRef key_ref = cos_string_get_ref(key);
+    for (size_t i = 0; i < key_count; i++) {
+        const size_t length = strlen(keys[i]);
+        if (key_ref.length == length &&
+            memcmp(key_ref.data, keys[i], length) == 0) {
+            return true;
+        }
     }
     return false;
 }
 
+static CosObjNode *
+cos_handle_dict_keys_(CosObjParser *parser,
+                      const char * const *keys,
+                      size_t key_count,
+                      CosError * COS_Nullable out_error)
+{
+    COS_IMPL_PARAM_CHECK(parser != NULL);
+
+    const CosObjParserContext context = {
+        .flags = (CosObjParserFlag_DirectObj |
+                  CosObjParserFlag_IndirectObjRef),
+    };
+
+    // Consume the dictionary start token.
+    cos_base_parser_advance(&(parser->base));
+
+    CosDictObjNode * const dict_obj = cos_dict_obj_node_create(parser->base.allocator,
+                                                               NULL);
+    if (!dict_obj) {
+        COS_ERROR_PROPAGATE(cos_error_make(COS_ERROR_MEMORY,
+                                           "Failed to create a dictionary"),
+                            out_error);
+        return NULL;
+    }
+
+    while (true) {
+        const CosToken * const token = cos_base_parser_get_current_token(&(parser->base));
+        if (!token || token->type == CosToken_Type_EOF) {
+            COS_ERROR_PROPAGATE(cos_error_make(COS_ERROR_SYNTAX,
+                                               "Unterminated dictionary"),
+                                out_error);
+            goto failure;
+        }
+
+        if (token->type == CosToken_Type_DictionaryEnd) {
+            cos_base_parser_advance(&(parser->base));
+            break;
+        }
+
+        const CosString *key = NULL;
+        if (token->type != CosToken_Type_Name ||
+            !cos_token_value_get_string(&token->value, &key) ||
+            !key) {
+            COS_ERROR_PROPAGATE(cos_error_make(COS_ERROR_SYNTAX,
+                                               "Expected a name as dictionary key"),
+                                out_error);
+            goto failure;
+        }
+
+        if (cos_is_requested_key_(COS_nonnull_cast(key), keys, key_count)) {
+            if (!cos_handle_dict_entry_(parser, &context, dict_obj, out_error)) {
+                goto failure;
+            }
+            continue;
+        }
+
+        cos_base_parser_advance(&(parser->base));
+
+        // The value can be skipped in the input, unless its tokens have already been read.
+        if (parser->base.token_count == 0) {
+            if (!cos_tokenizer_skip_dict_value(parser->base.tokenizer, out_error)) {
+                goto failure;
+            }
+        }
+        else {
+            CosObjValue value;
+            if (!cos_next_value_(parser, &context, &value, out_error)) {
+                goto failure;
+            }
+            cos_obj_value_release(value);
+        }
+    }
+
+    return (CosObjNode *)dict_obj;
+
+failure:
+    cos_obj_node_release((CosObjNode *)dict_obj);
+    return NULL;
+}
+
 static CosObjNode *
 cos_handle_stream_(CosObjParser *parser,
                    const CosObjParserContext *context,
@@ -793,22 +1317,35 @@ cos_handle_stream_(CosObjParser *parser,
 
     int stream_length = -1;
 
-    CosObjNode *length_obj = NULL;
-    if (cos_dict_obj_node_get_value_with_string(dict_obj,
-                                           "Length",
-                                           &length_obj,
-                                           NULL)) {
-        if (cos_obj_node_is_integer(length_obj)) {
-            CosIntObjNode * const int_obj = (CosIntObjNode *)length_obj;
-
-            stream_length = cos_int_obj_node_get_value(int_obj);
+    CosObjValue length_value;
+    if (cos_dict_obj_node_lookup_with_key(dict_obj,
+                                          cos_name_key_get_well_known(CosWellKnownName_Length),
+                                          &length_value)) {
+        const bool is_indirect = (length_value.kind == CosObjValueKind_Node &&
+                                  length_value.as.node &&
+                                  cos_obj_node_get_type(COS_nonnull_cast(length_value.as.node)) == CosObjNodeType_Reference);
+        if (!is_indirect) {
+            if (!cos_obj_value_get_int(length_value, &stream_length)) {
+                // Error: The Length entry is not an integer.
+            }
         }
-        else {
-            // Error: The Length entry is not an integer.
+        else if (!parser->resolving_stream_length) {
+            // Loading the Length object may parse another stream, or this one again, with this
+            // parser. Such a stream cannot resolve its own Length, which ends the recursion.
+            parser->resolving_stream_length = true;
+            if (!cos_obj_value_get_int(length_value, &stream_length)) {
+                stream_length = -1;
+            }
+            parser->resolving_stream_length = false;
+
+            // The tokens that were read for the loaded object do not belong to this one.
+            cos_obj_parser_flush_tokens_(parser);
         }
     }
 
-    printf("Stream length: %d\n", stream_length);
+    COS_LOG_TRACE(cos_log_context_get_default(),
+                  "Stream length: %d",
+                  stream_length);
 
     // Need to get the offset from the token.
     //    const CosStreamOffset stream_position = cos_stream_get_position(parser->input_stream,
@@ -817,32 +1354,72 @@ cos_handle_stream_(CosObjParser *parser,
     //        goto failure;
     //    }
 
-    // TODO: Check for overflow.
-    CosStreamOffset stream_end_position = stream_start + stream_length;
-
-    // Skip the stream data.
-    if (!cos_stream_seek(parser->base.input_stream,
-                         stream_end_position,
-                         CosStreamOffsetWhence_Set,
-                         out_error)) {
+    // The data starts after the end-of-line marker that follows the stream keyword.
+    if (!cos_tokenizer_seek(parser->base.tokenizer, stream_start, out_error)) {
         goto failure;
     }
-
-    cos_tokenizer_reset(parser->base.tokenizer);
-
-    // Skip the endstream keyword.
-    if (cos_base_parser_matches_next_token(&(parser->base),
-                                           CosToken_Type_EndStream,
-                                           out_error)) {
-        cos_base_parser_advance(&(parser->base));
+    const CosStreamOffset data_start = stream_start + (CosStreamOffset)cos_tokenizer_skip_eol(parser->base.tokenizer);
+
+    // The data cannot run past the end of the input. Checking this before adding the Length to
+    // the data offset also keeps the sum from overflowing.
+    const CosStreamOffset input_end = (parser->input_size >= 0) ? parser->input_size : COS_STREAM_OFFSET_MAX;
+    if (stream_length > input_end - data_start) {
+        cos_diagnose(COS_nonnull_cast(parser->base.diagnostic_handler),
+                     CosDiagnosticLevel_Warning,
+                     "Stream Length runs past the end of the input");
+        stream_length = -1;
+    }
+
+    if (parser->stops_at_stream_data) {
+        // Leave the tokenizer at the data, for the caller to read.
+        parser->has_pending_stream = true;
+        parser->pending_stream_length = (stream_length >= 0) ? (CosStreamOffset)stream_length : -1;
+
+        return (CosObjNode *)cos_stream_obj_node_create(parser->base.allocator,
+                                                        dict_obj,
+                                                        NULL);
+    }
+
+    if (stream_length < 0) {
+        // Without a usable Length entry, the data runs up to the endstream keyword. Reading
+        // through it consumes the keyword too.
+        CosStream * const body = cos_stream_body_create(parser->base.tokenizer, -1);
+        if (!body) {
+            COS_ERROR_PROPAGATE(cos_error_make(COS_ERROR_MEMORY,
+                                               "Failed to skip stream data"),
+                                out_error);
+            goto failure;
+        }
+        const bool skipped = cos_stream_body_finish(body, out_error);
+        cos_stream_close(body);
+        if (!skipped) {
+            goto failure;
+        }
     }
     else {
-        // Error: Expected an endstream token.
-        printf("Expected an endstream token.\n");
+        const CosStreamOffset stream_end_position = data_start + stream_length;
+
+        // Skip the stream data.
+        if (!cos_tokenizer_seek(parser->base.tokenizer, stream_end_position, out_error)) {
+            goto failure;
+        }
+
+        // Skip the endstream keyword.
+        if (cos_base_parser_matches_next_token(&(parser->base),
+                                               CosToken_Type_EndStream,
+                                               out_error)) {
+            cos_base_parser_advance(&(parser->base));
+        }
+        else {
+            cos_diagnose(COS_nonnull_cast(parser->base.diagnostic_handler),
+                         CosDiagnosticLevel_Warning,
+                         "Expected an endstream token");
+        }
     }
 
-    CosStreamObjNode *stream_obj = cos_stream_obj_node_create(dict_obj,
-                                                     NULL);
+    CosStreamObjNode *stream_obj = cos_stream_obj_node_create(parser->base.allocator,
+                                                              dict_obj,
+                                                              NULL);
     if (!stream_obj) {
         goto failure;
     }
@@ -867,15 +1444,18 @@ cos_handle_bool_(CosObjParser *parser,
     COS_IMPL_PARAM_CHECK(context != NULL);
 
     // Is a boolean object allowed in the current context?
-    if (cos_parser_context_allows_(context,
-                                   CosObjParserFlag_BoolObj)) {
+    if (!cos_parser_context_allows_(context,
+                                    CosObjParserFlag_BoolObj)) {
         COS_ERROR_PROPAGATE(cos_error_make(COS_ERROR_INVALID_STATE,
                                            "Invalid boolean object"),
                             out_error);
         goto failure;
     }
 
-    CosBoolObjNode * const bool_obj = cos_bool_obj_node_alloc(value);
+    cos_base_parser_advance(&(parser->base));
+
+    CosBoolObjNode * const bool_obj = cos_bool_obj_node_alloc(parser->base.allocator,
+                                                              value);
     return (CosObjNode *)bool_obj;
 
 failure:
@@ -891,14 +1471,16 @@ cos_handle_null_(CosObjParser *parser,
     COS_IMPL_PARAM_CHECK(context != NULL);
 
     // Is a null object allowed in the current context?
-    if (cos_parser_context_allows_(context,
-                                   CosObjParserFlag_NullObj)) {
+    if (!cos_parser_context_allows_(context,
+                                    CosObjParserFlag_NullObj)) {
         COS_ERROR_PROPAGATE(cos_error_make(COS_ERROR_INVALID_STATE,
                                            "Invalid null object"),
                             out_error);
         goto failure;
     }
 
+    cos_base_parser_advance(&(parser->base));
+
     CosNullObjNode * const null_obj = cos_null_obj_node_get();
     return (CosObjNode *)null_obj;
 
@@ -906,61 +1488,93 @@ failure:
     return NULL;
 }
 
-static CosObjNode * COS_Nullable
-cos_handle_indirect_ref_(CosObjParser *parser,
-                         const CosObjParserContext *context,
-                         CosError * COS_Nullable out_error)
+static bool
+cos_read_obj_id_(CosObjParser *parser,
+                 CosToken_Type compound_type,
+                 CosObjID *out_obj_id,
+                 CosError * COS_Nullable out_error)
 {
     COS_IMPL_PARAM_CHECK(parser != NULL);
-    COS_IMPL_PARAM_CHECK(context != NULL);
+    COS_IMPL_PARAM_CHECK(out_obj_id != NULL);
+
+    const CosToken * const first_token = &parser->base.token_buffer[0];
+    if (first_token->type == compound_type) {
+        if (!cos_token_value_get_obj_id(&first_token->value, out_obj_id)) {
+            COS_ERROR_PROPAGATE(cos_error_make(COS_ERROR_INVALID_STATE,
+                                               "Invalid indirect object token"),
+                                out_error);
+            return false;
+        }
 
-    if (!cos_parser_context_allows_(context,
-                                    CosObjParserFlag_IndirectObjRef)) {
-        COS_ERROR_PROPAGATE(cos_error_make(COS_ERROR_INVALID_STATE,
-                                           "Invalid indirect object reference"),
-                            out_error);
-        goto failure;
+        cos_base_parser_advance(&(parser->base));
+        return true;
     }
 
     COS_ASSERT(parser->base.token_buffer[0].type == CosToken_Type_Integer,
                "Expected an object-number integer token");
     COS_ASSERT(parser->base.token_buffer[1].type == CosToken_Type_Integer,
                "Expected a generation-number integer token");
-    COS_ASSERT(parser->base.token_buffer[2].type == CosToken_Type_R,
-               "Expected an 'R' keyword token");
-
-    // TODO: Validate the indirect reference tokens and whitespace.
-    const CosToken * const obj_num_token = &parser->base.token_buffer[0];
-    const CosToken * const gen_num_token = &parser->base.token_buffer[1];
+    COS_ASSERT(parser->base.token_buffer[2].type == ((compound_type == CosToken_Type_IndirectRef) ? CosToken_Type_R : CosToken_Type_Obj),
+               "Expected an 'R' or 'obj' keyword token");
 
     int obj_num = 0;
     int gen_num = 0;
 
-    if (!cos_token_get_integer_value(obj_num_token,
+    if (!cos_token_get_integer_value(first_token,
                                      &obj_num)) {
         COS_ERROR_PROPAGATE(cos_error_make(COS_ERROR_INVALID_STATE,
                                            "Invalid object number token"),
                             out_error);
-        goto failure;
+        return false;
     }
-    if (!cos_token_get_integer_value(gen_num_token,
+    if (!cos_token_get_integer_value(&parser->base.token_buffer[1],
                                      &gen_num)) {
         COS_ERROR_PROPAGATE(cos_error_make(COS_ERROR_INVALID_STATE,
                                            "Invalid generation number token"),
                             out_error);
+        return false;
+    }
+
+    cos_base_parser_advance(&(parser->base));
+    cos_base_parser_advance(&(parser->base));
+    cos_base_parser_advance(&(parser->base));
+
+    *out_obj_id = cos_obj_id_make((unsigned int)obj_num,
+                                  (unsigned int)gen_num);
+    return true;
+}
+
+static CosObjNode * COS_Nullable
+cos_handle_indirect_ref_(CosObjParser *parser,
+                         const CosObjParserContext *context,
+                         CosError * COS_Nullable out_error)
+{
+    COS_IMPL_PARAM_CHECK(parser != NULL);
+    COS_IMPL_PARAM_CHECK(context != NULL);
+
+    if (!cos_parser_context_allows_(context,
+                                    CosObjParserFlag_IndirectObjRef)) {
+        COS_ERROR_PROPAGATE(cos_error_make(COS_ERROR_INVALID_STATE,
+                                           "Invalid indirect object reference"),
+                            out_error);
         goto failure;
     }
 
-    CosObjNode * const obj = (CosObjNode *)cos_reference_obj_node_alloc(cos_obj_id_make((unsigned int)obj_num,
-                                                                           (unsigned int)gen_num),
-                                                           parser->base.doc);
-    if (!obj) {
+    // TODO: Validate the indirect reference tokens and whitespace.
+    CosObjID obj_id = CosObjID_Invalid;
+    if (!cos_read_obj_id_(parser,
+                          CosToken_Type_IndirectRef,
+                          &obj_id,
+                          out_error)) {
         goto failure;
     }
 
-    cos_base_parser_advance(&(parser->base));
-    cos_base_parser_advance(&(parser->base));
-    cos_base_parser_advance(&(parser->base));
+    CosObjNode * const obj = (CosObjNode *)cos_reference_obj_node_alloc(parser->base.allocator,
+                                                                        obj_id,
+                                                                        parser->base.doc);
+    if (!obj) {
+        goto failure;
+    }
 
     return obj;
 
@@ -984,48 +1598,21 @@ cos_handle_indirect_def_(CosObjParser *parser,
         goto failure;
     }
 
-    COS_ASSERT(parser->base.token_buffer[0].type == CosToken_Type_Integer,
-               "Expected an object-number integer token");
-    COS_ASSERT(parser->base.token_buffer[1].type == CosToken_Type_Integer,
-               "Expected a generation-number integer token");
-    COS_ASSERT(parser->base.token_buffer[2].type == CosToken_Type_Obj,
-               "Expected an 'obj' keyword token");
-
-    CosToken * const obj_num_token = &parser->base.token_buffer[0];
-    CosToken * const gen_num_token = &parser->base.token_buffer[1];
-
     // ISO 19005-1:2005(E), Section 6.1.8 Indirect objects (PDF/A-1a, PDF/A-1b)
     // "The object number and generation number shall be separated by a single white-space character."
     // "The generation number and the obj keyword shall be separated by a single white-space character."
     // "The object number and endobj keyword shall each be preceded by an EOL marker."
     // "The obj and endobj keywords shall each be followed by an EOL marker.
 
-    int obj_num = 0;
-    int gen_num = 0;
-
-    if (!cos_token_get_integer_value(obj_num_token,
-                                     &obj_num)) {
-        COS_ERROR_PROPAGATE(cos_error_make(COS_ERROR_INVALID_STATE,
-                                           "Invalid object number token"),
-                            out_error);
-        goto failure;
-    }
-    if (!cos_token_get_integer_value(gen_num_token,
-                                     &gen_num)) {
-        COS_ERROR_PROPAGATE(cos_error_make(COS_ERROR_INVALID_STATE,
-                                           "Invalid generation number token"),
-                            out_error);
+    // Consume the object header tokens.
+    CosObjID obj_id = CosObjID_Invalid;
+    if (!cos_read_obj_id_(parser,
+                          CosToken_Type_IndirectDef,
+                          &obj_id,
+                          out_error)) {
         goto failure;
     }
 
-    // Consume the object header tokens.
-    cos_base_parser_advance(&(parser->base));
-    cos_base_parser_advance(&(parser->base));
-    cos_base_parser_advance(&(parser->base));
-
-    const CosObjID obj_id = cos_obj_id_make((unsigned int)obj_num,
-                                            (unsigned int)gen_num);
-
     COS_LOG_TRACE(cos_log_context_get_default(),
                   "Parsing indirect object definition: %u %u",
                   obj_id.obj_number,
@@ -1044,18 +1631,24 @@ cos_handle_indirect_def_(CosObjParser *parser,
         goto failure;
     }
 
-    if (cos_base_parser_matches_next_token(&(parser->base),
-                                           CosToken_Type_EndObj,
-                                           out_error)) {
-        // TODO: Validate endobj token.
-        cos_base_parser_advance(&(parser->base));
-    }
-    else {
-        printf("Expected endobj token\n");
+    // When the parser stopped at stream data, the endobj keyword has not been reached yet.
+    if (!parser->has_pending_stream) {
+        if (cos_base_parser_matches_next_token(&(parser->base),
+                                               CosToken_Type_EndObj,
+                                               out_error)) {
+            // TODO: Validate endobj token.
+            cos_base_parser_advance(&(parser->base));
+        }
+        else {
+            cos_diagnose(COS_nonnull_cast(parser->base.diagnostic_handler),
+                         CosDiagnosticLevel_Warning,
+                         "Expected an endobj token");
+        }
     }
 
-    CosIndirectObjNode * const indirect_obj = cos_indirect_obj_node_alloc(obj_id,
-                                                                 obj);
+    CosIndirectObjNode * const indirect_obj = cos_indirect_obj_node_alloc(parser->base.allocator,
+                                                                          obj_id,
+                                                                          obj);
     if (!indirect_obj) {
         goto failure;
     }
@@ -1099,7 +1692,8 @@ cos_parse_string_(CosObjParser *parser,
 
     cos_base_parser_advance(&(parser->base));
 
-    CosStringObjNode * const string_obj = cos_string_obj_node_alloc(string_data);
+    CosStringObjNode * const string_obj = cos_string_obj_node_alloc(parser->base.allocator,
+                                                                    string_data);
     return (CosObjNode *)string_obj;
 
 failure:
@@ -1128,7 +1722,9 @@ cos_parse_name_(CosObjParser *parser,
 
     cos_base_parser_advance(&(parser->base));
 
-    CosNameObjNode * const nameObj = cos_name_obj_node_alloc(name);
+    // Names are interned, so that equal dictionary keys share a single name object.
+    CosNameObjNode * const nameObj = cos_doc_intern_name_(parser->base.doc,
+                                                          name);
     return (CosObjNode *)nameObj;
 
 failure:
@@ -1142,8 +1738,8 @@ cos_handle_real_(CosObjParser *parser,
 {
     COS_IMPL_PARAM_CHECK(parser != NULL);
 
-    if (cos_parser_context_allows_(context,
-                                   CosObjParserFlag_RealObj)) {
+    if (!cos_parser_context_allows_(context,
+                                    CosObjParserFlag_RealObj)) {
         COS_ERROR_PROPAGATE(cos_error_make(COS_ERROR_INVALID_STATE,
                                            "Invalid real object"),
                             error);
@@ -1170,13 +1766,359 @@ cos_handle_real_(CosObjParser *parser,
 
     cos_base_parser_advance(&(parser->base));
 
-    CosRealObjNode * const real_obj = cos_real_obj_node_alloc(real_value);
+    CosRealObjNode * const real_obj = cos_real_obj_node_alloc(parser->base.allocator,
+                                                              real_value);
     return (CosObjNode *)real_obj;
 
 failure:
     return NULL;
 }
 
+// MARK: - Event scanning
+
+static bool
+cos_matches_obj_id_(CosObjParser *parser,
+                    CosToken_Type compound_type,
+                    CosToken_Type keyword_type)
+{
+    COS_IMPL_PARAM_CHECK(parser != NULL);
+
+    const CosToken * const token = cos_base_parser_get_current_token(&(parser->base));
+    if (!token) {
+        return false;
+    }
+    if (token->type == compound_type) {
+        return true;
+    }
+    if (token->type != CosToken_Type_Integer) {
+        return false;
+    }
+
+    const CosToken * const second_token = cos_base_parser_peek_next_token(&(parser->base), 1);
+    if (!second_token || second_token->type != CosToken_Type_Integer) {
+        return false;
+    }
+    const CosToken * const third_token = cos_base_parser_peek_next_token(&(parser->base), 2);
+    return (third_token && third_token->type == keyword_type);
+}
+
+/**
+ * Passes an event to the handler.
+ *
+ * @return @c false if the handler asked to stop.
+ */
+static bool
+cos_emit_event_(CosObjEventScan *scan,
+                const CosObjEvent *event)
+{
+    COS_IMPL_PARAM_CHECK(scan != NULL);
+    COS_IMPL_PARAM_CHECK(event != NULL);
+
+    if (!scan->handler->handle_event(event, scan->handler->user_data)) {
+        scan->stopped = true;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Scans an array, starting at its opening bracket.
+ */
+static bool
+cos_scan_array_(CosObjParser *parser,
+                CosObjEventScan *scan,
+                CosError * COS_Nullable out_error)
+{
+    COS_IMPL_PARAM_CHECK(parser != NULL);
+    COS_IMPL_PARAM_CHECK(scan != NULL);
+
+    const CosToken * const start_token = cos_base_parser_get_current_token(&(parser->base));
+    COS_ASSERT(start_token && start_token->type == CosToken_Type_ArrayStart,
+               "Expected an array start token");
+
+    const CosObjEvent start_event = {
+        .type = CosObjEventType_ArrayStart,
+        .offset = (CosStreamOffset)start_token->offset,
+    };
+    cos_base_parser_advance(&(parser->base));
+    if (!cos_emit_event_(scan, &start_event)) {
+        return false;
+    }
+
+    while (true) {
+        const CosToken * const token = cos_base_parser_get_current_token(&(parser->base));
+        if (!token || token->type == CosToken_Type_EOF) {
+            COS_ERROR_PROPAGATE(cos_error_make(COS_ERROR_SYNTAX,
+                                               "Unterminated array"),
+                                out_error);
+            return false;
+        }
+
+        if (token->type == CosToken_Type_ArrayEnd) {
+            const CosObjEvent end_event = {
+                .type = CosObjEventType_ArrayEnd,
+                .offset = (CosStreamOffset)token->offset,
+            };
+            cos_base_parser_advance(&(parser->base));
+            return cos_emit_event_(scan, &end_event);
+        }
+
+        if (!cos_scan_value_(parser, scan, out_error)) {
+            return false;
+        }
+    }
+}
+
+static bool
+cos_scan_dict_(CosObjParser *parser,
+               CosObjEventScan *scan,
+               CosStreamOffset * COS_Nullable out_length,
+               CosError * COS_Nullable out_error)
+{
+    COS_IMPL_PARAM_CHECK(parser != NULL);
+    COS_IMPL_PARAM_CHECK(scan != NULL);
+
+    const CosToken * const start_token = cos_base_parser_get_current_token(&(parser->base));
+    COS_ASSERT(start_token && start_token->type == CosToken_Type_DictionaryStart,
+               "Expected a dictionary start token");
+
+    const CosObjEvent start_event = {
+        .type = CosObjEventType_DictStart,
+        .offset = (CosStreamOffset)start_token->offset,
+    };
+    cos_base_parser_advance(&(parser->base));
+    if (!cos_emit_event_(scan, &start_event)) {
+        return false;
+    }
+
+    while (true) {
+        const CosToken * const token = cos_base_parser_get_current_token(&(parser->base));
+        if (!token || token->type == CosToken_Type_EOF) {
+            COS_ERROR_PROPAGATE(cos_error_make(COS_ERROR_SYNTAX,
+                                               "Unterminated dictionary"),
+                                out_error);
+            return false;
+        }
+
+        if (token->type == CosToken_Type_DictionaryEnd) {
+            const CosObjEvent end_event = {
+                .type = CosObjEventType_DictEnd,
+                .offset = (CosStreamOffset)token->offset,
+            };
+            cos_base_parser_advance(&(parser->base));
+            return cos_emit_event_(scan, &end_event);
+        }
+
+        const CosString *key = NULL;
+        if (token->type != CosToken_Type_Name ||
+            !cos_token_value_get_string(&token->value, &key) ||
+            !key) {
+            COS_ERROR_PROPAGATE(cos_error_make(COS_ERROR_SYNTAX,
+                                               "Expected a name as dictionary key"),
+                                out_error);
+            return false;
+        }
+
+        const CosObjEvent key_event = {
+            .type = CosObjEventType_Key,
+            .offset = (CosStreamOffset)token->offset,
+            .as.name = cos_string_get_ref(key),
+        };
+        const bool is_length = (out_length &&
+                                key_event.as.name.length == 6 &&
+                                memcmp(key_event.as.name.data, "Length", 6) == 0);
+        if (!cos_emit_event_(scan, &key_event)) {
+            return false;
+        }
+        cos_base_parser_advance(&(parser->base));
+
+        // Remember a direct Length, for the stream data that may follow.
+        if (is_length) {
+            const CosToken * const value_token = cos_base_parser_get_current_token(&(parser->base));
+            int length = 0;
+            if (value_token &&
+                !cos_matches_obj_id_(parser, CosToken_Type_IndirectRef, CosToken_Type_R) &&
+                cos_token_get_integer_value(value_token, &length) &&
+                length >= 0) {
+                *out_length = length;
+            }
+        }
+
+        if (!cos_scan_value_(parser, scan, out_error)) {
+            return false;
+        }
+    }
+}
+
+static bool
+cos_scan_value_(CosObjParser *parser,
+                CosObjEventScan *scan,
+                CosError * COS_Nullable out_error)
+{
+    COS_IMPL_PARAM_CHECK(parser != NULL);
+    COS_IMPL_PARAM_CHECK(scan != NULL);
+
+    const CosToken * const token = cos_base_parser_get_current_token(&(parser->base));
+    if (!token) {
+        COS_ERROR_PROPAGATE(cos_error_make(COS_ERROR_SYNTAX,
+                                           "Expected an object"),
+                            out_error);
+        return false;
+    }
+
+    CosObjEvent event = {
+        .type = CosObjEventType_Scalar,
+        .offset = (CosStreamOffset)token->offset,
+    };
+
+    switch (token->type) {
+        case CosToken_Type_ArrayStart:
+            return cos_scan_array_(parser, scan, out_error);
+
+        case CosToken_Type_DictionaryStart:
+            return cos_scan_dict_(parser, scan, NULL, out_error);
+
+        case CosToken_Type_Integer:
+        case CosToken_Type_IndirectRef: {
+            if (cos_matches_obj_id_(parser, CosToken_Type_IndirectRef, CosToken_Type_R)) {
+                event.type = CosObjEventType_Reference;
+                if (!cos_read_obj_id_(parser, CosToken_Type_IndirectRef, &event.as.obj_id, out_error)) {
+                    return false;
+                }
+                return cos_emit_event_(scan, &event);
+            }
+
+            event.scalar_type = CosObjType_Integer;
+            if (!cos_token_get_integer_value(token, &event.as.integer)) {
+                COS_ERROR_PROPAGATE(cos_error_make(COS_ERROR_INVALID_STATE,
+                                                   "Invalid integer token"),
+                                    out_error);
+                return false;
+            }
+        } break;
+
+        case CosToken_Type_Real: {
+            event.scalar_type = CosObjType_Real;
+            if (!cos_token_value_get_real_number(&token->value, &event.as.real)) {
+                COS_ERROR_PROPAGATE(cos_error_make(COS_ERROR_INVALID_STATE,
+                                                   "Invalid real token"),
+                                    out_error);
+                return false;
+            }
+        } break;
+
+        case CosToken_Type_True:
+        case CosToken_Type_False: {
+            event.scalar_type = CosObjType_Boolean;
+            event.as.boolean = (token->type == CosToken_Type_True);
+        } break;
+
+        case CosToken_Type_Null: {
+            event.scalar_type = CosObjType_Null;
+        } break;
+
+        case CosToken_Type_Name: {
+            const CosString *name = NULL;
+            if (!cos_token_value_get_string(&token->value, &name) || !name) {
+                COS_ERROR_PROPAGATE(cos_error_make(COS_ERROR_INVALID_STATE,
+                                                   "Invalid name token"),
+                                    out_error);
+                return false;
+            }
+            event.scalar_type = CosObjType_Name;
+            event.as.name = cos_string_get_ref(name);
+        } break;
+
+        case CosToken_Type_Literal_String:
+        case CosToken_Type_Hex_String: {
+            const CosData *data = NULL;
+            if (!cos_token_value_get_data(&token->value, &data) || !data) {
+                COS_ERROR_PROPAGATE(cos_error_make(COS_ERROR_INVALID_STATE,
+                                                   "Invalid string token"),
+                                    out_error);
+                return false;
+            }
+            event.scalar_type = CosObjType_String;
+            event.as.string = cos_data_get_ref(data);
+        } break;
+
+        default: {
+            COS_ERROR_PROPAGATE(cos_error_make(COS_ERROR_SYNTAX,
+                                               "Unexpected token"),
+                                out_error);
+            return false;
+        }
+    }
+
+    // The token owns the borrowed name or string, so it is only released after the callback.
+    const bool should_continue = cos_emit_event_(scan, &event);
+    cos_base_parser_advance(&(parser->base));
+    return should_continue;
+}
+
+static bool
+cos_scan_stream_(CosObjParser *parser,
+                 CosObjEventScan *scan,
+                 CosStreamOffset length,
+                 CosError * COS_Nullable out_error)
+{
+    COS_IMPL_PARAM_CHECK(parser != NULL);
+    COS_IMPL_PARAM_CHECK(scan != NULL);
+
+    const CosToken * const stream_token = cos_base_parser_get_current_token(&(parser->base));
+    COS_ASSERT(stream_token && stream_token->type == CosToken_Type_Stream,
+               "Expected a stream token");
+
+    const CosStreamOffset stream_start = (CosStreamOffset)(stream_token->offset + stream_token->length);
+    CosObjEvent event = {
+        .type = CosObjEventType_StreamStart,
+        .offset = (CosStreamOffset)stream_token->offset,
+    };
+    cos_base_parser_advance(&(parser->base));
+
+    if (!cos_tokenizer_seek(parser->base.tokenizer, stream_start, out_error)) {
+        return false;
+    }
+    event.as.stream.data_offset = stream_start + (CosStreamOffset)cos_tokenizer_skip_eol(parser->base.tokenizer);
+    event.as.stream.length = length;
+
+    if (!cos_emit_event_(scan, &event)) {
+        return false;
+    }
+
+    if (length < 0) {
+        // The Length entry is an indirect reference, which a scan cannot resolve. Read through
+        // the data to the endstream keyword instead, which consumes the keyword too.
+        CosStream * const body = cos_stream_body_create(parser->base.tokenizer, -1);
+        if (!body) {
+            COS_ERROR_PROPAGATE(cos_error_make(COS_ERROR_MEMORY,
+                                               "Failed to skip stream data"),
+                                out_error);
+            return false;
+        }
+        const bool skipped = cos_stream_body_finish(body, out_error);
+        cos_stream_close(body);
+        return skipped;
+    }
+
+    if (!cos_tokenizer_seek(parser->base.tokenizer,
+                            event.as.stream.data_offset + length,
+                            out_error)) {
+        return false;
+    }
+
+    if (!cos_base_parser_matches_next_token(&(parser->base),
+                                            CosToken_Type_EndStream,
+                                            out_error)) {
+        COS_ERROR_PROPAGATE(cos_error_make(COS_ERROR_SYNTAX,
+                                           "Expected an endstream token"),
+                            out_error);
+        return false;
+    }
+    cos_base_parser_advance(&(parser->base));
+    return true;
+}
+
 // NOLINTEND(misc-no-recursion)
 
 COS_ASSUME_NONNULL_END
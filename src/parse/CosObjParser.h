@@ -5,9 +5,12 @@
 #ifndef LIBCOS_COS_OBJ_PARSER_H
 #define LIBCOS_COS_OBJ_PARSER_H
 
+#include <libcos/common/CosBasicTypes.h>
 #include <libcos/common/CosDefines.h>
 #include <libcos/common/CosError.h>
 #include <libcos/common/CosTypes.h>
+#include <libcos/parse/CosObjEvent.h>
+#include <libcos/syntax/tokenizer/CosToken.h>
 
 #include <stdbool.h>
 
@@ -65,6 +68,80 @@ cos_obj_parser_create_with_tokenizer(CosDoc *document,
 void
 cos_obj_parser_flush_tokens_(CosObjParser *parser);
 
+/**
+ * @brief Sets the stream that the parser's tokenizer reads from.
+ *
+ * A parser that borrows a tokenizer needs the stream to skip over stream data.
+ *
+ * @param parser The parser.
+ * @param input_stream The tokenizer's input stream. Borrowed.
+ */
+void
+cos_obj_parser_set_input_stream_(CosObjParser *parser,
+                                 CosStream *input_stream);
+
+/**
+ * @brief Sets the size of the input, which bounds the Length of stream objects.
+ *
+ * @param parser The parser.
+ * @param input_size The size of the input, or @c -1 if it is not known.
+ */
+void
+cos_obj_parser_set_input_size_(CosObjParser *parser,
+                               CosStreamOffset input_size);
+
+/**
+ * @brief Returns the offset of the parser's next token, reading the token if needed.
+ *
+ * @param parser The parser.
+ *
+ * @return The offset of the next token, or @c -1 if there is none, or if an object has already
+ * been peeked.
+ */
+CosStreamOffset
+cos_obj_parser_peek_token_offset_(CosObjParser *parser);
+
+/**
+ * @brief Sets whether stream objects are parsed without skipping their data.
+ *
+ * When enabled, parsing a stream object stops at the first byte of its data, which lets input
+ * that cannot seek be parsed. The caller must then take the pending stream with
+ * @c cos_obj_parser_take_pending_stream_ and read past the data and the endstream and endobj
+ * keywords before parsing anything else.
+ *
+ * This is disabled by default.
+ *
+ * @param parser The parser.
+ * @param enabled Whether to stop at stream data.
+ */
+void
+cos_obj_parser_set_stops_at_stream_data_(CosObjParser *parser,
+                                         bool enabled);
+
+/**
+ * @brief Takes the stream whose data the parser stopped at, if there is one.
+ *
+ * @param parser The parser.
+ * @param out_length On output, the length of the stream's data from its Length entry, or @c -1
+ * if the entry is not a direct integer.
+ *
+ * @return @c true if the last object parsed was a stream object whose data has not been read,
+ * @c false otherwise.
+ */
+bool
+cos_obj_parser_take_pending_stream_(CosObjParser *parser,
+                                    CosStreamOffset *out_length);
+
+/**
+ * @brief Returns the type of the parser's next token, reading the token if needed.
+ *
+ * @param parser The parser.
+ *
+ * @return The type of the next token, or @c CosToken_Type_EOF if there is none.
+ */
+CosToken_Type
+cos_obj_parser_peek_token_type_(CosObjParser *parser);
+
 /**
  * Checks if there is a next object or if the end of the input stream has been reached.
  *
@@ -102,6 +179,46 @@ cos_obj_parser_next_object(CosObjParser *parser,
                            CosError * COS_Nullable error)
     COS_WARN_UNUSED_RESULT;
 
+/**
+ * @brief Scans the next object, reporting its structure as events instead of building nodes.
+ *
+ * An indirect object definition is scanned without its header and endobj keyword, so the first
+ * event is for its value. Stream data is skipped by its Length entry when that is a direct
+ * integer, and otherwise by reading up to the endstream keyword.
+ *
+ * @param parser The object parser, which must not have a peeked object.
+ * @param handler The event handler.
+ * @param out_error On input, a pointer to an error object, or @c NULL.
+ *
+ * @return @c true if the object was scanned, or the handler stopped the scan, @c false if an
+ * error occurred.
+ */
+bool
+cos_obj_parser_scan_next_object(CosObjParser *parser,
+                                const CosObjEventHandler *handler,
+                                CosError * COS_Nullable out_error);
+
+/**
+ * @brief Parses the next object, keeping only some of its dictionary's entries.
+ *
+ * If the object's value is a dictionary, only the values of @p keys are parsed. The other values
+ * are skipped in the input without being tokenized. For a stream object, only the dictionary is
+ * returned, and the stream data is not read. Other values are parsed in full.
+ *
+ * @param parser The object parser, which must not have a peeked object.
+ * @param keys The keys to keep, without the leading solidus.
+ * @param key_count The number of keys in @p keys .
+ * @param out_error On input, a pointer to an error object, or @c NULL.
+ *
+ * @return The object, or @c NULL if an error occurred.
+ */
+CosObjNode * COS_Nullable
+cos_obj_parser_next_object_keys(CosObjParser *parser,
+                                const char * const *keys,
+                                size_t key_count,
+                                CosError * COS_Nullable out_error)
+    COS_WARN_UNUSED_RESULT;
+
 COS_ASSUME_NONNULL_END
 COS_DECLS_END
 
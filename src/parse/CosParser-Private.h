@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2025 OpenCOS.
+ */
+
+#ifndef LIBCOS_PARSE_COS_PARSER_PRIVATE_H
+#define LIBCOS_PARSE_COS_PARSER_PRIVATE_H
+
+#include <libcos/CosParser.h>
+#include <libcos/common/CosDefines.h>
+#include <libcos/common/CosTypes.h>
+#include <libcos/parse/CosObjEvent.h>
+
+COS_DECLS_BEGIN
+COS_ASSUME_NONNULL_BEGIN
+
+/**
+ * @brief Creates a parser for loading the objects of an already-parsed document.
+ *
+ * Unlike @c cos_parser_create , the parser does not become the document's parser: the caller
+ * owns it, and destroys it with @c cos_parser_destroy . This is used to give each concurrent
+ * reader of a document its own tokenizer and parser state.
+ *
+ * @param document The document.
+ * @param input_stream The stream to read objects from. Borrowed.
+ *
+ * @return A new parser, or @c NULL if an error occurred.
+ */
+CosParser * COS_Nullable
+cos_parser_create_context_(CosDoc *document,
+                           CosStream *input_stream);
+
+/**
+ * @brief Loads the object at @p byte_offset , carrying on from the previous load if possible.
+ *
+ * If the parser's previous load ended right before the object, and nothing has moved the input
+ * stream since, the object is parsed from there: the tokenizer keeps its buffered input, and
+ * there is no seek. Otherwise, this is the same as @c cos_parser_load_object .
+ *
+ * @param parser The parser.
+ * @param byte_offset The byte offset of the object in the input stream.
+ * @param out_error On input, a pointer to an error object, or @c NULL.
+ *
+ * @return The object, or @c NULL if an error occurred.
+ */
+CosObjNode * COS_Nullable
+cos_parser_load_next_object_(CosParser *parser,
+                             CosStreamOffset byte_offset,
+                             CosError * COS_Nullable out_error)
+    COS_ATTR_ACCESS_WRITE_ONLY(3);
+
+/**
+ * @brief Scans the object at @p byte_offset , reporting it as events instead of building nodes.
+ *
+ * Like @c cos_parser_load_next_object_ , this carries on from the previous load or scan if
+ * possible.
+ *
+ * @param parser The parser.
+ * @param byte_offset The byte offset of the object in the input stream.
+ * @param handler The event handler.
+ * @param out_error On input, a pointer to an error object, or @c NULL.
+ *
+ * @return @c true if the object was scanned, or the handler stopped the scan, @c false if an
+ * error occurred.
+ */
+bool
+cos_parser_scan_next_object_(CosParser *parser,
+                             CosStreamOffset byte_offset,
+                             const CosObjEventHandler *handler,
+                             CosError * COS_Nullable out_error);
+
+/**
+ * @brief Loads the object at @p byte_offset , keeping only some of its dictionary's entries.
+ *
+ * See @c cos_obj_parser_next_object_keys . Like @c cos_parser_load_next_object_ , this carries
+ * on from the previous load if possible.
+ *
+ * @param parser The parser.
+ * @param byte_offset The byte offset of the object in the input stream.
+ * @param keys The keys to keep, without the leading solidus.
+ * @param key_count The number of keys in @p keys .
+ * @param out_error On input, a pointer to an error object, or @c NULL.
+ *
+ * @return The object, or @c NULL if an error occurred.
+ */
+CosObjNode * COS_Nullable
+cos_parser_load_object_keys_(CosParser *parser,
+                             CosStreamOffset byte_offset,
+                             const char * const *keys,
+                             size_t key_count,
+                             CosError * COS_Nullable out_error);
+
+/**
+ * @brief Returns the stream that the parser reads from.
+ *
+ * @param parser The parser.
+ *
+ * @return The parser's input stream.
+ */
+CosStream *
+cos_parser_get_input_stream_(const CosParser *parser);
+
+/**
+ * @brief Returns the size of the parser's input.
+ *
+ * @param parser The parser.
+ *
+ * @return The size of the input, or @c -1 if it is not known.
+ */
+CosStreamOffset
+cos_parser_get_input_size_(const CosParser *parser);
+
+/**
+ * @brief Sets the size of the parser's input, which bounds the Length of stream objects.
+ *
+ * @param parser The parser.
+ * @param input_size The size of the input, or @c -1 if it is not known.
+ */
+void
+cos_parser_set_input_size_(CosParser *parser,
+                           CosStreamOffset input_size);
+
+COS_ASSUME_NONNULL_END
+COS_DECLS_END
+
+#endif /* LIBCOS_PARSE_COS_PARSER_PRIVATE_H */
@@ -8,19 +8,26 @@
 #include "common/Assert.h"
 #include "parse/CosBaseParser.h"
 #include "parse/CosObjParser.h"
+#include "parse/CosParser-Private.h"
+#include "parse/CosStreamBody.h"
 
 #include <libcos/CosDoc.h>
 #include <libcos/common/CosError.h>
 #include <libcos/common/memory/CosMemory.h>
 #include <libcos/io/CosStream.h>
 #include <libcos/objects/CosDictObjNode.h>
+#include <libcos/objects/CosIndirectObjNode.h>
+#include <libcos/objects/CosNameKey.h>
 #include <libcos/objects/CosObjNode.h>
+#include <libcos/syntax/tokenizer/CosToken.h>
 #include <libcos/syntax/tokenizer/CosTokenizer.h>
-#include <libcos/objects/CosIntObjNode.h>
 #include <libcos/xref/CosXrefTableParser.h>
+#include <libcos/xref/table/CosXrefEntry.h>
 #include <libcos/xref/table/CosXrefSection.h>
+#include <libcos/xref/table/CosXrefSubsection.h>
 #include <libcos/xref/table/CosXrefTable.h>
 
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -29,8 +36,68 @@ COS_ASSUME_NONNULL_BEGIN
 struct CosParser {
     CosBaseParser base;       /**< Owns the tokenizer; borrows the stream. */
     CosObjParser *obj_parser; /**< Borrows base.tokenizer. Owned by this parser. */
+
+    /**
+     * The position of the input stream after the last successful load, or @c -1.
+     *
+     * While the stream is still there, the tokenizer's buffered input is in sync with it.
+     */
+    CosStreamOffset resume_position;
+
+    /**
+     * The size of the input, or @c -1 if it is not known.
+     */
+    CosStreamOffset input_size;
 };
 
+/**
+ * Where a forward parse found an object.
+ */
+typedef struct CosParserForwardObjLocation {
+    CosObjNumber obj_number;
+    CosStreamOffset byte_offset;
+} CosParserForwardObjLocation;
+
+/**
+ * What a forward parse has read so far.
+ */
+typedef struct CosParserForwardState {
+    /**
+     * Where each object definition was found, in file order.
+     *
+     * This is a list rather than a table indexed by object number, so that its size follows the
+     * number of objects in the input rather than the object numbers that the input claims.
+     */
+    CosParserForwardObjLocation * COS_Nullable obj_locations;
+
+    /**
+     * The number of entries in @c obj_locations.
+     */
+    size_t obj_location_count;
+
+    /**
+     * The capacity of @c obj_locations.
+     */
+    size_t obj_location_capacity;
+
+    /**
+     * The cross-reference sections, oldest first.
+     */
+    CosXrefSection * COS_Nullable * COS_Nullable sections;
+
+    /**
+     * The number of entries in @c sections.
+     */
+    size_t section_count;
+
+    /**
+     * The newest trailer dictionary, or @c NULL.
+     */
+    CosDictObjNode * COS_Nullable trailer_dict;
+
+    CosParserForwardSummary summary;
+} CosParserForwardState;
+
 // MARK: - Forward declarations
 
 static bool
@@ -38,6 +105,12 @@ cos_parser_parse_header_(CosParser *parser,
                          CosError * COS_Nullable out_error)
     COS_ATTR_ACCESS_WRITE_ONLY(2);
 
+static bool
+cos_parser_check_header_(CosParser *parser,
+                         const unsigned char *header,
+                         size_t count,
+                         CosError * COS_Nullable out_error);
+
 static bool
 cos_parser_find_startxref_(CosParser *parser,
                            CosStreamOffset *out_xref_offset,
@@ -51,6 +124,51 @@ cos_parser_parse_xref_and_trailer_(CosParser *parser,
                                    CosError * COS_Nullable out_error)
     COS_ATTR_ACCESS_WRITE_ONLY(3);
 
+static void
+cos_parser_store_trailer_(CosParser *parser,
+                          CosDictObjNode *trailer_dict)
+    COS_OWNERSHIP_TAKES(2);
+
+static bool
+cos_parser_forward_read_object_(CosParser *parser,
+                                CosParserForwardState *state,
+                                const CosParserObjHandler *handler,
+                                bool *out_stopped,
+                                CosError * COS_Nullable out_error);
+
+static bool
+cos_parser_forward_read_xref_(CosParser *parser,
+                              CosParserForwardState *state,
+                              CosError * COS_Nullable out_error);
+
+static bool
+cos_parser_forward_record_offset_(CosParser *parser,
+                                  CosParserForwardState *state,
+                                  CosObjNumber obj_number,
+                                  CosStreamOffset offset);
+
+static CosStreamOffset
+cos_parser_forward_find_offset_(const CosParserForwardState *state,
+                                CosObjNumber obj_number);
+
+static int
+cos_parser_forward_compare_obj_locations_(const void *lhs,
+                                          const void *rhs);
+
+static bool
+cos_parser_forward_finish_(CosParser *parser,
+                           CosParserForwardState *state,
+                           CosError * COS_Nullable out_error);
+
+static bool
+cos_parser_begin_load_(CosParser *parser,
+                       CosStreamOffset byte_offset,
+                       CosError * COS_Nullable out_error);
+
+static void
+cos_parser_end_load_(CosParser *parser,
+                     bool succeeded);
+
 // MARK: - Public API
 
 CosParser *
@@ -63,15 +181,38 @@ cos_parser_create(CosDoc *document,
         return NULL;
     }
 
+    CosParser * const parser = cos_parser_create_context_(document, input_stream);
+    if (!parser) {
+        return NULL;
+    }
+
+    cos_doc_set_parser_(document, parser);
+
+    return parser;
+}
+
+CosParser *
+cos_parser_create_context_(CosDoc *document,
+                           CosStream *input_stream)
+{
+    COS_API_PARAM_CHECK(document != NULL);
+    COS_API_PARAM_CHECK(input_stream != NULL);
+    if (!document || !input_stream) {
+        return NULL;
+    }
+
+    CosAllocator * const allocator = cos_doc_get_allocator(document);
     CosParser *parser = NULL;
     CosObjParser *obj_parser = NULL;
 
-    parser = calloc(1, sizeof(CosParser));
+    parser = cos_calloc(allocator, 1, sizeof(CosParser));
     if (!parser) {
         goto failure;
     }
 
     if (!cos_base_parser_init(&(parser->base), document, input_stream)) {
+        cos_free(allocator, parser);
+        parser = NULL;
         goto failure;
     }
 
@@ -81,9 +222,11 @@ cos_parser_create(CosDoc *document,
         goto failure;
     }
 
-    parser->obj_parser = obj_parser;
+    cos_obj_parser_set_input_stream_(obj_parser, input_stream);
 
-    cos_doc_set_parser_(document, parser);
+    parser->obj_parser = obj_parser;
+    parser->resume_position = -1;
+    parser->input_size = -1;
 
     return parser;
 
@@ -112,6 +255,32 @@ cos_parser_destroy(CosParser *parser)
     cos_base_parser_destroy(&(parser->base));
 }
 
+CosStream *
+cos_parser_get_input_stream_(const CosParser *parser)
+{
+    COS_IMPL_PARAM_CHECK(parser != NULL);
+
+    return parser->base.input_stream;
+}
+
+CosStreamOffset
+cos_parser_get_input_size_(const CosParser *parser)
+{
+    COS_IMPL_PARAM_CHECK(parser != NULL);
+
+    return parser->input_size;
+}
+
+void
+cos_parser_set_input_size_(CosParser *parser,
+                           CosStreamOffset input_size)
+{
+    COS_IMPL_PARAM_CHECK(parser != NULL);
+
+    parser->input_size = input_size;
+    cos_obj_parser_set_input_size_(parser->obj_parser, input_size);
+}
+
 bool
 cos_parser_parse(CosParser *parser,
                  CosError * COS_Nullable out_error)
@@ -140,6 +309,106 @@ cos_parser_parse(CosParser *parser,
     return true;
 }
 
+bool
+cos_parser_parse_forward(CosParser *parser,
+                         const CosParserObjHandler *handler,
+                         CosParserForwardSummary * COS_Nullable out_summary,
+                         CosError * COS_Nullable out_error)
+{
+    COS_API_PARAM_CHECK(parser != NULL);
+    COS_API_PARAM_CHECK(handler != NULL);
+    if (COS_UNLIKELY(!parser || !handler)) {
+        return false;
+    }
+
+    CosAllocator * const allocator = cos_doc_get_allocator(parser->base.doc);
+
+    CosParserForwardState state;
+    memset(&state, 0, sizeof(state));
+
+    bool result = false;
+    bool stopped = false;
+
+    // The header is read through the tokenizer, since the stream cannot be rewound afterwards.
+    unsigned char header[8];
+    const size_t header_count = cos_tokenizer_read_raw(parser->base.tokenizer,
+                                                       header,
+                                                       sizeof(header));
+    if (!cos_parser_check_header_(parser, header, header_count, out_error)) {
+        return false;
+    }
+
+    parser->resume_position = -1;
+    cos_obj_parser_flush_tokens_(parser->obj_parser);
+    cos_obj_parser_set_stops_at_stream_data_(parser->obj_parser, true);
+
+    while (!stopped) {
+        const CosToken_Type token_type = cos_obj_parser_peek_token_type_(parser->obj_parser);
+        if (token_type == CosToken_Type_EOF) {
+            break;
+        }
+
+        bool succeeded = false;
+        if (token_type == CosToken_Type_IndirectDef ||
+            token_type == CosToken_Type_Integer) {
+            succeeded = cos_parser_forward_read_object_(parser,
+                                                        &state,
+                                                        handler,
+                                                        &stopped,
+                                                        out_error);
+        }
+        else if (token_type == CosToken_Type_XRef) {
+            succeeded = cos_parser_forward_read_xref_(parser,
+                                                      &state,
+                                                      out_error);
+        }
+        else if (token_type == CosToken_Type_StartXRef) {
+            // The offset after the keyword is only of use for seeking.
+            cos_obj_parser_flush_tokens_(parser->obj_parser);
+            if (cos_obj_parser_peek_token_type_(parser->obj_parser) == CosToken_Type_Integer) {
+                cos_obj_parser_flush_tokens_(parser->obj_parser);
+            }
+            succeeded = true;
+        }
+        else {
+            COS_ERROR_PROPAGATE(cos_error_make(COS_ERROR_SYNTAX,
+                                               "Unexpected token between objects"),
+                                out_error);
+        }
+
+        if (!succeeded) {
+            goto cleanup;
+        }
+    }
+
+    if (!stopped && !cos_parser_forward_finish_(parser, &state, out_error)) {
+        goto cleanup;
+    }
+
+    if (out_summary) {
+        *out_summary = state.summary;
+    }
+    result = true;
+
+cleanup:
+    cos_obj_parser_set_stops_at_stream_data_(parser->obj_parser, false);
+    CosStreamOffset pending_length = -1;
+    (void)cos_obj_parser_take_pending_stream_(parser->obj_parser, &pending_length);
+    cos_obj_parser_flush_tokens_(parser->obj_parser);
+
+    for (size_t i = 0; i < state.section_count; i++) {
+        if (state.sections[i]) {
+            cos_xref_section_destroy(COS_nonnull_cast(state.sections[i]));
+        }
+    }
+    cos_free(allocator, state.sections);
+    cos_free(allocator, state.obj_locations);
+    if (state.trailer_dict) {
+        cos_obj_node_release((CosObjNode *)state.trailer_dict);
+    }
+    return result;
+}
+
 CosObjNode *
 cos_parser_load_object(CosParser *parser,
                        CosStreamOffset byte_offset,
@@ -150,16 +419,115 @@ cos_parser_load_object(CosParser *parser,
         return NULL;
     }
 
-    CosStream * const stream = parser->base.input_stream;
+    // Objects that are close together are often already in the tokenizer's buffer.
+    if (!cos_tokenizer_seek(parser->base.tokenizer, byte_offset, out_error)) {
+        return NULL;
+    }
+    cos_obj_parser_flush_tokens_(parser->obj_parser);
+
+    CosObjNode * const obj = cos_obj_parser_next_object(parser->obj_parser, out_error);
+    cos_parser_end_load_(parser, obj != NULL);
+    return obj;
+}
+
+CosObjNode *
+cos_parser_load_next_object_(CosParser *parser,
+                             CosStreamOffset byte_offset,
+                             CosError * COS_Nullable out_error)
+{
+    COS_IMPL_PARAM_CHECK(parser != NULL);
+
+    if (!cos_parser_begin_load_(parser, byte_offset, out_error)) {
+        return NULL;
+    }
+
+    CosObjNode * const obj = cos_obj_parser_next_object(parser->obj_parser, out_error);
+    cos_parser_end_load_(parser, obj != NULL);
+    return obj;
+}
+
+bool
+cos_parser_scan_next_object_(CosParser *parser,
+                             CosStreamOffset byte_offset,
+                             const CosObjEventHandler *handler,
+                             CosError * COS_Nullable out_error)
+{
+    COS_IMPL_PARAM_CHECK(parser != NULL);
+    COS_IMPL_PARAM_CHECK(handler != NULL);
 
-    if (!cos_stream_seek(stream, byte_offset, CosStreamOffsetWhence_Set, out_error)) {
+    if (!cos_parser_begin_load_(parser, byte_offset, out_error)) {
+        return false;
+    }
+
+    const bool result = cos_obj_parser_scan_next_object(parser->obj_parser, handler, out_error);
+    cos_parser_end_load_(parser, result);
+    return result;
+}
+
+CosObjNode *
+cos_parser_load_object_keys_(CosParser *parser,
+                             CosStreamOffset byte_offset,
+                             const char * const *keys,
+                             size_t key_count,
+                             CosError * COS_Nullable out_error)
+{
+    COS_IMPL_PARAM_CHECK(parser != NULL);
+
+    if (!cos_parser_begin_load_(parser, byte_offset, out_error)) {
         return NULL;
     }
 
-    cos_tokenizer_reset(parser->base.tokenizer);
+    CosObjNode * const obj = cos_obj_parser_next_object_keys(parser->obj_parser,
+                                                             keys,
+                                                             key_count,
+                                                             out_error);
+    cos_parser_end_load_(parser, obj != NULL);
+    return obj;
+}
+
+/**
+ * Moves the parser to the object at @p byte_offset , unless the previous load ended right
+ * before it.
+ */
+static bool
+cos_parser_begin_load_(CosParser *parser,
+                       CosStreamOffset byte_offset,
+                       CosError * COS_Nullable out_error)
+{
+    COS_IMPL_PARAM_CHECK(parser != NULL);
+
+    CosStream * const stream = parser->base.input_stream;
+
+    // The next token can only be trusted if the tokenizer is still in sync with the stream.
+    // Reading it moves the stream, so a mismatch falls back to a seek.
+    if (parser->resume_position >= 0 &&
+        cos_stream_get_position(stream, NULL) == parser->resume_position &&
+        cos_obj_parser_peek_token_offset_(parser->obj_parser) == byte_offset) {
+        return true;
+    }
+
+    if (!cos_tokenizer_seek(parser->base.tokenizer, byte_offset, out_error)) {
+        return false;
+    }
     cos_obj_parser_flush_tokens_(parser->obj_parser);
+    return true;
+}
 
-    return cos_obj_parser_next_object(parser->obj_parser, out_error);
+/**
+ * Records where a load left the input stream, so that the next load can carry on from there.
+ */
+static void
+cos_parser_end_load_(CosParser *parser,
+                     bool succeeded)
+{
+    COS_IMPL_PARAM_CHECK(parser != NULL);
+
+    if (succeeded) {
+        parser->resume_position = cos_stream_get_position(parser->base.input_stream, NULL);
+    }
+    else {
+        parser->resume_position = -1;
+    }
 }
 
 // MARK: - Phase 1: Header parsing
@@ -184,7 +552,26 @@ cos_parser_parse_header_(CosParser *parser,
                                               header,
                                               sizeof(header) - 1,
                                               out_error);
-    if (bytes_read < 8) {
+
+    return cos_parser_check_header_(parser,
+                                    header,
+                                    bytes_read,
+                                    out_error);
+}
+
+/**
+ * Checks the "%PDF-M.m" header at the start of @p header , and stores its version.
+ */
+static bool
+cos_parser_check_header_(CosParser *parser,
+                         const unsigned char *header,
+                         size_t count,
+                         CosError * COS_Nullable out_error)
+{
+    COS_IMPL_PARAM_CHECK(parser != NULL);
+    COS_IMPL_PARAM_CHECK(header != NULL);
+
+    if (count < 8) {
         cos_error_propagate(out_error,
                             cos_error_make(COS_ERROR_SYNTAX,
                                            "File too short to be a PDF"));
@@ -242,6 +629,7 @@ cos_parser_find_startxref_(CosParser *parser,
                                            "Failed to determine file size"));
         return false;
     }
+    cos_parser_set_input_size_(parser, file_size);
 
     // Read up to 1024 bytes from the end of the file.
     const size_t scan_size = ((size_t)file_size < 1024u) ? (size_t)file_size : 1024u;
@@ -352,7 +740,6 @@ cos_parser_parse_xref_and_trailer_(CosParser *parser,
     COS_IMPL_PARAM_CHECK(parser != NULL);
 
     CosDoc * const doc = parser->base.doc;
-    CosStream * const stream = parser->base.input_stream;
 
     // Create the master xref table that will accumulate sections from all revisions.
     CosXrefTable *table = cos_xref_table_create();
@@ -369,11 +756,10 @@ cos_parser_parse_xref_and_trailer_(CosParser *parser,
 
     // Walk the Prev chain from newest to oldest, accumulating xref sections.
     while (true) {
-        // Seek to the xref section and reset the tokenizer.
-        if (!cos_stream_seek(stream, xref_offset, CosStreamOffsetWhence_Set, out_error)) {
+        // Move the tokenizer to the xref section.
+        if (!cos_tokenizer_seek(parser->base.tokenizer, xref_offset, out_error)) {
             goto done;
         }
-        cos_tokenizer_reset(parser->base.tokenizer);
         cos_obj_parser_flush_tokens_(parser->obj_parser);
 
         CosXrefTableParser * const xtp =
@@ -428,24 +814,18 @@ cos_parser_parse_xref_and_trailer_(CosParser *parser,
         const bool own_trailer = !first_revision;
 
         if (first_revision) {
-            cos_doc_set_trailer_dict_(doc, trailer_dict); // transfers ownership
-            CosObjNode * COS_Nullable root_obj = NULL;
-            if (cos_dict_obj_node_get_value_with_string(trailer_dict, "Root",
-                                                        &root_obj, NULL) &&
-                root_obj != NULL) {
-                cos_doc_set_root_(doc, root_obj);
-            }
+            cos_parser_store_trailer_(parser, trailer_dict); // transfers ownership
             first_revision = false;
         }
 
         // Check /Prev to decide whether to continue traversing older revisions.
         CosStreamOffset prev_offset = -1;
-        CosObjNode * COS_Nullable prev_obj = NULL;
-        if (cos_dict_obj_node_get_value_with_string(trailer_dict, "Prev",
-                                                    &prev_obj, NULL) &&
-            prev_obj != NULL &&
-            cos_obj_node_is_integer(COS_nonnull_cast(prev_obj))) {
-            const int prev_value = cos_int_obj_node_get_value((CosIntObjNode *)prev_obj);
+        CosObjValue prev_obj;
+        int prev_value = -1;
+        if (cos_dict_obj_node_lookup_with_key(trailer_dict,
+                                              cos_name_key_get_well_known(CosWellKnownName_Prev),
+                                              &prev_obj) &&
+            cos_obj_value_get_int(prev_obj, &prev_value)) {
             if (prev_value >= 0) {
                 prev_offset = (CosStreamOffset)prev_value;
             }
@@ -473,4 +853,357 @@ done:
     return result;
 }
 
+/**
+ * Stores the newest trailer dictionary on the document, along with the root that it refers to.
+ */
+static void
+cos_parser_store_trailer_(CosParser *parser,
+                          CosDictObjNode *trailer_dict)
+{
+    COS_IMPL_PARAM_CHECK(parser != NULL);
+    COS_IMPL_PARAM_CHECK(trailer_dict != NULL);
+
+    CosDoc * const doc = parser->base.doc;
+
+    cos_doc_set_trailer_dict_(doc, trailer_dict);
+
+    CosObjNode * COS_Nullable root_obj = NULL;
+    if (cos_dict_obj_node_get_value_with_key(trailer_dict,
+                                             cos_name_key_get_well_known(CosWellKnownName_Root),
+                                             &root_obj, NULL) &&
+        root_obj != NULL) {
+        cos_doc_set_root_(doc, root_obj);
+    }
+}
+
+// MARK: - Forward parsing
+
+/**
+ * Reads an indirect object, handing it and any stream data to @p handler .
+ */
+static bool
+cos_parser_forward_read_object_(CosParser *parser,
+                                CosParserForwardState *state,
+                                const CosParserObjHandler *handler,
+                                bool *out_stopped,
+                                CosError * COS_Nullable out_error)
+{
+    COS_IMPL_PARAM_CHECK(parser != NULL);
+    COS_IMPL_PARAM_CHECK(state != NULL);
+    COS_IMPL_PARAM_CHECK(handler != NULL);
+    COS_IMPL_PARAM_CHECK(out_stopped != NULL);
+
+    const CosStreamOffset offset = cos_obj_parser_peek_token_offset_(parser->obj_parser);
+
+    CosObjNode * const obj = cos_obj_parser_next_object(parser->obj_parser, out_error);
+    if (!obj) {
+        return false;
+    }
+
+    bool result = false;
+    CosStream *data = NULL;
+
+    CosObjNode * const value = (cos_obj_node_is_indirect(obj)
+                                    ? cos_indirect_obj_node_get_value((const CosIndirectObjNode *)obj)
+                                    : NULL);
+    if (!value) {
+        COS_ERROR_PROPAGATE(cos_error_make(COS_ERROR_SYNTAX,
+                                           "Expected an indirect object definition"),
+                            out_error);
+        goto cleanup;
+    }
+    const CosObjID obj_id = cos_indirect_obj_node_get_id((const CosIndirectObjNode *)obj);
+
+    if (!cos_parser_forward_record_offset_(parser, state, obj_id.obj_number, offset)) {
+        COS_ERROR_PROPAGATE(cos_error_make(COS_ERROR_MEMORY,
+                                           "Failed to record object offset"),
+                            out_error);
+        goto cleanup;
+    }
+    state->summary.obj_count++;
+
+    CosStreamOffset data_length = -1;
+    if (cos_obj_parser_take_pending_stream_(parser->obj_parser, &data_length)) {
+        data = cos_stream_body_create(parser->base.tokenizer, data_length);
+        if (!data) {
+            COS_ERROR_PROPAGATE(cos_error_make(COS_ERROR_MEMORY,
+                                               "Failed to create stream data"),
+                                out_error);
+            goto cleanup;
+        }
+    }
+
+    if (!handler->handle_object(obj_id, value, data, handler->user_data)) {
+        *out_stopped = true;
+        result = true;
+        goto cleanup;
+    }
+
+    if (data) {
+        // Skip whatever the handler did not read, to get to the endstream keyword.
+        if (!cos_stream_body_finish(COS_nonnull_cast(data), out_error)) {
+            goto cleanup;
+        }
+        // Without a length, the body stops at the keyword and consumes it.
+        if (data_length >= 0) {
+            if (cos_obj_parser_peek_token_type_(parser->obj_parser) != CosToken_Type_EndStream) {
+                COS_ERROR_PROPAGATE(cos_error_make(COS_ERROR_SYNTAX,
+                                                   "Expected endstream keyword after stream data"),
+                                    out_error);
+                goto cleanup;
+            }
+            cos_obj_parser_flush_tokens_(parser->obj_parser);
+        }
+        if (cos_obj_parser_peek_token_type_(parser->obj_parser) == CosToken_Type_EndObj) {
+            cos_obj_parser_flush_tokens_(parser->obj_parser);
+        }
+    }
+
+    result = true;
+
+cleanup:
+    if (data) {
+        cos_stream_close(COS_nonnull_cast(data));
+    }
+    cos_obj_node_release(obj);
+    return result;
+}
+
+/**
+ * Reads a cross-reference section and the trailer dictionary that follows it.
+ */
+static bool
+cos_parser_forward_read_xref_(CosParser *parser,
+                              CosParserForwardState *state,
+                              CosError * COS_Nullable out_error)
+{
+    COS_IMPL_PARAM_CHECK(parser != NULL);
+    COS_IMPL_PARAM_CHECK(state != NULL);
+
+    CosDoc * const doc = parser->base.doc;
+    CosAllocator * const allocator = cos_doc_get_allocator(doc);
+
+    // Drop the peeked xref keyword. The tokenizer is already past it.
+    cos_obj_parser_flush_tokens_(parser->obj_parser);
+
+    CosXrefTableParser * const xtp = cos_xref_table_parser_create(doc, parser->base.tokenizer);
+    if (!xtp) {
+        COS_ERROR_PROPAGATE(cos_error_make(COS_ERROR_PARSE,
+                                           "Failed to create xref table parser"),
+                            out_error);
+        return false;
+    }
+    CosXrefSection * const section = cos_xref_table_parser_parse_section_body(xtp, out_error);
+    cos_xref_table_parser_destroy(xtp);
+    if (!section) {
+        return false;
+    }
+
+    CosXrefSection ** const new_sections = cos_realloc(allocator,
+                                                       state->sections,
+                                                       (state->section_count + 1) * sizeof(CosXrefSection *));
+    if (!new_sections) {
+        cos_xref_section_destroy(section);
+        COS_ERROR_PROPAGATE(cos_error_make(COS_ERROR_MEMORY,
+                                           "Failed to add xref section"),
+                            out_error);
+        return false;
+    }
+    new_sections[state->section_count] = section;
+    state->sections = (CosXrefSection * COS_Nullable *)new_sections;
+    state->section_count++;
+    state->summary.xref_section_count++;
+
+    // The xref table parser consumed the trailer keyword.
+    CosObjNode * const trailer_obj = cos_obj_parser_next_object(parser->obj_parser, out_error);
+    if (!trailer_obj) {
+        return false;
+    }
+    if (!cos_obj_node_is_dict(trailer_obj)) {
+        cos_obj_node_release(trailer_obj);
+        COS_ERROR_PROPAGATE(cos_error_make(COS_ERROR_PARSE,
+                                           "Trailer is not a dictionary"),
+                            out_error);
+        return false;
+    }
+
+    if (state->trailer_dict) {
+        cos_obj_node_release((CosObjNode *)state->trailer_dict);
+    }
+    state->trailer_dict = (CosDictObjNode *)trailer_obj;
+    return true;
+}
+
+/**
+ * Records where an object was found.
+ */
+static bool
+cos_parser_forward_record_offset_(CosParser *parser,
+                                  CosParserForwardState *state,
+                                  CosObjNumber obj_number,
+                                  CosStreamOffset offset)
+{
+    COS_IMPL_PARAM_CHECK(parser != NULL);
+    COS_IMPL_PARAM_CHECK(state != NULL);
+
+    if (state->obj_location_count == state->obj_location_capacity) {
+        const size_t new_capacity = (state->obj_location_capacity > 0) ? state->obj_location_capacity * 2 : 64;
+        if (new_capacity > SIZE_MAX / sizeof(CosParserForwardObjLocation)) {
+            return false;
+        }
+
+        CosParserForwardObjLocation * const new_locations = cos_realloc(cos_doc_get_allocator(parser->base.doc),
+                                                                        state->obj_locations,
+                                                                        new_capacity * sizeof(CosParserForwardObjLocation));
+        if (!new_locations) {
+            return false;
+        }
+        state->obj_locations = new_locations;
+        state->obj_location_capacity = new_capacity;
+    }
+
+    CosParserForwardObjLocation * const location = &COS_nonnull_cast(state->obj_locations)[state->obj_location_count++];
+    location->obj_number = obj_number;
+    location->byte_offset = offset;
+    return true;
+}
+
+/**
+ * Returns the offset of the last definition of an object, or @c -1 if it was not found.
+ *
+ * The locations must be sorted with @c cos_parser_forward_compare_obj_locations_ .
+ */
+static CosStreamOffset
+cos_parser_forward_find_offset_(const CosParserForwardState *state,
+                                CosObjNumber obj_number)
+{
+    COS_IMPL_PARAM_CHECK(state != NULL);
+
+    // Find the first location past the object's, and step back to its last definition.
+    size_t low = 0;
+    size_t high = state->obj_location_count;
+    while (low < high) {
+        const size_t mid = low + (high - low) / 2;
+        if (COS_nonnull_cast(state->obj_locations)[mid].obj_number <= obj_number) {
+            low = mid + 1;
+        }
+        else {
+            high = mid;
+        }
+    }
+
+    if (low == 0 || COS_nonnull_cast(state->obj_locations)[low - 1].obj_number != obj_number) {
+        return -1;
+    }
+    return COS_nonnull_cast(state->obj_locations)[low - 1].byte_offset;
+}
+
+static int
+cos_parser_forward_compare_obj_locations_(const void *lhs,
+                                          const void *rhs)
+{
+    const CosParserForwardObjLocation * const lhs_location = lhs;
+    const CosParserForwardObjLocation * const rhs_location = rhs;
+
+    if (lhs_location->obj_number != rhs_location->obj_number) {
+        return (lhs_location->obj_number < rhs_location->obj_number) ? -1 : 1;
+    }
+    // Within an object, file order is offset order, so the last definition sorts last.
+    if (lhs_location->byte_offset != rhs_location->byte_offset) {
+        return (lhs_location->byte_offset < rhs_location->byte_offset) ? -1 : 1;
+    }
+    return 0;
+}
+
+/**
+ * Builds the document's cross-reference table from the sections, and checks it against the
+ * offsets where the objects were found.
+ */
+static bool
+cos_parser_forward_finish_(CosParser *parser,
+                           CosParserForwardState *state,
+                           CosError * COS_Nullable out_error)
+{
+    COS_IMPL_PARAM_CHECK(parser != NULL);
+    COS_IMPL_PARAM_CHECK(state != NULL);
+
+    if (state->section_count == 0 || !state->trailer_dict) {
+        COS_ERROR_PROPAGATE(cos_error_make(COS_ERROR_XREF,
+                                           "No cross-reference table found"),
+                            out_error);
+        return false;
+    }
+
+    CosXrefTable *table = cos_xref_table_create();
+    if (!table) {
+        COS_ERROR_PROPAGATE(cos_error_make(COS_ERROR_MEMORY,
+                                           "Failed to create xref table"),
+                            out_error);
+        return false;
+    }
+
+    // The first section to match an object wins, so the newest goes first.
+    for (size_t i = state->section_count; i > 0; i--) {
+        CosXrefSection * const section = COS_nonnull_cast(state->sections[i - 1]);
+        if (!cos_xref_table_add_section(table, section, out_error)) {
+            cos_xref_table_destroy(table);
+            return false;
+        }
+        state->sections[i - 1] = NULL;
+    }
+
+    if (state->obj_locations) {
+        qsort(COS_nonnull_cast(state->obj_locations),
+              state->obj_location_count,
+              sizeof(CosParserForwardObjLocation),
+              &cos_parser_forward_compare_obj_locations_);
+    }
+
+    // Only the newest entry for each object is checked, against the last definition found. The
+    // entries themselves are walked, as the object numbers that they claim can be far apart.
+    for (size_t section_index = 0; section_index < cos_xref_table_get_section_count(table); section_index++) {
+        const CosXrefSection * const section = cos_xref_table_get_section(table, section_index, NULL);
+        if (!section) {
+            continue;
+        }
+
+        for (size_t subsection_index = 0;
+             subsection_index < cos_xref_section_get_subsection_count(section);
+             subsection_index++) {
+            const CosXrefSubsection * const subsection = cos_xref_section_get_subsection(section,
+                                                                                         subsection_index,
+                                                                                         NULL);
+            if (!subsection) {
+                continue;
+            }
+
+            const CosObjNumber first_obj_number = cos_xref_subsection_get_first_object_number(subsection);
+            for (size_t i = 0; i < cos_xref_subsection_get_entry_count(subsection); i++) {
+                const CosXrefEntry * const entry = cos_xref_subsection_get_entry(subsection, i, NULL);
+                if (!entry || entry->type != CosXrefEntryType_InUse) {
+                    continue;
+                }
+
+                const CosObjNumber obj_number = first_obj_number + (CosObjNumber)i;
+                if (cos_xref_table_find_entry_for_obj_num(table, obj_number, NULL) != entry) {
+                    continue;
+                }
+
+                const CosStreamOffset found_offset = cos_parser_forward_find_offset_(state, obj_number);
+                if (found_offset < 0) {
+                    state->summary.missing_obj_count++;
+                }
+                else if (found_offset != (CosStreamOffset)entry->value.in_use.byte_offset) {
+                    state->summary.moved_obj_count++;
+                }
+            }
+        }
+    }
+
+    cos_doc_set_xref_table_(parser->base.doc, table);
+    cos_parser_store_trailer_(parser, COS_nonnull_cast(state->trailer_dict));
+    state->trailer_dict = NULL;
+    return true;
+}
+
 COS_ASSUME_NONNULL_END
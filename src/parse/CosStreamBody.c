@@ -0,0 +1,279 @@
+/*
+ * Copyright (c) 2025 OpenCOS.
+ */
+
+#include "parse/CosStreamBody.h"
+
+#include "common/Assert.h"
+
+#include <libcos/common/CosError.h>
+#include <libcos/syntax/tokenizer/CosTokenizer.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+COS_ASSUME_NONNULL_BEGIN
+
+enum {
+    /**
+     * The length of the longest end marker, "\r\nendstream".
+     */
+    COS_STREAM_BODY_MAX_END_MARKER_LENGTH_ = 11,
+};
+
+typedef struct CosStreamBody {
+    CosStream base;
+
+    /**
+     * The tokenizer that the data is read from. Borrowed.
+     */
+    CosTokenizer *tokenizer;
+
+    /**
+     * The length of the data, or -1 if the data runs up to the endstream keyword.
+     */
+    CosStreamOffset length;
+
+    /**
+     * The number of bytes of data that have been read.
+     */
+    CosStreamOffset position;
+
+    /**
+     * Whether the end of the data has been reached.
+     */
+    bool ended;
+
+    /**
+     * Whether the input ended before the end of the data.
+     */
+    bool truncated;
+
+    /**
+     * The bytes read past the data that may be the start of the end marker.
+     */
+    unsigned char held[COS_STREAM_BODY_MAX_END_MARKER_LENGTH_];
+
+    /**
+     * The number of bytes in @c held.
+     */
+    size_t held_count;
+} CosStreamBody;
+
+static size_t
+cos_stream_body_read_(CosStream *stream,
+                      void *buffer,
+                      size_t count,
+                      CosError * COS_Nullable out_error);
+
+static size_t
+cos_stream_body_read_scanning_(CosStreamBody *body,
+                               unsigned char *buffer,
+                               size_t count);
+
+static bool
+cos_stream_body_match_end_marker_(const unsigned char *bytes,
+                                  size_t count,
+                                  bool *out_complete);
+
+static CosStreamOffset
+cos_stream_body_tell_(CosStream *stream,
+                      CosError * COS_Nullable out_error);
+
+static bool
+cos_stream_body_eof_(CosStream *stream);
+
+CosStream *
+cos_stream_body_create(CosTokenizer *tokenizer,
+                       CosStreamOffset length)
+{
+    COS_API_PARAM_CHECK(tokenizer != NULL);
+    COS_API_PARAM_CHECK(length >= -1);
+    if (COS_UNLIKELY(!tokenizer || length < -1)) {
+        return NULL;
+    }
+
+    CosStreamBody * const body = calloc(1, sizeof(CosStreamBody));
+    if (COS_UNLIKELY(!body)) {
+        return NULL;
+    }
+
+    body->tokenizer = tokenizer;
+    body->length = length;
+    body->position = 0;
+    body->ended = (length == 0);
+
+    const CosStreamFunctions functions = {
+        .read_func = &cos_stream_body_read_,
+        .read_at_func = NULL,
+        .write_func = NULL,
+        .seek_func = NULL,
+        .tell_func = &cos_stream_body_tell_,
+        .eof_func = &cos_stream_body_eof_,
+        .close_func = NULL,
+    };
+
+    cos_stream_init(&(body->base),
+                    &functions);
+
+    return (CosStream *)body;
+}
+
+bool
+cos_stream_body_finish(CosStream *stream,
+                       CosError * COS_Nullable out_error)
+{
+    COS_API_PARAM_CHECK(stream != NULL);
+    if (COS_UNLIKELY(!stream)) {
+        return false;
+    }
+
+    CosStreamBody * const body = (CosStreamBody *)stream;
+
+    unsigned char scratch[256];
+    while (!body->ended) {
+        (void)cos_stream_body_read_(stream,
+                                    scratch,
+                                    sizeof(scratch),
+                                    NULL);
+    }
+
+    if (body->truncated) {
+        COS_ERROR_PROPAGATE(cos_error_make(COS_ERROR_SYNTAX,
+                                           "Unexpected end of input in stream data"),
+                            out_error);
+        return false;
+    }
+    return true;
+}
+
+static size_t
+cos_stream_body_read_(CosStream *stream,
+                      void *buffer,
+                      size_t count,
+                      COS_ATTR_UNUSED CosError * COS_Nullable out_error)
+{
+    COS_IMPL_PARAM_CHECK(stream != NULL);
+    COS_IMPL_PARAM_CHECK(buffer != NULL);
+
+    CosStreamBody * const body = (CosStreamBody *)stream;
+    if (body->ended) {
+        return 0;
+    }
+
+    size_t read_count = 0;
+    if (body->length < 0) {
+        read_count = cos_stream_body_read_scanning_(body,
+                                                    buffer,
+                                                    count);
+    }
+    else {
+        const CosStreamOffset remaining = body->length - body->position;
+        const size_t request_count = ((CosStreamOffset)count < remaining) ? count : (size_t)remaining;
+
+        read_count = cos_tokenizer_read_raw(body->tokenizer,
+                                            buffer,
+                                            request_count);
+        if (read_count < request_count) {
+            body->truncated = true;
+            body->ended = true;
+        }
+        else if (body->position + (CosStreamOffset)read_count == body->length) {
+            body->ended = true;
+        }
+    }
+
+    body->position += (CosStreamOffset)read_count;
+    return read_count;
+}
+
+static size_t
+cos_stream_body_read_scanning_(CosStreamBody *body,
+                               unsigned char *buffer,
+                               size_t count)
+{
+    COS_IMPL_PARAM_CHECK(body != NULL);
+    COS_IMPL_PARAM_CHECK(buffer != NULL);
+
+    // Bytes are held back for as long as they could be the start of the end marker, and handed
+    // out once they no longer can.
+    size_t read_count = 0;
+    while (read_count < count && !body->ended) {
+        bool complete = false;
+        if (body->held_count > 0 && !cos_stream_body_match_end_marker_(body->held,
+                                                                       body->held_count,
+                                                                       &complete)) {
+            buffer[read_count++] = body->held[0];
+            body->held_count--;
+            memmove(body->held, &body->held[1], body->held_count);
+            continue;
+        }
+        if (complete) {
+            body->held_count = 0;
+            body->ended = true;
+            break;
+        }
+
+        unsigned char c = 0;
+        if (cos_tokenizer_read_raw(body->tokenizer, &c, 1) == 0) {
+            body->truncated = true;
+            body->ended = true;
+            break;
+        }
+        body->held[body->held_count++] = c;
+    }
+
+    return read_count;
+}
+
+static bool
+cos_stream_body_match_end_marker_(const unsigned char *bytes,
+                                  size_t count,
+                                  bool *out_complete)
+{
+    COS_IMPL_PARAM_CHECK(bytes != NULL);
+    COS_IMPL_PARAM_CHECK(out_complete != NULL);
+
+    static const char * const end_markers[] = {
+        "endstream",
+        "\nendstream",
+        "\rendstream",
+        "\r\nendstream",
+    };
+
+    bool is_prefix = false;
+    *out_complete = false;
+    for (size_t i = 0; i < sizeof(end_markers) / sizeof(end_markers[0]); i++) {
+        const size_t marker_length = strlen(end_markers[i]);
+        if (count <= marker_length && memcmp(bytes, end_markers[i], count) == 0) {
+            is_prefix = true;
+            if (count == marker_length) {
+                *out_complete = true;
+            }
+        }
+    }
+    return is_prefix;
+}
+
+static CosStreamOffset
+cos_stream_body_tell_(CosStream *stream,
+                      COS_ATTR_UNUSED CosError * COS_Nullable out_error)
+{
+    COS_IMPL_PARAM_CHECK(stream != NULL);
+
+    const CosStreamBody * const body = (const CosStreamBody *)stream;
+
+    return body->position;
+}
+
+static bool
+cos_stream_body_eof_(CosStream *stream)
+{
+    COS_IMPL_PARAM_CHECK(stream != NULL);
+
+    const CosStreamBody * const body = (const CosStreamBody *)stream;
+
+    return body->ended;
+}
+
+COS_ASSUME_NONNULL_END
@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2025 OpenCOS.
+ */
+
+#ifndef LIBCOS_PARSE_COS_STREAM_BODY_H
+#define LIBCOS_PARSE_COS_STREAM_BODY_H
+
+#include <libcos/common/CosBasicTypes.h>
+#include <libcos/common/CosDefines.h>
+#include <libcos/common/CosError.h>
+#include <libcos/common/CosTypes.h>
+#include <libcos/io/CosStream.h>
+
+#include <stdbool.h>
+
+COS_DECLS_BEGIN
+COS_ASSUME_NONNULL_BEGIN
+
+/**
+ * @brief Creates a read-only stream of a stream object's data, read straight from a tokenizer.
+ *
+ * The data is read through the tokenizer's buffer and never seeks, so this works on input that
+ * can only be read forwards. The body borrows @p tokenizer , which must not be used for anything
+ * else until the body has been finished with @c cos_stream_body_finish .
+ *
+ * With a @p length , the body is that many bytes long. Otherwise, it runs up to the endstream
+ * keyword, without the end-of-line marker before it, and the keyword is consumed too.
+ *
+ * @param tokenizer The tokenizer, positioned at the first byte of the data.
+ * @param length The length of the data, or @c -1 to read up to the endstream keyword.
+ *
+ * @return A new stream, or @c NULL if an error occurred. Close it with @c cos_stream_close .
+ */
+CosStream * COS_Nullable
+cos_stream_body_create(CosTokenizer *tokenizer,
+                       CosStreamOffset length)
+    COS_ALLOCATOR_FUNC
+    COS_ALLOCATOR_FUNC_MATCHED_DEALLOC(cos_stream_close);
+
+/**
+ * @brief Skips the rest of a body, leaving its tokenizer after the data.
+ *
+ * @param stream The body.
+ * @param out_error On input, a pointer to an error object, or @c NULL.
+ *
+ * @return @c true if the whole body was read, @c false if the input ended first.
+ */
+bool
+cos_stream_body_finish(CosStream *stream,
+                       CosError * COS_Nullable out_error);
+
+COS_ASSUME_NONNULL_END
+COS_DECLS_END
+
+#endif /* LIBCOS_PARSE_COS_STREAM_BODY_H */
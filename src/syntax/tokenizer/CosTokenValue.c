@@ -24,6 +24,7 @@ cos_token_value_reset(CosTokenValue *token_value)
         case CosTokenValue_Type_IntegerNumber:
         case CosTokenValue_Type_LongIntegerNumber:
         case CosTokenValue_Type_RealNumber:
+        case CosTokenValue_Type_ObjID:
             break;
 
         case CosTokenValue_Type_String: {
@@ -120,6 +121,22 @@ cos_token_value_get_real_number(const CosTokenValue *token_value,
     return true;
 }
 
+bool
+cos_token_value_get_obj_id(const CosTokenValue *token_value,
+                           CosObjID *result)
+{
+    COS_API_PARAM_CHECK(token_value != NULL);
+    COS_API_PARAM_CHECK(result != NULL);
+    if (!token_value || token_value->type != CosTokenValue_Type_ObjID) {
+        return false;
+    }
+
+    if (result) {
+        *result = token_value->value.obj_id;
+    }
+    return true;
+}
+
 // MARK: - Setters
 
 void
@@ -199,6 +216,21 @@ cos_token_value_set_real_number(CosTokenValue *token_value,
     token_value->value.real_number = value;
 }
 
+void
+cos_token_value_set_obj_id(CosTokenValue *token_value,
+                           CosObjID value)
+{
+    COS_API_PARAM_CHECK(token_value != NULL);
+    if (!token_value) {
+        return;
+    }
+
+    cos_token_value_reset(token_value);
+
+    token_value->type = CosTokenValue_Type_ObjID;
+    token_value->value.obj_id = value;
+}
+
 bool
 cos_token_value_take_string(CosTokenValue *token_value,
                             CosString * COS_Nullable *result)
@@ -12,21 +12,49 @@
 #include "libcos/common/CosString.h"
 #include "libcos/syntax/CosLimits.h"
 
+#include <libcos/common/memory/CosMemory.h>
 #include <libcos/syntax/tokenizer/CosTokenValue.h>
 #include <libcos/syntax/tokenizer/CosTokenizer.h>
 
 #include <limits.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 COS_ASSUME_NONNULL_BEGIN
 
 struct CosTokenizer {
+    /**
+     * The allocator used for the tokenizer and the values of the tokens it produces.
+     */
+    CosAllocator * COS_Nullable allocator;
+
     CosStreamReader *stream_reader;
 
     bool strict;
+
+    /**
+     * Whether "12 0 R" and "12 0 obj" are read as single tokens.
+     */
+    bool combines_indirect_tokens;
+
+    /**
+     * The expected size of a literal or hex string that does not fit in a data object's
+     * inline storage.
+     *
+     * This is a running average of the sizes of recent long strings. When a string outgrows
+     * its inline storage, it grows straight to this size instead of doubling its way there.
+     */
+    size_t string_size_hint;
 };
 
+/**
+ * The size of the buffer used to read keywords.
+ *
+ * The longest keyword is 9 characters long.
+ */
+#define COS_TOKENIZER_KEYWORD_BUFFER_SIZE 16
+
 static bool
 cos_tokenizer_read_next_token_(CosTokenizer *tokenizer,
                                CosToken *token,
@@ -108,28 +136,71 @@ cos_read_number_(CosTokenizer *tokenizer,
     COS_ATTR_ACCESS_WRITE_ONLY(2)
     COS_ATTR_ACCESS_WRITE_ONLY(3);
 
-static bool
+/**
+ * Reads a regular token, such as a keyword.
+ *
+ * @param tokenizer The tokenizer.
+ * @param buffer The buffer to read the token into. It is not nul-terminated.
+ * @param buffer_size The size of @p buffer.
+ *
+ * @return The length of the token. If it is greater than @p buffer_size, only the first
+ * @p buffer_size characters were stored.
+ */
+static size_t
 cos_tokenizer_read_token_(CosTokenizer *tokenizer,
-                          CosString *string,
-                          CosError *error);
+                          char *buffer,
+                          size_t buffer_size)
+    COS_ATTR_ACCESS_WRITE_ONLY_SIZE(2, 3);
+
+static bool
+cos_tokenizer_push_string_byte_(CosTokenizer *tokenizer,
+                                CosData *data,
+                                unsigned char byte);
+
+static void
+cos_tokenizer_update_string_size_hint_(CosTokenizer *tokenizer,
+                                       size_t size);
 
 static CosToken_Type
 cos_keyword_token_type_from_string_(CosStringRef string);
 
+static bool
+cos_tokenizer_skip_literal_string_(CosTokenizer *tokenizer);
+
+static bool
+cos_tokenizer_skip_hex_string_(CosTokenizer *tokenizer);
+
+static void
+cos_tokenizer_skip_regular_characters_(CosTokenizer *tokenizer);
+
+/**
+ * Reads the rest of an indirect object reference or header that starts with the integer
+ * @p obj_number , if it is in the stream reader's buffer.
+ *
+ * @return @c true if @p token was set to an indirect object token, @c false if nothing was
+ * read.
+ */
+static bool
+cos_tokenizer_read_indirect_suffix_(CosTokenizer *tokenizer,
+                                    int obj_number,
+                                    CosToken *token);
+
 // MARK: - Public
 
 CosTokenizer *
-cos_tokenizer_create(CosStream *input_stream)
+cos_tokenizer_create(CosAllocator * COS_Nullable allocator,
+                     CosStream *input_stream)
 {
     COS_API_PARAM_CHECK(input_stream != NULL);
 
     CosTokenizer *tokenizer = NULL;
     CosStreamReader *stream_reader = NULL;
 
-    tokenizer = calloc(1, sizeof(CosTokenizer));
+    tokenizer = cos_calloc(allocator, 1, sizeof(CosTokenizer));
     if (!tokenizer) {
         goto failure;
     }
+    tokenizer->allocator = allocator;
 
     stream_reader = cos_stream_reader_create(input_stream);
     if (!stream_reader) {
@@ -142,7 +213,7 @@ cos_tokenizer_create(CosStream *input_stream)
 
 failure:
     if (tokenizer) {
-        free(tokenizer);
+        cos_free(allocator, tokenizer);
     }
     if (stream_reader) {
         cos_stream_reader_destroy(stream_reader);
@@ -160,7 +231,7 @@ cos_tokenizer_destroy(CosTokenizer *tokenizer)
 
     cos_stream_reader_destroy(tokenizer->stream_reader);
 
-    free(tokenizer);
+    cos_free(tokenizer->allocator, tokenizer);
 }
 
 void
@@ -174,6 +245,171 @@ cos_tokenizer_reset(CosTokenizer *tokenizer)
     cos_stream_reader_reset(tokenizer->stream_reader);
 }
 
+void
+cos_tokenizer_set_combines_indirect_tokens(CosTokenizer *tokenizer,
+                                           bool enabled)
+{
+    COS_API_PARAM_CHECK(tokenizer != NULL);
+    if (COS_UNLIKELY(!tokenizer)) {
+        return;
+    }
+
+    tokenizer->combines_indirect_tokens = enabled;
+}
+
+bool
+cos_tokenizer_seek(CosTokenizer *tokenizer,
+                   CosStreamOffset offset,
+                   CosError * COS_Nullable out_error)
+{
+    COS_API_PARAM_CHECK(tokenizer != NULL);
+    if (COS_UNLIKELY(!tokenizer)) {
+        return false;
+    }
+
+    return cos_stream_reader_seek(tokenizer->stream_reader, offset, out_error);
+}
+
+size_t
+cos_tokenizer_skip_eol(CosTokenizer *tokenizer)
+{
+    COS_API_PARAM_CHECK(tokenizer != NULL);
+    if (COS_UNLIKELY(!tokenizer)) {
+        return 0;
+    }
+
+    if (cos_tokenizer_match_(tokenizer, CosCharacterSet_LineFeed)) {
+        return 1;
+    }
+    if (cos_tokenizer_match_(tokenizer, CosCharacterSet_CarriageReturn)) {
+        return cos_tokenizer_match_(tokenizer, CosCharacterSet_LineFeed) ? 2 : 1;
+    }
+    return 0;
+}
+
+size_t
+cos_tokenizer_read_raw(CosTokenizer *tokenizer,
+                       void *buffer,
+                       size_t count)
+{
+    COS_API_PARAM_CHECK(tokenizer != NULL);
+    COS_API_PARAM_CHECK(buffer != NULL || count == 0);
+    if (COS_UNLIKELY(!tokenizer || (!buffer && count > 0))) {
+        return 0;
+    }
+
+    unsigned char * const bytes = buffer;
+    size_t read_count = 0;
+    while (read_count < count) {
+        size_t available = 0;
+        const unsigned char * const buffered = cos_stream_reader_get_buffered_bytes(tokenizer->stream_reader,
+                                                                                    &available);
+        if (!buffered) {
+            // Peeking refills the buffer.
+            if (cos_tokenizer_peek_next_char_(tokenizer) == EOF) {
+                break;
+            }
+            continue;
+        }
+
+        const size_t chunk_size = (available < count - read_count) ? available : count - read_count;
+        memcpy(&bytes[read_count], buffered, chunk_size);
+        cos_stream_reader_skip_buffered(tokenizer->stream_reader, chunk_size);
+        read_count += chunk_size;
+    }
+
+    return read_count;
+}
+
+bool
+cos_tokenizer_skip_dict_value(CosTokenizer *tokenizer,
+                              CosError * COS_Nullable out_error)
+{
+    COS_API_PARAM_CHECK(tokenizer != NULL);
+    if (COS_UNLIKELY(!tokenizer)) {
+        return false;
+    }
+
+    // The number of arrays and dictionaries that are open.
+    size_t depth = 0;
+    bool has_item = false;
+    bool runs_on = false;
+
+    while (true) {
+        CosTokenWhitespace ws = {0};
+        cos_tokenizer_skip_whitespace_and_comments_(tokenizer, &ws);
+
+        const int c = cos_tokenizer_peek_next_char_(tokenizer);
+        if (c == EOF) {
+            goto unterminated;
+        }
+
+        // A key or the end of the dictionary can only follow a complete value, but the tokens
+        // after a leading number or keyword still belong to it.
+        const bool is_regular = !cos_is_delimiter(c);
+        if (depth == 0 && has_item && !(runs_on && is_regular)) {
+            return true;
+        }
+
+        (void)cos_tokenizer_get_next_char_(tokenizer);
+        switch (c) {
+            case CosCharacterSet_LeftParenthesis: {
+                if (!cos_tokenizer_skip_literal_string_(tokenizer)) {
+                    goto unterminated;
+                }
+            } break;
+
+            case CosCharacterSet_LessThanSign: {
+                if (cos_tokenizer_match_(tokenizer, CosCharacterSet_LessThanSign)) {
+                    depth++;
+                }
+                else if (!cos_tokenizer_skip_hex_string_(tokenizer)) {
+                    goto unterminated;
+                }
+            } break;
+
+            case CosCharacterSet_LeftSquareBracket: {
+                depth++;
+            } break;
+
+            case CosCharacterSet_GreaterThanSign:
+            case CosCharacterSet_RightSquareBracket: {
+                if (depth == 0) {
+                    COS_ERROR_PROPAGATE(cos_error_make(COS_ERROR_SYNTAX,
+                                                       "Expected a dictionary value"),
+                                        out_error);
+                    return false;
+                }
+                if (c == CosCharacterSet_GreaterThanSign) {
+                    (void)cos_tokenizer_match_(tokenizer, CosCharacterSet_GreaterThanSign);
+                }
+                depth--;
+            } break;
+
+            case CosCharacterSet_Solidus: {
+                cos_tokenizer_skip_regular_characters_(tokenizer);
+            } break;
+
+            default: {
+                if (is_regular) {
+                    cos_tokenizer_skip_regular_characters_(tokenizer);
+                    if (depth == 0 && !has_item) {
+                        runs_on = true;
+                    }
+                }
+            } break;
+        }
+
+        has_item = true;
+    }
+
+unterminated:
+    COS_ERROR_PROPAGATE(cos_error_make(COS_ERROR_SYNTAX,
+                                       "Unterminated dictionary value"),
+                        out_error);
+    return false;
+}
+
 bool
 cos_tokenizer_get_next_token(CosTokenizer *tokenizer,
                              CosToken *out_token,
@@ -233,7 +469,7 @@ cos_tokenizer_read_next_token_(CosTokenizer *tokenizer,
 
         case CosCharacterSet_Solidus: {
             // This is a name.
-            CosString * const string = cos_string_alloc(0);
+            CosString * const string = cos_string_alloc(tokenizer->allocator, 0);
             if (!string) {
                 // Error: out of memory.
                 break;
@@ -256,13 +492,14 @@ cos_tokenizer_read_next_token_(CosTokenizer *tokenizer,
 
         case CosCharacterSet_LeftParenthesis: {
             // This is a literal string.
-            CosData * const data = cos_data_alloc(0);
+            CosData * const data = cos_data_alloc(tokenizer->allocator, 0);
             if (!data) {
                 // Error: out of memory.
                 break;
             }
 
             if (cos_tokenizer_read_literal_string_(tokenizer, data)) {
+                cos_tokenizer_update_string_size_hint_(tokenizer, data->size);
                 token->type = CosToken_Type_Literal_String;
                 cos_token_value_set_data(&token->value, data);
             }
@@ -281,7 +518,7 @@ cos_tokenizer_read_next_token_(CosTokenizer *tokenizer,
             }
             else {
                 // This is a hex string.
-                CosData * const data = cos_data_alloc(0);
+                CosData * const data = cos_data_alloc(tokenizer->allocator, 0);
                 if (!data) {
                     // Error: out of memory.
                     break;
@@ -289,6 +526,7 @@ cos_tokenizer_read_next_token_(CosTokenizer *tokenizer,
 
                 CosError error;
                 if (cos_tokenizer_read_hex_string_(tokenizer, data, &error)) {
+                    cos_tokenizer_update_string_size_hint_(tokenizer, data->size);
                     token->type = CosToken_Type_Hex_String;
                     cos_token_value_set_data(&token->value, data);
                 }
@@ -333,9 +571,14 @@ cos_tokenizer_read_next_token_(CosTokenizer *tokenizer,
             if (cos_read_number_(tokenizer, &number_value, &error)) {
                 // This is a number.
                 if (number_value.type == CosNumberType_Integer) {
-                    token->type = CosToken_Type_Integer;
-                    cos_token_value_set_integer_number(&token->value,
-                                                       number_value.value.integer);
+                    if (!tokenizer->combines_indirect_tokens ||
+                        !cos_tokenizer_read_indirect_suffix_(tokenizer,
+                                                             number_value.value.integer,
+                                                             token)) {
+                        token->type = CosToken_Type_Integer;
+                        cos_token_value_set_integer_number(&token->value,
+                                                           number_value.value.integer);
+                    }
                 }
                 else {
                     token->type = CosToken_Type_Real;
@@ -355,34 +598,18 @@ cos_tokenizer_read_next_token_(CosTokenizer *tokenizer,
             cos_stream_reader_ungetc(tokenizer->stream_reader);
 
             // This could be a keyword or an unknown token.
-            CosString *string = cos_string_alloc(0);
-            if (!string) {
-                // Error: out of memory.
-                break;
-            }
-
-            CosError error;
-            if (cos_tokenizer_read_token_(tokenizer, string, &error)) {
-                // This might be a keyword.
-                const CosToken_Type keyword_type = cos_keyword_token_type_from_string_(cos_string_get_ref(string));
-                if (keyword_type != CosToken_Type_Unknown) {
-                    // This is a keyword.
-                    token->type = keyword_type;
-                }
-                else {
-                    // Error: unrecognized token.
-                    token->type = CosToken_Type_Unknown;
-                }
-
-                cos_string_free(string);
+            // Keywords are short, so the token is read into a local buffer.
+            char buffer[COS_TOKENIZER_KEYWORD_BUFFER_SIZE];
+            const size_t length = cos_tokenizer_read_token_(tokenizer,
+                                                            buffer,
+                                                            sizeof(buffer));
+            if (length <= sizeof(buffer)) {
+                // This might be a keyword. If not, it is an unrecognized token.
+                token->type = cos_keyword_token_type_from_string_(cos_string_ref_make(buffer, length));
             }
             else {
-                // Error: invalid token.
+                // Error: unrecognized token.
                 token->type = CosToken_Type_Unknown;
-
-                cos_error_propagate(out_error, error);
-
-                cos_string_free(string);
             }
         } break;
     }
@@ -658,7 +885,7 @@ cos_tokenizer_read_literal_string_(CosTokenizer *tokenizer,
                 break;
         }
 
-        cos_data_push_back(data, (unsigned char)c, NULL);
+        cos_tokenizer_push_string_byte_(tokenizer, data, (unsigned char)c);
 
     continue_label:;
     }
@@ -807,7 +1034,7 @@ cos_tokenizer_read_hex_string_(CosTokenizer *tokenizer,
                 hex_value = (hex_value << 4) | hex_digit_value;
 
                 // Write the byte to the buffer.
-                cos_data_push_back(data, (unsigned char)hex_value, NULL);
+                cos_tokenizer_push_string_byte_(tokenizer, data, (unsigned char)hex_value);
 
                 // Reset the hex value.
                 hex_value = 0;
@@ -823,7 +1050,7 @@ cos_tokenizer_read_hex_string_(CosTokenizer *tokenizer,
             if (odd_number_of_hex_digits) {
                 // Write the last byte to the buffer.
                 hex_value = (hex_value << 4);
-                cos_data_push_back(data, (unsigned char)hex_value, NULL);
+                cos_tokenizer_push_string_byte_(tokenizer, data, (unsigned char)hex_value);
             }
             return true;
         }
@@ -974,30 +1201,69 @@ cos_tokenizer_skip_comment_(CosTokenizer *tokenizer)
     }
 }
 
-static bool
-cos_tokenizer_read_token_(CosTokenizer *tokenizer, CosString *string, CosError *error)
+static size_t
+cos_tokenizer_read_token_(CosTokenizer *tokenizer,
+                          char *buffer,
+                          size_t buffer_size)
 {
     COS_IMPL_PARAM_CHECK(tokenizer != NULL);
-    COS_IMPL_PARAM_CHECK(string != NULL);
+    COS_IMPL_PARAM_CHECK(buffer != NULL);
+
+    size_t length = 0;
 
     int c = EOF;
     while ((c = cos_tokenizer_get_next_char_(tokenizer)) != EOF) {
         if (cos_is_whitespace(c) || cos_is_delimiter(c)) {
             // This is the end of the token.
             cos_stream_reader_ungetc(tokenizer->stream_reader);
-            return true;
+            break;
         }
 
-        if (!cos_string_push_back(string, (char)c)) {
-            // Error: out of memory.
-            if (error) {
-                *error = cos_error_make(COS_ERROR_MEMORY, "Out of memory");
-            }
-            return false;
+        if (length < buffer_size) {
+            buffer[length] = (char)c;
+        }
+        // Keep consuming the token even if it does not fit.
+        if (length <= buffer_size) {
+            length++;
         }
     }
 
-    return true;
+    return length;
+}
+
+static bool
+cos_tokenizer_push_string_byte_(CosTokenizer *tokenizer,
+                                CosData *data,
+                                unsigned char byte)
+{
+    COS_IMPL_PARAM_CHECK(tokenizer != NULL);
+    COS_IMPL_PARAM_CHECK(data != NULL);
+
+    if (COS_UNLIKELY(data->size == data->capacity) &&
+        data->bytes == data->inline_bytes &&
+        tokenizer->string_size_hint > data->capacity) {
+        // The string is about to outgrow its inline storage. If this fails, the push below
+        // will try again with a smaller buffer.
+        (void)cos_data_reserve(data, tokenizer->string_size_hint, NULL);
+    }
+
+    return cos_data_push_back(data, byte, NULL);
+}
+
+static void
+cos_tokenizer_update_string_size_hint_(CosTokenizer *tokenizer,
+                                       size_t size)
+{
+    COS_IMPL_PARAM_CHECK(tokenizer != NULL);
+
+    if (size <= COS_DATA_INLINE_CAPACITY) {
+        // Short strings do not need a hint.
+        return;
+    }
+
+    // Move a quarter of the way towards the new size.
+    const size_t hint = tokenizer->string_size_hint;
+    tokenizer->string_size_hint = hint - (hint / 4) + (size / 4);
 }
 
 static CosToken_Type
@@ -1072,4 +1338,128 @@ cos_keyword_token_type_from_string_(CosStringRef string)
     return CosToken_Type_Unknown;
 }
 
+static bool
+cos_tokenizer_read_indirect_suffix_(CosTokenizer *tokenizer,
+                                    int obj_number,
+                                    CosToken *token)
+{
+    COS_IMPL_PARAM_CHECK(tokenizer != NULL);
+    COS_IMPL_PARAM_CHECK(token != NULL);
+
+    if (obj_number < 0) {
+        return false;
+    }
+
+    size_t count = 0;
+    const unsigned char * const bytes = cos_stream_reader_get_buffered_bytes(tokenizer->stream_reader,
+                                                                             &count);
+    if (!bytes) {
+        return false;
+    }
+
+    // The shortest match is " 0 R" followed by a delimiter.
+    size_t i = 0;
+    if (count < 5 || bytes[i++] != CosCharacterSet_Space) {
+        return false;
+    }
+
+    long long gen_number = 0;
+    const size_t gen_start = i;
+    while (i < count && cos_is_decimal_digit(bytes[i])) {
+        gen_number = gen_number * 10 + (bytes[i] - CosCharacterSet_DigitZero);
+        if (gen_number > INT_MAX) {
+            return false;
+        }
+        i++;
+    }
+    if (i == gen_start || i >= count || bytes[i++] != CosCharacterSet_Space) {
+        return false;
+    }
+
+    CosToken_Type type = CosToken_Type_Unknown;
+    if (i < count && bytes[i] == 'R') {
+        type = CosToken_Type_IndirectRef;
+        i += 1;
+    }
+    else if (count - i >= 3 && memcmp(&bytes[i], "obj", 3) == 0) {
+        type = CosToken_Type_IndirectDef;
+        i += 3;
+    }
+    else {
+        return false;
+    }
+
+    // The keyword must end here. If the buffer ends first, the general path decides.
+    if (i >= count ||
+        !(cos_is_whitespace(bytes[i]) || cos_is_delimiter(bytes[i]))) {
+        return false;
+    }
+
+    cos_stream_reader_skip_buffered(tokenizer->stream_reader, i);
+
+    token->type = type;
+    cos_token_value_set_obj_id(&token->value,
+                               cos_obj_id_make((unsigned int)obj_number,
+                                               (unsigned int)gen_number));
+    return true;
+}
+
+static bool
+cos_tokenizer_skip_literal_string_(CosTokenizer *tokenizer)
+{
+    COS_IMPL_PARAM_CHECK(tokenizer != NULL);
+
+    unsigned int nested_parentheses_level = 0;
+
+    int c = EOF;
+    while ((c = cos_tokenizer_get_next_char_(tokenizer)) != EOF) {
+        if (c == CosCharacterSet_ReverseSolidus) {
+            // The escaped character cannot open or close the string.
+            if (cos_tokenizer_get_next_char_(tokenizer) == EOF) {
+                return false;
+            }
+        }
+        else if (c == CosCharacterSet_LeftParenthesis) {
+            nested_parentheses_level++;
+        }
+        else if (c == CosCharacterSet_RightParenthesis) {
+            if (nested_parentheses_level == 0) {
+                return true;
+            }
+            nested_parentheses_level--;
+        }
+    }
+
+    return false;
+}
+
+static bool
+cos_tokenizer_skip_hex_string_(CosTokenizer *tokenizer)
+{
+    COS_IMPL_PARAM_CHECK(tokenizer != NULL);
+
+    int c = EOF;
+    while ((c = cos_tokenizer_get_next_char_(tokenizer)) != EOF) {
+        if (c == CosCharacterSet_GreaterThanSign) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static void
+cos_tokenizer_skip_regular_characters_(CosTokenizer *tokenizer)
+{
+    COS_IMPL_PARAM_CHECK(tokenizer != NULL);
+
+    int c = EOF;
+    while ((c = cos_tokenizer_peek_next_char_(tokenizer)) != EOF) {
+        if (cos_is_whitespace(c) || cos_is_delimiter(c)) {
+            break;
+        }
+        (void)cos_tokenizer_get_next_char_(tokenizer);
+    }
+}
+
 COS_ASSUME_NONNULL_END
@@ -104,6 +104,18 @@ cos_xref_table_parser_parse_section(CosXrefTableParser *parser,
     }
     cos_base_parser_advance(&(parser->base));
 
+    return cos_xref_table_parser_parse_section_body(parser, out_error);
+}
+
+CosXrefSection *
+cos_xref_table_parser_parse_section_body(CosXrefTableParser *parser,
+                                         CosError * COS_Nullable out_error)
+{
+    COS_API_PARAM_CHECK(parser != NULL);
+    if (COS_UNLIKELY(!parser)) {
+        return NULL;
+    }
+
     CosXrefSection *section = cos_xref_section_create();
     if (COS_UNLIKELY(!section)) {
         return NULL;
@@ -183,7 +195,8 @@ cos_xref_table_parser_parse_subsection_(CosXrefTableParser *parser,
 
     // The entries array uses a release callback so that cos_array_destroy
     // frees each CosXrefEntry on cleanup.
-    entries = cos_array_create(sizeof(CosXrefEntry *),
+    entries = cos_array_create(NULL,
+                               sizeof(CosXrefEntry *),
                                &cos_xref_entry_array_callbacks_,
                                entry_count);
     if (COS_UNLIKELY(!entries)) {
@@ -27,7 +27,8 @@ cos_xref_section_create(void)
         goto failure;
     }
 
-    subsections = cos_array_create(sizeof(CosXrefSubsection *),
+    subsections = cos_array_create(NULL,
+                                   sizeof(CosXrefSubsection *),
                                    NULL,
                                    0);
     if (COS_UNLIKELY(!subsections)) {
@@ -31,7 +31,7 @@ cos_xref_table_create(void)
         goto failure;
     }
 
-    sections = cos_array_create(sizeof(CosXrefSection *), NULL, 0);
+    sections = cos_array_create(NULL, sizeof(CosXrefSection *), NULL, 0);
     if (COS_UNLIKELY(!sections)) {
         goto failure;
     }
@@ -110,6 +110,41 @@ cos_xref_table_add_section(CosXrefTable *table,
     return cos_array_append_item(table->sections, (void *)&section, out_error);
 }
 
+size_t
+cos_xref_table_get_obj_count(const CosXrefTable *table)
+{
+    COS_API_PARAM_CHECK(table != NULL);
+    if (COS_UNLIKELY(!table)) {
+        return 0;
+    }
+
+    size_t obj_count = 0;
+
+    const size_t section_count = cos_xref_table_get_section_count(table);
+    for (size_t si = 0; si < section_count; si++) {
+        CosXrefSection * const section = cos_xref_table_get_section(table, si, NULL);
+        if (!section) {
+            continue;
+        }
+
+        const size_t subsection_count = cos_xref_section_get_subsection_count(section);
+        for (size_t ssi = 0; ssi < subsection_count; ssi++) {
+            CosXrefSubsection * const sub = cos_xref_section_get_subsection(section, ssi, NULL);
+            if (!sub) {
+                continue;
+            }
+
+            const size_t end = (size_t)cos_xref_subsection_get_first_object_number(sub) +
+                               cos_xref_subsection_get_entry_count(sub);
+            if (end > obj_count) {
+                obj_count = end;
+            }
+        }
+    }
+
+    return obj_count;
+}
+
 const CosXrefEntry *
 cos_xref_table_find_entry_for_obj_num(const CosXrefTable *table,
                                       CosObjNumber object_number,
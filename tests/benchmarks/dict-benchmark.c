@@ -0,0 +1,214 @@
+/*
+ * Copyright (c) 2024 OpenCOS.
+ */
+
+/*
+ * Compares the insert and lookup throughput of CosDict against the linear-probing table
+ * that it replaced.
+ *
+ * Usage: libcos-dict-benchmark [entry-count] [rounds]
+ */
+
+#include "linear-dict.h"
+
+#include <libcos/common/CosDict.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+// MARK: - Keys
+
+static size_t
+int_key_hash_(void *key)
+{
+    return (size_t)key;
+}
+
+static bool
+int_keys_equal_(void *key1,
+                void *key2)
+{
+    return key1 == key2;
+}
+
+static const CosDictKeyCallbacks k_int_key_callbacks = {
+    .hash = &int_key_hash_,
+    .retain = NULL,
+    .release = NULL,
+    .equal = &int_keys_equal_,
+};
+
+static const CosDictValueCallbacks k_value_callbacks = {
+    .retain = NULL,
+    .release = NULL,
+    .equal = NULL,
+};
+
+static bool g_scatter_keys = false;
+
+/**
+ * Returns the key for index @a i.
+ *
+ * Sequential keys look like object numbers, and are the best case for linear probing.
+ * Scattered keys look like pointers and string hashes, which collide far more.
+ */
+static void *
+key_at_(size_t i)
+{
+    uint64_t key = (uint64_t)(i + 1);
+    if (g_scatter_keys) {
+        key *= UINT64_C(0x9E3779B97F4A7C15);
+        key ^= key >> 29;
+        key |= 1;
+    }
+    return (void *)(uintptr_t)key;
+}
+
+// MARK: - Timing
+
+static double
+seconds_since_(clock_t start)
+{
+    return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+static void
+report_(const char *name,
+        size_t operation_count,
+        double seconds)
+{
+    const double mops = (seconds > 0.0) ? ((double)operation_count / seconds) / 1e6 : 0.0;
+    printf("%-24s %10.3f s %10.2f Mops/s\n", name, seconds, mops);
+}
+
+// MARK: - Benchmarks
+
+static bool
+run_cos_dict_(size_t entry_count,
+              size_t rounds,
+              size_t *checksum)
+{
+    size_t insert_ops = 0;
+    size_t lookup_ops = 0;
+    double insert_seconds = 0.0;
+    double lookup_seconds = 0.0;
+
+    for (size_t round = 0; round < rounds; round++) {
+        CosDict * const dict = cos_dict_create(NULL, &k_int_key_callbacks, &k_value_callbacks, 0);
+        if (!dict) {
+            return false;
+        }
+
+        clock_t start = clock();
+        for (size_t i = 0; i < entry_count; i++) {
+            if (!cos_dict_set(dict, key_at_(i), key_at_(i), NULL)) {
+                cos_dict_destroy(dict);
+                return false;
+            }
+        }
+        insert_seconds += seconds_since_(start);
+        insert_ops += entry_count;
+
+        start = clock();
+        // Half of the lookups hit, half miss.
+        for (size_t i = 0; i < entry_count * 2; i++) {
+            void *value = NULL;
+            if (cos_dict_get(dict, key_at_(i), &value, NULL)) {
+                *checksum += (size_t)(uintptr_t)value;
+            }
+        }
+        lookup_seconds += seconds_since_(start);
+        lookup_ops += entry_count * 2;
+
+        cos_dict_destroy(dict);
+    }
+
+    report_("CosDict insert", insert_ops, insert_seconds);
+    report_("CosDict lookup", lookup_ops, lookup_seconds);
+    return true;
+}
+
+static bool
+run_linear_dict_(size_t entry_count,
+                 size_t rounds,
+                 size_t *checksum)
+{
+    size_t insert_ops = 0;
+    size_t lookup_ops = 0;
+    double insert_seconds = 0.0;
+    double lookup_seconds = 0.0;
+
+    for (size_t round = 0; round < rounds; round++) {
+        LinearDict dict;
+        if (!linear_dict_init(&dict, &k_int_key_callbacks)) {
+            return false;
+        }
+
+        clock_t start = clock();
+        for (size_t i = 0; i < entry_count; i++) {
+            if (!linear_dict_set(&dict, key_at_(i), key_at_(i))) {
+                linear_dict_deinit(&dict);
+                return false;
+            }
+        }
+        insert_seconds += seconds_since_(start);
+        insert_ops += entry_count;
+
+        start = clock();
+        for (size_t i = 0; i < entry_count * 2; i++) {
+            void *value = NULL;
+            if (linear_dict_get(&dict, key_at_(i), &value)) {
+                *checksum += (size_t)(uintptr_t)value;
+            }
+        }
+        lookup_seconds += seconds_since_(start);
+        lookup_ops += entry_count * 2;
+
+        linear_dict_deinit(&dict);
+    }
+
+    report_("Linear probing insert", insert_ops, insert_seconds);
+    report_("Linear probing lookup", lookup_ops, lookup_seconds);
+    return true;
+}
+
+int
+main(int argc,
+     char *argv[])
+{
+    size_t entry_count = 100000;
+    size_t rounds = 20;
+
+    if (argc > 1) {
+        entry_count = (size_t)strtoul(argv[1], NULL, 10);
+    }
+    if (argc > 2) {
+        rounds = (size_t)strtoul(argv[2], NULL, 10);
+    }
+
+    for (int scatter = 0; scatter < 2; scatter++) {
+        g_scatter_keys = (scatter != 0);
+        printf("%zu %s keys, %zu rounds\n",
+               entry_count,
+               g_scatter_keys ? "scattered" : "sequential",
+               rounds);
+
+        size_t cos_checksum = 0;
+        size_t linear_checksum = 0;
+        if (!run_cos_dict_(entry_count, rounds, &cos_checksum) ||
+            !run_linear_dict_(entry_count, rounds, &linear_checksum)) {
+            fprintf(stderr, "Allocation failed\n");
+            return EXIT_FAILURE;
+        }
+
+        if (cos_checksum != linear_checksum) {
+            fprintf(stderr, "Checksum mismatch\n");
+            return EXIT_FAILURE;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
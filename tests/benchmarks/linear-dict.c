@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2024 OpenCOS.
+ */
+
+#include "linear-dict.h"
+
+#include <stdlib.h>
+
+static LinearDictEntry *
+linear_dict_find_entry_(const LinearDict *dict,
+                        void *key,
+                        size_t hash)
+{
+    size_t index = hash % dict->capacity;
+    while (true) {
+        LinearDictEntry * const entry = &dict->entries[index];
+        if (entry->key == NULL || dict->key_callbacks.equal(entry->key, key)) {
+            return entry;
+        }
+        index = (index + 1) % dict->capacity;
+    }
+}
+
+bool
+linear_dict_init(LinearDict *dict,
+                 const CosDictKeyCallbacks *key_callbacks)
+{
+    dict->capacity = 16;
+    dict->count = 0;
+    dict->key_callbacks = *key_callbacks;
+    dict->entries = calloc(dict->capacity, sizeof(LinearDictEntry));
+    return dict->entries != NULL;
+}
+
+void
+linear_dict_deinit(LinearDict *dict)
+{
+    free(dict->entries);
+    dict->entries = NULL;
+}
+
+static bool
+linear_dict_grow_(LinearDict *dict)
+{
+    LinearDictEntry * const old_entries = dict->entries;
+    const size_t old_capacity = dict->capacity;
+
+    LinearDictEntry * const new_entries = calloc(old_capacity * 2, sizeof(LinearDictEntry));
+    if (!new_entries) {
+        return false;
+    }
+
+    dict->entries = new_entries;
+    dict->capacity = old_capacity * 2;
+
+    for (size_t i = 0; i < old_capacity; i++) {
+        if (old_entries[i].key == NULL) {
+            continue;
+        }
+        LinearDictEntry * const entry = linear_dict_find_entry_(dict,
+                                                                old_entries[i].key,
+                                                                dict->key_callbacks.hash(old_entries[i].key));
+        *entry = old_entries[i];
+    }
+
+    free(old_entries);
+    return true;
+}
+
+bool
+linear_dict_set(LinearDict *dict,
+                void *key,
+                void *value)
+{
+    if (dict->count >= (dict->capacity / 4) * 3) {
+        if (!linear_dict_grow_(dict)) {
+            return false;
+        }
+    }
+
+    LinearDictEntry * const entry = linear_dict_find_entry_(dict,
+                                                            key,
+                                                            dict->key_callbacks.hash(key));
+    if (entry->key == NULL) {
+        dict->count++;
+    }
+    entry->key = key;
+    entry->value = value;
+    return true;
+}
+
+bool
+linear_dict_get(const LinearDict *dict,
+                void *key,
+                void **out_value)
+{
+    const LinearDictEntry * const entry = linear_dict_find_entry_(dict,
+                                                                  key,
+                                                                  dict->key_callbacks.hash(key));
+    if (entry->key == NULL) {
+        return false;
+    }
+    *out_value = entry->value;
+    return true;
+}
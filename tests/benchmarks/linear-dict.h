@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) 2024 OpenCOS.
+ */
+
+#ifndef LIBCOS_TESTS_BENCHMARKS_LINEAR_DICT_H
+#define LIBCOS_TESTS_BENCHMARKS_LINEAR_DICT_H
+
+#include <libcos/common/CosDict.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/*
+ * The linear-probing hash table that CosDict used before it moved to control-byte groups,
+ * kept as a reference point for the benchmarks. It lives in its own translation unit so
+ * that, like CosDict, it is called through real function calls and callbacks.
+ */
+
+typedef struct LinearDictEntry {
+    void *key;
+    void *value;
+} LinearDictEntry;
+
+typedef struct LinearDict {
+    LinearDictEntry *entries;
+    size_t capacity;
+    size_t count;
+    CosDictKeyCallbacks key_callbacks;
+} LinearDict;
+
+bool
+linear_dict_init(LinearDict *dict,
+                 const CosDictKeyCallbacks *key_callbacks);
+
+void
+linear_dict_deinit(LinearDict *dict);
+
+bool
+linear_dict_set(LinearDict *dict,
+                void *key,
+                void *value);
+
+bool
+linear_dict_get(const LinearDict *dict,
+                void *key,
+                void **out_value);
+
+#endif /* LIBCOS_TESTS_BENCHMARKS_LINEAR_DICT_H */
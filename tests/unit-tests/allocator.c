@@ -0,0 +1,363 @@
+/*
+ * Copyright (c) 2025 OpenCOS.
+ */
+
+#include "CosTest.h"
+
+#include <libcos/CosDoc.h>
+#include <libcos/CosObjID.h>
+#include <libcos/CosParser.h>
+#include <libcos/common/CosError.h>
+#include <libcos/common/memory/CosAllocator.h>
+#include <libcos/common/memory/CosMemory.h>
+#include <libcos/io/CosMemoryStream.h>
+#include <libcos/io/CosStream.h>
+#include <libcos/objects/CosIndirectObjNode.h>
+#include <libcos/objects/CosIntObjNode.h>
+#include <libcos/objects/CosObjNode.h>
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+COS_ASSUME_NONNULL_BEGIN
+
+// MARK: - Counting allocator
+
+typedef struct CountingAllocatorStats {
+    size_t alloc_count;
+    size_t dealloc_count;
+} CountingAllocatorStats;
+
+static void * COS_Nullable
+counting_alloc_(size_t size,
+                void * COS_Nullable user_data)
+{
+    CountingAllocatorStats * const stats = user_data;
+    if (stats) {
+        stats->alloc_count++;
+    }
+    return malloc(size);
+}
+
+static void * COS_Nullable
+counting_realloc_(void * COS_Nullable ptr,
+                  size_t size,
+                  void * COS_Nullable user_data)
+{
+    CountingAllocatorStats * const stats = user_data;
+    if (stats && !ptr) {
+        stats->alloc_count++;
+    }
+    return realloc(ptr, size);
+}
+
+static void
+counting_dealloc_(void *ptr,
+                  void * COS_Nullable user_data)
+{
+    CountingAllocatorStats * const stats = user_data;
+    if (stats) {
+        stats->dealloc_count++;
+    }
+    free(ptr);
+}
+
+static const CosAllocatorCallbacks k_counting_callbacks = {
+    .alloc = &counting_alloc_,
+    .realloc = &counting_realloc_,
+    .dealloc = &counting_dealloc_,
+    .retain = NULL,
+    .release = NULL,
+};
+
+// MARK: - Test PDF
+
+/*
+ * PDF with one indirect array object: 1 0 obj [1 2 3 4 5 6 7 8] endobj
+ *
+ * Byte layout:
+ *   offset   0 : %PDF-1.0\n                          (9 bytes)
+ *   offset   9 : 1 0 obj\n[1 2 3 4 5 6 7 8]\nendobj\n (33 bytes)
+ *   offset  42 : xref\n                              (5 bytes)
+ */
+static const char k_pdf_array_obj[] =
+    "%PDF-1.0\n"
+    "1 0 obj\n[1 2 3 4 5 6 7 8]\nendobj\n"
+    "xref\n"
+    "0 2\n"
+    "0000000000 65535 f \n"
+    "0000000009 00000 n \n"
+    "trailer\n"
+    "<< /Size 2 >>\n"
+    "startxref\n"
+    "42\n"
+    "%%EOF";
+
+// MARK: - Tests
+
+static int
+arenaAlloc_multipleAllocations_areAlignedAndDistinct(void)
+{
+    CosAllocator *arena = cos_allocator_create_arena(NULL, 128);
+    TEST_EXPECT(arena != NULL);
+
+    unsigned char *first = cos_alloc(arena, 3);
+    unsigned char *second = cos_alloc(arena, 5);
+    TEST_EXPECT(first != NULL);
+    TEST_EXPECT(second != NULL);
+    TEST_EXPECT(first != second);
+    TEST_EXPECT(((uintptr_t)first % sizeof(void *)) == 0);
+    TEST_EXPECT(((uintptr_t)second % sizeof(void *)) == 0);
+
+    memset(first, 0xAA, 3);
+    memset(second, 0xBB, 5);
+    TEST_EXPECT(first[2] == 0xAA);
+    TEST_EXPECT(second[0] == 0xBB);
+
+    // Allocations larger than the block size get their own block.
+    unsigned char *large = cos_alloc(arena, 1024);
+    TEST_EXPECT(large != NULL);
+    memset(large, 0xCC, 1024);
+
+    cos_allocator_destroy(arena);
+
+    return EXIT_SUCCESS;
+}
+
+static int
+arenaRealloc_lastAllocation_growsInPlace(void)
+{
+    CosAllocator *arena = cos_allocator_create_arena(NULL, 256);
+    TEST_EXPECT(arena != NULL);
+
+    unsigned char *first = cos_alloc(arena, 8);
+    TEST_EXPECT(first != NULL);
+    memcpy(first, "abcdefg", 8);
+
+    unsigned char *grown = cos_realloc(arena, first, 32);
+    TEST_EXPECT(grown == first);
+    TEST_EXPECT(memcmp(grown, "abcdefg", 8) == 0);
+
+    cos_allocator_destroy(arena);
+
+    return EXIT_SUCCESS;
+}
+
+static int
+arenaRealloc_olderAllocation_copiesContents(void)
+{
+    CosAllocator *arena = cos_allocator_create_arena(NULL, 256);
+    TEST_EXPECT(arena != NULL);
+
+    unsigned char *first = cos_alloc(arena, 8);
+    TEST_EXPECT(first != NULL);
+    memcpy(first, "abcdefg", 8);
+
+    unsigned char *second = cos_alloc(arena, 8);
+    TEST_EXPECT(second != NULL);
+
+    unsigned char *grown = cos_realloc(arena, first, 64);
+    TEST_EXPECT(grown != NULL);
+    TEST_EXPECT(grown != first);
+    TEST_EXPECT(memcmp(grown, "abcdefg", 8) == 0);
+
+    cos_allocator_destroy(arena);
+
+    return EXIT_SUCCESS;
+}
+
+static int
+docWithArena_loadAndRelease_freesBlocksInBulk(void)
+{
+    CountingAllocatorStats stats = {0};
+    CosAllocator *parent = cos_allocator_create(NULL, &k_counting_callbacks, &stats);
+    TEST_EXPECT(parent != NULL);
+
+    CosAllocator *arena = cos_allocator_create_arena(parent, 0);
+    TEST_EXPECT(arena != NULL);
+
+    CosDoc *doc = cos_doc_create(arena);
+    TEST_EXPECT(doc != NULL);
+    TEST_EXPECT(cos_doc_get_allocator(doc) == arena);
+
+    CosMemoryStream *stream = cos_memory_stream_create_readonly(k_pdf_array_obj,
+                                                                strlen(k_pdf_array_obj));
+    TEST_EXPECT(stream != NULL);
+
+    CosParser *parser = cos_parser_create(doc, (CosStream *)stream);
+    TEST_EXPECT(parser != NULL);
+
+    CosError error = cos_error_none();
+    TEST_EXPECT(cos_parser_parse(parser, &error));
+
+    CosObjNode *obj = cos_doc_get_object(doc, cos_obj_id_make(1, 0), &error);
+    TEST_EXPECT(obj != NULL);
+    TEST_EXPECT(cos_obj_node_get_type(obj) == CosObjNodeType_Indirect);
+
+    CosObjNode *value = cos_indirect_obj_node_get_value((CosIndirectObjNode *)obj);
+    TEST_EXPECT(value != NULL);
+    TEST_EXPECT(cos_obj_node_is_array(COS_nonnull_cast(value)));
+
+    // All of the parsed nodes came from the arena, which only needed a single block.
+    const size_t parent_alloc_count = stats.alloc_count;
+    TEST_EXPECT(parent_alloc_count <= 3);
+
+    cos_obj_node_release(obj);
+    cos_doc_destroy(doc);
+    cos_stream_close((CosStream *)stream);
+
+    // Releasing the object graph does not return memory to the parent allocator.
+    TEST_EXPECT(stats.dealloc_count == 0);
+
+    cos_allocator_destroy(arena);
+    TEST_EXPECT(stats.dealloc_count == parent_alloc_count);
+
+    cos_allocator_destroy(parent);
+
+    return EXIT_SUCCESS;
+}
+
+static int
+nodeAlloc_customAllocator_isUsedForNodeAndValue(void)
+{
+    CountingAllocatorStats stats = {0};
+    CosAllocator *allocator = cos_allocator_create(NULL, &k_counting_callbacks, &stats);
+    TEST_EXPECT(allocator != NULL);
+
+    CosIntObjNode *int_node = cos_int_obj_node_alloc(allocator, 7);
+    TEST_EXPECT(int_node != NULL);
+    TEST_EXPECT(stats.alloc_count == 1);
+
+    cos_obj_node_release((CosObjNode *)int_node);
+    TEST_EXPECT(stats.dealloc_count == 1);
+
+    cos_allocator_destroy(allocator);
+
+    return EXIT_SUCCESS;
+}
+
+static int
+poolAlloc_deallocatedSlot_isReused(void)
+{
+    CosAllocator *pool = cos_allocator_create_pool(NULL);
+    TEST_EXPECT(pool != NULL);
+
+    void *first = cos_alloc(pool, 24);
+    void *second = cos_alloc(pool, 24);
+    TEST_EXPECT(first != NULL);
+    TEST_EXPECT(second != NULL);
+    TEST_EXPECT(first != second);
+    TEST_EXPECT(((uintptr_t)first % sizeof(void *)) == 0);
+
+    cos_free(pool, first);
+
+    void *third = cos_alloc(pool, 20);
+    TEST_EXPECT(third == first);
+
+    cos_free(pool, second);
+    cos_free(pool, third);
+    cos_allocator_destroy(pool);
+
+    return EXIT_SUCCESS;
+}
+
+static int
+poolRealloc_growPastSizeClass_preservesContents(void)
+{
+    CosAllocator *pool = cos_allocator_create_pool(NULL);
+    TEST_EXPECT(pool != NULL);
+
+    unsigned char *ptr = cos_alloc(pool, 10);
+    TEST_EXPECT(ptr != NULL);
+    memcpy(ptr, "abcdefghi", 10);
+
+    // Growing within the slot keeps the allocation in place.
+    TEST_EXPECT(cos_realloc(pool, ptr, 16) == ptr);
+
+    ptr = cos_realloc(pool, ptr, 40);
+    TEST_EXPECT(ptr != NULL);
+    TEST_EXPECT(memcmp(ptr, "abcdefghi", 10) == 0);
+
+    ptr = cos_realloc(pool, ptr, 4096);
+    TEST_EXPECT(ptr != NULL);
+    TEST_EXPECT(memcmp(ptr, "abcdefghi", 10) == 0);
+
+    CosPoolAllocatorStats stats = {0};
+    TEST_EXPECT(cos_allocator_get_pool_stats(pool, &stats));
+    TEST_EXPECT(stats.live_count == 0);
+    TEST_EXPECT(stats.large_live_count == 1);
+
+    cos_free(pool, ptr);
+    cos_allocator_destroy(pool);
+
+    return EXIT_SUCCESS;
+}
+
+static int
+poolStats_scalarNodes_reportLiveObjectsAndOccupancy(void)
+{
+    CosAllocator *pool = cos_allocator_create_pool(NULL);
+    TEST_EXPECT(pool != NULL);
+
+    enum { k_node_count = 100 };
+    CosIntObjNode *nodes[k_node_count] = {NULL};
+    for (int i = 0; i < k_node_count; i++) {
+        nodes[i] = cos_int_obj_node_alloc(pool, i);
+        TEST_EXPECT(nodes[i] != NULL);
+    }
+
+    CosPoolAllocatorStats stats = {0};
+    TEST_EXPECT(cos_allocator_get_pool_stats(pool, &stats));
+    TEST_EXPECT(stats.live_count == k_node_count);
+    TEST_EXPECT(stats.large_live_count == 0);
+    TEST_EXPECT(stats.slab_count == 1);
+    TEST_EXPECT(stats.slot_count >= k_node_count);
+
+    for (int i = 0; i < k_node_count; i++) {
+        cos_obj_node_release((CosObjNode *)nodes[i]);
+    }
+
+    TEST_EXPECT(cos_allocator_get_pool_stats(pool, &stats));
+    TEST_EXPECT(stats.live_count == 0);
+    TEST_EXPECT(stats.slab_count == 1);
+
+    // Nodes allocated after the releases reuse the same slab.
+    for (int i = 0; i < k_node_count; i++) {
+        nodes[i] = cos_int_obj_node_alloc(pool, i);
+        TEST_EXPECT(nodes[i] != NULL);
+    }
+
+    TEST_EXPECT(cos_allocator_get_pool_stats(pool, &stats));
+    TEST_EXPECT(stats.live_count == k_node_count);
+    TEST_EXPECT(stats.slab_count == 1);
+
+    for (int i = 0; i < k_node_count; i++) {
+        cos_obj_node_release((CosObjNode *)nodes[i]);
+    }
+
+    // Only pool allocators have pool statistics.
+    TEST_EXPECT(!cos_allocator_get_pool_stats(CosAllocatorDefault, &stats));
+
+    cos_allocator_destroy(pool);
+
+    return EXIT_SUCCESS;
+}
+
+// MARK: - Test driver
+
+TEST_MAIN()
+{
+    TEST_EXPECT(arenaAlloc_multipleAllocations_areAlignedAndDistinct() == EXIT_SUCCESS);
+    TEST_EXPECT(arenaRealloc_lastAllocation_growsInPlace() == EXIT_SUCCESS);
+    TEST_EXPECT(arenaRealloc_olderAllocation_copiesContents() == EXIT_SUCCESS);
+    TEST_EXPECT(docWithArena_loadAndRelease_freesBlocksInBulk() == EXIT_SUCCESS);
+    TEST_EXPECT(nodeAlloc_customAllocator_isUsedForNodeAndValue() == EXIT_SUCCESS);
+    TEST_EXPECT(poolAlloc_deallocatedSlot_isReused() == EXIT_SUCCESS);
+    TEST_EXPECT(poolRealloc_growPastSizeClass_preservesContents() == EXIT_SUCCESS);
+    TEST_EXPECT(poolStats_scalarNodes_reportLiveObjectsAndOccupancy() == EXIT_SUCCESS);
+
+    return EXIT_SUCCESS;
+}
+
+COS_ASSUME_NONNULL_END
@@ -43,7 +43,7 @@ static const CosDictValueCallbacks k_value_callbacks = {
 static CosDict * COS_Nullable
 create_dict_(void)
 {
-    return cos_dict_create(&k_key_callbacks, &k_value_callbacks, 0);
+    return cos_dict_create(NULL, &k_key_callbacks, &k_value_callbacks, 0);
 }
 
 // MARK: - Creation tests
@@ -134,6 +134,134 @@ get_nonExistingKey_returnsFalse(void)
     return EXIT_SUCCESS;
 }
 
+static int
+set_manyEntries_growsAndKeepsAll(void)
+{
+    CosDict * const dict = create_dict_();
+    TEST_EXPECT(dict != NULL);
+
+    const size_t entry_count = 1000;
+    for (size_t i = 1; i <= entry_count; i++) {
+        TEST_EXPECT(cos_dict_set(dict, (void *)i, (void *)(i * 10), NULL));
+    }
+    TEST_EXPECT(cos_dict_get_count(dict) == entry_count);
+
+    for (size_t i = 1; i <= entry_count; i++) {
+        void *out = NULL;
+        TEST_EXPECT(cos_dict_get(dict, (void *)i, &out, NULL));
+        TEST_EXPECT(out == (void *)(i * 10));
+    }
+
+    cos_dict_destroy(dict);
+    return EXIT_SUCCESS;
+}
+
+// MARK: - Remove tests
+
+static int
+remove_existingKey_removesEntry(void)
+{
+    CosDict * const dict = create_dict_();
+    TEST_EXPECT(dict != NULL);
+
+    cos_dict_set(dict, (void *)1, (void *)100, NULL);
+    cos_dict_set(dict, (void *)2, (void *)200, NULL);
+
+    TEST_EXPECT(cos_dict_remove(dict, (void *)1, NULL));
+    TEST_EXPECT(cos_dict_get_count(dict) == 1);
+
+    void *out = NULL;
+    TEST_EXPECT(!cos_dict_get(dict, (void *)1, &out, NULL));
+    TEST_EXPECT(cos_dict_get(dict, (void *)2, &out, NULL));
+    TEST_EXPECT(out == (void *)200);
+
+    cos_dict_destroy(dict);
+    return EXIT_SUCCESS;
+}
+
+static int
+remove_nonExistingKey_returnsFalse(void)
+{
+    CosDict * const dict = create_dict_();
+    TEST_EXPECT(dict != NULL);
+
+    cos_dict_set(dict, (void *)1, (void *)100, NULL);
+
+    TEST_EXPECT(!cos_dict_remove(dict, (void *)2, NULL));
+    TEST_EXPECT(cos_dict_get_count(dict) == 1);
+
+    cos_dict_destroy(dict);
+    return EXIT_SUCCESS;
+}
+
+static int
+remove_repeatedInsertAndRemove_keepsWorking(void)
+{
+    CosDict * const dict = create_dict_();
+    TEST_EXPECT(dict != NULL);
+
+    // Churn through many more keys than the table holds at once, so that deleted slots
+    // have to be reclaimed.
+    for (size_t i = 1; i <= 5000; i++) {
+        TEST_EXPECT(cos_dict_set(dict, (void *)i, (void *)(i * 10), NULL));
+        if (i > 8) {
+            TEST_EXPECT(cos_dict_remove(dict, (void *)(i - 8), NULL));
+        }
+    }
+    TEST_EXPECT(cos_dict_get_count(dict) == 8);
+
+    for (size_t i = 4993; i <= 5000; i++) {
+        void *out = NULL;
+        TEST_EXPECT(cos_dict_get(dict, (void *)i, &out, NULL));
+        TEST_EXPECT(out == (void *)(i * 10));
+    }
+
+    cos_dict_destroy(dict);
+    return EXIT_SUCCESS;
+}
+
+// MARK: - Ownership tests
+
+static size_t g_release_count = 0;
+
+static void
+counting_release_(void *value)
+{
+    (void)value;
+    g_release_count++;
+}
+
+static int
+set_existingKey_releasesOldKeyAndValue(void)
+{
+    const CosDictKeyCallbacks key_callbacks = {
+        .hash = &ptr_hash_,
+        .retain = NULL,
+        .release = &counting_release_,
+        .equal = &ptr_equal_,
+    };
+    const CosDictValueCallbacks value_callbacks = {
+        .retain = NULL,
+        .release = &counting_release_,
+        .equal = NULL,
+    };
+
+    CosDict * const dict = cos_dict_create(NULL, &key_callbacks, &value_callbacks, 0);
+    TEST_EXPECT(dict != NULL);
+
+    g_release_count = 0;
+    cos_dict_set(dict, (void *)1, (void *)100, NULL);
+    cos_dict_set(dict, (void *)1, (void *)200, NULL);
+    TEST_EXPECT(g_release_count == 2);
+
+    TEST_EXPECT(cos_dict_remove(dict, (void *)1, NULL));
+    TEST_EXPECT(g_release_count == 4);
+
+    cos_dict_destroy(dict);
+    TEST_EXPECT(g_release_count == 4);
+    return EXIT_SUCCESS;
+}
+
 // MARK: - Iterator tests
 
 static int
@@ -222,6 +350,15 @@ TEST_MAIN()
     TEST_EXPECT(set_duplicateKey_doesNotIncrementCount() == EXIT_SUCCESS);
     TEST_EXPECT(get_existingKey_returnsValue() == EXIT_SUCCESS);
     TEST_EXPECT(get_nonExistingKey_returnsFalse() == EXIT_SUCCESS);
+    TEST_EXPECT(set_manyEntries_growsAndKeepsAll() == EXIT_SUCCESS);
+
+    /* Remove */
+    TEST_EXPECT(remove_existingKey_removesEntry() == EXIT_SUCCESS);
+    TEST_EXPECT(remove_nonExistingKey_returnsFalse() == EXIT_SUCCESS);
+    TEST_EXPECT(remove_repeatedInsertAndRemove_keepsWorking() == EXIT_SUCCESS);
+
+    /* Ownership */
+    TEST_EXPECT(set_existingKey_releasesOldKeyAndValue() == EXIT_SUCCESS);
 
     /* Iterator */
     TEST_EXPECT(iterator_emptyDict_returnsNoEntries() == EXIT_SUCCESS);
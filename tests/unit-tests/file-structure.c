@@ -6,6 +6,7 @@
 
 #include <libcos/CosDoc.h>
 #include <libcos/CosParser.h>
+#include <libcos/CosObjID.h>
 #include <libcos/common/CosError.h>
 #include <libcos/io/CosMemoryStream.h>
 #include <libcos/io/CosStream.h>
@@ -398,6 +399,294 @@ parse_trailerObjectNotDict_ReturnsError(void)
     return EXIT_SUCCESS;
 }
 
+// MARK: - Forward parse tests
+
+/**
+ * @brief A stream that can only be read forwards, like a pipe.
+ */
+typedef struct TestPipeStream {
+    CosStream base;
+    CosStream *source;
+} TestPipeStream;
+
+static size_t
+test_pipe_stream_read_(CosStream *stream,
+                       void *buffer,
+                       size_t count,
+                       CosError * COS_Nullable out_error)
+{
+    return cos_stream_read(((TestPipeStream *)stream)->source, buffer, count, out_error);
+}
+
+static CosStreamOffset
+test_pipe_stream_tell_(CosStream *stream,
+                       CosError * COS_Nullable out_error)
+{
+    return cos_stream_get_position(((TestPipeStream *)stream)->source, out_error);
+}
+
+static bool
+test_pipe_stream_eof_(CosStream *stream)
+{
+    return cos_stream_is_at_end(((TestPipeStream *)stream)->source, NULL);
+}
+
+static CosStream * COS_Nullable
+test_pipe_stream_create_(CosStream *source)
+{
+    TestPipeStream * const pipe = calloc(1, sizeof(TestPipeStream));
+    if (!pipe) {
+        return NULL;
+    }
+    pipe->source = source;
+
+    const CosStreamFunctions functions = {
+        .read_func = &test_pipe_stream_read_,
+        .read_at_func = NULL,
+        .write_func = NULL,
+        .seek_func = NULL,
+        .tell_func = &test_pipe_stream_tell_,
+        .eof_func = &test_pipe_stream_eof_,
+        .close_func = NULL,
+    };
+    cos_stream_init(&(pipe->base), &functions);
+
+    return (CosStream *)pipe;
+}
+
+typedef struct TestForwardObjects {
+    unsigned int obj_numbers[8];
+    size_t obj_count;
+    char data[64];
+    size_t data_count;
+    bool reads_data;
+    size_t stop_after;
+} TestForwardObjects;
+
+static bool
+test_forward_handle_object_(CosObjID obj_id,
+                            COS_ATTR_UNUSED CosObjNode *obj,
+                            CosStream * COS_Nullable data,
+                            void * COS_Nullable user_data)
+{
+    TestForwardObjects * const objects = user_data;
+    if (objects->obj_count < 8) {
+        objects->obj_numbers[objects->obj_count] = obj_id.obj_number;
+    }
+    objects->obj_count++;
+
+    if (data && objects->reads_data) {
+        size_t read_count = 0;
+        do {
+            read_count = cos_stream_read(COS_nonnull_cast(data),
+                                         &objects->data[objects->data_count],
+                                         sizeof(objects->data) - 1 - objects->data_count,
+                                         NULL);
+            objects->data_count += read_count;
+        } while (read_count > 0 && objects->data_count < sizeof(objects->data) - 1);
+        objects->data[objects->data_count++] = '|';
+    }
+
+    return (objects->stop_after == 0 || objects->obj_count < objects->stop_after);
+}
+
+/**
+ * @brief Runs a forward parse of @p input through a stream that cannot seek.
+ */
+static bool
+parse_pdf_forward_(const char *input,
+                   TestForwardObjects *objects,
+                   CosParserForwardSummary *out_summary,
+                   bool *out_has_root,
+                   CosError * COS_Nullable out_error)
+{
+    CosDoc *doc = NULL;
+    CosMemoryStream *stream = NULL;
+    CosStream *pipe = NULL;
+    bool result = false;
+
+    doc = cos_doc_create(NULL);
+    if (!doc) {
+        goto cleanup;
+    }
+    stream = cos_memory_stream_create_readonly(input,
+                                               strlen(input));
+    if (!stream) {
+        goto cleanup;
+    }
+    pipe = test_pipe_stream_create_((CosStream *)stream);
+    if (!pipe) {
+        goto cleanup;
+    }
+
+    CosParser * const parser = cos_parser_create(doc, COS_nonnull_cast(pipe));
+    if (!parser) {
+        goto cleanup;
+    }
+
+    const CosParserObjHandler handler = {
+        .handle_object = &test_forward_handle_object_,
+        .user_data = objects,
+    };
+    result = cos_parser_parse_forward(parser, &handler, out_summary, out_error);
+    *out_has_root = (cos_doc_get_root(doc) != NULL);
+
+cleanup:
+    if (doc) {
+        cos_doc_destroy(doc);
+    }
+    if (pipe) {
+        cos_stream_close(COS_nonnull_cast(pipe));
+    }
+    if (stream) {
+        cos_stream_close((CosStream *)stream);
+    }
+    return result;
+}
+
+/*
+ * Object 1 is a stream with a direct Length, object 2 a stream whose Length is the indirect
+ * object 3. The objects start at offsets 9, 63 and 120, and the xref section at 137.
+ */
+#define TEST_FORWARD_PDF_OBJECTS_                                   \
+    "%PDF-1.4\n"                                                    \
+    "1 0 obj\n<< /Length 5 >>\nstream\nhello\nendstream\nendobj\n"    \
+    "2 0 obj\n<< /Length 3 0 R >>\nstream\nabc\r\nendstream\nendobj\n" \
+    "3 0 obj\n3\nendobj\n"
+
+static const char k_forward_pdf[] =
+    TEST_FORWARD_PDF_OBJECTS_
+    "xref\n"
+    "0 4\n"
+    "0000000000 65535 f \n"
+    "0000000009 00000 n \n"
+    "0000000063 00000 n \n"
+    "0000000120 00000 n \n"
+    "trailer\n"
+    "<< /Size 4 /Root 1 0 R >>\n"
+    "startxref\n"
+    "137\n"
+    "%%EOF";
+
+/* Object 3 is listed at the wrong offset, and object 4 does not exist. */
+static const char k_forward_pdf_stale_xref[] =
+    TEST_FORWARD_PDF_OBJECTS_
+    "xref\n"
+    "0 5\n"
+    "0000000000 65535 f \n"
+    "0000000009 00000 n \n"
+    "0000000063 00000 n \n"
+    "0000000100 00000 n \n"
+    "0000000130 00000 n \n"
+    "trailer\n"
+    "<< /Size 5 /Root 1 0 R >>\n"
+    "startxref\n"
+    "137\n"
+    "%%EOF";
+
+/* Object 2000000000 is at offset 29, and the xref section at 58. */
+static const char k_forward_pdf_large_obj_number[] =
+    "%PDF-1.4\n"
+    "1 0 obj\nnull\nendobj\n"
+    "2000000000 0 obj\nnull\nendobj\n"
+    "xref\n"
+    "0 2\n"
+    "0000000000 65535 f \n"
+    "0000000009 00000 n \n"
+    "2000000000 1\n"
+    "0000000029 00000 n \n"
+    "trailer\n"
+    "<< /Size 2000000001 /Root 1 0 R >>\n"
+    "startxref\n"
+    "58\n"
+    "%%EOF";
+
+static int
+parseForward_nonSeekableStream_ReadsObjectsAndStreamData(void)
+{
+    TestForwardObjects objects = {.reads_data = true};
+    CosParserForwardSummary summary = {0};
+    bool has_root = false;
+    CosError error = cos_error_none();
+
+    const bool result = parse_pdf_forward_(k_forward_pdf, &objects, &summary, &has_root, &error);
+
+    TEST_EXPECT(result);
+    TEST_EXPECT(error.code == COS_ERROR_NONE);
+    TEST_EXPECT(objects.obj_count == 3);
+    TEST_EXPECT(objects.obj_numbers[0] == 1);
+    TEST_EXPECT(objects.obj_numbers[1] == 2);
+    TEST_EXPECT(objects.obj_numbers[2] == 3);
+    TEST_EXPECT(objects.data_count == 10);
+    TEST_EXPECT(memcmp(objects.data, "hello|abc|", 10) == 0);
+
+    TEST_EXPECT(summary.obj_count == 3);
+    TEST_EXPECT(summary.xref_section_count == 1);
+    TEST_EXPECT(summary.missing_obj_count == 0);
+    TEST_EXPECT(summary.moved_obj_count == 0);
+    TEST_EXPECT(has_root);
+
+    return EXIT_SUCCESS;
+}
+
+static int
+parseForward_staleXref_CountsMissingAndMovedObjects(void)
+{
+    // The stream data is left unread, so it has to be skipped.
+    TestForwardObjects objects = {.reads_data = false};
+    CosParserForwardSummary summary = {0};
+    bool has_root = false;
+    CosError error = cos_error_none();
+
+    const bool result = parse_pdf_forward_(k_forward_pdf_stale_xref, &objects, &summary, &has_root, &error);
+
+    TEST_EXPECT(result);
+    TEST_EXPECT(objects.obj_count == 3);
+    TEST_EXPECT(summary.obj_count == 3);
+    TEST_EXPECT(summary.missing_obj_count == 1);
+    TEST_EXPECT(summary.moved_obj_count == 1);
+
+    return EXIT_SUCCESS;
+}
+
+static int
+parseForward_largeObjNumber_ReadsObject(void)
+{
+    TestForwardObjects objects = {.reads_data = false};
+    CosParserForwardSummary summary = {0};
+    bool has_root = false;
+    CosError error = cos_error_none();
+
+    const bool result = parse_pdf_forward_(k_forward_pdf_large_obj_number, &objects, &summary, &has_root, &error);
+
+    TEST_EXPECT(result);
+    TEST_EXPECT(objects.obj_count == 2);
+    TEST_EXPECT(objects.obj_numbers[1] == 2000000000);
+    TEST_EXPECT(summary.missing_obj_count == 0);
+    TEST_EXPECT(summary.moved_obj_count == 0);
+
+    return EXIT_SUCCESS;
+}
+
+static int
+parseForward_handlerStops_StopsWithoutError(void)
+{
+    TestForwardObjects objects = {.reads_data = false, .stop_after = 1};
+    CosParserForwardSummary summary = {0};
+    bool has_root = false;
+    CosError error = cos_error_none();
+
+    const bool result = parse_pdf_forward_(k_forward_pdf, &objects, &summary, &has_root, &error);
+
+    TEST_EXPECT(result);
+    TEST_EXPECT(objects.obj_count == 1);
+    TEST_EXPECT(summary.obj_count == 1);
+    TEST_EXPECT(summary.xref_section_count == 0);
+    TEST_EXPECT(!has_root);
+
+    return EXIT_SUCCESS;
+}
+
 // MARK: - Test driver
 
 TEST_MAIN()
@@ -427,6 +716,12 @@ TEST_MAIN()
     /* Trailer content */
     TEST_EXPECT(parse_trailerObjectNotDict_ReturnsError() == EXIT_SUCCESS);
 
+    /* Forward parse */
+    TEST_EXPECT(parseForward_nonSeekableStream_ReadsObjectsAndStreamData() == EXIT_SUCCESS);
+    TEST_EXPECT(parseForward_staleXref_CountsMissingAndMovedObjects() == EXIT_SUCCESS);
+    TEST_EXPECT(parseForward_largeObjNumber_ReadsObject() == EXIT_SUCCESS);
+    TEST_EXPECT(parseForward_handlerStops_StopsWithoutError() == EXIT_SUCCESS);
+
     return EXIT_SUCCESS;
 }
 
@@ -10,9 +10,11 @@
 #include <libcos/common/CosError.h>
 #include <libcos/io/CosMemoryStream.h>
 #include <libcos/io/CosStream.h>
+#include <libcos/objects/CosDictObjNode.h>
 #include <libcos/objects/CosIndirectObjNode.h>
 #include <libcos/objects/CosIntObjNode.h>
 #include <libcos/objects/CosObjNode.h>
+#include <libcos/parse/CosObjEvent.h>
 
 #include <stdlib.h>
 #include <string.h>
@@ -79,6 +81,79 @@ failure:
     return NULL;
 }
 
+/**
+ * @brief Loads object @p obj_number and checks the type of its value.
+ */
+static bool
+load_object_of_type_(CosDoc *doc,
+                     unsigned int obj_number,
+                     CosObjNodeType type)
+{
+    CosError error = cos_error_none();
+    CosObjNode * const obj = cos_doc_get_object(doc, cos_obj_id_make(obj_number, 0), &error);
+    if (!obj) {
+        return false;
+    }
+
+    bool result = false;
+    if (cos_obj_node_get_type(obj) == CosObjNodeType_Indirect) {
+        const CosObjNode * const value = cos_indirect_obj_node_get_value((CosIndirectObjNode *)obj);
+        result = (value && cos_obj_node_get_type(value) == type);
+    }
+    cos_obj_node_release(obj);
+    return result;
+}
+
+/**
+ * Records the events of a scan. Borrowed names are not kept.
+ */
+typedef struct EventLog {
+    CosObjEvent events[16];
+    size_t count;
+
+    /**
+     * The number of events after which to stop the scan, or 0 to never stop.
+     */
+    size_t stop_after;
+
+    bool has_length_key;
+} EventLog;
+
+static bool
+log_event_(const CosObjEvent *event,
+           void * COS_Nullable user_data)
+{
+    EventLog * const log = user_data;
+    if (event->type == CosObjEventType_Key &&
+        event->as.name.length == 6 &&
+        memcmp(event->as.name.data, "Length", 6) == 0) {
+        log->has_length_key = true;
+    }
+    if (log->count < 16) {
+        log->events[log->count] = *event;
+    }
+    log->count++;
+    return (log->stop_after == 0 || log->count < log->stop_after);
+}
+
+
+/**
+ * @brief Scans the next object of @p cursor into @p log, replacing the events logged before.
+ */
+static bool
+scan_next_(CosDocObjCursor *cursor,
+           EventLog *log,
+           CosObjID *out_obj_id,
+           CosError *out_error)
+{
+    log->count = 0;
+    const CosObjEventHandler handler = {
+        .handle_event = &log_event_,
+        .user_data = log,
+    };
+    return cos_doc_obj_cursor_scan_next(cursor, &handler, out_obj_id, out_error);
+}
+
 // MARK: - Test PDF
 
 /*
@@ -110,6 +185,146 @@ static const char k_pdf_one_indirect_obj[] =
     "27\n"
     "%%EOF";
 
+/*
+ * PDF whose objects are not in object-number order, with a stream:
+ *   offset  0 : %PDF-1.0\n
+ *   offset  9 : 2 0 obj << /Length 5 >> stream ... endstream endobj
+ *   offset 63 : 1 0 obj [1 2] endobj
+ *   offset 84 : xref
+ */
+static const char k_pdf_stream_first[] =
+    "%PDF-1.0\n"
+    "2 0 obj\n<< /Length 5 >>\nstream\nhello\nendstream\nendobj\n"
+    "1 0 obj\n[1 2]\nendobj\n"
+    "xref\n"
+    "0 3\n"
+    "0000000000 65535 f \n"
+    "0000000063 00000 n \n"
+    "0000000009 00000 n \n"
+    "trailer\n"
+    "<< /Size 3 /Root 1 0 R >>\n"
+    "startxref\n"
+    "84\n"
+    "%%EOF";
+
+/*
+ * PDF with a stream whose Length is an indirect reference:
+ *   offset   0 : %PDF-1.0\n
+ *   offset   9 : 2 0 obj << /Length 3 0 R >> stream ... endstream endobj
+ *   offset  67 : 3 0 obj 5 endobj
+ *   offset  84 : 1 0 obj [1 2] endobj
+ *   offset 105 : xref
+ */
+static const char k_pdf_indirect_length[] =
+    "%PDF-1.0\n"
+    "2 0 obj\n<< /Length 3 0 R >>\nstream\nhello\nendstream\nendobj\n"
+    "3 0 obj\n5\nendobj\n"
+    "1 0 obj\n[1 2]\nendobj\n"
+    "xref\n"
+    "0 4\n"
+    "0000000000 65535 f \n"
+    "0000000084 00000 n \n"
+    "0000000009 00000 n \n"
+    "0000000067 00000 n \n"
+    "trailer\n"
+    "<< /Size 4 /Root 1 0 R >>\n"
+    "startxref\n"
+    "105\n"
+    "%%EOF";
+
+/*
+ * PDF with a stream whose Length runs past the end of the input:
+ *   offset  0 : %PDF-1.0\n
+ *   offset  9 : 2 0 obj << /Length 999999 >> stream ... endstream endobj
+ *   offset 68 : 1 0 obj [1 2] endobj
+ *   offset 89 : xref
+ */
+static const char k_pdf_oversized_length[] =
+    "%PDF-1.0\n"
+    "2 0 obj\n<< /Length 999999 >>\nstream\nhello\nendstream\nendobj\n"
+    "1 0 obj\n[1 2]\nendobj\n"
+    "xref\n"
+    "0 3\n"
+    "0000000000 65535 f \n"
+    "0000000068 00000 n \n"
+    "0000000009 00000 n \n"
+    "trailer\n"
+    "<< /Size 3 /Root 1 0 R >>\n"
+    "startxref\n"
+    "89\n"
+    "%%EOF";
+
+/*
+ * PDF with a stream whose Length refers to the stream itself:
+ *   offset  0 : %PDF-1.0\n
+ *   offset  9 : 2 0 obj << /Length 2 0 R >> stream ... endstream endobj
+ *   offset 67 : 1 0 obj [1 2] endobj
+ *   offset 88 : xref
+ */
+static const char k_pdf_self_length[] =
+    "%PDF-1.0\n"
+    "2 0 obj\n<< /Length 2 0 R >>\nstream\nhello\nendstream\nendobj\n"
+    "1 0 obj\n[1 2]\nendobj\n"
+    "xref\n"
+    "0 3\n"
+    "0000000000 65535 f \n"
+    "0000000067 00000 n \n"
+    "0000000009 00000 n \n"
+    "trailer\n"
+    "<< /Size 3 /Root 1 0 R >>\n"
+    "startxref\n"
+    "88\n"
+    "%%EOF";
+
+/*
+ * PDF with two streams whose Length entries refer to each other:
+ *   offset   0 : %PDF-1.0\n
+ *   offset   9 : 2 0 obj << /Length 3 0 R >> stream ... endstream endobj
+ *   offset  67 : 3 0 obj << /Length 2 0 R >> stream ... endstream endobj
+ *   offset 125 : 1 0 obj [1 2] endobj
+ *   offset 146 : xref
+ */
+static const char k_pdf_mutual_length[] =
+    "%PDF-1.0\n"
+    "2 0 obj\n<< /Length 3 0 R >>\nstream\nhello\nendstream\nendobj\n"
+    "3 0 obj\n<< /Length 2 0 R >>\nstream\nworld\nendstream\nendobj\n"
+    "1 0 obj\n[1 2]\nendobj\n"
+    "xref\n"
+    "0 4\n"
+    "0000000000 65535 f \n"
+    "0000000125 00000 n \n"
+    "0000000009 00000 n \n"
+    "0000000067 00000 n \n"
+    "trailer\n"
+    "<< /Size 4 /Root 1 0 R >>\n"
+    "startxref\n"
+    "146\n"
+    "%%EOF";
+
+/*
+ * PDF with a page whose skipped values hold brackets inside strings and comments:
+ *   offset   0 : %PDF-1.0\n
+ *   offset   9 : 1 0 obj << /Type /Pages /Kids [2 0 R] /Count 1 >> endobj
+ *   offset  66 : 2 0 obj << /Type /Page /Contents ... /Rotate 90 >> endobj
+ *   offset 232 : xref
+ */
+static const char k_pdf_page[] =
+    "%PDF-1.0\n"
+    "1 0 obj\n<< /Type /Pages /Kids [2 0 R] /Count 1 >>\nendobj\n"
+    "2 0 obj\n<< /Type /Page /Contents (a [ >> \\) b) "
+    "/Resources << /Font << /F1 3 0 R >> /X [<41> (])] >> % ] >>\n"
+    "/Parent 1 0 R /MediaBox [0 0 612 792] /Rotate 90 >>\nendobj\n"
+    "xref\n"
+    "0 3\n"
+    "0000000000 65535 f \n"
+    "0000000009 00000 n \n"
+    "0000000066 00000 n \n"
+    "trailer\n"
+    "<< /Size 3 /Root 1 0 R >>\n"
+    "startxref\n"
+    "232\n"
+    "%%EOF";
+
 // MARK: - Tests
 
 static int
@@ -202,6 +417,248 @@ resolveIndirectObj_FreeEntry_ReturnsError(void)
     return EXIT_SUCCESS;
 }
 
+static int
+resolveIndirectObj_IndirectStreamLength_ReadsStream(void)
+{
+    CosMemoryStream *stream = NULL;
+    CosDoc *doc = parse_pdf_(k_pdf_indirect_length, &stream);
+    TEST_EXPECT(doc != NULL);
+
+    TEST_EXPECT(load_object_of_type_(doc, 2, CosObjNodeType_Stream));
+    TEST_EXPECT(load_object_of_type_(doc, 1, CosObjNodeType_Array));
+
+    cos_doc_destroy(doc);
+    cos_stream_close((CosStream *)stream);
+
+    return EXIT_SUCCESS;
+}
+
+static int
+resolveIndirectObj_StreamLengthPastEndOfInput_SkipsToEndstream(void)
+{
+    CosMemoryStream *stream = NULL;
+    CosDoc *doc = parse_pdf_(k_pdf_oversized_length, &stream);
+    TEST_EXPECT(doc != NULL);
+
+    TEST_EXPECT(load_object_of_type_(doc, 2, CosObjNodeType_Stream));
+    TEST_EXPECT(load_object_of_type_(doc, 1, CosObjNodeType_Array));
+
+    cos_doc_destroy(doc);
+    cos_stream_close((CosStream *)stream);
+
+    return EXIT_SUCCESS;
+}
+
+static int
+resolveIndirectObj_SelfReferencingStreamLength_SkipsToEndstream(void)
+{
+    CosMemoryStream *stream = NULL;
+    CosDoc *doc = parse_pdf_(k_pdf_self_length, &stream);
+    TEST_EXPECT(doc != NULL);
+
+    TEST_EXPECT(load_object_of_type_(doc, 2, CosObjNodeType_Stream));
+    TEST_EXPECT(load_object_of_type_(doc, 1, CosObjNodeType_Array));
+
+    cos_doc_destroy(doc);
+    cos_stream_close((CosStream *)stream);
+
+    return EXIT_SUCCESS;
+}
+
+static int
+resolveIndirectObj_MutuallyReferencingStreamLengths_SkipToEndstream(void)
+{
+    CosMemoryStream *stream = NULL;
+    CosDoc *doc = parse_pdf_(k_pdf_mutual_length, &stream);
+    TEST_EXPECT(doc != NULL);
+
+    TEST_EXPECT(load_object_of_type_(doc, 2, CosObjNodeType_Stream));
+    TEST_EXPECT(load_object_of_type_(doc, 3, CosObjNodeType_Stream));
+    TEST_EXPECT(load_object_of_type_(doc, 1, CosObjNodeType_Array));
+
+    cos_doc_destroy(doc);
+    cos_stream_close((CosStream *)stream);
+
+    return EXIT_SUCCESS;
+}
+
+// MARK: - Partial load tests
+
+static int
+getObjectKeys_largeDict_parsesOnlyRequestedKeys(void)
+{
+    CosMemoryStream *stream = NULL;
+    CosDoc *doc = parse_pdf_(k_pdf_page, &stream);
+    TEST_EXPECT(doc != NULL);
+
+    const char * const keys[] = {"Type", "Parent", "Rotate", "Missing"};
+    CosError error = cos_error_none();
+    CosObjNode * const obj = cos_doc_get_object_keys(COS_nonnull_cast(doc),
+                                                     cos_obj_id_make(2, 0),
+                                                     keys,
+                                                     4,
+                                                     &error);
+    TEST_EXPECT(obj != NULL);
+    TEST_EXPECT(cos_indirect_obj_node_get_id((CosIndirectObjNode *)obj).obj_number == 2);
+
+    CosObjNode * const value = cos_indirect_obj_node_get_value((CosIndirectObjNode *)obj);
+    TEST_EXPECT(value != NULL);
+    TEST_EXPECT(cos_obj_node_get_type(COS_nonnull_cast(value)) == CosObjNodeType_Dict);
+
+    CosDictObjNode * const dict = (CosDictObjNode *)value;
+    TEST_EXPECT(cos_dict_obj_node_get_count(dict) == 3);
+
+    CosObjNode *entry = NULL;
+    TEST_EXPECT(cos_dict_obj_node_get_value_with_string(dict, "Parent", &entry, &error));
+    TEST_EXPECT(entry && cos_obj_node_get_type(COS_nonnull_cast(entry)) == CosObjNodeType_Reference);
+
+    entry = NULL;
+    TEST_EXPECT(cos_dict_obj_node_get_value_with_string(dict, "Rotate", &entry, &error));
+    TEST_EXPECT(entry && cos_obj_node_get_type(COS_nonnull_cast(entry)) == CosObjNodeType_Integer);
+    TEST_EXPECT(cos_int_obj_node_get_value((CosIntObjNode *)entry) == 90);
+
+    entry = NULL;
+    TEST_EXPECT(!cos_dict_obj_node_get_value_with_string(dict, "Resources", &entry, &error));
+
+    // The partial object is not cached.
+    CosDocCacheStats stats;
+    cos_doc_get_cache_stats(COS_nonnull_cast(doc), &stats);
+    TEST_EXPECT(stats.object_count == 0);
+
+    cos_obj_node_release(COS_nonnull_cast(obj));
+    cos_doc_destroy(COS_nonnull_cast(doc));
+    cos_stream_close((CosStream *)stream);
+
+    return EXIT_SUCCESS;
+}
+
+// MARK: - Scan tests
+
+static int
+objCursor_scanNext_reportsEventsWithoutNodes(void)
+{
+    CosMemoryStream *stream = NULL;
+    CosDoc *doc = parse_pdf_(k_pdf_stream_first, &stream);
+    TEST_EXPECT(doc != NULL);
+
+    CosError error = cos_error_none();
+    CosDocObjCursor * const cursor = cos_doc_obj_cursor_create(COS_nonnull_cast(doc), &error);
+    TEST_EXPECT(cursor != NULL);
+
+    EventLog log = {.count = 0, .stop_after = 0, .has_length_key = false};
+    CosObjID obj_id = CosObjID_Invalid;
+
+    // 2 0 obj << /Length 5 >> stream ... endstream endobj
+    TEST_EXPECT(scan_next_(COS_nonnull_cast(cursor), &log, &obj_id, &error));
+    TEST_EXPECT(obj_id.obj_number == 2);
+    TEST_EXPECT(log.count == 5);
+    TEST_EXPECT(log.events[0].type == CosObjEventType_DictStart);
+    TEST_EXPECT(log.events[1].type == CosObjEventType_Key);
+    TEST_EXPECT(log.has_length_key);
+    TEST_EXPECT(log.events[2].type == CosObjEventType_Scalar);
+    TEST_EXPECT(log.events[2].scalar_type == CosObjType_Integer);
+    TEST_EXPECT(log.events[2].as.integer == 5);
+    TEST_EXPECT(log.events[3].type == CosObjEventType_DictEnd);
+    TEST_EXPECT(log.events[4].type == CosObjEventType_StreamStart);
+    TEST_EXPECT(log.events[4].as.stream.data_offset == 40);
+    TEST_EXPECT(log.events[4].as.stream.length == 5);
+
+    // 1 0 obj [1 2] endobj
+    TEST_EXPECT(scan_next_(COS_nonnull_cast(cursor), &log, &obj_id, &error));
+    TEST_EXPECT(obj_id.obj_number == 1);
+    TEST_EXPECT(log.count == 4);
+    TEST_EXPECT(log.events[0].type == CosObjEventType_ArrayStart);
+    TEST_EXPECT(log.events[0].offset == 71);
+    TEST_EXPECT(log.events[1].type == CosObjEventType_Scalar);
+    TEST_EXPECT(log.events[1].as.integer == 1);
+    TEST_EXPECT(log.events[2].as.integer == 2);
+    TEST_EXPECT(log.events[3].type == CosObjEventType_ArrayEnd);
+
+    TEST_EXPECT(!scan_next_(COS_nonnull_cast(cursor), &log, &obj_id, &error));
+    TEST_EXPECT(error.code == COS_ERROR_NONE);
+
+    CosDocCacheStats stats;
+    cos_doc_get_cache_stats(COS_nonnull_cast(doc), &stats);
+    TEST_EXPECT(stats.object_count == 0);
+
+    cos_doc_obj_cursor_destroy(COS_nonnull_cast(cursor));
+    cos_doc_destroy(COS_nonnull_cast(doc));
+    cos_stream_close((CosStream *)stream);
+
+    return EXIT_SUCCESS;
+}
+
+static int
+objCursor_scanIndirectLength_skipsToEndstream(void)
+{
+    CosMemoryStream *stream = NULL;
+    CosDoc *doc = parse_pdf_(k_pdf_indirect_length, &stream);
+    TEST_EXPECT(doc != NULL);
+
+    CosError error = cos_error_none();
+    CosDocObjCursor * const cursor = cos_doc_obj_cursor_create(COS_nonnull_cast(doc), &error);
+    TEST_EXPECT(cursor != NULL);
+
+    EventLog log = {.count = 0, .stop_after = 0, .has_length_key = false};
+    CosObjID obj_id = CosObjID_Invalid;
+
+    TEST_EXPECT(scan_next_(COS_nonnull_cast(cursor), &log, &obj_id, &error));
+    TEST_EXPECT(obj_id.obj_number == 2);
+    TEST_EXPECT(log.count == 5);
+    TEST_EXPECT(log.events[2].type == CosObjEventType_Reference);
+    TEST_EXPECT(log.events[4].type == CosObjEventType_StreamStart);
+    TEST_EXPECT(log.events[4].as.stream.data_offset == 44);
+    TEST_EXPECT(log.events[4].as.stream.length == -1);
+
+    TEST_EXPECT(scan_next_(COS_nonnull_cast(cursor), &log, &obj_id, &error));
+    TEST_EXPECT(obj_id.obj_number == 3);
+    TEST_EXPECT(log.count == 1);
+    TEST_EXPECT(log.events[0].as.integer == 5);
+
+    TEST_EXPECT(scan_next_(COS_nonnull_cast(cursor), &log, &obj_id, &error));
+    TEST_EXPECT(obj_id.obj_number == 1);
+    TEST_EXPECT(log.count == 4);
+    TEST_EXPECT(error.code == COS_ERROR_NONE);
+
+    cos_doc_obj_cursor_destroy(COS_nonnull_cast(cursor));
+    cos_doc_destroy(COS_nonnull_cast(doc));
+    cos_stream_close((CosStream *)stream);
+
+    return EXIT_SUCCESS;
+}
+
+static int
+objCursor_scanStopped_carriesOnWithNextObject(void)
+{
+    CosMemoryStream *stream = NULL;
+    CosDoc *doc = parse_pdf_(k_pdf_stream_first, &stream);
+    TEST_EXPECT(doc != NULL);
+
+    CosError error = cos_error_none();
+    CosDocObjCursor * const cursor = cos_doc_obj_cursor_create(COS_nonnull_cast(doc), &error);
+    TEST_EXPECT(cursor != NULL);
+
+    EventLog log = {.count = 0, .stop_after = 1, .has_length_key = false};
+    CosObjID obj_id = CosObjID_Invalid;
+
+    TEST_EXPECT(scan_next_(COS_nonnull_cast(cursor), &log, &obj_id, &error));
+    TEST_EXPECT(obj_id.obj_number == 2);
+    TEST_EXPECT(log.count == 1);
+
+    log.stop_after = 0;
+    TEST_EXPECT(scan_next_(COS_nonnull_cast(cursor), &log, &obj_id, &error));
+    TEST_EXPECT(obj_id.obj_number == 1);
+    TEST_EXPECT(log.count == 4);
+    TEST_EXPECT(log.events[0].type == CosObjEventType_ArrayStart);
+    TEST_EXPECT(error.code == COS_ERROR_NONE);
+
+    cos_doc_obj_cursor_destroy(COS_nonnull_cast(cursor));
+    cos_doc_destroy(COS_nonnull_cast(doc));
+    cos_stream_close((CosStream *)stream);
+
+    return EXIT_SUCCESS;
+}
+
 // MARK: - Test driver
 
 TEST_MAIN()
@@ -210,6 +667,14 @@ TEST_MAIN()
     TEST_EXPECT(resolveIndirectObj_MismatchedGenNumber_ReturnsError() == EXIT_SUCCESS);
     TEST_EXPECT(resolveIndirectObj_NonexistentObjNumber_ReturnsError() == EXIT_SUCCESS);
     TEST_EXPECT(resolveIndirectObj_FreeEntry_ReturnsError() == EXIT_SUCCESS);
+    TEST_EXPECT(resolveIndirectObj_IndirectStreamLength_ReadsStream() == EXIT_SUCCESS);
+    TEST_EXPECT(resolveIndirectObj_StreamLengthPastEndOfInput_SkipsToEndstream() == EXIT_SUCCESS);
+    TEST_EXPECT(resolveIndirectObj_SelfReferencingStreamLength_SkipsToEndstream() == EXIT_SUCCESS);
+    TEST_EXPECT(resolveIndirectObj_MutuallyReferencingStreamLengths_SkipToEndstream() == EXIT_SUCCESS);
+    TEST_EXPECT(getObjectKeys_largeDict_parsesOnlyRequestedKeys() == EXIT_SUCCESS);
+    TEST_EXPECT(objCursor_scanNext_reportsEventsWithoutNodes() == EXIT_SUCCESS);
+    TEST_EXPECT(objCursor_scanIndirectLength_skipsToEndstream() == EXIT_SUCCESS);
+    TEST_EXPECT(objCursor_scanStopped_carriesOnWithNextObject() == EXIT_SUCCESS);
 
     return EXIT_SUCCESS;
 }
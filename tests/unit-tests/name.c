@@ -0,0 +1,347 @@
+/*
+ * Copyright (c) 2025 OpenCOS.
+ */
+
+#include "CosTest.h"
+
+#include <libcos/CosDoc.h>
+#include <libcos/CosObjID.h>
+#include <libcos/CosParser.h>
+#include <libcos/common/CosError.h>
+#include <libcos/common/CosString.h>
+#include <libcos/io/CosMemoryStream.h>
+#include <libcos/io/CosStream.h>
+#include <libcos/objects/CosArrayObjNode.h>
+#include <libcos/objects/CosDictObjNode.h>
+#include <libcos/objects/CosIndirectObjNode.h>
+#include <libcos/objects/CosIntObjNode.h>
+#include <libcos/objects/CosNameKey.h>
+#include <libcos/objects/CosNameObjNode.h>
+#include <libcos/objects/CosObjNode.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+COS_ASSUME_NONNULL_BEGIN
+
+// MARK: - Helpers
+
+/**
+ * @brief Parses an in-memory PDF and returns the document.
+ *
+ * On success the caller owns the returned @c CosDoc (free with
+ * @c cos_doc_destroy) and the output stream (close with
+ * @c cos_stream_close).  Both must be kept alive together because the
+ * parser borrows the stream.
+ *
+ * @param input         NUL-terminated PDF bytes.
+ * @param out_stream    On success, receives the memory stream. The caller
+ *                      must close it after destroying the document.
+ *
+ * @return The parsed document, or @c NULL on failure.
+ */
+static CosDoc * COS_Nullable
+parse_pdf_(const char *input,
+           CosMemoryStream * COS_Nullable * COS_Nullable out_stream)
+{
+    CosDoc *doc = NULL;
+    CosMemoryStream *stream = NULL;
+    CosParser *parser = NULL;
+    CosError error = cos_error_none();
+
+    doc = cos_doc_create(NULL);
+    if (!doc) {
+        goto failure;
+    }
+
+    stream = cos_memory_stream_create_readonly(input, strlen(input));
+    if (!stream) {
+        goto failure;
+    }
+
+    parser = cos_parser_create(doc, (CosStream *)stream);
+    if (!parser) {
+        goto failure;
+    }
+    /* parser is now owned by doc; cos_doc_destroy will free it. */
+
+    if (!cos_parser_parse(parser, &error)) {
+        goto failure;
+    }
+
+    if (out_stream) {
+        *out_stream = stream;
+    }
+    return doc;
+
+failure:
+    if (doc) {
+        cos_doc_destroy(doc);
+    }
+    if (stream) {
+        cos_stream_close((CosStream *)stream);
+    }
+    return NULL;
+}
+
+/**
+ * @brief Returns the value of the indirect object 1 0 R, which must be an array of two
+ * dictionaries.
+ */
+static CosArrayObjNode * COS_Nullable
+get_array_obj_(CosDoc *doc,
+               CosObjNode * COS_Nullable * COS_Nonnull out_obj)
+{
+    CosError error = cos_error_none();
+    CosObjNode * const obj = cos_doc_get_object(doc, cos_obj_id_make(1, 0), &error);
+    if (!obj || cos_obj_node_get_type(obj) != CosObjNodeType_Indirect) {
+        return NULL;
+    }
+    *out_obj = obj;
+
+    CosObjNode * const value = cos_indirect_obj_node_get_value((CosIndirectObjNode *)obj);
+    if (!value || !cos_obj_node_is_array(COS_nonnull_cast(value))) {
+        return NULL;
+    }
+
+    CosArrayObjNode * const array_obj = (CosArrayObjNode *)value;
+    if (cos_array_obj_node_get_count(array_obj) != 2) {
+        return NULL;
+    }
+    return array_obj;
+}
+
+/**
+ * @brief Returns the key of the entry named @a key in the dictionary, or @c NULL.
+ */
+static CosNameObjNode * COS_Nullable
+find_key_(CosDictObjNode *dict_obj,
+          const char *key)
+{
+    CosDictObjNodeIterator iterator = cos_dict_obj_node_iterator_init(dict_obj);
+    CosNameObjNode *entry_key = NULL;
+    CosObjNode *entry_value = NULL;
+    while (cos_dict_obj_node_iterator_next(&iterator, &entry_key, &entry_value)) {
+        const CosString * const key_str = cos_name_obj_node_get_value(COS_nonnull_cast(entry_key));
+        if (key_str && strcmp(cos_string_get_data(COS_nonnull_cast(key_str)), key) == 0) {
+            return entry_key;
+        }
+    }
+    return NULL;
+}
+
+// MARK: - Test PDF
+
+/*
+ * PDF with one indirect array object holding two dictionaries that share names:
+ *   1 0 obj [<< /Type /A >> << /Type /A /Count 2 >>] endobj
+ *
+ * Byte layout:
+ *   offset   0 : %PDF-1.0\n                                           (9 bytes)
+ *   offset   9 : 1 0 obj\n[<< /Type /A >> << /Type /A /Count 2 >>]\nendobj\n (56 bytes)
+ *   offset  65 : xref\n                                               (5 bytes)
+ */
+static const char k_pdf_shared_names[] =
+    "%PDF-1.0\n"
+    "1 0 obj\n[<< /Type /A >> << /Type /A /Count 2 >>]\nendobj\n"
+    "xref\n"
+    "0 2\n"
+    "0000000000 65535 f \n"
+    "0000000009 00000 n \n"
+    "trailer\n"
+    "<< /Size 2 >>\n"
+    "startxref\n"
+    "65\n"
+    "%%EOF";
+
+// MARK: - Tests
+
+static int
+parseNames_equalNames_shareNameObject(void)
+{
+    CosMemoryStream *stream = NULL;
+    CosDoc *doc = parse_pdf_(k_pdf_shared_names, &stream);
+    TEST_EXPECT(doc != NULL);
+
+    CosObjNode *obj = NULL;
+    CosArrayObjNode *array_obj = get_array_obj_(COS_nonnull_cast(doc), &obj);
+    TEST_EXPECT(array_obj != NULL);
+
+    CosError error = cos_error_none();
+    CosDictObjNode *dict1 = (CosDictObjNode *)cos_array_obj_node_get_at(COS_nonnull_cast(array_obj), 0, &error);
+    CosDictObjNode *dict2 = (CosDictObjNode *)cos_array_obj_node_get_at(COS_nonnull_cast(array_obj), 1, &error);
+    TEST_EXPECT(dict1 != NULL);
+    TEST_EXPECT(dict2 != NULL);
+
+    // The /Type keys of both dictionaries are the same name object.
+    CosNameObjNode *key1 = find_key_(COS_nonnull_cast(dict1), "Type");
+    CosNameObjNode *key2 = find_key_(COS_nonnull_cast(dict2), "Type");
+    TEST_EXPECT(key1 != NULL);
+    TEST_EXPECT(key1 == key2);
+
+    // So are the /A values.
+    CosObjNode *value1 = NULL;
+    CosObjNode *value2 = NULL;
+    TEST_EXPECT(cos_dict_obj_node_get_value(COS_nonnull_cast(dict1), COS_nonnull_cast(key1), &value1, &error));
+    TEST_EXPECT(cos_dict_obj_node_get_value(COS_nonnull_cast(dict2), COS_nonnull_cast(key2), &value2, &error));
+    TEST_EXPECT(value1 != NULL);
+    TEST_EXPECT(value1 == value2);
+
+    cos_obj_node_release(obj);
+    cos_doc_destroy(COS_nonnull_cast(doc));
+    cos_stream_close((CosStream *)stream);
+
+    return EXIT_SUCCESS;
+}
+
+static int
+getValueWithString_internedKeys_findsValue(void)
+{
+    CosMemoryStream *stream = NULL;
+    CosDoc *doc = parse_pdf_(k_pdf_shared_names, &stream);
+    TEST_EXPECT(doc != NULL);
+
+    CosObjNode *obj = NULL;
+    CosArrayObjNode *array_obj = get_array_obj_(COS_nonnull_cast(doc), &obj);
+    TEST_EXPECT(array_obj != NULL);
+
+    CosError error = cos_error_none();
+    CosDictObjNode *dict2 = (CosDictObjNode *)cos_array_obj_node_get_at(COS_nonnull_cast(array_obj), 1, &error);
+    TEST_EXPECT(dict2 != NULL);
+
+    // Lookups with a name that was not interned compare by content.
+    CosObjNode *value = NULL;
+    TEST_EXPECT(cos_dict_obj_node_get_value_with_string(COS_nonnull_cast(dict2), "Count", &value, &error));
+    TEST_EXPECT(value != NULL);
+    TEST_EXPECT(cos_obj_node_get_type(COS_nonnull_cast(value)) == CosObjNodeType_Integer);
+
+    value = NULL;
+    TEST_EXPECT(!cos_dict_obj_node_get_value_with_string(COS_nonnull_cast(dict2), "Kids", &value, &error));
+    TEST_EXPECT(value == NULL);
+
+    cos_obj_node_release(obj);
+    cos_doc_destroy(COS_nonnull_cast(doc));
+    cos_stream_close((CosStream *)stream);
+
+    return EXIT_SUCCESS;
+}
+
+static int
+internedName_outlivesDocument_comparesByContent(void)
+{
+    CosMemoryStream *stream = NULL;
+    CosDoc *doc = parse_pdf_(k_pdf_shared_names, &stream);
+    TEST_EXPECT(doc != NULL);
+
+    CosObjNode *obj = NULL;
+    CosArrayObjNode *array_obj = get_array_obj_(COS_nonnull_cast(doc), &obj);
+    TEST_EXPECT(array_obj != NULL);
+
+    CosError error = cos_error_none();
+    CosDictObjNode *dict1 = (CosDictObjNode *)cos_array_obj_node_get_at(COS_nonnull_cast(array_obj), 0, &error);
+    TEST_EXPECT(dict1 != NULL);
+
+    CosNameObjNode *key = find_key_(COS_nonnull_cast(dict1), "Type");
+    TEST_EXPECT(key != NULL);
+    cos_obj_node_retain((CosObjNode *)key);
+
+    cos_obj_node_release(obj);
+    cos_doc_destroy(COS_nonnull_cast(doc));
+    cos_stream_close((CosStream *)stream);
+
+    // The retained name is no longer interned, and can be modified.
+    CosNameObjNode *other = cos_name_obj_node_alloc(NULL, COS_nonnull_cast(cos_string_alloc_with_str(NULL, "Type")));
+    TEST_EXPECT(other != NULL);
+    TEST_EXPECT(cos_name_obj_node_equal(COS_nonnull_cast(key), COS_nonnull_cast(other)));
+
+    cos_name_obj_node_set_value(COS_nonnull_cast(key), COS_nonnull_cast(cos_string_alloc_with_str(NULL, "Subtype")));
+    TEST_EXPECT(!cos_name_obj_node_equal(COS_nonnull_cast(key), COS_nonnull_cast(other)));
+
+    cos_obj_node_release((CosObjNode *)other);
+    cos_obj_node_release((CosObjNode *)key);
+
+    return EXIT_SUCCESS;
+}
+
+static int
+getValueWithKey_wellKnownKey_findsValue(void)
+{
+    CosMemoryStream *stream = NULL;
+    CosDoc *doc = parse_pdf_(k_pdf_shared_names, &stream);
+    TEST_EXPECT(doc != NULL);
+
+    CosObjNode *obj = NULL;
+    CosArrayObjNode *array_obj = get_array_obj_(COS_nonnull_cast(doc), &obj);
+    TEST_EXPECT(array_obj != NULL);
+
+    CosError error = cos_error_none();
+    CosDictObjNode *dict2 = (CosDictObjNode *)cos_array_obj_node_get_at(COS_nonnull_cast(array_obj), 1, &error);
+    TEST_EXPECT(dict2 != NULL);
+
+    CosObjNode *value = NULL;
+    TEST_EXPECT(cos_dict_obj_node_get_value_with_key(COS_nonnull_cast(dict2),
+                                                     cos_name_key_get_well_known(CosWellKnownName_Count),
+                                                     &value,
+                                                     &error));
+    TEST_EXPECT(value != NULL);
+    TEST_EXPECT(cos_obj_node_is_integer(COS_nonnull_cast(value)));
+    TEST_EXPECT(cos_int_obj_node_get_value((CosIntObjNode *)value) == 2);
+
+    value = NULL;
+    TEST_EXPECT(!cos_dict_obj_node_get_value_with_key(COS_nonnull_cast(dict2),
+                                                      cos_name_key_get_well_known(CosWellKnownName_Kids),
+                                                      &value,
+                                                      &error));
+    TEST_EXPECT(value == NULL);
+
+    // A key made from a string with the same contents finds the same value.
+    const CosNameKey type_key = cos_name_key("Type");
+    TEST_EXPECT(cos_dict_obj_node_get_value_with_key(COS_nonnull_cast(dict2),
+                                                     &type_key,
+                                                     &value,
+                                                     &error));
+    TEST_EXPECT(value != NULL);
+    TEST_EXPECT(cos_obj_node_get_type(COS_nonnull_cast(value)) == CosObjNodeType_Name);
+
+    cos_obj_node_release(obj);
+    cos_doc_destroy(COS_nonnull_cast(doc));
+    cos_stream_close((CosStream *)stream);
+
+    return EXIT_SUCCESS;
+}
+
+static int
+nameKey_wellKnownNames_matchNameHashes(void)
+{
+    for (int i = 0; i < COS_WELL_KNOWN_NAME_COUNT; i++) {
+        const CosNameKey *key = cos_name_key_get_well_known((CosWellKnownName)i);
+        TEST_EXPECT(key != NULL);
+        TEST_EXPECT(key->name.data != NULL);
+        TEST_EXPECT(key->name.length > 0);
+
+        CosString *string = cos_string_alloc_with_strn(NULL, COS_nonnull_cast(key->name.data), key->name.length);
+        TEST_EXPECT(string != NULL);
+        TEST_EXPECT(cos_string_get_hash(COS_nonnull_cast(string)) == key->hash);
+        cos_string_free(COS_nonnull_cast(string));
+    }
+
+    const CosNameKey *length_key = cos_name_key_get_well_known(CosWellKnownName_Length);
+    TEST_EXPECT(cos_string_ref_cmp(length_key->name, cos_string_ref_const("Length")) == 0);
+
+    return EXIT_SUCCESS;
+}
+
+// MARK: - Test driver
+
+TEST_MAIN()
+{
+    TEST_EXPECT(parseNames_equalNames_shareNameObject() == EXIT_SUCCESS);
+    TEST_EXPECT(getValueWithString_internedKeys_findsValue() == EXIT_SUCCESS);
+    TEST_EXPECT(internedName_outlivesDocument_comparesByContent() == EXIT_SUCCESS);
+    TEST_EXPECT(getValueWithKey_wellKnownKey_findsValue() == EXIT_SUCCESS);
+    TEST_EXPECT(nameKey_wellKnownNames_matchNameHashes() == EXIT_SUCCESS);
+
+    return EXIT_SUCCESS;
+}
+
+COS_ASSUME_NONNULL_END
@@ -0,0 +1,1062 @@
+/*
+ * Copyright (c) 2025 OpenCOS.
+ */
+
+#include "CosTest.h"
+#include "common/CosThread.h"
+#include "objects/CosObjCache.h"
+
+#include <libcos/CosDoc.h>
+#include <libcos/CosObjID.h>
+#include <libcos/CosParser.h>
+#include <libcos/common/CosError.h>
+#include <libcos/common/memory/CosAllocator.h>
+#include <libcos/io/CosMemoryStream.h>
+#include <libcos/io/CosStream.h>
+#include <libcos/objects/CosIndirectObjNode.h>
+#include <libcos/objects/CosIntObjNode.h>
+#include <libcos/objects/CosObjNode.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+COS_ASSUME_NONNULL_BEGIN
+
+// MARK: - Test PDF
+
+/*
+ * PDF with four objects:
+ *   1 0 obj << /Type /Catalog >> endobj
+ *   2 0 obj [1 2 3] endobj
+ *   3 0 obj [4.5 6] endobj
+ *   4 0 obj << /N 4 >> endobj
+ *
+ * Byte layout:
+ *   offset   0 : %PDF-1.0\n                                (9 bytes)
+ *   offset   9 : 1 0 obj\n<< /Type /Catalog >>\nendobj\n   (36 bytes)
+ *   offset  45 : 2 0 obj\n[1 2 3]\nendobj\n                (23 bytes)
+ *   offset  68 : 3 0 obj\n[4.5 6]\nendobj\n                (23 bytes)
+ *   offset  91 : 4 0 obj\n<< /N 4 >>\nendobj\n             (26 bytes)
+ *   offset 117 : xref\n
+ */
+static const char k_pdf_four_objects[] =
+    "%PDF-1.0\n"
+    "1 0 obj\n<< /Type /Catalog >>\nendobj\n"
+    "2 0 obj\n[1 2 3]\nendobj\n"
+    "3 0 obj\n[4.5 6]\nendobj\n"
+    "4 0 obj\n<< /N 4 >>\nendobj\n"
+    "xref\n"
+    "0 5\n"
+    "0000000000 65535 f \n"
+    "0000000009 00000 n \n"
+    "0000000045 00000 n \n"
+    "0000000068 00000 n \n"
+    "0000000091 00000 n \n"
+    "trailer\n"
+    "<< /Size 5 /Root 1 0 R >>\n"
+    "startxref\n"
+    "117\n"
+    "%%EOF";
+
+/* The four-object PDF, with a trailer that claims far more objects than the xref table has. */
+static const char k_pdf_oversized_trailer[] =
+    "%PDF-1.0\n"
+    "1 0 obj\n<< /Type /Catalog >>\nendobj\n"
+    "2 0 obj\n[1 2 3]\nendobj\n"
+    "3 0 obj\n[4.5 6]\nendobj\n"
+    "4 0 obj\n<< /N 4 >>\nendobj\n"
+    "xref\n"
+    "0 5\n"
+    "0000000000 65535 f \n"
+    "0000000009 00000 n \n"
+    "0000000045 00000 n \n"
+    "0000000068 00000 n \n"
+    "0000000091 00000 n \n"
+    "trailer\n"
+    "<< /Size 50000000 /Root 1 0 R >>\n"
+    "startxref\n"
+    "117\n"
+    "%%EOF";
+
+/*
+ * PDF whose objects are not in object-number order, with a stream:
+ *   offset  0 : %PDF-1.0\n
+ *   offset  9 : 2 0 obj << /Length 5 >> stream ... endstream endobj
+ *   offset 63 : 1 0 obj [1 2] endobj
+ *   offset 84 : xref
+ */
+static const char k_pdf_stream_first[] =
+    "%PDF-1.0\n"
+    "2 0 obj\n<< /Length 5 >>\nstream\nhello\nendstream\nendobj\n"
+    "1 0 obj\n[1 2]\nendobj\n"
+    "xref\n"
+    "0 3\n"
+    "0000000000 65535 f \n"
+    "0000000063 00000 n \n"
+    "0000000009 00000 n \n"
+    "trailer\n"
+    "<< /Size 3 /Root 1 0 R >>\n"
+    "startxref\n"
+    "84\n"
+    "%%EOF";
+
+// MARK: - Helpers
+
+/**
+ * @brief Parses an in-memory PDF and returns the document.
+ *
+ * On success the caller owns the returned @c CosDoc (free with
+ * @c cos_doc_destroy) and the output stream (close with
+ * @c cos_stream_close).
+ */
+static CosDoc * COS_Nullable
+parse_pdf_(const char *input,
+           CosMemoryStream * COS_Nullable * COS_Nonnull out_stream)
+{
+    CosDoc *doc = NULL;
+    CosMemoryStream *stream = NULL;
+    CosParser *parser = NULL;
+    CosError error = cos_error_none();
+
+    doc = cos_doc_create(NULL);
+    if (!doc) {
+        goto failure;
+    }
+
+    stream = cos_memory_stream_create_readonly(input, strlen(input));
+    if (!stream) {
+        goto failure;
+    }
+
+    parser = cos_parser_create(doc, (CosStream *)stream);
+    if (!parser) {
+        goto failure;
+    }
+    /* parser is now owned by doc; cos_doc_destroy will free it. */
+
+    if (!cos_parser_parse(parser, &error)) {
+        goto failure;
+    }
+
+    *out_stream = stream;
+    return doc;
+
+failure:
+    if (doc) {
+        cos_doc_destroy(doc);
+    }
+    if (stream) {
+        cos_stream_close((CosStream *)stream);
+    }
+    return NULL;
+}
+
+/**
+ * @brief Loads object @p obj_number and releases it straight away.
+ */
+static bool
+touch_object_(CosDoc *doc,
+              unsigned int obj_number)
+{
+    CosError error = cos_error_none();
+    CosObjNode * const obj = cos_doc_get_object(doc, cos_obj_id_make(obj_number, 0), &error);
+    if (!obj) {
+        return false;
+    }
+    cos_obj_node_release(obj);
+    return true;
+}
+
+// MARK: - Tests
+
+static int
+getObject_repeatedLookup_countsHitsAndMisses(void)
+{
+    CosMemoryStream *stream = NULL;
+    CosDoc *doc = parse_pdf_(k_pdf_four_objects, &stream);
+    TEST_EXPECT(doc != NULL);
+
+    TEST_EXPECT(touch_object_(COS_nonnull_cast(doc), 2));
+    TEST_EXPECT(touch_object_(COS_nonnull_cast(doc), 2));
+    TEST_EXPECT(touch_object_(COS_nonnull_cast(doc), 3));
+
+    CosDocCacheStats stats;
+    cos_doc_get_cache_stats(COS_nonnull_cast(doc), &stats);
+    TEST_EXPECT(stats.miss_count == 2);
+    TEST_EXPECT(stats.hit_count == 1);
+    TEST_EXPECT(stats.eviction_count == 0);
+    TEST_EXPECT(stats.object_count == 2);
+    TEST_EXPECT(stats.byte_count > 0);
+
+    cos_doc_destroy(COS_nonnull_cast(doc));
+    cos_stream_close((CosStream *)stream);
+
+    return EXIT_SUCCESS;
+}
+
+static int
+getObject_streamObject_isCached(void)
+{
+    CosMemoryStream *stream = NULL;
+    CosDoc *doc = parse_pdf_(k_pdf_stream_first, &stream);
+    TEST_EXPECT(doc != NULL);
+
+    CosError error = cos_error_none();
+    CosObjNode * const obj = cos_doc_get_object(COS_nonnull_cast(doc), cos_obj_id_make(2, 0), &error);
+    TEST_EXPECT(obj != NULL);
+    const CosObjNode * const stream_obj = cos_indirect_obj_node_get_value((CosIndirectObjNode *)obj);
+    TEST_EXPECT(stream_obj && cos_obj_node_get_type(stream_obj) == CosObjNodeType_Stream);
+    cos_obj_node_release(COS_nonnull_cast(obj));
+
+    CosDocCacheStats stats;
+    cos_doc_get_cache_stats(COS_nonnull_cast(doc), &stats);
+    TEST_EXPECT(stats.object_count == 1);
+    TEST_EXPECT(stats.byte_count > 0);
+
+    cos_doc_destroy(COS_nonnull_cast(doc));
+    cos_stream_close((CosStream *)stream);
+
+    return EXIT_SUCCESS;
+}
+
+static int
+setCacheLimits_maxObjects_evictsLeastRecentlyUsed(void)
+{
+    CosMemoryStream *stream = NULL;
+    CosDoc *doc = parse_pdf_(k_pdf_four_objects, &stream);
+    TEST_EXPECT(doc != NULL);
+
+    cos_doc_set_cache_limits(COS_nonnull_cast(doc), (CosDocCacheLimits){.max_objects = 2});
+
+    // An object that is still retained by the caller stays valid once it is evicted.
+    CosError error = cos_error_none();
+    CosObjNode * const obj1 = cos_doc_get_object(COS_nonnull_cast(doc), cos_obj_id_make(1, 0), &error);
+    TEST_EXPECT(obj1 != NULL);
+
+    for (unsigned int obj_number = 2; obj_number <= 4; obj_number++) {
+        TEST_EXPECT(touch_object_(COS_nonnull_cast(doc), obj_number));
+    }
+
+    CosDocCacheStats stats;
+    cos_doc_get_cache_stats(COS_nonnull_cast(doc), &stats);
+    TEST_EXPECT(stats.object_count == 2);
+    TEST_EXPECT(stats.eviction_count == 2);
+    TEST_EXPECT(cos_obj_node_get_type(COS_nonnull_cast(obj1)) == CosObjNodeType_Indirect);
+    TEST_EXPECT(cos_indirect_obj_node_get_value((CosIndirectObjNode *)obj1) != NULL);
+
+    // The most recently loaded object is still cached, the first one is parsed again.
+    TEST_EXPECT(touch_object_(COS_nonnull_cast(doc), 4));
+    TEST_EXPECT(touch_object_(COS_nonnull_cast(doc), 1));
+    cos_doc_get_cache_stats(COS_nonnull_cast(doc), &stats);
+    TEST_EXPECT(stats.hit_count == 1);
+    TEST_EXPECT(stats.miss_count == 5);
+
+    cos_obj_node_release(obj1);
+    cos_doc_destroy(COS_nonnull_cast(doc));
+    cos_stream_close((CosStream *)stream);
+
+    return EXIT_SUCCESS;
+}
+
+static int
+pinObject_overBudget_isNotEvicted(void)
+{
+    CosMemoryStream *stream = NULL;
+    CosDoc *doc = parse_pdf_(k_pdf_four_objects, &stream);
+    TEST_EXPECT(doc != NULL);
+
+    CosError error = cos_error_none();
+    TEST_EXPECT(cos_doc_pin_object(COS_nonnull_cast(doc), cos_obj_id_make(1, 0), &error));
+
+    cos_doc_set_cache_limits(COS_nonnull_cast(doc), (CosDocCacheLimits){.max_objects = 1});
+    for (unsigned int obj_number = 2; obj_number <= 4; obj_number++) {
+        TEST_EXPECT(touch_object_(COS_nonnull_cast(doc), obj_number));
+    }
+
+    CosDocCacheStats stats;
+    cos_doc_get_cache_stats(COS_nonnull_cast(doc), &stats);
+    TEST_EXPECT(stats.pinned_count == 1);
+    TEST_EXPECT(stats.object_count == 1);
+
+    const size_t hit_count = stats.hit_count;
+    TEST_EXPECT(touch_object_(COS_nonnull_cast(doc), 1));
+    cos_doc_get_cache_stats(COS_nonnull_cast(doc), &stats);
+    TEST_EXPECT(stats.hit_count == hit_count + 1);
+
+    cos_doc_unpin_object(COS_nonnull_cast(doc), cos_obj_id_make(1, 0));
+    cos_doc_get_cache_stats(COS_nonnull_cast(doc), &stats);
+    TEST_EXPECT(stats.pinned_count == 0);
+
+    cos_doc_destroy(COS_nonnull_cast(doc));
+    cos_stream_close((CosStream *)stream);
+
+    return EXIT_SUCCESS;
+}
+
+static int
+setCacheLimits_maxBytes_keepsEstimatedSizeWithinBudget(void)
+{
+    CosMemoryStream *stream = NULL;
+    CosDoc *doc = parse_pdf_(k_pdf_four_objects, &stream);
+    TEST_EXPECT(doc != NULL);
+
+    for (unsigned int obj_number = 1; obj_number <= 4; obj_number++) {
+        TEST_EXPECT(touch_object_(COS_nonnull_cast(doc), obj_number));
+    }
+
+    CosDocCacheStats stats;
+    cos_doc_get_cache_stats(COS_nonnull_cast(doc), &stats);
+    TEST_EXPECT(stats.object_count == 4);
+
+    const size_t max_bytes = stats.byte_count / 2;
+    cos_doc_set_cache_limits(COS_nonnull_cast(doc), (CosDocCacheLimits){.max_bytes = max_bytes});
+
+    cos_doc_get_cache_stats(COS_nonnull_cast(doc), &stats);
+    TEST_EXPECT(stats.byte_count <= max_bytes);
+    TEST_EXPECT(stats.object_count < 4);
+    TEST_EXPECT(stats.eviction_count == 4 - stats.object_count);
+
+    cos_doc_destroy(COS_nonnull_cast(doc));
+    cos_stream_close((CosStream *)stream);
+
+    return EXIT_SUCCESS;
+}
+
+static int
+cacheGet_otherGeneration_returnsNull(void)
+{
+    CosObjCache *cache = cos_obj_cache_create(NULL, 4);
+    TEST_EXPECT(cache != NULL);
+
+    CosObjNode *obj = (CosObjNode *)cos_int_obj_node_alloc(NULL, 42);
+    TEST_EXPECT(obj != NULL);
+
+    // Object number 0 is a slot like any other.
+    const CosObjID obj_id = {.obj_number = 0, .gen_number = 1};
+    TEST_EXPECT(cos_obj_cache_insert(COS_nonnull_cast(cache), obj_id, COS_nonnull_cast(obj)));
+    CosObjNode *cached = cos_obj_cache_get(COS_nonnull_cast(cache), obj_id);
+    TEST_EXPECT(cached == obj);
+    TEST_EXPECT(cos_obj_cache_get(COS_nonnull_cast(cache), (CosObjID){.obj_number = 0, .gen_number = 0}) == NULL);
+    TEST_EXPECT(cos_obj_cache_get(COS_nonnull_cast(cache), cos_obj_id_make(1, 1)) == NULL);
+
+    cos_obj_node_release(cached);
+    cos_obj_node_release(obj);
+    cos_obj_cache_destroy(COS_nonnull_cast(cache));
+
+    return EXIT_SUCCESS;
+}
+
+static int
+cacheInsert_objNumberBeyondSize_growsSlots(void)
+{
+    CosObjCache *cache = cos_obj_cache_create(NULL, 0);
+    TEST_EXPECT(cache != NULL);
+
+    for (unsigned int obj_number = 1; obj_number <= 100; obj_number++) {
+        CosObjNode *obj = (CosObjNode *)cos_int_obj_node_alloc(NULL, (int)obj_number);
+        TEST_EXPECT(obj != NULL);
+        TEST_EXPECT(cos_obj_cache_insert(COS_nonnull_cast(cache), cos_obj_id_make(obj_number, 0), COS_nonnull_cast(obj)));
+        cos_obj_node_release(obj);
+    }
+
+    for (unsigned int obj_number = 1; obj_number <= 100; obj_number++) {
+        CosObjNode *obj = cos_obj_cache_get(COS_nonnull_cast(cache), cos_obj_id_make(obj_number, 0));
+        TEST_EXPECT(obj != NULL);
+        TEST_EXPECT(cos_int_obj_node_get_value((CosIntObjNode *)obj) == (int)obj_number);
+        cos_obj_node_release(obj);
+    }
+
+    CosDocCacheStats stats;
+    cos_obj_cache_get_stats(COS_nonnull_cast(cache), &stats);
+    TEST_EXPECT(stats.object_count == 100);
+    TEST_EXPECT(stats.hit_count == 100);
+
+    cos_obj_cache_destroy(COS_nonnull_cast(cache));
+
+    return EXIT_SUCCESS;
+}
+
+static void *
+largest_alloc_(size_t size,
+               void * COS_Nullable user_data)
+{
+    size_t * const largest_size = user_data;
+    if (size > *largest_size) {
+        *largest_size = size;
+    }
+    return malloc(size);
+}
+
+static void *
+largest_realloc_(void * COS_Nullable ptr,
+                 size_t size,
+                 void * COS_Nullable user_data)
+{
+    size_t * const largest_size = user_data;
+    if (size > *largest_size) {
+        *largest_size = size;
+    }
+    return realloc(ptr, size);
+}
+
+static void
+largest_dealloc_(void *ptr,
+                 COS_ATTR_UNUSED void * COS_Nullable user_data)
+{
+    free(ptr);
+}
+
+static int
+getObject_oversizedTrailerSize_reservesOnlyXrefObjects(void)
+{
+    size_t largest_size = 0;
+    const CosAllocatorCallbacks callbacks = {
+        .alloc = &largest_alloc_,
+        .realloc = &largest_realloc_,
+        .dealloc = &largest_dealloc_,
+    };
+    CosAllocator *allocator = cos_allocator_create(NULL, &callbacks, &largest_size);
+    TEST_EXPECT(allocator != NULL);
+
+    CosDoc *doc = cos_doc_create(allocator);
+    TEST_EXPECT(doc != NULL);
+    CosMemoryStream *stream = cos_memory_stream_create_readonly(k_pdf_oversized_trailer,
+                                                                strlen(k_pdf_oversized_trailer));
+    TEST_EXPECT(stream != NULL);
+    CosParser *parser = cos_parser_create(COS_nonnull_cast(doc), (CosStream *)stream);
+    TEST_EXPECT(parser != NULL);
+
+    CosError error = cos_error_none();
+    TEST_EXPECT(cos_parser_parse(COS_nonnull_cast(parser), &error));
+    TEST_EXPECT(touch_object_(COS_nonnull_cast(doc), 4));
+
+    // The cache's slots cover the five objects in the xref table, not the 50 million in /Size.
+    TEST_EXPECT(largest_size < 4096);
+
+    cos_doc_destroy(COS_nonnull_cast(doc));
+    cos_stream_close((CosStream *)stream);
+    cos_allocator_destroy(COS_nonnull_cast(allocator));
+
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @brief The memory stream's seek function, wrapped by @c count_seek_ .
+ */
+static bool (* COS_Nullable s_memory_seek_func)(CosStream *stream,
+                                               CosStreamOffset offset,
+                                               CosStreamOffsetWhence whence,
+                                               CosError * COS_Nullable out_error);
+static size_t s_seek_count = 0;
+
+static bool
+count_seek_(CosStream *stream,
+            CosStreamOffset offset,
+            CosStreamOffsetWhence whence,
+            CosError * COS_Nullable out_error)
+{
+    s_seek_count++;
+    return COS_nonnull_cast(s_memory_seek_func)(stream, offset, whence, out_error);
+}
+
+static bool
+obj_has_number_(const CosObjNode * COS_Nullable obj,
+                unsigned int obj_number)
+{
+    if (!obj) {
+        return false;
+    }
+    const CosObjID obj_id = cos_indirect_obj_node_get_id((const CosIndirectObjNode *)obj);
+    return (obj_id.obj_number == obj_number);
+}
+
+static int
+loadObjects_outOfOrder_parsesInOneSequentialPass(void)
+{
+    CosMemoryStream *stream = NULL;
+    CosDoc *doc = parse_pdf_(k_pdf_four_objects, &stream);
+    TEST_EXPECT(doc != NULL);
+
+    s_memory_seek_func = stream->base.functions.seek_func;
+    stream->base.functions.seek_func = &count_seek_;
+    s_seek_count = 0;
+
+    const CosObjID obj_ids[] = {
+        cos_obj_id_make(4, 0),
+        cos_obj_id_make(2, 0),
+        cos_obj_id_make(1, 0),
+        cos_obj_id_make(3, 0),
+        cos_obj_id_make(2, 0),
+    };
+    CosObjNode *objs[5] = {NULL};
+    CosError error = cos_error_none();
+    TEST_EXPECT(cos_doc_load_objects(COS_nonnull_cast(doc), obj_ids, 5, objs, &error));
+
+    TEST_EXPECT(obj_has_number_(objs[0], 4));
+    TEST_EXPECT(obj_has_number_(objs[1], 2));
+    TEST_EXPECT(obj_has_number_(objs[2], 1));
+    TEST_EXPECT(obj_has_number_(objs[3], 3));
+    TEST_EXPECT(objs[4] == objs[1]);
+
+    // The objects are back to back, so only the first one needs a seek.
+    TEST_EXPECT(s_seek_count == 1);
+
+    CosDocCacheStats stats;
+    cos_doc_get_cache_stats(COS_nonnull_cast(doc), &stats);
+    TEST_EXPECT(stats.object_count == 4);
+
+    for (size_t i = 0; i < 5; i++) {
+        cos_obj_node_release(COS_nonnull_cast(objs[i]));
+    }
+    stream->base.functions.seek_func = s_memory_seek_func;
+    cos_doc_destroy(COS_nonnull_cast(doc));
+    cos_stream_close((CosStream *)stream);
+
+    return EXIT_SUCCESS;
+}
+
+static int
+loadObjects_missingObject_loadsTheOthers(void)
+{
+    CosMemoryStream *stream = NULL;
+    CosDoc *doc = parse_pdf_(k_pdf_four_objects, &stream);
+    TEST_EXPECT(doc != NULL);
+
+    // Object 3 is cached already.
+    TEST_EXPECT(touch_object_(COS_nonnull_cast(doc), 3));
+
+    const CosObjID obj_ids[] = {
+        cos_obj_id_make(3, 0),
+        cos_obj_id_make(5, 0),
+        cos_obj_id_make(2, 0),
+    };
+    CosObjNode *objs[3] = {NULL};
+    CosError error = cos_error_none();
+    TEST_EXPECT(!cos_doc_load_objects(COS_nonnull_cast(doc), obj_ids, 3, objs, &error));
+    TEST_EXPECT(error.code == COS_ERROR_XREF);
+
+    TEST_EXPECT(obj_has_number_(objs[0], 3));
+    TEST_EXPECT(objs[1] == NULL);
+    TEST_EXPECT(obj_has_number_(objs[2], 2));
+
+    CosDocCacheStats stats;
+    cos_doc_get_cache_stats(COS_nonnull_cast(doc), &stats);
+    TEST_EXPECT(stats.hit_count == 1);
+
+    cos_obj_node_release(COS_nonnull_cast(objs[0]));
+    cos_obj_node_release(COS_nonnull_cast(objs[2]));
+    cos_doc_destroy(COS_nonnull_cast(doc));
+    cos_stream_close((CosStream *)stream);
+
+    return EXIT_SUCCESS;
+}
+
+static int
+loadObjects_streamObject_loadsEachObject(void)
+{
+    CosMemoryStream *stream = NULL;
+    CosDoc *doc = parse_pdf_(k_pdf_stream_first, &stream);
+    TEST_EXPECT(doc != NULL);
+
+    const CosObjID obj_ids[] = {
+        cos_obj_id_make(1, 0),
+        cos_obj_id_make(2, 0),
+    };
+    CosObjNode *objs[2] = {NULL};
+    CosError error = cos_error_none();
+    TEST_EXPECT(cos_doc_load_objects(COS_nonnull_cast(doc), obj_ids, 2, objs, &error));
+
+    TEST_EXPECT(obj_has_number_(objs[0], 1));
+    TEST_EXPECT(obj_has_number_(objs[1], 2));
+    const CosObjNode * const stream_obj = cos_indirect_obj_node_get_value((CosIndirectObjNode *)objs[1]);
+    TEST_EXPECT(stream_obj && cos_obj_node_get_type(stream_obj) == CosObjNodeType_Stream);
+
+    CosDocCacheStats stats;
+    cos_doc_get_cache_stats(COS_nonnull_cast(doc), &stats);
+    TEST_EXPECT(stats.object_count == 2);
+
+    for (size_t i = 0; i < 2; i++) {
+        cos_obj_node_release(COS_nonnull_cast(objs[i]));
+    }
+    cos_doc_destroy(COS_nonnull_cast(doc));
+    cos_stream_close((CosStream *)stream);
+
+    return EXIT_SUCCESS;
+}
+
+static int
+getObject_nearbyObjects_reusesTokenizerBuffer(void)
+{
+    CosMemoryStream *stream = NULL;
+    CosDoc *doc = parse_pdf_(k_pdf_four_objects, &stream);
+    TEST_EXPECT(doc != NULL);
+
+    s_memory_seek_func = stream->base.functions.seek_func;
+    stream->base.functions.seek_func = &count_seek_;
+    s_seek_count = 0;
+
+    // The whole body fits in the tokenizer's buffer once the first object has been read.
+    TEST_EXPECT(touch_object_(COS_nonnull_cast(doc), 1));
+    TEST_EXPECT(touch_object_(COS_nonnull_cast(doc), 3));
+    TEST_EXPECT(touch_object_(COS_nonnull_cast(doc), 2));
+    TEST_EXPECT(touch_object_(COS_nonnull_cast(doc), 4));
+
+    TEST_EXPECT(s_seek_count == 1);
+
+    stream->base.functions.seek_func = s_memory_seek_func;
+    cos_doc_destroy(COS_nonnull_cast(doc));
+    cos_stream_close((CosStream *)stream);
+
+    return EXIT_SUCCESS;
+}
+
+static int
+objCursor_streamFirst_visitsObjectsInFileOrder(void)
+{
+    CosMemoryStream *stream = NULL;
+    CosDoc *doc = parse_pdf_(k_pdf_stream_first, &stream);
+    TEST_EXPECT(doc != NULL);
+
+    s_memory_seek_func = stream->base.functions.seek_func;
+    stream->base.functions.seek_func = &count_seek_;
+    s_seek_count = 0;
+
+    CosError error = cos_error_none();
+    CosDocObjCursor * const cursor = cos_doc_obj_cursor_create(COS_nonnull_cast(doc), &error);
+    TEST_EXPECT(cursor != NULL);
+
+    CosObjID obj_id = CosObjID_Invalid;
+    CosObjNode *obj = NULL;
+
+    TEST_EXPECT(cos_doc_obj_cursor_next(COS_nonnull_cast(cursor), &obj_id, &obj, &error));
+    TEST_EXPECT(obj_id.obj_number == 2);
+    TEST_EXPECT(obj_has_number_(obj, 2));
+    const CosObjNode * const stream_obj = cos_indirect_obj_node_get_value((CosIndirectObjNode *)obj);
+    TEST_EXPECT(stream_obj && cos_obj_node_get_type(stream_obj) == CosObjNodeType_Stream);
+    cos_obj_node_release(COS_nonnull_cast(obj));
+
+    TEST_EXPECT(cos_doc_obj_cursor_next(COS_nonnull_cast(cursor), &obj_id, &obj, &error));
+    TEST_EXPECT(obj_id.obj_number == 1);
+    TEST_EXPECT(obj_has_number_(obj, 1));
+    cos_obj_node_release(COS_nonnull_cast(obj));
+
+    TEST_EXPECT(!cos_doc_obj_cursor_next(COS_nonnull_cast(cursor), &obj_id, &obj, &error));
+    TEST_EXPECT(obj == NULL);
+    TEST_EXPECT(error.code == COS_ERROR_NONE);
+
+    // The memory stream has positional reads, so the read-ahead buffer never seeks it.
+    TEST_EXPECT(s_seek_count == 0);
+
+    // The scanned objects were not cached.
+    CosDocCacheStats stats;
+    cos_doc_get_cache_stats(COS_nonnull_cast(doc), &stats);
+    TEST_EXPECT(stats.object_count == 0);
+
+    cos_doc_obj_cursor_destroy(COS_nonnull_cast(cursor));
+    stream->base.functions.seek_func = s_memory_seek_func;
+    cos_doc_destroy(COS_nonnull_cast(doc));
+    cos_stream_close((CosStream *)stream);
+
+    return EXIT_SUCCESS;
+}
+
+#if COS_HAVE_PTHREADS && COS_ATOMIC_REF_COUNTS
+
+/*
+ * PDF with a stream whose Length refers to the stream itself:
+ *   offset  0 : %PDF-1.0\n
+ *   offset  9 : 2 0 obj << /Length 2 0 R >> stream ... endstream endobj
+ *   offset 67 : 1 0 obj [1 2] endobj
+ *   offset 88 : xref
+ */
+static const char k_pdf_self_length[] =
+    "%PDF-1.0\n"
+    "2 0 obj\n<< /Length 2 0 R >>\nstream\nhello\nendstream\nendobj\n"
+    "1 0 obj\n[1 2]\nendobj\n"
+    "xref\n"
+    "0 3\n"
+    "0000000000 65535 f \n"
+    "0000000067 00000 n \n"
+    "0000000009 00000 n \n"
+    "trailer\n"
+    "<< /Size 3 /Root 1 0 R >>\n"
+    "startxref\n"
+    "88\n"
+    "%%EOF";
+
+enum {
+    k_reader_thread_count = 8,
+    k_reader_iteration_count = 200,
+};
+
+typedef struct ReaderContext {
+    CosDoc *doc;
+    CosObjNode * COS_Nullable objs[4];
+    bool succeeded;
+} ReaderContext;
+
+static void * COS_Nullable
+reader_thread_main_(void *arg)
+{
+    ReaderContext * const context = arg;
+
+    context->succeeded = true;
+    for (int iteration = 0; iteration < k_reader_iteration_count; iteration++) {
+        for (unsigned int obj_number = 1; obj_number <= 4; obj_number++) {
+            CosObjNode * const obj = cos_doc_get_object(context->doc,
+                                                        cos_obj_id_make(obj_number, 0),
+                                                        NULL);
+            if (!obj || !cos_obj_node_is_frozen(COS_nonnull_cast(obj))) {
+                context->succeeded = false;
+                return NULL;
+            }
+
+            // Objects 1 and 4 are dictionaries, objects 2 and 3 are arrays.
+            const bool is_dict = (obj_number == 1 || obj_number == 4);
+            if (is_dict ? !cos_obj_node_is_dict(COS_nonnull_cast(obj)) : !cos_obj_node_is_array(COS_nonnull_cast(obj))) {
+                context->succeeded = false;
+            }
+
+            CosObjNode ** const seen = &context->objs[obj_number - 1];
+            if (!*seen) {
+                *seen = obj;
+            }
+            else if (*seen != obj) {
+                context->succeeded = false;
+            }
+            cos_obj_node_release(obj);
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Reads the four objects of @p doc from several threads at once.
+ */
+static int
+run_concurrent_readers_(CosDoc *doc)
+{
+    CosError error = cos_error_none();
+    TEST_EXPECT(cos_doc_enable_concurrent_access(COS_nonnull_cast(doc), &error));
+
+    ReaderContext contexts[k_reader_thread_count] = {0};
+    pthread_t threads[k_reader_thread_count];
+    for (int i = 0; i < k_reader_thread_count; i++) {
+        contexts[i].doc = COS_nonnull_cast(doc);
+        TEST_EXPECT(pthread_create(&threads[i], NULL, reader_thread_main_, &contexts[i]) == 0);
+    }
+    for (int i = 0; i < k_reader_thread_count; i++) {
+        TEST_EXPECT(pthread_join(threads[i], NULL) == 0);
+    }
+
+    // Every thread must have seen the same instance of each object.
+    for (int i = 0; i < k_reader_thread_count; i++) {
+        TEST_EXPECT(contexts[i].succeeded);
+        for (size_t j = 0; j < 4; j++) {
+            TEST_EXPECT(contexts[i].objs[j] == contexts[0].objs[j]);
+        }
+    }
+
+    CosDocCacheStats stats;
+    cos_doc_get_cache_stats(COS_nonnull_cast(doc), &stats);
+    TEST_EXPECT(stats.object_count == 4);
+    TEST_EXPECT(stats.hit_count + stats.miss_count == k_reader_thread_count * k_reader_iteration_count * 4);
+
+    return EXIT_SUCCESS;
+}
+
+static int
+getObject_concurrentReaders_shareEachObject(void)
+{
+    CosMemoryStream *stream = NULL;
+    CosDoc *doc = parse_pdf_(k_pdf_four_objects, &stream);
+    TEST_EXPECT(doc != NULL);
+
+    TEST_EXPECT(run_concurrent_readers_(COS_nonnull_cast(doc)) == EXIT_SUCCESS);
+
+    cos_doc_destroy(COS_nonnull_cast(doc));
+    cos_stream_close((CosStream *)stream);
+
+    return EXIT_SUCCESS;
+}
+
+static int
+getObject_concurrentReadersWithoutPositionalReads_shareEachObject(void)
+{
+    CosMemoryStream *stream = NULL;
+    CosDoc *doc = parse_pdf_(k_pdf_four_objects, &stream);
+    TEST_EXPECT(doc != NULL);
+
+    // Without positional reads, the readers have to take turns with the document's parser.
+    stream->base.functions.read_at_func = NULL;
+
+    TEST_EXPECT(run_concurrent_readers_(COS_nonnull_cast(doc)) == EXIT_SUCCESS);
+
+    cos_doc_destroy(COS_nonnull_cast(doc));
+    cos_stream_close((CosStream *)stream);
+
+    return EXIT_SUCCESS;
+}
+
+static int
+loadAllObjectsParallel_fourObjects_cachesEachObjectOnce(void)
+{
+    CosMemoryStream *stream = NULL;
+    CosDoc *doc = parse_pdf_(k_pdf_four_objects, &stream);
+    TEST_EXPECT(doc != NULL);
+
+    CosError error = cos_error_none();
+    TEST_EXPECT(cos_doc_load_all_objects_parallel(COS_nonnull_cast(doc), 3, &error));
+
+    CosDocCacheStats stats;
+    cos_doc_get_cache_stats(COS_nonnull_cast(doc), &stats);
+    TEST_EXPECT(stats.object_count == 4);
+    TEST_EXPECT(stats.miss_count == 4);
+
+    // The objects are served from the cache afterwards.
+    for (unsigned int obj_number = 1; obj_number <= 4; obj_number++) {
+        TEST_EXPECT(touch_object_(COS_nonnull_cast(doc), obj_number));
+    }
+    cos_doc_get_cache_stats(COS_nonnull_cast(doc), &stats);
+    TEST_EXPECT(stats.hit_count == 4);
+    TEST_EXPECT(stats.miss_count == 4);
+
+    cos_doc_destroy(COS_nonnull_cast(doc));
+    cos_stream_close((CosStream *)stream);
+
+    return EXIT_SUCCESS;
+}
+
+static int
+loadAllObjectsParallel_streamObject_cachesEachObjectOnce(void)
+{
+    CosMemoryStream *stream = NULL;
+    CosDoc *doc = parse_pdf_(k_pdf_stream_first, &stream);
+    TEST_EXPECT(doc != NULL);
+
+    CosError error = cos_error_none();
+    TEST_EXPECT(cos_doc_load_all_objects_parallel(COS_nonnull_cast(doc), 2, &error));
+
+    CosDocCacheStats stats;
+    cos_doc_get_cache_stats(COS_nonnull_cast(doc), &stats);
+    TEST_EXPECT(stats.object_count == 2);
+    TEST_EXPECT(stats.miss_count == 2);
+
+    TEST_EXPECT(touch_object_(COS_nonnull_cast(doc), 2));
+    cos_doc_get_cache_stats(COS_nonnull_cast(doc), &stats);
+    TEST_EXPECT(stats.hit_count == 1);
+
+    cos_doc_destroy(COS_nonnull_cast(doc));
+    cos_stream_close((CosStream *)stream);
+
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @brief An executor that runs each job straight away, on the submitting thread.
+ */
+static void
+run_job_inline_(CosExecutorJobFunc job_func,
+                void *job,
+                void * COS_Nullable user_data)
+{
+    size_t * const submit_count = user_data;
+    (*submit_count)++;
+    job_func(job);
+}
+
+static int
+loadAllObjectsParallel_withExecutor_runsTasksOnExecutor(void)
+{
+    CosMemoryStream *stream = NULL;
+    CosDoc *doc = parse_pdf_(k_pdf_four_objects, &stream);
+    TEST_EXPECT(doc != NULL);
+
+    size_t submit_count = 0;
+    const CosExecutor executor = {
+        .submit = &run_job_inline_,
+        .user_data = &submit_count,
+    };
+    cos_doc_set_executor(COS_nonnull_cast(doc), &executor);
+
+    CosError error = cos_error_none();
+    TEST_EXPECT(cos_doc_load_all_objects_parallel(COS_nonnull_cast(doc), 3, &error));
+    TEST_EXPECT(submit_count > 0);
+
+    CosDocCacheStats stats;
+    cos_doc_get_cache_stats(COS_nonnull_cast(doc), &stats);
+    TEST_EXPECT(stats.object_count == 4);
+    TEST_EXPECT(stats.miss_count == 4);
+
+    cos_doc_destroy(COS_nonnull_cast(doc));
+    cos_stream_close((CosStream *)stream);
+
+    return EXIT_SUCCESS;
+}
+
+static int
+beginLoad_loadingOnSameThread_returnsCycle(void)
+{
+    CosObjCache *cache = cos_obj_cache_create(NULL, 4);
+    TEST_EXPECT(cache != NULL);
+
+    CosError error = cos_error_none();
+    TEST_EXPECT(cos_obj_cache_make_concurrent(COS_nonnull_cast(cache), 4, &error));
+
+    const CosObjID obj_id = cos_obj_id_make(1, 0);
+    CosObjNode *obj = NULL;
+    TEST_EXPECT(cos_obj_cache_begin_load(COS_nonnull_cast(cache), obj_id, &obj) == CosObjCacheLoadState_Claimed);
+    TEST_EXPECT(cos_obj_cache_begin_load(COS_nonnull_cast(cache), obj_id, &obj) == CosObjCacheLoadState_Cycle);
+    TEST_EXPECT(obj == NULL);
+    cos_obj_cache_end_load(COS_nonnull_cast(cache), obj_id, NULL);
+
+    cos_obj_cache_destroy(COS_nonnull_cast(cache));
+
+    return EXIT_SUCCESS;
+}
+
+/**
+ * Two threads that each claim one object and then need the other one.
+ */
+typedef struct CycleLoadTest {
+    CosObjCache *cache;
+    pthread_mutex_t mutex;
+    pthread_cond_t claimed;
+    int claimed_count;
+} CycleLoadTest;
+
+typedef struct CycleLoaderContext {
+    CycleLoadTest *test;
+    CosObjID claimed_obj_id;
+    CosObjID needed_obj_id;
+    CosObjCacheLoadState claimed_state;
+    CosObjCacheLoadState needed_state;
+} CycleLoaderContext;
+
+static void * COS_Nullable
+cycle_loader_thread_main_(void *arg)
+{
+    CycleLoaderContext * const context = arg;
+    CycleLoadTest * const test = context->test;
+    CosObjNode *obj = NULL;
+
+    context->claimed_state = cos_obj_cache_begin_load(test->cache, context->claimed_obj_id, &obj);
+
+    // Both objects must be claimed before either thread asks for the other one.
+    pthread_mutex_lock(&test->mutex);
+    test->claimed_count++;
+    pthread_cond_broadcast(&test->claimed);
+    while (test->claimed_count < 2) {
+        pthread_cond_wait(&test->claimed, &test->mutex);
+    }
+    pthread_mutex_unlock(&test->mutex);
+
+    context->needed_state = cos_obj_cache_begin_load(test->cache, context->needed_obj_id, &obj);
+    if (context->needed_state == CosObjCacheLoadState_Claimed) {
+        cos_obj_cache_end_load(test->cache, context->needed_obj_id, NULL);
+    }
+    cos_obj_cache_end_load(test->cache, context->claimed_obj_id, NULL);
+    return NULL;
+}
+
+static int
+beginLoad_crossThreadCycle_returnsCycleInsteadOfWaiting(void)
+{
+    CosObjCache *cache = cos_obj_cache_create(NULL, 4);
+    TEST_EXPECT(cache != NULL);
+
+    CosError error = cos_error_none();
+    TEST_EXPECT(cos_obj_cache_make_concurrent(COS_nonnull_cast(cache), 4, &error));
+
+    CycleLoadTest test = {
+        .cache = COS_nonnull_cast(cache),
+        .claimed_count = 0,
+    };
+    TEST_EXPECT(pthread_mutex_init(&test.mutex, NULL) == 0);
+    TEST_EXPECT(pthread_cond_init(&test.claimed, NULL) == 0);
+
+    CycleLoaderContext contexts[2] = {
+        {.test = &test, .claimed_obj_id = cos_obj_id_make(1, 0), .needed_obj_id = cos_obj_id_make(2, 0)},
+        {.test = &test, .claimed_obj_id = cos_obj_id_make(2, 0), .needed_obj_id = cos_obj_id_make(1, 0)},
+    };
+    pthread_t threads[2];
+    for (int i = 0; i < 2; i++) {
+        TEST_EXPECT(pthread_create(&threads[i], NULL, cycle_loader_thread_main_, &contexts[i]) == 0);
+    }
+    for (int i = 0; i < 2; i++) {
+        TEST_EXPECT(pthread_join(threads[i], NULL) == 0);
+    }
+
+    // One thread finds the cycle and gives up its object, which the other one then claims.
+    TEST_EXPECT(contexts[0].claimed_state == CosObjCacheLoadState_Claimed);
+    TEST_EXPECT(contexts[1].claimed_state == CosObjCacheLoadState_Claimed);
+    TEST_EXPECT((contexts[0].needed_state == CosObjCacheLoadState_Cycle) !=
+                (contexts[1].needed_state == CosObjCacheLoadState_Cycle));
+    TEST_EXPECT(contexts[0].needed_state == CosObjCacheLoadState_Claimed ||
+                contexts[1].needed_state == CosObjCacheLoadState_Claimed);
+
+    pthread_cond_destroy(&test.claimed);
+    pthread_mutex_destroy(&test.mutex);
+    cos_obj_cache_destroy(COS_nonnull_cast(cache));
+
+    return EXIT_SUCCESS;
+}
+
+static int
+getObject_concurrentSelfReferencingLength_skipsToEndstream(void)
+{
+    CosMemoryStream *stream = NULL;
+    CosDoc *doc = parse_pdf_(k_pdf_self_length, &stream);
+    TEST_EXPECT(doc != NULL);
+
+    CosError error = cos_error_none();
+    TEST_EXPECT(cos_doc_enable_concurrent_access(COS_nonnull_cast(doc), &error));
+
+    CosObjNode *obj = cos_doc_get_object(COS_nonnull_cast(doc), cos_obj_id_make(2, 0), &error);
+    TEST_EXPECT(obj_has_number_(obj, 2));
+    const CosObjNode * const stream_obj = cos_indirect_obj_node_get_value((CosIndirectObjNode *)obj);
+    TEST_EXPECT(stream_obj && cos_obj_node_get_type(stream_obj) == CosObjNodeType_Stream);
+    cos_obj_node_release(COS_nonnull_cast(obj));
+
+    TEST_EXPECT(touch_object_(COS_nonnull_cast(doc), 1));
+
+    cos_doc_destroy(COS_nonnull_cast(doc));
+    cos_stream_close((CosStream *)stream);
+
+    return EXIT_SUCCESS;
+}
+
+#endif /* COS_HAVE_PTHREADS && COS_ATOMIC_REF_COUNTS */
+
+// MARK: - Test driver
+
+TEST_MAIN()
+{
+    TEST_EXPECT(getObject_repeatedLookup_countsHitsAndMisses() == EXIT_SUCCESS);
+    TEST_EXPECT(getObject_streamObject_isCached() == EXIT_SUCCESS);
+    TEST_EXPECT(setCacheLimits_maxObjects_evictsLeastRecentlyUsed() == EXIT_SUCCESS);
+    TEST_EXPECT(pinObject_overBudget_isNotEvicted() == EXIT_SUCCESS);
+    TEST_EXPECT(setCacheLimits_maxBytes_keepsEstimatedSizeWithinBudget() == EXIT_SUCCESS);
+    TEST_EXPECT(cacheGet_otherGeneration_returnsNull() == EXIT_SUCCESS);
+    TEST_EXPECT(cacheInsert_objNumberBeyondSize_growsSlots() == EXIT_SUCCESS);
+    TEST_EXPECT(getObject_oversizedTrailerSize_reservesOnlyXrefObjects() == EXIT_SUCCESS);
+    TEST_EXPECT(loadObjects_outOfOrder_parsesInOneSequentialPass() == EXIT_SUCCESS);
+    TEST_EXPECT(loadObjects_missingObject_loadsTheOthers() == EXIT_SUCCESS);
+    TEST_EXPECT(loadObjects_streamObject_loadsEachObject() == EXIT_SUCCESS);
+    TEST_EXPECT(getObject_nearbyObjects_reusesTokenizerBuffer() == EXIT_SUCCESS);
+    TEST_EXPECT(objCursor_streamFirst_visitsObjectsInFileOrder() == EXIT_SUCCESS);
+#if COS_HAVE_PTHREADS && COS_ATOMIC_REF_COUNTS
+    TEST_EXPECT(getObject_concurrentReaders_shareEachObject() == EXIT_SUCCESS);
+    TEST_EXPECT(getObject_concurrentReadersWithoutPositionalReads_shareEachObject() == EXIT_SUCCESS);
+    TEST_EXPECT(loadAllObjectsParallel_fourObjects_cachesEachObjectOnce() == EXIT_SUCCESS);
+    TEST_EXPECT(loadAllObjectsParallel_streamObject_cachesEachObjectOnce() == EXIT_SUCCESS);
+    TEST_EXPECT(loadAllObjectsParallel_withExecutor_runsTasksOnExecutor() == EXIT_SUCCESS);
+    TEST_EXPECT(beginLoad_loadingOnSameThread_returnsCycle() == EXIT_SUCCESS);
+    TEST_EXPECT(beginLoad_crossThreadCycle_returnsCycleInsteadOfWaiting() == EXIT_SUCCESS);
+    TEST_EXPECT(getObject_concurrentSelfReferencingLength_skipsToEndstream() == EXIT_SUCCESS);
+#endif
+
+    return EXIT_SUCCESS;
+}
+
+COS_ASSUME_NONNULL_END
@@ -7,20 +7,28 @@
 #include <libcos/CosObj.h>
 #include <libcos/CosObjID.h>
 #include <libcos/common/CosArray.h>
+#include <libcos/common/CosData.h>
+#include <libcos/common/CosDataRef.h>
 #include <libcos/common/CosDict.h>
 #include <libcos/common/CosError.h>
 #include <libcos/common/CosString.h>
+#include <libcos/common/memory/CosAllocator.h>
 #include <libcos/objects/CosArrayObjNode.h>
 #include <libcos/objects/CosBoolObjNode.h>
 #include <libcos/objects/CosDictObjNode.h>
 #include <libcos/objects/CosIndirectObjNode.h>
 #include <libcos/objects/CosIntObjNode.h>
+#include <libcos/objects/CosNameKey.h>
 #include <libcos/objects/CosNameObjNode.h>
 #include <libcos/objects/CosNullObjNode.h>
 #include <libcos/objects/CosObjNode.h>
+#include <libcos/objects/CosObjValue.h>
 #include <libcos/objects/CosRealObjNode.h>
+#include <libcos/objects/CosStringObjNode.h>
 
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 COS_ASSUME_NONNULL_BEGIN
 
@@ -29,7 +37,7 @@ COS_ASSUME_NONNULL_BEGIN
 static int
 create_fromDirectIntNode_succeeds(void)
 {
-    CosIntObjNode *int_node = cos_int_obj_node_alloc(42);
+    CosIntObjNode *int_node = cos_int_obj_node_alloc(NULL, 42);
     TEST_EXPECT(int_node != NULL);
 
     CosObj *obj = cos_obj_create((CosObjNode *)int_node);
@@ -48,12 +56,12 @@ create_fromDirectIntNode_succeeds(void)
 static int
 create_fromIndirectNode_resolvesType(void)
 {
-    CosIntObjNode *int_node = cos_int_obj_node_alloc(99);
+    CosIntObjNode *int_node = cos_int_obj_node_alloc(NULL, 99);
     TEST_EXPECT(int_node != NULL);
 
     CosObjID id = cos_obj_id_make(1, 0);
     CosIndirectObjNode *indirect =
-        cos_indirect_obj_node_alloc(id, (CosObjNode *)int_node);
+        cos_indirect_obj_node_alloc(NULL, id, (CosObjNode *)int_node);
     TEST_EXPECT(indirect != NULL);
 
     CosObj *obj = cos_obj_create((CosObjNode *)indirect);
@@ -86,12 +94,39 @@ create_fromNullNode_isNull(void)
     return EXIT_SUCCESS;
 }
 
+static int
+release_immortalNode_isNotDeallocated(void)
+{
+    // The arena reclaims the node, which is never deallocated on its own.
+    CosAllocator *arena = cos_allocator_create_arena(NULL, 0);
+    TEST_EXPECT(arena != NULL);
+
+    CosIntObjNode *int_node = cos_int_obj_node_alloc(arena, 42);
+    TEST_EXPECT(int_node != NULL);
+    TEST_EXPECT(!cos_obj_node_is_immortal((CosObjNode *)int_node));
+
+    cos_obj_node_make_immortal((CosObjNode *)int_node);
+    TEST_EXPECT(cos_obj_node_is_immortal((CosObjNode *)int_node));
+
+    for (int i = 0; i < 4; i++) {
+        cos_obj_node_release((CosObjNode *)int_node);
+    }
+    TEST_EXPECT(cos_obj_node_retain((CosObjNode *)int_node) == (CosObjNode *)int_node);
+    TEST_EXPECT(cos_int_obj_node_get_value(int_node) == 42);
+
+    TEST_EXPECT(cos_obj_node_is_immortal((CosObjNode *)cos_null_obj_node_get()));
+
+    cos_allocator_destroy(arena);
+
+    return EXIT_SUCCESS;
+}
+
 // MARK: - Scalar accessor tests
 
 static int
 getBoolValue_boolObj_returnsValue(void)
 {
-    CosBoolObjNode *bool_node = cos_bool_obj_node_alloc(true);
+    CosBoolObjNode *bool_node = cos_bool_obj_node_alloc(NULL, true);
     TEST_EXPECT(bool_node != NULL);
 
     CosObj *obj = cos_obj_create((CosObjNode *)bool_node);
@@ -108,7 +143,7 @@ getBoolValue_boolObj_returnsValue(void)
 static int
 getRealValue_realObj_returnsValue(void)
 {
-    CosRealObjNode *real_node = cos_real_obj_node_alloc(3.14);
+    CosRealObjNode *real_node = cos_real_obj_node_alloc(NULL, 3.14);
     TEST_EXPECT(real_node != NULL);
 
     CosObj *obj = cos_obj_create((CosObjNode *)real_node);
@@ -125,7 +160,7 @@ getRealValue_realObj_returnsValue(void)
 static int
 getIntValue_typeMismatch_returnsZero(void)
 {
-    CosBoolObjNode *bool_node = cos_bool_obj_node_alloc(true);
+    CosBoolObjNode *bool_node = cos_bool_obj_node_alloc(NULL, true);
     TEST_EXPECT(bool_node != NULL);
 
     CosObj *obj = cos_obj_create((CosObjNode *)bool_node);
@@ -143,10 +178,10 @@ getIntValue_typeMismatch_returnsZero(void)
 static int
 getArrayCount_arrayObj_returnsCount(void)
 {
-    CosArrayObjNode *array_node = cos_array_obj_node_alloc(NULL);
+    CosArrayObjNode *array_node = cos_array_obj_node_alloc(NULL, NULL);
     TEST_EXPECT(array_node != NULL);
 
-    CosIntObjNode *elem = cos_int_obj_node_alloc(10);
+    CosIntObjNode *elem = cos_int_obj_node_alloc(NULL, 10);
     TEST_EXPECT(elem != NULL);
     TEST_EXPECT(cos_array_obj_node_append(array_node, (CosObjNode *)elem, NULL));
 
@@ -168,20 +203,202 @@ getArrayCount_arrayObj_returnsCount(void)
     return EXIT_SUCCESS;
 }
 
+static int
+arrayAppendValue_scalars_storedInline(void)
+{
+    CosArrayObjNode *array_node = cos_array_obj_node_alloc(NULL, NULL);
+    TEST_EXPECT(array_node != NULL);
+
+    TEST_EXPECT(cos_array_obj_node_append_value(array_node, cos_obj_value_make_int(612), NULL));
+    TEST_EXPECT(cos_array_obj_node_append_value(array_node, cos_obj_value_make_real(0.5), NULL));
+    TEST_EXPECT(cos_array_obj_node_append_value(array_node, cos_obj_value_make_bool(true), NULL));
+
+    CosObjValue value;
+    TEST_EXPECT(cos_array_obj_node_get_value_at(array_node, 0, &value, NULL));
+    TEST_EXPECT(value.kind == CosObjValueKind_Integer);
+    TEST_EXPECT(value.as.integer == 612);
+    TEST_EXPECT(cos_array_obj_node_get_value_at(array_node, 1, &value, NULL));
+    TEST_EXPECT(value.kind == CosObjValueKind_Real);
+    TEST_EXPECT(cos_obj_value_get_type(value) == CosObjNodeValueType_Real);
+
+    CosObj *obj = cos_obj_create((CosObjNode *)array_node);
+    TEST_EXPECT(obj != NULL);
+
+    int int_value = 0;
+    double number = 0.0;
+    TEST_EXPECT(cos_obj_get_int_at_index(obj, 0, &int_value, NULL));
+    TEST_EXPECT(int_value == 612);
+    TEST_EXPECT(cos_obj_get_number_at_index(obj, 0, &number, NULL));
+    TEST_EXPECT(number == 612.0);
+    TEST_EXPECT(cos_obj_get_number_at_index(obj, 1, &number, NULL));
+    TEST_EXPECT(number == 0.5);
+
+    // Elements of the wrong type.
+    CosError error = cos_error_none();
+    TEST_EXPECT(!cos_obj_get_int_at_index(obj, 1, &int_value, &error));
+    TEST_EXPECT(error.code == COS_ERROR_INVALID_ARGUMENT);
+    error = cos_error_none();
+    TEST_EXPECT(!cos_obj_get_number_at_index(obj, 2, &number, &error));
+    TEST_EXPECT(error.code == COS_ERROR_INVALID_ARGUMENT);
+
+    // An index past the end.
+    error = cos_error_none();
+    TEST_EXPECT(!cos_obj_get_number_at_index(obj, 3, &number, &error));
+    TEST_EXPECT(error.code == COS_ERROR_OUT_OF_RANGE);
+
+    CosObj *element = cos_obj_get_object_at_index(obj, 2, NULL);
+    TEST_EXPECT(element != NULL);
+    TEST_EXPECT(cos_obj_get_type(element) == CosObjType_Boolean);
+    TEST_EXPECT(cos_obj_is_direct(element));
+    TEST_EXPECT(cos_obj_get_bool_value(element));
+    cos_obj_destroy(element);
+
+    // The element is still stored inline.
+    TEST_EXPECT(cos_array_obj_node_get_value_at(array_node, 2, &value, NULL));
+    TEST_EXPECT(value.kind == CosObjValueKind_Boolean);
+
+    cos_obj_destroy(obj);
+    cos_obj_node_release((CosObjNode *)array_node);
+
+    return EXIT_SUCCESS;
+}
+
+static int
+arrayGetAt_inlineScalar_boxesOnce(void)
+{
+    CosArrayObjNode *array_node = cos_array_obj_node_alloc(NULL, NULL);
+    TEST_EXPECT(array_node != NULL);
+    TEST_EXPECT(cos_array_obj_node_append_value(array_node, cos_obj_value_make_int(7), NULL));
+
+    CosError error = cos_error_none();
+    CosObjNode *node = cos_array_obj_node_get_at(array_node, 0, &error);
+    TEST_EXPECT(node != NULL);
+    TEST_EXPECT(cos_obj_node_get_type(node) == CosObjNodeType_Integer);
+    TEST_EXPECT(cos_int_obj_node_get_value((CosIntObjNode *)node) == 7);
+
+    // The boxed node replaces the inline value, so it is returned again.
+    TEST_EXPECT(cos_array_obj_node_get_at(array_node, 0, &error) == node);
+
+    CosObjValue value;
+    TEST_EXPECT(cos_array_obj_node_get_value_at(array_node, 0, &value, NULL));
+    TEST_EXPECT(value.kind == CosObjValueKind_Node);
+
+    int int_value = 0;
+    TEST_EXPECT(cos_obj_value_get_int(value, &int_value));
+    TEST_EXPECT(int_value == 7);
+
+    cos_obj_node_release((CosObjNode *)array_node);
+
+    return EXIT_SUCCESS;
+}
+
+static int
+arrayPack_numbers_copiesOutInOnePass(void)
+{
+    CosArrayObjNode *array_node = cos_array_obj_node_alloc(NULL, NULL);
+    TEST_EXPECT(array_node != NULL);
+    TEST_EXPECT(cos_array_obj_node_append_value(array_node, cos_obj_value_make_real(0.0), NULL));
+    TEST_EXPECT(cos_array_obj_node_append_value(array_node, cos_obj_value_make_real(0.0), NULL));
+    TEST_EXPECT(cos_array_obj_node_append_value(array_node, cos_obj_value_make_real(612.5), NULL));
+    TEST_EXPECT(cos_array_obj_node_append_value(array_node, cos_obj_value_make_real(792.0), NULL));
+
+    TEST_EXPECT(cos_array_obj_node_pack(array_node));
+    TEST_EXPECT(cos_array_obj_node_get_count(array_node) == 4);
+
+    CosObjValue value;
+    TEST_EXPECT(cos_array_obj_node_get_value_at(array_node, 2, &value, NULL));
+    TEST_EXPECT(value.kind == CosObjValueKind_Real);
+    TEST_EXPECT(value.as.real == 612.5);
+    TEST_EXPECT(!cos_array_obj_node_get_value_at(array_node, 4, &value, NULL));
+
+    CosObj *obj = cos_obj_create((CosObjNode *)array_node);
+    TEST_EXPECT(obj != NULL);
+
+    double numbers[5] = {0};
+    TEST_EXPECT(cos_obj_get_number_array(obj, numbers, 4, NULL));
+    TEST_EXPECT(numbers[0] == 0.0);
+    TEST_EXPECT(numbers[2] == 612.5);
+    TEST_EXPECT(numbers[3] == 792.0);
+    TEST_EXPECT(!cos_obj_get_number_array(obj, numbers, 5, NULL));
+
+    int ints[4] = {0};
+    TEST_EXPECT(!cos_obj_get_int_array(obj, ints, 4, NULL));
+
+    // Modifying the array unpacks it.
+    TEST_EXPECT(cos_array_obj_node_append_value(array_node, cos_obj_value_make_bool(true), NULL));
+    TEST_EXPECT(cos_array_obj_node_get_count(array_node) == 5);
+    TEST_EXPECT(cos_obj_get_number_array(obj, numbers, 4, NULL));
+    TEST_EXPECT(numbers[3] == 792.0);
+    TEST_EXPECT(!cos_obj_get_number_array(obj, numbers, 5, NULL));
+    TEST_EXPECT(!cos_array_obj_node_pack(array_node));
+
+    cos_obj_destroy(obj);
+    cos_obj_node_release((CosObjNode *)array_node);
+
+    return EXIT_SUCCESS;
+}
+
+static int
+arrayPack_ints_boxesOnGetAt(void)
+{
+    CosArrayObjNode *array_node = cos_array_obj_node_alloc(NULL, NULL);
+    TEST_EXPECT(array_node != NULL);
+    for (int i = 0; i < 8; i++) {
+        TEST_EXPECT(cos_array_obj_node_append_value(array_node, cos_obj_value_make_int(i * 10), NULL));
+    }
+
+    TEST_EXPECT(cos_array_obj_node_pack(array_node));
+
+    int ints[3] = {0};
+    TEST_EXPECT(cos_array_obj_node_get_ints(array_node, 5, ints, 3, NULL));
+    TEST_EXPECT(ints[0] == 50);
+    TEST_EXPECT(ints[2] == 70);
+    TEST_EXPECT(!cos_array_obj_node_get_ints(array_node, 6, ints, 3, NULL));
+
+    // Requesting a node unpacks the array, and boxes the element.
+    CosObjNode *node = cos_array_obj_node_get_at(array_node, 3, NULL);
+    TEST_EXPECT(node != NULL);
+    TEST_EXPECT(cos_int_obj_node_get_value((CosIntObjNode *)node) == 30);
+    TEST_EXPECT(cos_array_obj_node_get_count(array_node) == 8);
+
+    TEST_EXPECT(cos_array_obj_node_get_ints(array_node, 2, ints, 3, NULL));
+    TEST_EXPECT(ints[0] == 20);
+    TEST_EXPECT(ints[1] == 30);
+    TEST_EXPECT(ints[2] == 40);
+
+    // Mixed arrays are not packed, so that each element keeps its type.
+    TEST_EXPECT(cos_array_obj_node_append_value(array_node, cos_obj_value_make_real(0.5), NULL));
+    TEST_EXPECT(!cos_array_obj_node_pack(array_node));
+
+    CosObjValue value;
+    TEST_EXPECT(cos_array_obj_node_get_value_at(array_node, 0, &value, NULL));
+    TEST_EXPECT(value.kind == CosObjValueKind_Integer);
+
+    double numbers[2] = {0};
+    TEST_EXPECT(cos_array_obj_node_get_numbers(array_node, 7, numbers, 2, NULL));
+    TEST_EXPECT(numbers[0] == 70.0);
+    TEST_EXPECT(numbers[1] == 0.5);
+
+    cos_obj_node_release((CosObjNode *)array_node);
+
+    return EXIT_SUCCESS;
+}
+
+// MARK: - Dict accessor tests
 // MARK: - Dict accessor tests
 
 static int
 getDictValue_existingKey_returnsValue(void)
 {
-    CosDictObjNode *dict_node = cos_dict_obj_node_create(NULL);
+    CosDictObjNode *dict_node = cos_dict_obj_node_create(NULL, NULL);
     TEST_EXPECT(dict_node != NULL);
 
-    CosString *key_str = cos_string_alloc_with_str("Type");
+    CosString *key_str = cos_string_alloc_with_str(NULL, "Type");
     TEST_EXPECT(key_str != NULL);
-    CosNameObjNode *key = cos_name_obj_node_alloc(key_str);
+    CosNameObjNode *key = cos_name_obj_node_alloc(NULL, key_str);
     TEST_EXPECT(key != NULL);
 
-    CosIntObjNode *value = cos_int_obj_node_alloc(42);
+    CosIntObjNode *value = cos_int_obj_node_alloc(NULL, 42);
     TEST_EXPECT(value != NULL);
 
     TEST_EXPECT(cos_dict_obj_node_set(dict_node, key, (CosObjNode *)value, NULL));
@@ -207,7 +424,7 @@ getDictValue_existingKey_returnsValue(void)
 static int
 getDictValue_nonExistingKey_returnsNull(void)
 {
-    CosDictObjNode *dict_node = cos_dict_obj_node_create(NULL);
+    CosDictObjNode *dict_node = cos_dict_obj_node_create(NULL, NULL);
     TEST_EXPECT(dict_node != NULL);
 
     CosObj *obj = cos_obj_create((CosObjNode *)dict_node);
@@ -223,20 +440,265 @@ getDictValue_nonExistingKey_returnsNull(void)
     return EXIT_SUCCESS;
 }
 
+static int
+dictSet_existingKey_replacesValue(void)
+{
+    CosDictObjNode *dict_node = cos_dict_obj_node_create(NULL, NULL);
+    TEST_EXPECT(dict_node != NULL);
+
+    CosNameObjNode *key1 = cos_name_obj_node_alloc(NULL, cos_string_alloc_with_str(NULL, "Type"));
+    CosNameObjNode *key2 = cos_name_obj_node_alloc(NULL, cos_string_alloc_with_str(NULL, "Type"));
+    TEST_EXPECT(key1 != NULL);
+    TEST_EXPECT(key2 != NULL);
+
+    TEST_EXPECT(cos_dict_obj_node_set(dict_node, key1, (CosObjNode *)cos_int_obj_node_alloc(NULL, 1), NULL));
+    TEST_EXPECT(cos_dict_obj_node_set(dict_node, key2, (CosObjNode *)cos_int_obj_node_alloc(NULL, 2), NULL));
+    TEST_EXPECT(cos_dict_obj_node_get_count(dict_node) == 1);
+
+    CosObjNode *value = NULL;
+    TEST_EXPECT(cos_dict_obj_node_get_value_with_string(dict_node, "Type", &value, NULL));
+    TEST_EXPECT(value != NULL);
+    TEST_EXPECT(cos_int_obj_node_get_value((CosIntObjNode *)value) == 2);
+
+    cos_obj_node_release((CosObjNode *)dict_node);
+
+    return EXIT_SUCCESS;
+}
+
+static int
+dictSet_pastInlineCapacity_keepsAllEntries(void)
+{
+    enum { k_entry_count = 20 };
+
+    CosDictObjNode *dict_node = cos_dict_obj_node_create(NULL, NULL);
+    TEST_EXPECT(dict_node != NULL);
+
+    char key_buffer[16];
+    for (int i = 0; i < k_entry_count; i++) {
+        snprintf(key_buffer, sizeof(key_buffer), "Key%d", i);
+        CosNameObjNode *key = cos_name_obj_node_alloc(NULL, cos_string_alloc_with_str(NULL, key_buffer));
+        TEST_EXPECT(key != NULL);
+        CosIntObjNode *value = cos_int_obj_node_alloc(NULL, i);
+        TEST_EXPECT(value != NULL);
+
+        TEST_EXPECT(cos_dict_obj_node_set(dict_node, key, (CosObjNode *)value, NULL));
+        TEST_EXPECT(cos_dict_obj_node_get_count(dict_node) == (size_t)(i + 1));
+    }
+
+    for (int i = 0; i < k_entry_count; i++) {
+        snprintf(key_buffer, sizeof(key_buffer), "Key%d", i);
+        const CosNameKey key = cos_name_key(key_buffer);
+
+        CosObjNode *value = NULL;
+        TEST_EXPECT(cos_dict_obj_node_get_value_with_key(dict_node, &key, &value, NULL));
+        TEST_EXPECT(value != NULL);
+        TEST_EXPECT(cos_int_obj_node_get_value((CosIntObjNode *)value) == i);
+    }
+
+    size_t iterated_count = 0;
+    CosDictObjNodeIterator iterator = cos_dict_obj_node_iterator_init(dict_node);
+    CosNameObjNode *iter_key = NULL;
+    CosObjNode *iter_value = NULL;
+    while (cos_dict_obj_node_iterator_next(&iterator, &iter_key, &iter_value)) {
+        TEST_EXPECT(iter_key != NULL);
+        TEST_EXPECT(iter_value != NULL);
+        iterated_count++;
+    }
+    TEST_EXPECT(iterated_count == k_entry_count);
+
+    cos_obj_node_release((CosObjNode *)dict_node);
+
+    return EXIT_SUCCESS;
+}
+
+static int
+dictSetValue_scalars_storedInlineAndBoxedOnPromotion(void)
+{
+    enum { k_entry_count = 12 };
+
+    CosDictObjNode *dict_node = cos_dict_obj_node_create(NULL, NULL);
+    TEST_EXPECT(dict_node != NULL);
+
+    CosObj *obj = cos_obj_create((CosObjNode *)dict_node);
+    TEST_EXPECT(obj != NULL);
+
+    char key_buffer[16];
+    for (int i = 0; i < k_entry_count; i++) {
+        snprintf(key_buffer, sizeof(key_buffer), "Key%d", i);
+        CosNameObjNode *key = cos_name_obj_node_alloc(NULL, cos_string_alloc_with_str(NULL, key_buffer));
+        TEST_EXPECT(key != NULL);
+        TEST_EXPECT(cos_dict_obj_node_set_value(dict_node, key, cos_obj_value_make_int(i * 10), NULL));
+
+        // Check every entry, both while they are stored inline and after promotion.
+        for (int j = 0; j <= i; j++) {
+            snprintf(key_buffer, sizeof(key_buffer), "Key%d", j);
+            int int_value = -1;
+            TEST_EXPECT(cos_obj_get_int_for_key(obj, key_buffer, &int_value, NULL));
+            TEST_EXPECT(int_value == j * 10);
+        }
+    }
+
+    double number = 0.0;
+    TEST_EXPECT(cos_obj_get_number_for_key(obj, "Key3", &number, NULL));
+    TEST_EXPECT(number == 30.0);
+    TEST_EXPECT(!cos_obj_get_number_for_key(obj, "NoSuchKey", &number, NULL));
+
+    size_t iterated_count = 0;
+    CosObjDictIterator iterator = cos_obj_dict_iterator_init(obj);
+    const char *iter_key = NULL;
+    CosObj *iter_value = NULL;
+    while (cos_obj_dict_iterator_next(&iterator, &iter_key, &iter_value)) {
+        TEST_EXPECT(iter_value != NULL);
+        TEST_EXPECT(cos_obj_get_type(iter_value) == CosObjType_Integer);
+        cos_obj_destroy(iter_value);
+        iterated_count++;
+    }
+    TEST_EXPECT(iterated_count == k_entry_count);
+
+    cos_obj_destroy(obj);
+    cos_obj_node_release((CosObjNode *)dict_node);
+
+    return EXIT_SUCCESS;
+}
+
+static int
+dictGetValue_inlineScalar_boxesOnce(void)
+{
+    CosDictObjNode *dict_node = cos_dict_obj_node_create(NULL, NULL);
+    TEST_EXPECT(dict_node != NULL);
+
+    CosNameObjNode *key = cos_name_obj_node_alloc(NULL, cos_string_alloc_with_str(NULL, "Rotate"));
+    TEST_EXPECT(key != NULL);
+    TEST_EXPECT(cos_dict_obj_node_set_value(dict_node, key, cos_obj_value_make_real(90.0), NULL));
+
+    const CosNameKey name_key = cos_name_key("Rotate");
+    CosObjValue value;
+    TEST_EXPECT(cos_dict_obj_node_lookup_with_key(dict_node, &name_key, &value));
+    TEST_EXPECT(value.kind == CosObjValueKind_Real);
+
+    CosObjNode *node = NULL;
+    TEST_EXPECT(cos_dict_obj_node_get_value_with_key(dict_node, &name_key, &node, NULL));
+    TEST_EXPECT(node != NULL);
+    TEST_EXPECT(cos_real_obj_node_get_value((CosRealObjNode *)node) == 90.0);
+
+    CosObjNode *node_again = NULL;
+    TEST_EXPECT(cos_dict_obj_node_get_value_with_string(dict_node, "Rotate", &node_again, NULL));
+    TEST_EXPECT(node_again == node);
+
+    cos_obj_node_release((CosObjNode *)dict_node);
+
+    return EXIT_SUCCESS;
+}
+
+// MARK: - Freezing tests
+
+static int
+freeze_dictWithArray_isReadOnlyAndReleasedWithRoot(void)
+{
+    CosDictObjNode *dict_node = cos_dict_obj_node_create(NULL, NULL);
+    TEST_EXPECT(dict_node != NULL);
+
+    CosArrayObjNode *array_node = cos_array_obj_node_alloc(NULL, NULL);
+    TEST_EXPECT(array_node != NULL);
+    TEST_EXPECT(cos_array_obj_node_append_value(array_node, cos_obj_value_make_int(500), NULL));
+    TEST_EXPECT(cos_array_obj_node_append_value(array_node, cos_obj_value_make_int(250), NULL));
+
+    // The key is shared with the test, like an interned name.
+    CosNameObjNode *widths_key = cos_name_obj_node_alloc(NULL, cos_string_alloc_with_str(NULL, "Widths"));
+    TEST_EXPECT(widths_key != NULL);
+    cos_obj_node_retain((CosObjNode *)widths_key);
+    TEST_EXPECT(cos_dict_obj_node_set(dict_node, widths_key, (CosObjNode *)array_node, NULL));
+
+    CosNameObjNode *first_char_key = cos_name_obj_node_alloc(NULL, cos_string_alloc_with_str(NULL, "FirstChar"));
+    TEST_EXPECT(first_char_key != NULL);
+    TEST_EXPECT(cos_dict_obj_node_set_value(dict_node, first_char_key, cos_obj_value_make_int(32), NULL));
+
+    CosError error = cos_error_none();
+    TEST_EXPECT(cos_obj_node_freeze((CosObjNode *)dict_node, &error));
+    TEST_EXPECT(cos_obj_node_is_frozen((CosObjNode *)dict_node));
+    TEST_EXPECT(cos_obj_node_is_frozen((CosObjNode *)array_node));
+    TEST_EXPECT(cos_obj_node_is_frozen((CosObjNode *)widths_key));
+
+    // Frozen objects cannot be modified.
+    CosNameObjNode *other_key = cos_name_obj_node_alloc(NULL, cos_string_alloc_with_str(NULL, "LastChar"));
+    TEST_EXPECT(other_key != NULL);
+    TEST_EXPECT(!cos_dict_obj_node_set_value(dict_node, other_key, cos_obj_value_make_int(126), &error));
+    TEST_EXPECT(error.code == COS_ERROR_INVALID_STATE);
+    cos_obj_node_release((CosObjNode *)other_key);
+    TEST_EXPECT(!cos_array_obj_node_append_value(array_node, cos_obj_value_make_int(1), NULL));
+    TEST_EXPECT(!cos_array_obj_node_remove_at(array_node, 0, NULL));
+    TEST_EXPECT(cos_array_obj_node_get_count(array_node) == 2);
+
+    // The elements of a frozen array keep their inline storage.
+    CosObjNode *element = cos_array_obj_node_get_at(array_node, 1, NULL);
+    TEST_EXPECT(element != NULL);
+    TEST_EXPECT(cos_int_obj_node_get_value((CosIntObjNode *)element) == 250);
+    TEST_EXPECT(cos_array_obj_node_get_at(array_node, 1, NULL) == element);
+    CosObjValue value;
+    TEST_EXPECT(cos_array_obj_node_get_value_at(array_node, 1, &value, NULL));
+    TEST_EXPECT(value.kind == CosObjValueKind_Integer);
+
+    // A reference to an object below the root is borrowed from the root.
+    cos_obj_node_retain((CosObjNode *)array_node);
+    cos_obj_node_release((CosObjNode *)array_node);
+    cos_obj_node_release((CosObjNode *)array_node);
+
+    CosObj *obj = cos_obj_create((CosObjNode *)dict_node);
+    TEST_EXPECT(obj != NULL);
+    int first_char = 0;
+    TEST_EXPECT(cos_obj_get_int_for_key(obj, "FirstChar", &first_char, NULL));
+    TEST_EXPECT(first_char == 32);
+    cos_obj_destroy(obj);
+
+    // Releasing the root releases the whole subgraph, apart from the shared key.
+    cos_obj_node_release((CosObjNode *)dict_node);
+    TEST_EXPECT(cos_name_obj_node_get_value(widths_key) != NULL);
+    cos_obj_node_release((CosObjNode *)widths_key);
+
+    return EXIT_SUCCESS;
+}
+
+static int
+freeze_arrayWithString_cachesStringHash(void)
+{
+    CosData *data = cos_data_alloc(NULL, 0);
+    TEST_EXPECT(data != NULL);
+    const char * const contents = "Helvetica";
+    TEST_EXPECT(cos_data_append(data, (const unsigned char *)contents, strlen(contents), NULL));
+    const size_t expected_hash = cos_data_ref_get_hash(cos_data_get_ref(data));
+
+    CosStringObjNode *string_node = cos_string_obj_node_alloc(NULL, data);
+    TEST_EXPECT(string_node != NULL);
+    CosArrayObjNode *array_node = cos_array_obj_node_alloc(NULL, NULL);
+    TEST_EXPECT(array_node != NULL);
+    TEST_EXPECT(cos_array_obj_node_append(array_node, (CosObjNode *)string_node, NULL));
+    TEST_EXPECT(!data->has_hash);
+
+    // Readers of a frozen string must not have to write its hash.
+    CosError error = cos_error_none();
+    TEST_EXPECT(cos_obj_node_freeze((CosObjNode *)array_node, &error));
+    TEST_EXPECT(data->has_hash);
+    TEST_EXPECT(cos_data_get_hash(data) == expected_hash);
+
+    cos_obj_node_release((CosObjNode *)array_node);
+
+    return EXIT_SUCCESS;
+}
+
 // MARK: - Dict iterator tests
 
 static int
 dictIterator_singleEntry_yieldsEntry(void)
 {
-    CosDictObjNode *dict_node = cos_dict_obj_node_create(NULL);
+    CosDictObjNode *dict_node = cos_dict_obj_node_create(NULL, NULL);
     TEST_EXPECT(dict_node != NULL);
 
-    CosString *key_str = cos_string_alloc_with_str("Size");
+    CosString *key_str = cos_string_alloc_with_str(NULL, "Size");
     TEST_EXPECT(key_str != NULL);
-    CosNameObjNode *key = cos_name_obj_node_alloc(key_str);
+    CosNameObjNode *key = cos_name_obj_node_alloc(NULL, key_str);
     TEST_EXPECT(key != NULL);
 
-    CosIntObjNode *value = cos_int_obj_node_alloc(100);
+    CosIntObjNode *value = cos_int_obj_node_alloc(NULL, 100);
     TEST_EXPECT(value != NULL);
 
     TEST_EXPECT(cos_dict_obj_node_set(dict_node, key, (CosObjNode *)value, NULL));
@@ -273,6 +735,7 @@ TEST_MAIN()
     TEST_EXPECT(create_fromDirectIntNode_succeeds() == EXIT_SUCCESS);
     TEST_EXPECT(create_fromIndirectNode_resolvesType() == EXIT_SUCCESS);
     TEST_EXPECT(create_fromNullNode_isNull() == EXIT_SUCCESS);
+    TEST_EXPECT(release_immortalNode_isNotDeallocated() == EXIT_SUCCESS);
 
     /* Scalar accessors */
     TEST_EXPECT(getBoolValue_boolObj_returnsValue() == EXIT_SUCCESS);
@@ -281,10 +744,22 @@ TEST_MAIN()
 
     /* Array */
     TEST_EXPECT(getArrayCount_arrayObj_returnsCount() == EXIT_SUCCESS);
+    TEST_EXPECT(arrayAppendValue_scalars_storedInline() == EXIT_SUCCESS);
+    TEST_EXPECT(arrayGetAt_inlineScalar_boxesOnce() == EXIT_SUCCESS);
+    TEST_EXPECT(arrayPack_numbers_copiesOutInOnePass() == EXIT_SUCCESS);
+    TEST_EXPECT(arrayPack_ints_boxesOnGetAt() == EXIT_SUCCESS);
 
     /* Dict */
     TEST_EXPECT(getDictValue_existingKey_returnsValue() == EXIT_SUCCESS);
     TEST_EXPECT(getDictValue_nonExistingKey_returnsNull() == EXIT_SUCCESS);
+    TEST_EXPECT(dictSet_existingKey_replacesValue() == EXIT_SUCCESS);
+    TEST_EXPECT(dictSet_pastInlineCapacity_keepsAllEntries() == EXIT_SUCCESS);
+    TEST_EXPECT(dictSetValue_scalars_storedInlineAndBoxedOnPromotion() == EXIT_SUCCESS);
+    TEST_EXPECT(dictGetValue_inlineScalar_boxesOnce() == EXIT_SUCCESS);
+
+    /* Freezing */
+    TEST_EXPECT(freeze_dictWithArray_isReadOnlyAndReleasedWithRoot() == EXIT_SUCCESS);
+    TEST_EXPECT(freeze_arrayWithString_cachesStringHash() == EXIT_SUCCESS);
 
     /* Dict iterator */
     TEST_EXPECT(dictIterator_singleEntry_yieldsEntry() == EXIT_SUCCESS);
@@ -0,0 +1,239 @@
+/*
+ * Copyright (c) 2024 OpenCOS.
+ */
+
+#include "CosTest.h"
+
+#include <libcos/common/CosData.h>
+#include <libcos/common/CosDataRef.h>
+#include <libcos/common/CosString.h>
+#include <libcos/common/memory/CosAllocator.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+COS_ASSUME_NONNULL_BEGIN
+
+// MARK: - Counting allocator
+
+static void * COS_Nullable
+counting_alloc_(size_t size,
+                void * COS_Nullable user_data)
+{
+    size_t * const alloc_count = user_data;
+    if (alloc_count) {
+        (*alloc_count)++;
+    }
+    return malloc(size);
+}
+
+static void * COS_Nullable
+counting_realloc_(void * COS_Nullable ptr,
+                  size_t size,
+                  void * COS_Nullable user_data)
+{
+    size_t * const alloc_count = user_data;
+    if (alloc_count) {
+        (*alloc_count)++;
+    }
+    return realloc(ptr, size);
+}
+
+static void
+counting_dealloc_(void *ptr,
+                  void * COS_Nullable user_data)
+{
+    (void)user_data;
+    free(ptr);
+}
+
+static const CosAllocatorCallbacks k_counting_callbacks = {
+    .alloc = &counting_alloc_,
+    .realloc = &counting_realloc_,
+    .dealloc = &counting_dealloc_,
+    .retain = NULL,
+    .release = NULL,
+};
+
+// MARK: - Storage tests
+
+static int
+alloc_shortString_usesSingleAllocation(void)
+{
+    size_t alloc_count = 0;
+    CosAllocator * const allocator = cos_allocator_create(NULL, &k_counting_callbacks, &alloc_count);
+    TEST_EXPECT(allocator != NULL);
+
+    CosString * const string = cos_string_alloc_with_str(allocator, "FontDescriptor");
+    TEST_EXPECT(string != NULL);
+    TEST_EXPECT(alloc_count == 1);
+
+    CosString * const empty = cos_string_alloc(allocator, 0);
+    TEST_EXPECT(empty != NULL);
+    TEST_EXPECT(cos_string_append_str(empty, "Type"));
+    TEST_EXPECT(alloc_count == 2);
+
+    cos_string_free(string);
+    cos_string_free(empty);
+    cos_allocator_destroy(allocator);
+    return EXIT_SUCCESS;
+}
+
+static int
+append_pastInlineCapacity_keepsContents(void)
+{
+    CosString * const string = cos_string_alloc(NULL, 0);
+    TEST_EXPECT(string != NULL);
+
+    const char * const expected = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz";
+    for (const char *c = expected; *c; c++) {
+        TEST_EXPECT(cos_string_push_back(string, *c));
+    }
+
+    TEST_EXPECT(cos_string_get_length(string) == strlen(expected));
+    TEST_EXPECT(strcmp(cos_string_get_data(string), expected) == 0);
+
+    CosString * const copy = cos_string_copy(string);
+    TEST_EXPECT(copy != NULL);
+    TEST_EXPECT(strcmp(cos_string_get_data(copy), expected) == 0);
+
+    cos_string_free(string);
+    cos_string_free(copy);
+    return EXIT_SUCCESS;
+}
+
+static int
+dataAppend_pastInlineCapacity_keepsContents(void)
+{
+    size_t alloc_count = 0;
+    CosAllocator * const allocator = cos_allocator_create(NULL, &k_counting_callbacks, &alloc_count);
+    TEST_EXPECT(allocator != NULL);
+
+    CosData * const data = cos_data_alloc(allocator, 0);
+    TEST_EXPECT(data != NULL);
+    TEST_EXPECT(alloc_count == 1);
+
+    for (size_t i = 0; i < 100; i++) {
+        TEST_EXPECT(cos_data_push_back(data, (unsigned char)i, NULL));
+    }
+    TEST_EXPECT(data->size == 100);
+    for (size_t i = 0; i < 100; i++) {
+        TEST_EXPECT(data->bytes[i] == (unsigned char)i);
+    }
+
+    // Growth is geometric, not one allocation per byte.
+    TEST_EXPECT(alloc_count < 10);
+
+    cos_data_free(data);
+    cos_allocator_destroy(allocator);
+    return EXIT_SUCCESS;
+}
+
+// MARK: - Hash tests
+
+static int
+hash_equalStrings_areEqual(void)
+{
+    CosString * const string1 = cos_string_alloc_with_str(NULL, "BaseFont");
+    CosString * const string2 = cos_string_alloc_with_str(NULL, "BaseFont");
+    TEST_EXPECT(string1 != NULL);
+    TEST_EXPECT(string2 != NULL);
+
+    TEST_EXPECT(cos_string_get_hash(string1) == cos_string_get_hash(string2));
+    TEST_EXPECT(cos_string_get_hash(string1) ==
+                cos_string_ref_get_hash(cos_string_ref_from_str("BaseFont")));
+
+    cos_string_free(string1);
+    cos_string_free(string2);
+    return EXIT_SUCCESS;
+}
+
+static int
+hash_afterAppend_matchesNewContents(void)
+{
+    CosString * const string = cos_string_alloc_with_str(NULL, "Base");
+    TEST_EXPECT(string != NULL);
+
+    // Cache the hash of the original contents.
+    const size_t old_hash = cos_string_get_hash(string);
+    TEST_EXPECT(old_hash == cos_string_ref_get_hash(cos_string_ref_from_str("Base")));
+
+    TEST_EXPECT(cos_string_append_str(string, "Font"));
+    TEST_EXPECT(cos_string_get_hash(string) ==
+                cos_string_ref_get_hash(cos_string_ref_from_str("BaseFont")));
+
+    TEST_EXPECT(cos_string_push_back(string, 'X'));
+    TEST_EXPECT(cos_string_get_hash(string) ==
+                cos_string_ref_get_hash(cos_string_ref_from_str("BaseFontX")));
+
+    cos_string_free(string);
+    return EXIT_SUCCESS;
+}
+
+static int
+hash_allLengths_dependOnEveryByte(void)
+{
+    char buffer[80];
+    memset(buffer, 'a', sizeof(buffer));
+
+    // Changing any single byte should change the hash, for every length the hash handles
+    // differently (short, word-sized, and multi-block inputs).
+    for (size_t length = 1; length <= sizeof(buffer); length++) {
+        const size_t hash = cos_string_ref_get_hash(cos_string_ref_make(buffer, length));
+        for (size_t i = 0; i < length; i++) {
+            buffer[i] = 'b';
+            TEST_EXPECT(cos_string_ref_get_hash(cos_string_ref_make(buffer, length)) != hash);
+            buffer[i] = 'a';
+        }
+    }
+
+    // The length is part of the hash.
+    TEST_EXPECT(cos_string_ref_get_hash(cos_string_ref_make(buffer, 16)) !=
+                cos_string_ref_get_hash(cos_string_ref_make(buffer, 17)));
+    TEST_EXPECT(cos_string_ref_get_hash(cos_string_ref_make(buffer, 0)) !=
+                cos_string_ref_get_hash(cos_string_ref_make(buffer, 1)));
+
+    return EXIT_SUCCESS;
+}
+
+static int
+hash_dataAndString_agree(void)
+{
+    CosData * const data = cos_data_alloc(NULL, 0);
+    TEST_EXPECT(data != NULL);
+
+    const char * const contents = "A string that is longer than a single block";
+    TEST_EXPECT(cos_data_append(data,
+                                (const unsigned char *)contents,
+                                strlen(contents),
+                                NULL));
+    TEST_EXPECT(cos_data_get_hash(data) ==
+                cos_string_ref_get_hash(cos_string_ref_from_str(contents)));
+    TEST_EXPECT(cos_data_get_hash(data) == cos_data_ref_get_hash(cos_data_get_ref(data)));
+
+    TEST_EXPECT(cos_data_reset(data));
+    TEST_EXPECT(cos_data_get_hash(data) == cos_data_ref_get_hash(cos_data_ref_make(NULL, 0)));
+
+    cos_data_free(data);
+    return EXIT_SUCCESS;
+}
+
+// MARK: - Test driver
+
+TEST_MAIN()
+{
+    /* Storage */
+    TEST_EXPECT(alloc_shortString_usesSingleAllocation() == EXIT_SUCCESS);
+    TEST_EXPECT(append_pastInlineCapacity_keepsContents() == EXIT_SUCCESS);
+    TEST_EXPECT(dataAppend_pastInlineCapacity_keepsContents() == EXIT_SUCCESS);
+
+    /* Hash */
+    TEST_EXPECT(hash_equalStrings_areEqual() == EXIT_SUCCESS);
+    TEST_EXPECT(hash_afterAppend_matchesNewContents() == EXIT_SUCCESS);
+    TEST_EXPECT(hash_allLengths_dependOnEveryByte() == EXIT_SUCCESS);
+    TEST_EXPECT(hash_dataAndString_agree() == EXIT_SUCCESS);
+
+    return EXIT_SUCCESS;
+}
+
+COS_ASSUME_NONNULL_END
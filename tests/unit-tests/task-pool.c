@@ -0,0 +1,207 @@
+/*
+ * Copyright (c) 2025 OpenCOS.
+ */
+
+#include "CosTest.h"
+#include "common/CosTaskPool.h"
+#include "common/CosThread.h"
+
+#include <libcos/common/CosExecutor.h>
+
+#include <stdlib.h>
+
+COS_ASSUME_NONNULL_BEGIN
+
+// MARK: - Helpers
+
+typedef struct Counter {
+    CosMutex mutex;
+    size_t value;
+} Counter;
+
+static void
+increment_(void * COS_Nullable arg)
+{
+    Counter * const counter = arg;
+    cos_mutex_lock(&counter->mutex);
+    counter->value++;
+    cos_mutex_unlock(&counter->mutex);
+}
+
+typedef struct FanOut {
+    CosTaskPool *pool;
+    CosTaskGroup *group;
+    Counter *counter;
+    size_t child_count;
+} FanOut;
+
+/**
+ * @brief Submits @a child_count increments from inside a task.
+ */
+static void
+fan_out_(void * COS_Nullable arg)
+{
+    FanOut * const fan_out = arg;
+    for (size_t i = 0; i < fan_out->child_count; i++) {
+        if (!cos_task_pool_submit(fan_out->pool, fan_out->group, &increment_, fan_out->counter)) {
+            increment_(fan_out->counter);
+        }
+    }
+}
+
+static void
+run_job_inline_(CosExecutorJobFunc job_func,
+                void *job,
+                void * COS_Nullable user_data)
+{
+    size_t * const submit_count = user_data;
+    (*submit_count)++;
+    job_func(job);
+}
+
+// MARK: - Tests
+
+static int
+submit_manyTasks_runsEachOnce(void)
+{
+    Counter counter = {.value = 0};
+    TEST_EXPECT(cos_mutex_init(&counter.mutex, false));
+
+    const CosTaskPoolOptions options = {
+        .thread_count = 4,
+        .executor = NULL,
+    };
+    CosTaskPool * const pool = cos_task_pool_create(NULL, &options);
+    TEST_EXPECT(pool != NULL);
+    TEST_EXPECT(cos_task_pool_get_thread_count(COS_nonnull_cast(pool)) <= 4);
+
+    CosTaskGroup group;
+    cos_task_group_init(&group);
+    for (size_t i = 0; i < 1000; i++) {
+        TEST_EXPECT(cos_task_pool_submit(COS_nonnull_cast(pool), &group, &increment_, &counter));
+    }
+    cos_task_pool_wait(COS_nonnull_cast(pool), &group);
+
+    TEST_EXPECT(counter.value == 1000);
+
+    cos_task_pool_destroy(COS_nonnull_cast(pool));
+    cos_mutex_destroy(&counter.mutex);
+
+    return EXIT_SUCCESS;
+}
+
+static int
+submit_fromTasks_waitsForNestedTasks(void)
+{
+    Counter counter = {.value = 0};
+    TEST_EXPECT(cos_mutex_init(&counter.mutex, false));
+
+    const CosTaskPoolOptions options = {
+        .thread_count = 3,
+        .executor = NULL,
+    };
+    CosTaskPool * const pool = cos_task_pool_create(NULL, &options);
+    TEST_EXPECT(pool != NULL);
+
+    CosTaskGroup group;
+    cos_task_group_init(&group);
+
+    FanOut fan_outs[8];
+    for (size_t i = 0; i < 8; i++) {
+        fan_outs[i] = (FanOut){
+            .pool = COS_nonnull_cast(pool),
+            .group = &group,
+            .counter = &counter,
+            .child_count = 50,
+        };
+        TEST_EXPECT(cos_task_pool_submit(COS_nonnull_cast(pool), &group, &fan_out_, &fan_outs[i]));
+    }
+    cos_task_pool_wait(COS_nonnull_cast(pool), &group);
+
+    TEST_EXPECT(counter.value == 8 * 50);
+
+    cos_task_pool_destroy(COS_nonnull_cast(pool));
+    cos_mutex_destroy(&counter.mutex);
+
+    return EXIT_SUCCESS;
+}
+
+static int
+submit_noWorkers_runsOnWaitingThread(void)
+{
+    Counter counter = {.value = 0};
+    TEST_EXPECT(cos_mutex_init(&counter.mutex, false));
+
+    const CosTaskPoolOptions options = {
+        .thread_count = 0,
+        .executor = NULL,
+    };
+    CosTaskPool * const pool = cos_task_pool_create(NULL, &options);
+    TEST_EXPECT(pool != NULL);
+    TEST_EXPECT(cos_task_pool_get_thread_count(COS_nonnull_cast(pool)) == 0);
+
+    CosTaskGroup group;
+    cos_task_group_init(&group);
+    for (size_t i = 0; i < 10; i++) {
+        TEST_EXPECT(cos_task_pool_submit(COS_nonnull_cast(pool), &group, &increment_, &counter));
+    }
+
+    // Nothing runs until the tasks are waited for.
+    TEST_EXPECT(counter.value == 0);
+    cos_task_pool_wait(COS_nonnull_cast(pool), &group);
+    TEST_EXPECT(counter.value == 10);
+
+    cos_task_pool_destroy(COS_nonnull_cast(pool));
+    cos_mutex_destroy(&counter.mutex);
+
+    return EXIT_SUCCESS;
+}
+
+static int
+submit_withExecutor_handsTasksToExecutor(void)
+{
+    Counter counter = {.value = 0};
+    TEST_EXPECT(cos_mutex_init(&counter.mutex, false));
+
+    size_t submit_count = 0;
+    const CosExecutor executor = {
+        .submit = &run_job_inline_,
+        .user_data = &submit_count,
+    };
+    const CosTaskPoolOptions options = {
+        .thread_count = 4,
+        .executor = &executor,
+    };
+    CosTaskPool * const pool = cos_task_pool_create(NULL, &options);
+    TEST_EXPECT(pool != NULL);
+    TEST_EXPECT(cos_task_pool_get_thread_count(COS_nonnull_cast(pool)) == 0);
+
+    CosTaskGroup group;
+    cos_task_group_init(&group);
+    for (size_t i = 0; i < 10; i++) {
+        TEST_EXPECT(cos_task_pool_submit(COS_nonnull_cast(pool), &group, &increment_, &counter));
+    }
+    cos_task_pool_wait(COS_nonnull_cast(pool), &group);
+
+    TEST_EXPECT(counter.value == 10);
+    TEST_EXPECT(submit_count == 10);
+
+    cos_task_pool_destroy(COS_nonnull_cast(pool));
+    cos_mutex_destroy(&counter.mutex);
+
+    return EXIT_SUCCESS;
+}
+
+// MARK: - Test driver
+
+TEST_MAIN()
+{
+    TEST_EXPECT(submit_manyTasks_runsEachOnce() == EXIT_SUCCESS);
+    TEST_EXPECT(submit_fromTasks_waitsForNestedTasks() == EXIT_SUCCESS);
+    TEST_EXPECT(submit_noWorkers_runsOnWaitingThread() == EXIT_SUCCESS);
+    TEST_EXPECT(submit_withExecutor_handsTasksToExecutor() == EXIT_SUCCESS);
+
+    return EXIT_SUCCESS;
+}
+
+COS_ASSUME_NONNULL_END
@@ -4,6 +4,7 @@
 
 #include "CosTest.h"
 
+#include <libcos/common/CosData.h>
 #include <libcos/io/CosMemoryStream.h>
 #include <libcos/io/CosStream.h>
 #include <libcos/syntax/tokenizer/CosToken.h>
@@ -26,9 +27,10 @@ COS_ASSUME_NONNULL_BEGIN
  * @c cos_token_reset() on each populated token when finished with it.
  */
 static bool
-get_tokens_(const char *input,
-            CosToken *out_tokens,
-            size_t count)
+get_tokens_with_options_(const char *input,
+                         bool combines_indirect_tokens,
+                         CosToken *out_tokens,
+                         size_t count)
 {
     CosMemoryStream *stream = NULL;
     CosTokenizer *tokenizer = NULL;
@@ -39,10 +41,11 @@ get_tokens_(const char *input,
         goto cleanup;
     }
 
-    tokenizer = cos_tokenizer_create((CosStream *)stream);
+    tokenizer = cos_tokenizer_create(NULL, (CosStream *)stream);
     if (!tokenizer) {
         goto cleanup;
     }
+    cos_tokenizer_set_combines_indirect_tokens(tokenizer, combines_indirect_tokens);
 
     for (size_t i = 0; i < count; i++) {
         out_tokens[i] = (CosToken){0};
@@ -63,6 +66,14 @@ cleanup:
     return ok;
 }
 
+static bool
+get_tokens_(const char *input,
+            CosToken *out_tokens,
+            size_t count)
+{
+    return get_tokens_with_options_(input, false, out_tokens, count);
+}
+
 // MARK: - Token type tests
 
 static int
@@ -262,6 +273,55 @@ tokenize_fKeyword_RecognizedCorrectly(void)
     return EXIT_SUCCESS;
 }
 
+static int
+tokenize_longUnknownToken_ThenKeyword(void)
+{
+    CosToken tokens[2] = {{0}, {0}};
+    TEST_EXPECT(get_tokens_("endobjendobjendobj endobj", tokens, 2));
+    TEST_EXPECT(tokens[0].type == CosToken_Type_Unknown);
+    TEST_EXPECT(tokens[0].length == 18);
+    TEST_EXPECT(tokens[1].type == CosToken_Type_EndObj);
+    return EXIT_SUCCESS;
+}
+
+static int
+tokenize_longLiteralStrings_KeepAllBytes(void)
+{
+    // Several strings longer than a data object's inline storage, so that later strings
+    // are sized from the tokenizer's hint.
+    enum { STRING_COUNT = 4, STRING_LENGTH = 300 };
+
+    char input[STRING_COUNT * (STRING_LENGTH + 3) + 1];
+    size_t offset = 0;
+    for (size_t i = 0; i < STRING_COUNT; i++) {
+        input[offset++] = '(';
+        for (size_t j = 0; j < STRING_LENGTH; j++) {
+            input[offset++] = (char)('a' + ((i + j) % 26));
+        }
+        input[offset++] = ')';
+        input[offset++] = ' ';
+    }
+    input[offset] = '\0';
+
+    CosToken tokens[STRING_COUNT];
+    TEST_EXPECT(get_tokens_(input, tokens, STRING_COUNT));
+
+    for (size_t i = 0; i < STRING_COUNT; i++) {
+        TEST_EXPECT(tokens[i].type == CosToken_Type_Literal_String);
+
+        const CosData *data = NULL;
+        TEST_EXPECT(cos_token_value_get_data(&tokens[i].value, &data));
+        TEST_EXPECT(data != NULL);
+        TEST_EXPECT(data->size == STRING_LENGTH);
+        for (size_t j = 0; j < STRING_LENGTH; j++) {
+            TEST_EXPECT(data->bytes[j] == (unsigned char)('a' + ((i + j) % 26)));
+        }
+
+        cos_token_reset(&tokens[i]);
+    }
+    return EXIT_SUCCESS;
+}
+
 // MARK: - Offset and length tests
 
 static int
@@ -448,6 +508,68 @@ whitespace_multipleSpaces_NotSingleSpace(void)
     return EXIT_SUCCESS;
 }
 
+// MARK: - Indirect object tokens
+
+static int
+indirectTokens_reference_IsOneToken(void)
+{
+    CosToken tokens[2] = {0};
+    TEST_EXPECT(get_tokens_with_options_("[12 3 R]", true, tokens, 2));
+    TEST_EXPECT(tokens[1].type == CosToken_Type_IndirectRef);
+    TEST_EXPECT(tokens[1].offset == 1);
+    TEST_EXPECT(tokens[1].length == 6);
+
+    CosObjID obj_id = {0};
+    TEST_EXPECT(cos_token_value_get_obj_id(&tokens[1].value, &obj_id));
+    TEST_EXPECT(obj_id.obj_number == 12);
+    TEST_EXPECT(obj_id.gen_number == 3);
+    return EXIT_SUCCESS;
+}
+
+static int
+indirectTokens_header_IsOneToken(void)
+{
+    CosToken tokens[2] = {0};
+    TEST_EXPECT(get_tokens_with_options_("7 0 obj\n<<", true, tokens, 2));
+    TEST_EXPECT(tokens[0].type == CosToken_Type_IndirectDef);
+    TEST_EXPECT(tokens[0].length == 7);
+    TEST_EXPECT(tokens[1].type == CosToken_Type_DictionaryStart);
+
+    CosObjID obj_id = {0};
+    TEST_EXPECT(cos_token_value_get_obj_id(&tokens[0].value, &obj_id));
+    TEST_EXPECT(obj_id.obj_number == 7);
+    TEST_EXPECT(obj_id.gen_number == 0);
+    return EXIT_SUCCESS;
+}
+
+static int
+indirectTokens_unusualSpacing_StaysSeparate(void)
+{
+    CosToken tokens[3] = {0};
+    TEST_EXPECT(get_tokens_with_options_("12\n0 R ", true, tokens, 3));
+    TEST_EXPECT(tokens[0].type == CosToken_Type_Integer);
+    TEST_EXPECT(tokens[1].type == CosToken_Type_Integer);
+    TEST_EXPECT(tokens[2].type == CosToken_Type_R);
+
+    // "Rx" is not the R keyword.
+    TEST_EXPECT(get_tokens_with_options_("12 0 Rx ", true, tokens, 3));
+    TEST_EXPECT(tokens[0].type == CosToken_Type_Integer);
+    TEST_EXPECT(tokens[1].type == CosToken_Type_Integer);
+    TEST_EXPECT(tokens[2].type == CosToken_Type_Unknown);
+    return EXIT_SUCCESS;
+}
+
+static int
+indirectTokens_disabled_StaysSeparate(void)
+{
+    CosToken tokens[3] = {0};
+    TEST_EXPECT(get_tokens_("12 0 R ", tokens, 3));
+    TEST_EXPECT(tokens[0].type == CosToken_Type_Integer);
+    TEST_EXPECT(tokens[1].type == CosToken_Type_Integer);
+    TEST_EXPECT(tokens[2].type == CosToken_Type_R);
+    return EXIT_SUCCESS;
+}
+
 // MARK: - Test driver
 
 TEST_MAIN()
@@ -473,6 +595,8 @@ TEST_MAIN()
     TEST_EXPECT(tokenize_startxrefKeyword_RecognizedCorrectly() == EXIT_SUCCESS);
     TEST_EXPECT(tokenize_nKeyword_RecognizedCorrectly() == EXIT_SUCCESS);
     TEST_EXPECT(tokenize_fKeyword_RecognizedCorrectly() == EXIT_SUCCESS);
+    TEST_EXPECT(tokenize_longUnknownToken_ThenKeyword() == EXIT_SUCCESS);
+    TEST_EXPECT(tokenize_longLiteralStrings_KeepAllBytes() == EXIT_SUCCESS);
 
     /* Offset and length tests */
     TEST_EXPECT(tokenize_singleToken_OffsetIsZero() == EXIT_SUCCESS);
@@ -500,6 +624,12 @@ TEST_MAIN()
     TEST_EXPECT(whitespace_bareCrPredicate_ReturnsFalseForCrLf() == EXIT_SUCCESS);
     TEST_EXPECT(whitespace_multipleSpaces_NotSingleSpace() == EXIT_SUCCESS);
 
+    /* Indirect object tokens */
+    TEST_EXPECT(indirectTokens_reference_IsOneToken() == EXIT_SUCCESS);
+    TEST_EXPECT(indirectTokens_header_IsOneToken() == EXIT_SUCCESS);
+    TEST_EXPECT(indirectTokens_unusualSpacing_StaysSeparate() == EXIT_SUCCESS);
+    TEST_EXPECT(indirectTokens_disabled_StaysSeparate() == EXIT_SUCCESS);
+
     return EXIT_SUCCESS;
 }
 
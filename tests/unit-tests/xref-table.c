@@ -55,7 +55,7 @@ parse_xref_from_string_(const char *input,
         goto cleanup;
     }
 
-    tokenizer = cos_tokenizer_create((CosStream *)stream);
+    tokenizer = cos_tokenizer_create(NULL, (CosStream *)stream);
     if (!tokenizer) {
         goto cleanup;
     }